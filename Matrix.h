@@ -0,0 +1,355 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+
+#ifdef _WIN32
+#  include <malloc.h>
+#endif
+
+/// 矩阵存储的对齐字节数(一个缓存行, 同时满足AVX-512的64字节对齐)
+constexpr size_t MATRIX_ALIGNMENT = 64;
+
+/// 页大小, 行跨度为其整数倍时会在组相联缓存中产生冲突
+constexpr size_t MATRIX_PAGE_SIZE = 4096;
+
+/**
+ * @brief 分配对齐内存
+ *
+ * 跨平台的对齐内存分配, Windows使用_aligned_malloc, 其他系统使用posix_memalign
+ *
+ * @param bytes 分配的字节数
+ * @param alignment 对齐字节数, 必须是2的幂且为sizeof(void*)的倍数
+ * @return void* 对齐后的内存指针
+ * @throws std::bad_alloc 分配失败时抛出
+ */
+inline void *aligned_malloc(size_t bytes, size_t alignment)
+{
+  if (bytes == 0) bytes = alignment;
+#ifdef _WIN32
+  void *ptr = _aligned_malloc(bytes, alignment);
+#else
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, alignment, bytes) != 0) ptr = nullptr;
+#endif
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+/**
+ * @brief 释放aligned_malloc分配的内存
+ *
+ * @param ptr 内存指针, 可以为nullptr
+ */
+inline void aligned_free(void *ptr)
+{
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+
+/// 大页大小, 不小于该字节数的分配按页对齐地向操作系统申请
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/**
+ * @brief 为矩阵和工作区分配内存
+ *
+ * 小于HUGE_PAGE_SIZE时等同于aligned_malloc(); 否则按set_page_mode()
+ * 选择的页面类型(4 KiB页、透明大页或MAP_HUGETLB大页)向操作系统申请,
+ * 长度取整到HUGE_PAGE_SIZE, 大页不可用时透明地回退。定义在
+ * MatrixMul_pages.cpp中
+ *
+ * @param bytes 分配的字节数
+ * @return void* 至少按MATRIX_ALIGNMENT对齐的内存指针
+ * @throws std::bad_alloc 分配失败时抛出
+ */
+void *page_alloc(size_t bytes);
+
+/**
+ * @brief 释放page_alloc()分配的内存
+ *
+ * @param ptr 内存指针, 可以为nullptr
+ * @param bytes 分配时传入的字节数
+ */
+void page_free(void *ptr, size_t bytes);
+
+/**
+ * @brief 计算默认的行跨度(leading dimension)
+ *
+ * 先把行长度向上对齐到缓存行, 如果行跨度恰好是页大小的整数倍
+ * (例如1024或2048列的int矩阵), 再额外填充一个缓存行,
+ * 避免同一列的元素全部映射到同一个缓存组
+ *
+ * @param cols 列数
+ * @param elem_size 元素字节数
+ * @return size_t 行跨度(元素个数)
+ */
+inline size_t default_leading_dimension(size_t cols, size_t elem_size)
+{
+  size_t line_elems = MATRIX_ALIGNMENT / elem_size;
+  size_t ld = ((cols + line_elems - 1) / line_elems) * line_elems;
+  if (ld == 0) ld = line_elems;
+  if ((ld * elem_size) % MATRIX_PAGE_SIZE == 0) ld += line_elems;
+  return ld;
+}
+
+/**
+ * @brief 构造矩阵时跳过清零的标记类型
+ *
+ * 用于NUMA首次访问(first-touch)初始化: 分配后不写入任何页,
+ * 由计算时负责对应行的线程完成首次写入, 使页面落在该线程所在的节点
+ */
+struct MatrixNoInit
+{
+};
+
+/// 跳过清零的标记值
+constexpr MatrixNoInit matrix_no_init{};
+
+/**
+ * @brief 行主序矩阵视图
+ *
+ * 不拥有内存, 描述一块行主序存储中的子矩阵(行、块视图)
+ *
+ * @tparam T 元素类型, 可以是const限定的类型
+ */
+template <typename T> struct MatrixView
+{
+  T *data = nullptr; ///< 左上角元素指针
+  size_t rows = 0; ///< 行数
+  size_t cols = 0; ///< 列数
+  size_t ld = 0; ///< 行跨度(元素个数)
+
+  /**
+   * @brief 获取第i行首元素指针
+   */
+  T *row(size_t i) const { return data + i * ld; }
+
+  /**
+   * @brief 访问(i, j)处的元素
+   */
+  T &operator()(size_t i, size_t j) const { return data[i * ld + j]; }
+
+  /**
+   * @brief 获取子块视图
+   *
+   * @param r0 起始行
+   * @param c0 起始列
+   * @param nr 行数
+   * @param nc 列数
+   */
+  MatrixView tile(size_t r0, size_t c0, size_t nr, size_t nc) const
+  {
+    return MatrixView{data + r0 * ld + c0, nr, nc, ld};
+  }
+};
+
+/**
+ * @brief 连续存储、64字节对齐的行主序矩阵
+ *
+ * 所有元素位于同一块对齐内存中, 每行起始地址都按缓存行对齐,
+ * 行跨度ld可以大于列数以避免2的幂尺寸下的缓存组冲突。
+ * 取代vector<vector<int>>, 消除逐行分配和双重间接寻址。
+ *
+ * @tparam T 元素类型
+ */
+template <typename T> class Matrix
+{
+private:
+  T *data_ptr = nullptr; ///< 对齐的数据指针
+  size_t num_rows = 0; ///< 行数
+  size_t num_cols = 0; ///< 列数
+  size_t leading_dim = 0; ///< 行跨度(元素个数)
+  size_t capacity = 0; ///< 已分配的元素个数
+
+public:
+  Matrix() = default;
+
+  /**
+   * @brief 构造矩阵并清零
+   *
+   * @param rows 行数
+   * @param cols 列数
+   * @param ld 行跨度, 0表示使用default_leading_dimension()
+   */
+  Matrix(size_t rows, size_t cols, size_t ld = 0)
+      : num_rows(rows), num_cols(cols),
+        leading_dim(ld == 0 ? default_leading_dimension(cols, sizeof(T))
+                            : std::max(ld, cols))
+  {
+    capacity = num_rows * leading_dim;
+    data_ptr = static_cast<T *>(page_alloc(capacity * sizeof(T)));
+    std::fill(data_ptr, data_ptr + num_rows * leading_dim, T{});
+  }
+
+  /**
+   * @brief 构造矩阵但不初始化元素
+   *
+   * @param rows 行数
+   * @param cols 列数
+   * @param ld 行跨度, 0表示使用default_leading_dimension()
+   * @note 元素值未定义, 使用前需要逐行写入(例如parallel_first_touch())
+   */
+  Matrix(size_t rows, size_t cols, size_t ld, MatrixNoInit)
+      : num_rows(rows), num_cols(cols),
+        leading_dim(ld == 0 ? default_leading_dimension(cols, sizeof(T))
+                            : std::max(ld, cols))
+  {
+    capacity = num_rows * leading_dim;
+    data_ptr = static_cast<T *>(page_alloc(capacity * sizeof(T)));
+  }
+
+  ~Matrix() { page_free(data_ptr, capacity * sizeof(T)); }
+
+  Matrix(const Matrix &) = delete;
+  Matrix &operator=(const Matrix &) = delete;
+
+  Matrix(Matrix &&other) noexcept
+      : data_ptr(std::exchange(other.data_ptr, nullptr)),
+        num_rows(std::exchange(other.num_rows, 0)),
+        num_cols(std::exchange(other.num_cols, 0)),
+        leading_dim(std::exchange(other.leading_dim, 0)),
+        capacity(std::exchange(other.capacity, 0))
+  {
+  }
+
+  Matrix &operator=(Matrix &&other) noexcept
+  {
+    if (this != &other)
+    {
+      page_free(data_ptr, capacity * sizeof(T));
+      data_ptr = std::exchange(other.data_ptr, nullptr);
+      num_rows = std::exchange(other.num_rows, 0);
+      num_cols = std::exchange(other.num_cols, 0);
+      leading_dim = std::exchange(other.leading_dim, 0);
+      capacity = std::exchange(other.capacity, 0);
+    }
+    return *this;
+  }
+
+  size_t rows() const { return num_rows; }
+  size_t cols() const { return num_cols; }
+  size_t ld() const { return leading_dim; }
+
+  /// 实际占用的字节数(包含行尾填充)
+  size_t size_bytes() const { return num_rows * leading_dim * sizeof(T); }
+
+  T *data() { return data_ptr; }
+  const T *data() const { return data_ptr; }
+
+  T *row(size_t i) { return data_ptr + i * leading_dim; }
+  const T *row(size_t i) const { return data_ptr + i * leading_dim; }
+
+  T &operator()(size_t i, size_t j) { return data_ptr[i * leading_dim + j]; }
+  const T &operator()(size_t i, size_t j) const
+  {
+    return data_ptr[i * leading_dim + j];
+  }
+
+  /**
+   * @brief 获取整个矩阵的视图
+   */
+  MatrixView<T> view() { return {data_ptr, num_rows, num_cols, leading_dim}; }
+  MatrixView<const T> view() const
+  {
+    return {data_ptr, num_rows, num_cols, leading_dim};
+  }
+
+  /**
+   * @brief 获取子块视图
+   *
+   * @param r0 起始行
+   * @param c0 起始列
+   * @param nr 行数
+   * @param nc 列数
+   */
+  MatrixView<T> tile(size_t r0, size_t c0, size_t nr, size_t nc)
+  {
+    return view().tile(r0, c0, nr, nc);
+  }
+  MatrixView<const T> tile(size_t r0, size_t c0, size_t nr, size_t nc) const
+  {
+    return view().tile(r0, c0, nr, nc);
+  }
+
+  /**
+   * @brief 在已分配的内存中改变矩阵的尺寸
+   *
+   * 不重新分配内存也不初始化元素, 参数扫描按最大规模分配一次后
+   * 在各个规模之间复用; 改变尺寸后元素值未定义, 需要重新写入
+   *
+   * @param rows 新行数
+   * @param cols 新列数
+   * @param ld 新行跨度, 0表示使用default_leading_dimension()
+   * @throws std::length_error 新尺寸超出构造时分配的容量
+   */
+  void reshape(size_t rows, size_t cols, size_t ld = 0)
+  {
+    ld = ld == 0 ? default_leading_dimension(cols, sizeof(T))
+                 : std::max(ld, cols);
+    if (rows * ld > capacity)
+    {
+      throw std::length_error("Matrix::reshape超出已分配的容量");
+    }
+    num_rows = rows;
+    num_cols = cols;
+    leading_dim = ld;
+  }
+
+  /**
+   * @brief 将所有元素(包括行尾填充)设置为给定值
+   */
+  void fill(const T &value)
+  {
+    std::fill(data_ptr, data_ptr + num_rows * leading_dim, value);
+  }
+};
+
+/**
+ * @brief 线程私有的对齐打包缓冲区
+ *
+ * 只在容量不足时重新分配。打包GEMM和量化GEMM通过worker_buffer()按
+ * 参与者编号取得实例, 每次调用创建线程时同一编号的新线程也复用同一块
+ * 内存, 分配只发生在预热迭代中; 内存来自page_alloc(),
+ * 较大的面板使用--pages选择的大页
+ *
+ * @tparam T 元素类型
+ */
+template <typename T> struct PackBuffer
+{
+  T *data = nullptr; ///< 对齐的缓冲区指针
+  size_t capacity = 0; ///< 容量(元素个数)
+
+  PackBuffer() = default;
+  PackBuffer(const PackBuffer &) = delete;
+  PackBuffer &operator=(const PackBuffer &) = delete;
+  ~PackBuffer() { page_free(data, capacity * sizeof(T)); }
+
+  /**
+   * @brief 确保缓冲区至少能容纳count个元素
+   *
+   * @param count 元素个数
+   * @return T* 缓冲区指针
+   */
+  T *reserve(size_t count)
+  {
+    if (count > capacity)
+    {
+      page_free(data, capacity * sizeof(T));
+      data = nullptr;
+      capacity = 0;
+      data = static_cast<T *>(page_alloc(count * sizeof(T)));
+      capacity = count;
+    }
+    return data;
+  }
+};
+
+#endif // MATRIX_H
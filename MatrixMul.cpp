@@ -1,105 +1,1006 @@
 #include "MatrixMul.h"
 
+#include <random>
+
+/// Strassen误差测量中用double计算参考结果的最多行数
+static constexpr size_t STRASSEN_ERROR_ROWS = 64;
+
 /**
- * @brief 矩阵乘法性能基准测试主程序
+ * @brief 判断是否需要继续计入统计的迭代
  *
- * 这是一个全面的矩阵乘法性能测试程序, 具有以下特性：
- * - 自动检测系统硬件信息(CPU核心数、缓存大小等)
- * - 自动计算最优的矩阵分块大小
- * - 支持单线程和多线程性能对比
- * - 提供详细的性能指标分析(GFLOPS、加速比、效率等)
- * - 跨平台支持(Windows、Linux、macOS)
- * - 跨架构支持(x86、x86_64、ARM、ARM64)
+ * 至少完成config.iterations次迭代; 指定ci_target时继续迭代,
+ * 直到单线程和多线程时间中位数的置信区间都足够窄, 或达到max_iterations;
+ * 跳过单线程测试时只看多线程
  *
- * @param argc 命令行参数个数
- * @param argv 命令行参数数组
- * @return int 程序退出状态码, 0表示成功
+ * @param config 基准测试配置
+ * @param run 已有的测量结果, 因置信区间收敛而停止时设置converged
+ * @return bool 需要继续迭代时返回true
  */
-int main(int argc, char *argv[])
+static bool need_more_iterations(const BenchmarkConfig &config, KernelRun &run)
 {
-  // 解析命令行参数
-  BenchmarkConfig config = parse_args(argc, argv);
+  const size_t done = run.multi_seconds.size();
+  if (done < config.iterations) return true;
+  if (config.ci_target <= 0.0) return false;
+  if ((config.skip_single
+       || ci_converged(compute_sample_stats(run.single_seconds),
+                       config.ci_target))
+      && ci_converged(compute_sample_stats(run.multi_seconds),
+                      config.ci_target))
+  {
+    run.converged = true;
+    return false;
+  }
+  return done < config.max_iterations;
+}
 
-  // 显示系统信息
-  print_system_info();
+/**
+ * @brief 打印一组计时样本的统计量
+ *
+ * 时间以毫秒为单位, 例如
+ * "多线程(毫秒): 最小 1.20 中位数 1.25 p90 1.31 最大 1.40 标准差 0.05
+ *  95%CI [1.22, 1.28] 离群值 1/20"
+ *
+ * @param label 样本名称
+ * @param samples 每次迭代的时间(秒)
+ */
+static void print_sample_stats(const char *label,
+                               const vector<double> &samples)
+{
+  const SampleStats stats = compute_sample_stats(samples);
+  cout << label << "(毫秒): " << fixed << setprecision(3) << "最小 "
+       << stats.min * 1e3 << " 中位数 " << stats.median * 1e3 << " p90 "
+       << stats.p90 * 1e3 << " 最大 " << stats.max * 1e3 << " 标准差 "
+       << stats.stddev * 1e3 << " 95%CI [" << stats.ci_low * 1e3 << ", "
+       << stats.ci_high * 1e3 << "] 离群值 " << stats.outliers.size() << "/"
+       << samples.size() << endl;
+}
+
+/**
+ * @brief 输出硬件计数器的每次迭代平均值
+ *
+ * 多线程读数是所有线程之和, 周期/FMA因此表示每次乘加消耗的核心周期,
+ * 与单线程直接可比; 不支持的事件显示为"不支持"
+ *
+ * @param label 计时区域名称
+ * @param readings 累计读数
+ * @param fmas 每次迭代的乘加次数(n³)
+ */
+static void print_counter_readings(const char *label,
+                                   const CounterReadings &readings,
+                                   double fmas)
+{
+  const double samples = static_cast<double>(readings.samples);
+  auto count = [samples](double total)
+  {
+    std::ostringstream text;
+    if (std::isfinite(total))
+    {
+      text << scientific << setprecision(3) << total / samples;
+    }
+    else
+    {
+      text << "不支持";
+    }
+    return text.str();
+  };
+  auto ratio = [](double numerator, double denominator)
+  {
+    std::ostringstream text;
+    if (std::isfinite(numerator) && std::isfinite(denominator)
+        && denominator > 0.0)
+    {
+      text << fixed << setprecision(4) << numerator / denominator;
+    }
+    else
+    {
+      text << "不支持";
+    }
+    return text.str();
+  };
+  cout << label << "计数器(每次迭代): 周期 " << count(readings.cycles)
+       << " 指令 " << count(readings.instructions) << " IPC "
+       << ratio(readings.instructions, readings.cycles) << endl;
+  cout << "  L1D缺失 " << count(readings.l1d_misses) << " LLC缺失 "
+       << count(readings.llc_misses) << " dTLB缺失 "
+       << count(readings.dtlb_misses) << " 周期/FMA "
+       << ratio(readings.cycles / samples, fmas) << endl;
+}
+
+/**
+ * @brief 输出并行驱动的线程级遥测
+ *
+ * 把多线程调用的时间拆分为三部分, 用来判断效率损失的来源:
+ * - 计算: 平均忙碌时间
+ * - 负载不均衡: 最忙线程与平均值之差, 其他线程在此期间空等
+ * - 派发/汇合: 调用时间中最忙线程也未在计算的部分
+ * 另外给出忙碌时间总和与单线程时间之比, 明显大于1说明线程之间
+ * 存在内存带宽或缓存争用, 应优先调整数据布局而不是调度。
+ *
+ * @param telemetry 累加的遥测数据
+ * @param mode 并行方式名称
+ * @param single_seconds 单线程时间中位数(秒)
+ * @param per_thread 是否输出每个线程的时间线
+ */
+static void print_thread_telemetry(const ThreadTelemetry &telemetry,
+                                   const char *mode,
+                                   double single_seconds,
+                                   bool per_thread)
+{
+  if (telemetry.calls == 0) return;
+  const double calls = static_cast<double>(telemetry.calls);
+  const double wall = telemetry.wall / calls;
+  const double max_busy = telemetry.max_busy / calls;
+  const double min_busy = telemetry.min_busy / calls;
+  const double avg_busy = telemetry.avg_busy / calls;
+  size_t active = 0;
+  for (const WorkerRecord &worker : telemetry.workers)
+  {
+    if (worker.active) active++;
+  }
+
+  cout << "线程遥测(" << mode << ", 每次调用平均, " << active
+       << " 个线程):" << endl;
+  cout << "  忙碌时间(毫秒): 最大 " << fixed << setprecision(3)
+       << max_busy * 1e3 << " 最小 " << min_busy * 1e3 << " 平均 "
+       << avg_busy * 1e3 << " 不均衡比(最大/平均) " << setprecision(3)
+       << (avg_busy > 0.0 ? max_busy / avg_busy : 0.0) << endl;
+  cout << "  派发开销 " << setprecision(1) << telemetry.fork / calls * 1e6
+       << " 微秒, 汇合开销 " << telemetry.join / calls * 1e6
+       << " 微秒, 调用时间 " << setprecision(3) << wall * 1e3 << " 毫秒"
+       << endl;
+  if (wall > 0.0)
+  {
+    cout << "  时间占比: 计算 " << setprecision(1) << avg_busy / wall * 100
+         << "% 负载不均衡 " << (max_busy - avg_busy) / wall * 100
+         << "% 派发/汇合 " << (wall - max_busy) / wall * 100 << "%" << endl;
+  }
+  if (single_seconds > 0.0)
+  {
+    cout << "  忙碌时间总和/单线程时间: " << setprecision(3)
+         << avg_busy * static_cast<double>(active) / single_seconds << endl;
+  }
+  if (!per_thread) return;
+  for (size_t t = 0; t < telemetry.workers.size(); t++)
+  {
+    const WorkerRecord &worker = telemetry.workers[t];
+    if (!worker.active) continue;
+    cout << "  线程 " << t << ": CPU " << worker.cpu << " 开始 +"
+         << setprecision(1) << worker.start / calls * 1e6 << " 微秒 结束 "
+         << setprecision(3) << worker.end / calls * 1e3 << " 毫秒 忙碌 "
+         << worker.busy / calls * 1e3 << " 毫秒 工作量 "
+         << worker.work_items << endl;
+  }
+}
+
+/**
+ * @brief 输出测得性能在屋顶线模型中的位置
+ *
+ * 上限取峰值算力与算术强度×带宽中较小的一个; 由带宽一项决定时
+ * 内核在该模型下是带宽受限, 否则是计算受限
+ *
+ * @param model 机器参数
+ * @param intensity 算术强度
+ * @param label 输出的标签(单线程/多线程)
+ * @param throughput 测得的性能(GFLOPS/GOPS)
+ * @param multi 是否与多线程参数比较
+ * @param unit 性能单位
+ */
+static void print_roofline_position(const RooflineModel &model,
+                                    double intensity,
+                                    const char *label,
+                                    double throughput,
+                                    bool multi,
+                                    const char *unit)
+{
+  const double bound = roofline_bound(model, intensity, multi);
+  const double peak = multi ? model.peak_multi : model.peak_single;
+  cout << "  " << label << ": 上限 " << fixed << setprecision(2) << bound
+       << " " << unit << " (" << (bound < peak ? "带宽受限" : "计算受限")
+       << "), 达到 " << setprecision(1) << 100.0 * throughput / bound << "%"
+       << endl;
+}
+
+/**
+ * @brief 在同一组输入上依次运行多个内核变体并输出对比表
+ *
+ * 每个变体分别测量单线程和多线程(parallel_computing_optimized)时间,
+ * 预热和停止规则与主测试相同, 对比表使用时间中位数;
+ * 结果与打包内核计算的参考结果并行逐元素比较, 不受--verify和
+ * --skip-single影响。
+ * 需要B^T的变体使用预先转置的矩阵, 转置不计入时间。
+ * 测量了屋顶线模型时, 对比表增加多线程性能占屋顶线上限的比例。
+ *
+ * @tparam T 元素类型
+ * @param config 基准测试配置, 使用其中的kernel_suite
+ * @param src1 左操作数
+ * @param src2 右操作数
+ * @param pool 线程池, nullptr表示创建线程
+ * @param report 运行结果, 每个变体追加一条记录
+ *
+ * @see kernel_variants()
+ */
+template <typename T>
+static void run_kernel_suite(const BenchmarkConfig &config,
+                             const Matrix<T> &src1,
+                             const Matrix<T> &src2,
+                             ThreadPool *pool,
+                             BenchmarkReport &report)
+{
+  const size_t m = src1.rows();
+  const size_t k = src1.cols();
+  const size_t n = src2.cols();
+  const size_t ld = configured_leading_dimension(config, n);
+  Matrix<T> src2_t = transpose_matrix(src2);
+  Matrix<T> reference(m, n, ld, matrix_no_init);
+  Matrix<T> result(m, n, ld, matrix_no_init);
+  parallel_first_touch(reference, config.num_threads, pool);
+  parallel_computing_optimized(src1,
+                               src2,
+                               reference,
+                               config.block_size,
+                               config.num_threads,
+                               packed_matrix_mul<T>,
+                               pool);
+  const double tolerance =
+      config.tolerance > 0.0 ? config.tolerance : default_tolerance<T>(k);
+
+  const double operations = 2.0 * static_cast<double>(m)
+                            * static_cast<double>(n) * static_cast<double>(k);
+  const char *unit = throughput_unit(config.dtype);
+  vector<SampleStats> single_stats;
+  vector<SampleStats> multi_stats;
+  vector<bool> correct;
+  Timer timer;
+
+  cout << "开始内核对比..." << endl;
+  for (const string &name : config.kernel_suite)
+  {
+    const KernelVariant<T> &variant = *find_kernel_variant<T>(name);
+    const Matrix<T> &right = variant.transposed_b ? src2_t : src2;
+    KernelRun run;
+    run.kernel = name;
+    for (size_t iter = 0;
+         iter < config.warmup || need_more_iterations(config, run);
+         iter++)
+    {
+      const bool warm = iter < config.warmup;
+      parallel_first_touch(result, config.num_threads, pool);
+      timer.start();
+      variant.kernel(src1, right, result, config.block_size, 0, m);
+      timer.stop();
+      if (!warm) run.single_seconds.push_back(timer.get_seconds());
+
+      parallel_first_touch(result, config.num_threads, pool);
+      timer.start();
+      parallel_computing_optimized(src1,
+                                   right,
+                                   result,
+                                   config.block_size,
+                                   config.num_threads,
+                                   variant.kernel,
+                                   pool,
+                                   warm ? nullptr : &run.telemetry);
+      timer.stop();
+      if (!warm) run.multi_seconds.push_back(timer.get_seconds());
+    }
+    single_stats.push_back(compute_sample_stats(run.single_seconds));
+    multi_stats.push_back(compute_sample_stats(run.multi_seconds));
+
+    const bool match = compare_matrices(reference,
+                                        result,
+                                        tolerance,
+                                        config.num_threads,
+                                        pool)
+                           .passed;
+    correct.push_back(match);
+    run.verified = match;
+    report.runs.push_back(run);
+    if (config.verbose)
+    {
+      cout << "  " << name << ": 单线程中位数 " << fixed << setprecision(4)
+           << single_stats.back().median << " 秒, 多线程中位数 "
+           << multi_stats.back().median << " 秒, 迭代 "
+           << run.multi_seconds.size() << " 次" << endl;
+    }
+  }
+
+  double fastest = std::numeric_limits<double>::infinity();
+  for (const SampleStats &stats : multi_stats)
+  {
+    fastest = std::min(fastest, stats.median);
+  }
+  cout << endl << "=== 内核对比 (" << unit << ") ===" << endl;
+  // 表头按显示宽度手工对齐(setw按字节计数, 不适用于中文)
+  const bool roofline = report.roofline.peak_multi > 0.0;
+  const double bound = roofline_bound(
+      report.roofline, gemm_intensity(m, n, k, sizeof(T)), true);
+  cout << "内核            单线程      多线程    加速比  相对最快  CI宽度  验证"
+       << (roofline ? "  屋顶线" : "") << endl;
+  for (size_t v = 0; v < config.kernel_suite.size(); v++)
+  {
+    const SampleStats &single = single_stats[v];
+    const SampleStats &multi = multi_stats[v];
+    cout << std::left << setw(10) << config.kernel_suite[v] << std::right
+         << fixed << setprecision(2) << setw(12)
+         << operations / (single.median * 1e9) << setw(12)
+         << operations / (multi.median * 1e9) << setw(9)
+         << single.median / multi.median << "x" << setw(9)
+         << fastest / multi.median << "x" << setw(7)
+         << 100.0 * (multi.ci_high - multi.ci_low) / multi.median << "%"
+         << (correct[v] ? "  通过" : "  失败");
+    if (roofline)
+    {
+      cout << setw(7) << 100.0 * operations / (multi.median * 1e9) / bound
+           << "%";
+    }
+    cout << endl;
+  }
+  cout << "==================" << endl;
+}
+
+/**
+ * @brief 运行批量小矩阵乘法基准测试(--batch)
+ *
+ * 一批config.batch个M x N x K的小矩阵连续存放在三个Matrix中,
+ * 每行存放一个矩阵(见SmallBatch), 首次写入按批量的划分进行。
+ * 单线程依次计算全部矩阵; 多线程用parallel_rows()把批量按连续区间
+ * 分给各线程, 每个矩阵只由一个线程计算, 不在单个乘法内部并行。
+ * 预热和停止规则与主测试相同; 结果与batch_reference()的朴素ijk参考结果
+ * 并行逐元素比较(--verify none时跳过), 参考实现不与被测内核共用代码。
+ *
+ * @tparam T 元素类型
+ * @param config 基准测试配置, 使用其中的batch和shape_m/shape_n/shape_k
+ * @param report 运行结果, 追加一条记录
+ * @return int 程序退出状态码, 0表示成功, 1表示结果验证失败
+ */
+template <typename T>
+static int run_batch(const BenchmarkConfig &config, BenchmarkReport &report)
+{
+  const size_t count = config.batch;
+  const size_t m = config.shape_m;
+  const size_t n = config.shape_n;
+  const size_t k = config.shape_k;
+  const size_t stride_a = batch_stride(m, k, sizeof(T));
+  const size_t stride_b = batch_stride(k, n, sizeof(T));
+  const size_t stride_c = batch_stride(m, n, sizeof(T));
+  const BatchKernel<T> kernel = select_batch_kernel<T>(m, n, k);
+  const bool specialized = batch_kernel_specialized(m, n, k);
+
+  cout << "=== 测试配置 ===" << endl;
+  cout << "批量: " << count << " 个 " << m << "x" << k << " * " << k << "x"
+       << n << endl;
+  cout << "元素类型: " << dtype_name(config.dtype) << endl;
+  cout << "内核: " << (specialized ? "编译期特化" : "通用(运行时维度)")
+       << endl;
+  cout << "线程数: " << config.num_threads << endl;
+  cout << "线程派发: " << (config.use_pool ? "线程池" : "每次创建线程") << endl;
+  cout << "迭代次数: " << config.iterations << " (预热 " << config.warmup
+       << " 次)" << endl;
+
+  std::unique_ptr<ThreadPool> pool;
+  if (config.use_pool)
+  {
+    pool = std::make_unique<ThreadPool>(config.num_threads);
+  }
+
+  // 每行存放一个矩阵, 行跨度即矩阵间距
+  Matrix<T> a(count, stride_a, stride_a, matrix_no_init);
+  Matrix<T> b(count, stride_b, stride_b, matrix_no_init);
+  Matrix<T> c_single(config.skip_single ? 0 : count,
+                     stride_c,
+                     stride_c,
+                     matrix_no_init);
+  Matrix<T> c_multi(count, stride_c, stride_c, matrix_no_init);
+  const double memory_mb = static_cast<double>(a.size_bytes()
+                                               + b.size_bytes()
+                                               + c_multi.size_bytes())
+                           / (1024.0 * 1024.0);
+  report.config = config;
+  report.leading_dimension = stride_c;
+  report.memory_mb = memory_mb;
+  cout << "矩阵间距: A=" << stride_a << " B=" << stride_b << " C=" << stride_c
+       << " 个元素" << endl;
+  cout << "内存使用量约: " << fixed << setprecision(2) << memory_mb << " MB"
+       << endl;
+  cout << "==================" << endl << endl;
+
+  parallel_first_touch<T>(a,
+                          config.num_threads,
+                          pool.get(),
+                          [m, k](size_t p, T *data)
+                          {
+                            for (size_t e = 0; e < m * k; e++)
+                            {
+                              data[e] = static_cast<T>(
+                                  ((p + e / k) * 31 + (e % k) * 17) % 100);
+                            }
+                          });
+  parallel_first_touch<T>(b,
+                          config.num_threads,
+                          pool.get(),
+                          [k, n](size_t p, T *data)
+                          {
+                            for (size_t e = 0; e < k * n; e++)
+                            {
+                              data[e] = static_cast<T>(
+                                  ((p + e / n) * 17 + (e % n) * 31) % 100);
+                            }
+                          });
+
+  auto batch_of = [&](Matrix<T> &c)
+  {
+    SmallBatch<T> batch;
+    batch.a = a.data();
+    batch.b = b.data();
+    batch.c = c.data();
+    batch.stride_a = stride_a;
+    batch.stride_b = stride_b;
+    batch.stride_c = stride_c;
+    batch.m = m;
+    batch.n = n;
+    batch.k = k;
+    return batch;
+  };
+  const SmallBatch<T> single_batch = batch_of(c_single);
+  const SmallBatch<T> multi_batch = batch_of(c_multi);
+
+  Timer timer;
+  KernelRun run;
+  run.kernel = specialized ? "batch-fixed" : "batch-generic";
+  cout << "开始批量测试..." << endl;
+  for (size_t iter = 0;
+       iter < config.warmup || need_more_iterations(config, run);
+       iter++)
+  {
+    const bool warm = iter < config.warmup;
+    parallel_first_touch(c_single, config.num_threads, pool.get());
+    parallel_first_touch(c_multi, config.num_threads, pool.get());
+
+    if (!config.skip_single)
+    {
+      timer.start();
+      kernel(single_batch, 0, count);
+      timer.stop();
+      if (!warm) run.single_seconds.push_back(timer.get_seconds());
+    }
+
+    timer.start();
+    parallel_rows(count,
+                  config.num_threads,
+                  pool.get(),
+                  [&](size_t start, size_t end)
+                  { kernel(multi_batch, start, end); });
+    timer.stop();
+    if (!warm) run.multi_seconds.push_back(timer.get_seconds());
+  }
+
+  const SampleStats single = compute_sample_stats(run.single_seconds);
+  const SampleStats multi = compute_sample_stats(run.multi_seconds);
+  const double operations = 2.0 * static_cast<double>(count)
+                            * static_cast<double>(m) * static_cast<double>(n)
+                            * static_cast<double>(k);
+  const char *unit = throughput_unit(config.dtype);
+  cout << endl << "=== 性能结果 ===" << endl;
+  cout << fixed << setprecision(4);
+  if (!config.skip_single)
+  {
+    cout << "单线程性能: " << operations / (single.median * 1e9) << " " << unit
+         << " (每个矩阵 " << setprecision(2)
+         << single.median * 1e9 / static_cast<double>(count) << " 纳秒)"
+         << endl;
+    cout << setprecision(4) << "加速比: " << single.median / multi.median
+         << "x" << endl;
+  }
+  cout << "多线程性能: " << operations / (multi.median * 1e9) << " " << unit
+       << " (每个矩阵 " << setprecision(2)
+       << multi.median * 1e9 / static_cast<double>(count) << " 纳秒)"
+       << endl;
+  if (!config.skip_single) print_sample_stats("单线程", run.single_seconds);
+  print_sample_stats("多线程", run.multi_seconds);
+
+  run.verified = true;
+  if (config.verify != VerifyMode::None)
+  {
+    Matrix<T> reference(count, stride_c, stride_c, matrix_no_init);
+    parallel_first_touch(reference, config.num_threads, pool.get());
+    const SmallBatch<T> reference_batch = batch_of(reference);
+    parallel_rows(count,
+                  config.num_threads,
+                  pool.get(),
+                  [&](size_t start, size_t end)
+                  { batch_reference(reference_batch, start, end); });
+    const double tolerance =
+        config.tolerance > 0.0 ? config.tolerance : default_tolerance<T>(k);
+    const VerifyResult verdict = compare_matrices(
+        reference, c_multi, tolerance, config.num_threads, pool.get());
+    run.verified = verdict.passed;
+    cout << "结果验证(对比朴素ijk参考): " << (verdict.passed ? "通过" : "失败");
+    if (!verdict.passed)
+    {
+      cout << ", " << verdict.mismatches << " 个元素不一致, 首个位于第 "
+           << verdict.first_row << " 个矩阵";
+    }
+    cout << endl;
+  }
+  cout << "==================" << endl;
+
+  report.runs.push_back(run);
+  return run.verified ? 0 : 1;
+}
+
+/**
+ * @brief 测量Strassen内核在浮点输入上的舍入误差
+ *
+ * 基准测试的输入是整数模式, Strassen与常规内核的结果逐位相同, 反映不出
+ * 加减运算引入的误差; 因此另外生成固定种子、[-1, 1]均匀分布的A和B,
+ * 分别用并行Strassen和打包内核计算, 与double累加的参考结果比较。
+ * 参考结果只计算均匀抽取的至多STRASSEN_ERROR_ROWS行, 代价为O(nk)每行
+ *
+ * @tparam T 浮点元素类型
+ * @param config 基准测试配置, 使用其中的block_size和num_threads
+ * @param m 结果矩阵行数
+ * @param n 结果矩阵列数
+ * @param k 公共维度
+ * @param pool 线程池, nullptr表示创建线程
+ */
+template <typename T>
+static void report_strassen_error(const BenchmarkConfig &config,
+                                  size_t m,
+                                  size_t n,
+                                  size_t k,
+                                  ThreadPool *pool)
+{
+  std::mt19937_64 generator(0x5eed);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  Matrix<T> a(m, k, 0, matrix_no_init);
+  Matrix<T> b(k, n, 0, matrix_no_init);
+  for (size_t i = 0; i < m; i++)
+  {
+    for (size_t j = 0; j < k; j++)
+    {
+      a(i, j) = static_cast<T>(uniform(generator));
+    }
+  }
+  for (size_t i = 0; i < k; i++)
+  {
+    for (size_t j = 0; j < n; j++)
+    {
+      b(i, j) = static_cast<T>(uniform(generator));
+    }
+  }
+  Matrix<T> strassen(m, n);
+  Matrix<T> packed(m, n);
+  parallel_strassen_matrix_mul(
+      a, b, strassen, config.block_size, config.num_threads, pool);
+  parallel_computing_optimized(a,
+                               b,
+                               packed,
+                               config.block_size,
+                               config.num_threads,
+                               select_kernel<T>(KernelType::Packed),
+                               pool);
+
+  const size_t samples = std::min(m, STRASSEN_ERROR_ROWS);
+  vector<double> reference(n);
+  double max_value = 0.0;
+  double strassen_error = 0.0;
+  double packed_error = 0.0;
+  for (size_t s = 0; s < samples; s++)
+  {
+    const size_t i = s * m / samples;
+    std::fill(reference.begin(), reference.end(), 0.0);
+    for (size_t p = 0; p < k; p++)
+    {
+      const double a_ip = static_cast<double>(a(i, p));
+      const T *b_row = b.row(p);
+      for (size_t j = 0; j < n; j++)
+      {
+        reference[j] += a_ip * static_cast<double>(b_row[j]);
+      }
+    }
+    for (size_t j = 0; j < n; j++)
+    {
+      const double expected = reference[j];
+      const double fast = static_cast<double>(strassen(i, j));
+      const double baseline = static_cast<double>(packed(i, j));
+      max_value = std::max(max_value, std::abs(expected));
+      strassen_error = std::max(strassen_error, std::abs(fast - expected));
+      packed_error = std::max(packed_error, std::abs(baseline - expected));
+    }
+  }
+  const double scale = max_value > 0.0 ? max_value : 1.0;
+  cout << "Strassen误差(均匀[-1, 1]输入, 对比double累加参考, 抽样 " << samples
+       << " 行): 最大绝对误差 " << scientific << setprecision(3)
+       << strassen_error << ", 相对误差 " << strassen_error / scale
+       << "; 打包内核相对误差 " << packed_error / scale << fixed << endl;
+}
+
+/**
+ * @brief 以指定元素类型运行基准测试
+ *
+ * 分配并初始化矩阵, 执行单线程和多线程测试并输出性能指标。
+ * 指定--kernels时改为依次运行各内核变体并输出对比表。
+ * 指定--autotune时先搜索最优参数, 写入调优缓存后以该参数运行测试。
+ * 指定--sweep时改为由run_sweep()扫描规模、线程数和块大小,
+ * 指定--batch时改为由run_batch()测试批量小矩阵乘法,
+ * 指定--sparse时改为由run_sparse()测试稀疏矩阵乘法,
+ * 指定--ooc时改为由run_out_of_core()测试基于映射文件的核外矩阵乘法,
+ * 指定--quant时改为由run_quantized()测试量化GEMM并与int32对比。
+ *
+ * @tparam T 元素类型
+ * @param base_config 基准测试配置
+ * @param report 运行结果, 供--format json|csv输出
+ * @return int 程序退出状态码, 0表示成功, 1表示结果验证失败
+ */
+template <typename T>
+static int run_benchmark(const BenchmarkConfig &base_config,
+                         BenchmarkReport &report)
+{
+  if (base_config.sweep) return run_sweep<T>(base_config, report);
+  if (base_config.batch > 0) return run_batch<T>(base_config, report);
+  if (base_config.sparse_density > 0.0)
+  {
+    return run_sparse<T>(base_config, report);
+  }
+  if (!base_config.ooc_dir.empty())
+  {
+    return run_out_of_core<T>(base_config, report);
+  }
+  if (base_config.quant != QuantType::None)
+  {
+    return run_quantized(base_config, report);
+  }
+
+  BenchmarkConfig config = base_config;
+  if (config.autotune)
+  {
+    TuningEntry best = autotune<T>(config);
+    config.kernel = best.kernel;
+    config.block_size = best.block_size;
+    config.num_threads = best.num_threads;
+    set_blocking_threads(config.num_threads);
+    if (save_tuning(config.tuning_cache, best))
+    {
+      cout << "调优结果已写入: " << config.tuning_cache << endl << endl;
+    }
+    else
+    {
+      cerr << "无法写入调优缓存: " << config.tuning_cache << endl;
+    }
+  }
 
   // 显示测试配置
   cout << "=== 测试配置 ===" << endl;
-  cout << "矩阵大小: " << config.matrix_size << "x" << config.matrix_size
+  const size_t m = config.shape_m;
+  const size_t n = config.shape_n;
+  const size_t k = config.shape_k;
+  if (m == n && n == k)
+  {
+    cout << "矩阵大小: " << n << "x" << n << endl;
+  }
+  else
+  {
+    cout << "问题形状: C(" << m << "x" << n << ") += A(" << m << "x" << k
+         << ") * B(" << k << "x" << n << ")" << endl;
+  }
+  cout << "元素类型: " << dtype_name(config.dtype) << endl;
+  if (config.kernel_suite.empty())
+  {
+    cout << "内核: " << kernel_name(config.kernel) << endl;
+  }
+  else
+  {
+    cout << "内核对比:";
+    for (const string &name : config.kernel_suite)
+    {
+      cout << " " << name;
+    }
+    cout << endl;
+  }
+  if (config.kernel == KernelType::Packed)
+  {
+    PackedBlocking blocking = calculate_packed_blocking(sizeof(T));
+    cout << "打包分块: MC=" << blocking.mc << " KC=" << blocking.kc
+         << " NC=" << blocking.nc << endl;
+  }
+  cout << "参数来源: "
+       << (config.autotune ? "自动调优"
+           : config.tuned  ? "调优缓存"
+                           : "默认/命令行")
        << endl;
   cout << "块大小: " << config.block_size << endl;
+  if (config.kernel == KernelType::Strassen)
+  {
+    cout << "Strassen截止规模: " << strassen_cutoff() << endl;
+    cout << "Strassen工作区: " << fixed << setprecision(2)
+         << static_cast<double>(
+                strassen_workspace_size(m, k, n, sizeof(T))
+                * sizeof(T))
+                / (1024.0 * 1024.0)
+         << " MB" << endl;
+  }
+  if (config.kernel == KernelType::Blocked)
+  {
+    CacheBlocking blocking =
+        calculate_cache_blocking(sizeof(T), config.block_size);
+    cout << "缓存分块: L1=" << blocking.l1_tile << " L2面板="
+         << blocking.l2_panel << " L3块=" << blocking.l3_block << endl;
+  }
   cout << "线程数: " << config.num_threads << endl;
+  cout << "线程派发: " << (config.use_pool ? "线程池" : "每次创建线程") << endl;
+  cout << "并行方式: " << parallel_mode_name(config.parallel) << endl;
+  cout << "线程绑核: " << affinity_mode_name(config.affinity) << endl;
+  cout << "页面类型: " << page_mode_name(config.pages) << endl;
+  if (config.parallel == ParallelMode::WorkStealing)
+  {
+    size_t tile = config.tile_size != 0
+                      ? config.tile_size
+                      : choose_tile_size(m, n, config.num_threads);
+    cout << "分块边长: " << tile << endl;
+  }
+  if (config.parallel == ParallelMode::Optimized
+      && config.kernel != KernelType::Strassen && config.kernel_suite.empty())
+  {
+    const ThreadGrid grid =
+        choose_thread_grid(m, n, k, config.num_threads, sizeof(T));
+    cout << "线程网格: " << grid.row_parts << "x" << grid.col_parts << "x"
+         << grid.k_parts << " (行段x列段xK段"
+         << (grid.k_parts > 1 ? ", split-K" : "") << ")" << endl;
+  }
   cout << "迭代次数: " << config.iterations << endl;
-  cout << "内存使用量约: " << fixed << setprecision(2)
-       << (3.0 * config.matrix_size * config.matrix_size * sizeof(int))
-          / (1024.0 * 1024.0)
-       << " MB" << endl;
-  cout << "==================" << endl << endl;
+  if (config.skip_single)
+  {
+    cout << "单线程测试: 跳过" << endl;
+  }
+  cout << "结果验证: " << verify_mode_name(config.verify);
+  if (config.verify == VerifyMode::Freivalds)
+  {
+    cout << " (" << config.verify_rounds << " 轮)";
+  }
+  cout << endl;
+  if (config.counters)
+  {
+    cout << "硬件计数器: 开启" << endl;
+  }
+  if (config.roofline)
+  {
+    cout << "屋顶线模型: 开启" << endl;
+  }
+  cout << "预热次数: " << config.warmup << endl;
+  if (config.ci_target > 0.0)
+  {
+    cout << "置信区间目标: " << config.ci_target * 100.0
+         << "% (最多迭代 " << config.max_iterations << " 次)" << endl;
+  }
 
   // 初始化矩阵
+  // A的行跨度按K计算, B和C的行跨度按N计算
+  const size_t ld = configured_leading_dimension(config, n);
+  Matrix<T> src1(m, k, configured_leading_dimension(config, k), matrix_no_init);
+  Matrix<T> src2(k, n, ld, matrix_no_init);
+  // 跳过单线程测试时不分配单线程结果, 大规模运行可节省一个矩阵的内存
+  Matrix<T> dst_single(config.skip_single ? 0 : m, n, ld, matrix_no_init);
+  Matrix<T> dst_multi(m, n, ld, matrix_no_init);
+  const double memory_mb = static_cast<double>(src1.size_bytes()
+                                               + src2.size_bytes()
+                                               + dst_multi.size_bytes())
+                           / (1024.0 * 1024.0);
+
+  report.config = config;
+  report.leading_dimension = src1.ld();
+  report.memory_mb = memory_mb;
+
+  if (src1.ld() == src2.ld())
+  {
+    cout << "行跨度: " << src1.ld() << endl;
+  }
+  else
+  {
+    cout << "行跨度: A=" << src1.ld() << " B/C=" << src2.ld() << endl;
+  }
+  cout << "内存使用量约: " << fixed << setprecision(2) << memory_mb << " MB"
+       << endl;
+  cout << "==================" << endl << endl;
+
   if (config.verbose)
   {
     cout << "初始化矩阵..." << endl;
   }
 
-  vector<vector<int>> src1(config.matrix_size,
-                           vector<int>(config.matrix_size));
-  vector<vector<int>> src2(config.matrix_size,
-                           vector<int>(config.matrix_size));
-  vector<vector<int>> dst_single(config.matrix_size,
-                                 vector<int>(config.matrix_size, 0));
-  vector<vector<int>> dst_multi(config.matrix_size,
-                                vector<int>(config.matrix_size, 0));
+  // 计数器必须在创建线程池之前打开, 工作线程才能继承计数
+  std::unique_ptr<PerfCounters> counters;
+  if (config.counters && config.kernel_suite.empty())
+  {
+    counters = std::make_unique<PerfCounters>();
+    if (!counters->available())
+    {
+      cout << "硬件计数器不可用: " << counters->error() << ", 只输出软件计时"
+           << endl << endl;
+      counters.reset();
+    }
+  }
+
+  std::unique_ptr<ThreadPool> pool;
+  if (config.use_pool)
+  {
+    pool = std::make_unique<ThreadPool>(config.num_threads);
+  }
 
-  // 初始化数据, 使用更好的模式来避免cache miss
-  for (size_t row = 0; row < config.matrix_size; row++)
+  // --parallel optimized按二维或split-K网格计算时, 先按同一网格放置页面,
+  // 使每个线程读写的A块、B块和C单元位于它所在的NUMA节点
+  if (config.parallel == ParallelMode::Optimized
+      && config.kernel != KernelType::Strassen && config.kernel_suite.empty())
   {
-    for (size_t col = 0; col < config.matrix_size; col++)
+    const ThreadGrid grid =
+        choose_thread_grid(m, n, k, config.num_threads, sizeof(T));
+    if (grid.col_parts > 1 || grid.k_parts > 1)
     {
-      src1[row][col] = static_cast<int>((row * 31 + col * 17) % 100);
-      src2[row][col] = static_cast<int>((row * 17 + col * 31) % 100);
+      grid_first_touch(src1, grid, GridOperand::Left, pool.get());
+      grid_first_touch(src2, grid, GridOperand::Right, pool.get());
+      grid_first_touch(dst_multi, grid, GridOperand::Result, pool.get());
     }
   }
 
+  // 初始化数据, 使用更好的模式来避免cache miss
+  // 按计算时的行划分并行写入, 使页面分配到负责该行的线程所在的NUMA节点;
+  // 已按网格放置的页面不会移动
+  parallel_first_touch<T>(src1,
+                          config.num_threads,
+                          pool.get(),
+                          [k](size_t row, T *a_row)
+                          {
+                            for (size_t col = 0; col < k; col++)
+                            {
+                              a_row[col] =
+                                  static_cast<T>((row * 31 + col * 17) % 100);
+                            }
+                          });
+  parallel_first_touch<T>(src2,
+                          config.num_threads,
+                          pool.get(),
+                          [n](size_t row, T *b_row)
+                          {
+                            for (size_t col = 0; col < n; col++)
+                            {
+                              b_row[col] =
+                                  static_cast<T>((row * 17 + col * 31) % 100);
+                            }
+                          });
+  parallel_first_touch(dst_single, config.num_threads, pool.get());
+  parallel_first_touch(dst_multi, config.num_threads, pool.get());
+
+  cout << "=== NUMA内存分布 ===" << endl;
+  print_numa_memory_map("src1", src1.data(), src1.size_bytes());
+  print_numa_memory_map("src2", src2.data(), src2.size_bytes());
+  print_numa_memory_map("dst_multi", dst_multi.data(), dst_multi.size_bytes());
+  cout << "==================" << endl << endl;
+
+  // 首次写入之后统计, 透明大页在缺页时才分配
+  report.huge_page_mb =
+      static_cast<double>(huge_page_bytes()) / (1024.0 * 1024.0);
+  report.huge_page_fallbacks = huge_page_fallbacks();
+  cout << "大页支撑: " << fixed << setprecision(2) << report.huge_page_mb
+       << " MB / 矩阵 " << memory_mb << " MB";
+  if (report.huge_page_fallbacks > 0)
+  {
+    cout << " (MAP_HUGETLB失败 " << report.huge_page_fallbacks
+         << " 次, 已回退到透明大页)";
+  }
+  cout << endl << endl;
+
+  // 机器参数在矩阵初始化之后测量, 多线程部分使用同一个线程池
+  if (config.roofline)
+  {
+    report.roofline = characterize_machine<T>(config.num_threads, pool.get());
+    print_roofline_model(report.roofline, config.dtype);
+  }
+
+  if (!config.kernel_suite.empty())
+  {
+    run_kernel_suite(config, src1, src2, pool.get(), report);
+    return 0;
+  }
+
+  GemmKernel<T> kernel = select_kernel<T>(config.kernel);
+  GemmTileKernel<T> tile_kernel = select_tile_kernel<T>(config.kernel);
+  WorkStealingStats steal_stats;
   Timer timer;
-  double total_single_time = 0.0;
-  double total_multi_time = 0.0;
+  KernelRun run;
+  run.kernel = kernel_name(config.kernel);
 
   cout << "开始性能测试..." << endl;
 
-  // 运行多次迭代取平均值
-  for (size_t iter = 0; iter < config.iterations; iter++)
+  // 先运行不计入统计的预热迭代, 再迭代到满足次数或置信区间要求
+  for (size_t iter = 0;
+       iter < config.warmup || need_more_iterations(config, run);
+       iter++)
   {
-    if (config.verbose && config.iterations > 1)
+    const bool warm = iter < config.warmup;
+    if (config.verbose)
     {
-      cout << "迭代 " << (iter + 1) << "/" << config.iterations << endl;
+      if (warm)
+      {
+        cout << "预热 " << (iter + 1) << "/" << config.warmup << endl;
+      }
+      else
+      {
+        cout << "迭代 " << (iter - config.warmup + 1) << endl;
+      }
     }
 
     // 重置结果矩阵
-    for (size_t i = 0; i < config.matrix_size; i++)
-    {
-      fill(dst_single[i].begin(), dst_single[i].end(), 0);
-      fill(dst_multi[i].begin(), dst_multi[i].end(), 0);
-    }
-
-    // 单线程测试
-    timer.start();
-    matrix_mul(src1, src2, dst_single, config.block_size, 0, src1.size());
-    timer.stop();
-    total_single_time += timer.get_seconds();
+    parallel_first_touch(dst_single, config.num_threads, pool.get());
+    parallel_first_touch(dst_multi, config.num_threads, pool.get());
 
-    if (config.verbose)
+    // 单线程测试, 计数器的启停放在计时区域之外
+    if (!config.skip_single)
     {
-      cout << "  单线程时间: " << fixed << setprecision(4)
-           << timer.get_seconds() << " 秒" << endl;
+      if (counters && !warm) counters->start();
+      timer.start();
+      kernel(src1, src2, dst_single, config.block_size, 0, src1.rows());
+      timer.stop();
+      if (counters && !warm) counters->stop(run.single_counters);
+      if (!warm) run.single_seconds.push_back(timer.get_seconds());
+
+      if (config.verbose)
+      {
+        cout << "  单线程时间: " << fixed << setprecision(4)
+             << timer.get_seconds() << " 秒" << endl;
+      }
     }
 
     // 多线程测试
+    ThreadTelemetry *telemetry = warm ? nullptr : &run.telemetry;
+    if (counters && !warm) counters->start();
     timer.start();
-    parallel_computing_optimized(
-        src1, src2, dst_multi, config.block_size, config.num_threads);
+    switch (config.parallel)
+    {
+      case ParallelMode::Simple:
+        parallel_computing_simple_multithread(src1,
+                                              src2,
+                                              dst_multi,
+                                              config.block_size,
+                                              kernel,
+                                              pool.get(),
+                                              telemetry);
+        break;
+      case ParallelMode::WorkStealing:
+        parallel_computing_work_stealing(src1,
+                                         src2,
+                                         dst_multi,
+                                         config.block_size,
+                                         config.num_threads,
+                                         config.tile_size,
+                                         tile_kernel,
+                                         pool.get(),
+                                         warm ? nullptr : &steal_stats,
+                                         telemetry);
+        break;
+      case ParallelMode::Optimized:
+        if (config.kernel == KernelType::Strassen)
+        {
+          parallel_strassen_matrix_mul(src1,
+                                       src2,
+                                       dst_multi,
+                                       config.block_size,
+                                       config.num_threads,
+                                       pool.get(),
+                                       telemetry);
+          break;
+        }
+        parallel_computing_partitioned(src1,
+                                       src2,
+                                       dst_multi,
+                                       config.block_size,
+                                       config.num_threads,
+                                       tile_kernel,
+                                       pool.get(),
+                                       telemetry);
+        break;
+    }
     timer.stop();
-    total_multi_time += timer.get_seconds();
+    if (counters && !warm) counters->stop(run.multi_counters);
+    if (!warm) run.multi_seconds.push_back(timer.get_seconds());
 
     if (config.verbose)
     {
@@ -109,47 +1010,248 @@ int main(int argc, char *argv[])
   }
 
   // 计算平均时间和性能指标
-  double avg_single_time = total_single_time / config.iterations;
-  double avg_multi_time = total_multi_time / config.iterations;
+  const size_t samples = run.multi_seconds.size();
+  double avg_single_time = 0.0;
+  double avg_multi_time = 0.0;
+  for (double seconds : run.single_seconds)
+  {
+    avg_single_time += seconds / static_cast<double>(samples);
+  }
+  for (double seconds : run.multi_seconds)
+  {
+    avg_multi_time += seconds / static_cast<double>(samples);
+  }
   double speedup = avg_single_time / avg_multi_time;
   double efficiency = speedup / config.num_threads;
 
-  // 计算性能指标 (GFLOPS)
-  double operations =
-      2.0 * config.matrix_size * config.matrix_size * config.matrix_size;
+  // 计算性能指标 (浮点类型为GFLOPS, 整数类型为GOPS)
+  double operations = 2.0 * static_cast<double>(m) * static_cast<double>(n)
+                      * static_cast<double>(k);
   double gflops_single = operations / (avg_single_time * 1e9);
   double gflops_multi = operations / (avg_multi_time * 1e9);
+  const char *unit = throughput_unit(config.dtype);
 
   // 显示性能结果
   cout << endl << "=== 性能结果 ===" << endl;
-  cout << fixed << setprecision(4);
-  cout << "单线程平均时间: " << avg_single_time << " 秒" << endl;
+  cout << fixed << setprecision(6);
+  if (!config.skip_single)
+  {
+    cout << "单线程平均时间: " << avg_single_time << " 秒" << endl;
+  }
   cout << "多线程平均时间: " << avg_multi_time << " 秒" << endl;
-  cout << "加速比: " << speedup << "x" << endl;
-  cout << "效率: " << (efficiency * 100) << "%" << endl;
-  cout << "单线程性能: " << gflops_single << " GFLOPS" << endl;
-  cout << "多线程性能: " << gflops_multi << " GFLOPS" << endl;
-  cout << "==================" << endl;
+  cout << setprecision(4);
+  if (!config.skip_single)
+  {
+    cout << "加速比: " << speedup << "x" << endl;
+    cout << "效率: " << (efficiency * 100) << "%" << endl;
+    cout << "单线程性能: " << gflops_single << " " << unit << endl;
+  }
+  cout << "多线程性能: " << gflops_multi << " " << unit << endl;
+  cout << "计入统计的迭代: " << samples << " 次 (预热 " << config.warmup
+       << " 次";
+  if (config.ci_target > 0.0)
+  {
+    cout << (run.converged ? ", 置信区间已收敛" : ", 达到最多迭代次数");
+  }
+  cout << ")" << endl;
+  if (!config.skip_single) print_sample_stats("单线程", run.single_seconds);
+  print_sample_stats("多线程", run.multi_seconds);
+  const SampleStats multi_stats = compute_sample_stats(run.multi_seconds);
+  cout << "多线程中位数性能: " << setprecision(4)
+       << operations / (multi_stats.median * 1e9) << " " << unit << endl;
+  if (run.multi_counters.samples > 0)
+  {
+    if (!config.skip_single)
+    {
+      print_counter_readings("单线程", run.single_counters, operations / 2.0);
+    }
+    print_counter_readings("多线程", run.multi_counters, operations / 2.0);
+  }
+  if (report.roofline.peak_multi > 0.0)
+  {
+    const double intensity = gemm_intensity(m, n, k, sizeof(T));
+    cout << "屋顶线(算术强度 " << setprecision(2) << intensity << " "
+         << intensity_unit(config.dtype) << "):" << endl;
+    if (!config.skip_single)
+    {
+      print_roofline_position(
+          report.roofline, intensity, "单线程", gflops_single, false, unit);
+    }
+    print_roofline_position(
+        report.roofline, intensity, "多线程", gflops_multi, true, unit);
+  }
+  print_thread_telemetry(run.telemetry,
+                         parallel_mode_name(config.parallel),
+                         compute_sample_stats(run.single_seconds).median,
+                         config.verbose);
+  if (config.use_pool)
+  {
+    cout << "派发延迟(每次创建线程): "
+         << measure_dispatch_latency(config.num_threads, nullptr, 100)
+         << " 微秒" << endl;
+    cout << "派发延迟(线程池): "
+         << measure_dispatch_latency(config.num_threads, pool.get(), 1000)
+         << " 微秒" << endl;
+  }
+  if (config.parallel == ParallelMode::WorkStealing)
+  {
+    cout << "工作窃取(每线程执行/窃取分块数):";
+    for (size_t t = 0; t < steal_stats.tiles_executed.size(); t++)
+    {
+      cout << " " << steal_stats.tiles_executed[t] << "/"
+           << steal_stats.tiles_stolen[t];
+    }
+    cout << endl;
+  }
+  if (config.kernel == KernelType::Strassen)
+  {
+    // Strassen的实际运算量低于2mnk, 上面的性能是按2mnk折算的等效值
+    cout << "(Strassen性能按2mnk折算为等效值)" << endl;
 
-  // 验证结果正确性(可选)
-  if (config.verbose)
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      report_strassen_error<T>(config, m, n, k, pool.get());
+    }
+    else
+    {
+      cout << "Strassen误差: 整数运算没有舍入误差, 结果与常规内核逐位相同"
+           << endl;
+    }
+  }
+
+  // 验证多线程结果, 不计入性能时间
+  const double tolerance =
+      config.tolerance > 0.0 ? config.tolerance : default_tolerance<T>(k);
+  VerifyResult verdict;
+  Timer verify_timer;
+  verify_timer.start();
+  if (config.verify == VerifyMode::Freivalds)
+  {
+    verdict = freivalds_verify(src1,
+                               src2,
+                               dst_multi,
+                               config.verify_rounds,
+                               tolerance,
+                               config.num_threads,
+                               pool.get());
+  }
+  else if (config.verify == VerifyMode::Exact && !config.skip_single)
+  {
+    verdict = compare_matrices(
+        dst_single, dst_multi, tolerance, config.num_threads, pool.get());
+  }
+  else if (config.verify == VerifyMode::Exact)
+  {
+    // 没有单线程结果时用另一种内核并行计算参考结果
+    Matrix<T> reference(m, n, ld, matrix_no_init);
+    parallel_first_touch(reference, config.num_threads, pool.get());
+    const KernelType reference_kernel = config.kernel == KernelType::Blocked
+                                            ? KernelType::Packed
+                                            : KernelType::Blocked;
+    parallel_computing_optimized(src1,
+                                 src2,
+                                 reference,
+                                 config.block_size,
+                                 config.num_threads,
+                                 select_kernel<T>(reference_kernel),
+                                 pool.get());
+    verdict = compare_matrices(
+        reference, dst_multi, tolerance, config.num_threads, pool.get());
+  }
+  verify_timer.stop();
+
+  if (config.verify != VerifyMode::None)
   {
-    cout << "验证结果正确性..." << endl;
-    bool correct = true;
-    for (size_t i = 0; i < min(size_t(10), config.matrix_size) && correct;
-         i++)
+    cout << "结果验证(" << verify_mode_name(config.verify) << "): "
+         << (verdict.passed ? "通过" : "失败");
+    if (!verdict.passed && config.verify == VerifyMode::Freivalds)
     {
-      for (size_t j = 0; j < min(size_t(10), config.matrix_size) && correct;
-           j++)
-      {
-        if (dst_single[i][j] != dst_multi[i][j])
-        {
-          correct = false;
-        }
-      }
+      cout << ", " << verdict.mismatches << " 行不一致, 首个出错行 "
+           << verdict.first_row;
     }
-    cout << "结果验证: " << (correct ? "通过" : "失败") << endl;
+    else if (!verdict.passed)
+    {
+      cout << ", " << verdict.mismatches << " 个元素不一致, 首个位于 ("
+           << verdict.first_row << ", " << verdict.first_col << ")";
+    }
+    if (std::is_floating_point_v<T>)
+    {
+      cout << ", 最大相对误差 " << scientific << setprecision(3)
+           << verdict.max_error << " (容差 " << tolerance << ")" << fixed;
+    }
+    cout << ", 耗时 " << setprecision(4) << verify_timer.get_seconds()
+         << " 秒" << endl;
   }
+  cout << "==================" << endl;
 
-  return 0;
+  run.verified = verdict.passed;
+  report.runs.push_back(run);
+  return verdict.passed ? 0 : 1;
+}
+
+/**
+ * @brief 矩阵乘法性能基准测试主程序
+ *
+ * 这是一个全面的矩阵乘法性能测试程序, 具有以下特性：
+ * - 自动检测系统硬件信息(CPU核心数、缓存大小等)
+ * - 自动计算最优的矩阵分块大小
+ * - 支持单线程和多线程性能对比
+ * - 支持f32、f64、i32、i64四种元素类型
+ * - 提供详细的性能指标分析(GFLOPS/GOPS、加速比、效率等)
+ * - 跨平台支持(Windows、Linux、macOS)
+ * - 跨架构支持(x86、x86_64、ARM、ARM64)
+ *
+ * @param argc 命令行参数个数
+ * @param argv 命令行参数数组
+ * @return int 程序退出状态码, 0表示成功
+ */
+int main(int argc, char *argv[])
+{
+  // 解析命令行参数
+  BenchmarkConfig config = parse_args(argc, argv);
+
+  // 结果写到标准输出时, 控制台文本不输出, 标准输出只包含JSON/CSV
+  const bool to_stdout =
+      config.format != OutputFormat::Text && config.output_file.empty();
+  std::streambuf *console = cout.rdbuf();
+  if (to_stdout) cout.rdbuf(nullptr);
+
+  // 显示系统信息
+  print_system_info();
+
+  BenchmarkReport report;
+  int status = 0;
+  switch (config.dtype)
+  {
+    case DataType::F32:
+      status = run_benchmark<float>(config, report);
+      break;
+    case DataType::F64:
+      status = run_benchmark<double>(config, report);
+      break;
+    case DataType::I64:
+      status = run_benchmark<int64_t>(config, report);
+      break;
+    case DataType::I32:
+      status = run_benchmark<int>(config, report);
+      break;
+  }
+
+  if (config.format == OutputFormat::Text) return status;
+  const SystemInfo system = collect_system_info();
+  if (to_stdout)
+  {
+    cout.rdbuf(console);
+    write_report(cout, report, system, config.format);
+    return status;
+  }
+  std::ofstream file(config.output_file);
+  write_report(file, report, system, config.format);
+  if (!file)
+  {
+    cerr << "无法写入结果文件: " << config.output_file << endl;
+    return 1;
+  }
+  cout << "结果已写入: " << config.output_file << endl;
+  return status;
 }
@@ -3,6 +3,8 @@
 
 #include <iostream>
 #include <vector>
+#include <deque>
+#include <mutex>
 #include <thread>
 #include <algorithm>
 #include <chrono>
@@ -10,7 +12,16 @@
 #include <cstdlib>
 #include <iomanip>
 #include <sstream>
+#include <fstream>
+#include <string>
 #include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <limits>
+#include <memory>
+
+#include "Matrix.h"
+#include "ThreadPool.h"
 
 #ifdef _WIN32
 #  include <windows.h>
@@ -18,7 +29,6 @@
 #elif defined(__linux__)
 #  include <unistd.h>
 #  include <sys/sysinfo.h>
-#  include <fstream>
 #elif defined(__APPLE__)
 #  include <unistd.h>
 #  include <sys/types.h>
@@ -27,6 +37,20 @@
 
 using namespace std;
 
+/**
+ * @brief 单个缓存的描述
+ *
+ * 对应Linux中/sys/devices/system/cpu/cpu0/cache/indexN的一项
+ */
+struct CacheLevel
+{
+  unsigned level = 0; ///< 缓存级别(1、2、3...)
+  string type; ///< 类型: Data、Instruction或Unified
+  size_t size = 0; ///< 容量(字节)
+  size_t line_size = 0; ///< 缓存行大小(字节)
+  size_t shared_cpus = 1; ///< 共享该缓存的逻辑CPU数
+};
+
 /**
  * @brief CPU缓存信息结构体
  *
@@ -38,6 +62,270 @@ struct CacheInfo
   size_t l2_cache_size = 262144; ///< L2缓存大小, 默认256KB
   size_t l3_cache_size = 8388608; ///< L3缓存大小, 默认8MB
   size_t line_size = 64; ///< 缓存行大小, 默认64字节
+  size_t l2_shared_cpus = 1; ///< 共享一个L2缓存的逻辑CPU数
+  size_t l3_shared_cpus = 1; ///< 共享一个L3缓存的逻辑CPU数
+  vector<CacheLevel> levels; ///< 检测到的全部缓存(包括指令缓存)
+};
+
+/**
+ * @brief 分块ikj内核的三级分块参数
+ *
+ * - l1_tile: i、k、j三个方向的L1分块边长(即-b指定的块大小)
+ * - l2_panel: C和B列面板的宽度, l1_tile行的C面板和B面板同时驻留L2
+ * - l3_block: 公共维度的分块深度, l3_block x l2_panel的B块驻留
+ *   当前线程分得的L3份额, 在A的所有行块之间复用
+ */
+struct CacheBlocking
+{
+  size_t l1_tile = 64; ///< L1分块边长
+  size_t l2_panel = 1024; ///< L2列面板宽度, l1_tile的倍数
+  size_t l3_block = 1024; ///< L3块深度, l1_tile的倍数
+};
+
+/**
+ * @brief 矩阵乘法内核类型
+ */
+enum class KernelType
+{
+  Blocked, ///< 分块ikj循环内核(matrix_mul)
+  Packed, ///< GotoBLAS风格的打包内核(packed_matrix_mul)
+  Strassen ///< Strassen-Winograd递归内核(strassen_matrix_mul)
+};
+
+/**
+ * @brief 矩阵元素类型
+ */
+enum class DataType
+{
+  F32, ///< float
+  F64, ///< double
+  I32, ///< int
+  I64 ///< int64_t
+};
+
+/**
+ * @brief 对所有支持的元素类型展开宏X
+ *
+ * 用于在实现文件中显式实例化模板
+ */
+#define MM_FOR_EACH_DTYPE(X) X(float) X(double) X(int) X(int64_t)
+
+/**
+ * @brief 多线程测试使用的并行方式
+ */
+enum class ParallelMode
+{
+  Optimized, ///< 按线程数静态划分行(parallel_computing_optimized)
+  Simple, ///< 每个行块一个线程(parallel_computing_simple_multithread)
+  WorkStealing ///< 二维分块+工作窃取(parallel_computing_work_stealing)
+};
+
+/**
+ * @brief 结果输出格式
+ */
+enum class OutputFormat
+{
+  Text, ///< 面向人阅读的控制台文本
+  Json, ///< 单个JSON对象
+  Csv ///< 带表头的CSV, 每个内核一行
+};
+
+/**
+ * @brief 多线程结果的验证方式
+ */
+enum class VerifyMode
+{
+  Freivalds, ///< O(n²)的随机化验证, 不需要单线程结果(freivalds_verify)
+  Exact, ///< 与参考结果并行逐元素比较(compare_matrices)
+  None ///< 不验证
+};
+
+/**
+ * @brief 稀疏矩阵非零元的分布结构
+ */
+enum class SparseStructure
+{
+  Uniform, ///< 每行的非零元个数和列位置都均匀随机
+  Banded, ///< 非零元集中在对角线附近宽度固定的带内
+  PowerLaw ///< 每行的非零元个数服从幂律分布, 少数行远比其他行稠密
+};
+
+/**
+ * @brief 量化GEMM的输入类型
+ */
+enum class QuantType
+{
+  None, ///< 不运行量化GEMM
+  U8S8, ///< uint8激活 x int8权重, int32累加
+  S16S16 ///< int16 x int16, int32累加
+};
+
+/**
+ * @brief 结果验证的结论
+ */
+struct VerifyResult
+{
+  bool passed = true; ///< 是否通过
+  size_t mismatches = 0; ///< 不一致的行数(Freivalds)或元素数(逐元素比较)
+  size_t first_row = 0; ///< 第一个不一致的行
+  size_t first_col = 0; ///< 第一个不一致的列, 仅逐元素比较有效
+  double max_error = 0.0; ///< 最大相对误差(浮点)或绝对误差(整数)
+};
+
+/**
+ * @brief 静态二维划分的线程网格
+ *
+ * 结果矩阵按行切为row_parts段、按列切为col_parts段, 公共维度K切为
+ * k_parts段, 每个线程负责一个单元; k_parts > 1时各K段的部分和需要归约
+ */
+struct ThreadGrid
+{
+  size_t row_parts = 1; ///< 行方向的段数
+  size_t col_parts = 1; ///< 列方向的段数
+  size_t k_parts = 1; ///< 公共维度K的段数, 大于1时为split-K
+  size_t rows_per_part = 0; ///< 每个行段的行数, 最后一段可能较短
+  size_t cols_per_part = 0; ///< 每个列段的列数, 缓存行的整数倍
+  size_t depth_per_part = 0; ///< 每个K段的深度, 最后一段可能较浅
+};
+
+/**
+ * @brief 矩阵在C = A * B中的角色, 决定按线程网格首次写入时的单元归属
+ */
+enum class GridOperand
+{
+  Left, ///< A: 按(行段, K段)划分
+  Right, ///< B: 按(K段, 列段)划分
+  Result ///< C: 按(行段, 列段)划分
+};
+
+/**
+ * @brief 工作窃取调度的统计信息
+ *
+ * 按线程记录执行和窃取的分块数, 多次调用时累加
+ */
+struct WorkStealingStats
+{
+  vector<size_t> tiles_executed; ///< 每个线程执行的分块数
+  vector<size_t> tiles_stolen; ///< 每个线程从其他线程窃取的分块数
+};
+
+/**
+ * @brief 单个工作线程的时间线
+ *
+ * 时刻相对并行调用开始计算; 在ThreadTelemetry中为多次调用的累加值
+ */
+struct WorkerRecord
+{
+  bool active = false; ///< 是否参与过计算
+  double start = 0.0; ///< 开始执行的时刻(秒)
+  double end = 0.0; ///< 结束执行的时刻(秒)
+  double busy = 0.0; ///< 执行内核的时间(秒)
+  size_t work_items = 0; ///< 处理的行数、分块数或子乘积数
+  int cpu = -1; ///< 最近一次运行所在的CPU, -1表示未知
+};
+
+/**
+ * @brief 并行驱动的线程级遥测
+ *
+ * 由TelemetryRecorder在每次并行调用结束时累加, 除workers外的字段
+ * 都是各次调用的和, 除以calls得到每次调用的平均值
+ */
+struct ThreadTelemetry
+{
+  size_t calls = 0; ///< 累计的并行调用次数
+  double wall = 0.0; ///< 调用开始到所有线程汇合的时间
+  double fork = 0.0; ///< 调用开始到最后一个线程开始执行的时间
+  double join = 0.0; ///< 最后一个线程结束到调用返回的时间
+  double max_busy = 0.0; ///< 最忙线程的忙碌时间
+  double min_busy = 0.0; ///< 最闲线程的忙碌时间
+  double avg_busy = 0.0; ///< 参与线程的平均忙碌时间
+  vector<WorkerRecord> workers; ///< 按线程编号累加的时间线
+};
+
+/**
+ * @brief 线程绑核策略
+ */
+enum class AffinityMode
+{
+  None, ///< 不绑核, 由操作系统调度
+  Compact, ///< 依次填满每个NUMA节点的CPU
+  Scatter ///< 在NUMA节点之间轮流分配CPU
+};
+
+/**
+ * @brief 矩阵和工作区的页面类型
+ *
+ * 只影响不小于HUGE_PAGE_SIZE的分配(page_alloc()), 较小的缓冲区始终使用普通页
+ */
+enum class PageMode
+{
+  Small, ///< 4 KiB普通页, 并对区域禁用透明大页(MADV_NOHUGEPAGE)
+  Transparent, ///< 透明大页, 按2 MiB对齐并设置MADV_HUGEPAGE
+  Huge ///< hugetlbfs预留的2 MiB大页(MAP_HUGETLB), 不可用时回退到透明大页
+};
+
+/**
+ * @brief NUMA拓扑信息
+ *
+ * 每个节点包含的逻辑CPU编号, 非Linux系统或读取失败时视为单节点
+ */
+struct NumaTopology
+{
+  vector<int> node_ids; ///< 在线节点编号
+  vector<vector<int>> node_cpus; ///< node_cpus[n]为node_ids[n]节点的CPU列表
+};
+
+/**
+ * @brief 系统信息
+ *
+ * print_system_info()输出的内容, 同时写入--format json|csv的结果
+ */
+struct SystemInfo
+{
+  string cpu_model; ///< CPU型号
+  size_t cpu_cores = 0; ///< CPU核心数
+  unsigned hardware_concurrency = 0; ///< 硬件并发数
+  string os; ///< 操作系统: Windows、Linux、macOS或unknown
+  string arch; ///< CPU架构: x86_64、x86、ARM64、ARM或unknown
+  long cplusplus = 0; ///< __cplusplus的值
+  CacheInfo cache; ///< 缓存信息
+  size_t optimal_block_size = 0; ///< 自动计算的最优块大小
+  vector<string> simd_supported; ///< CPU支持的SIMD指令集
+  string simd_active; ///< 打包GEMM选用的SIMD指令集
+  NumaTopology numa; ///< NUMA拓扑
+};
+
+/**
+ * @brief SIMD指令集类型
+ *
+ * 打包GEMM微内核在启动时按检测结果(或--isa参数)选择对应的实现
+ */
+enum class SimdIsa
+{
+  Auto, ///< 自动选择可用的最高指令集
+  Scalar, ///< 可移植的标量实现
+  AVX2, ///< x86 AVX2
+  AVX512, ///< x86 AVX-512F
+  NEON ///< ARM NEON (Advanced SIMD)
+};
+
+/// 打包GEMM微内核寄存器分块的行数
+constexpr size_t PACK_MR = 4;
+
+/// 打包GEMM微内核寄存器分块的列数, 每行正好一个缓存行(一个512位向量)
+template <typename T> constexpr size_t PACK_NR = MATRIX_ALIGNMENT / sizeof(T);
+
+/**
+ * @brief 打包GEMM的三级分块参数
+ *
+ * 对应GotoBLAS/BLIS的MC、KC、NC: A的MCxKC面板驻留L2,
+ * B的KCxNR微面板驻留L1, B的KCxNC面板驻留L3
+ */
+struct PackedBlocking
+{
+  size_t mc = 96; ///< A面板行数, MR的倍数
+  size_t kc = 256; ///< 公共维度分块大小
+  size_t nc = 2048; ///< B面板列数, NR的倍数
 };
 
 /**
@@ -48,156 +336,1878 @@ struct CacheInfo
 struct BenchmarkConfig
 {
   size_t matrix_size = 1024; ///< 矩阵大小, 默认1024x1024
+  size_t batch = 0; ///< 批量小矩阵乘法的矩阵个数, 0表示单个大矩阵
+  double sparse_density = 0.0; ///< 稀疏矩阵A的密度(0, 1], 0表示稠密测试
+  SparseStructure sparse_structure = SparseStructure::Uniform; ///< 非零元分布
+  size_t bsr_block = 4; ///< BSR格式的块边长
+  string ooc_dir; ///< 核外模式的矩阵文件目录, 空表示矩阵都在内存中
+  size_t ooc_memory_mb = 256; ///< 核外模式内存工作集的上限(MB)
+  QuantType quant = QuantType::None; ///< 量化GEMM的输入类型
+  size_t shape_m = 0; ///< A和C的行数(M), 0表示使用matrix_size
+  size_t shape_n = 0; ///< B和C的列数(N), 0表示使用matrix_size
+  size_t shape_k = 0; ///< 公共维度(K), 0表示使用matrix_size
   size_t block_size = 0; ///< 块大小, 0表示自动计算
   size_t num_threads = 0; ///< 线程数, 0表示自动检测
   bool verbose = false; ///< 是否详细输出
-  size_t iterations = 1; ///< 迭代次数, 默认1次
+  size_t iterations = 1; ///< 计入统计的迭代次数, 指定ci_target时为最少次数
+  size_t warmup = 1; ///< 不计入统计的预热迭代次数
+  double ci_target = 0.0; ///< 置信区间相对宽度达到该值时停止, 0表示不提前停止
+  size_t max_iterations = 100; ///< 指定ci_target时的最多迭代次数
+  long ld_padding = -1; ///< 行跨度填充元素数, -1表示自动选择
+  KernelType kernel = KernelType::Blocked; ///< 矩阵乘法内核
+  SimdIsa isa = SimdIsa::Auto; ///< 微内核使用的SIMD指令集
+  DataType dtype = DataType::I32; ///< 矩阵元素类型
+  bool use_pool = false; ///< 多线程测试是否使用持久线程池
+  ParallelMode parallel = ParallelMode::Optimized; ///< 多线程测试的并行方式
+  size_t tile_size = 0; ///< 工作窃取的分块边长, 0表示自动计算
+  AffinityMode affinity = AffinityMode::None; ///< 线程绑核策略
+  PageMode pages = PageMode::Transparent; ///< 矩阵和工作区的页面类型
+  size_t strassen_cutoff = 512; ///< Strassen递归回退到分块内核的阈值
+  bool autotune = false; ///< 是否先运行自动调优
+  string tuning_cache; ///< 调优缓存文件路径, 空表示default_tuning_cache_path()
+  bool tuned = false; ///< 内核、块大小和线程数是否来自调优缓存
+  vector<string> kernel_suite; ///< --kernels指定的内核变体, 为空表示不比较
+  OutputFormat format = OutputFormat::Text; ///< 结果输出格式
+  string output_file; ///< 结果文件路径, 空表示写到标准输出
+  bool counters = false; ///< 是否用硬件性能计数器测量计时区域(仅Linux)
+  VerifyMode verify = VerifyMode::Freivalds; ///< 多线程结果的验证方式
+  size_t verify_rounds = 3; ///< Freivalds验证的随机向量个数
+  double tolerance = 0.0; ///< 浮点验证的相对容差, 0表示default_tolerance()
+  bool skip_single = false; ///< 是否跳过单线程测试
+  bool roofline = false; ///< 是否先测量峰值算力和带宽, 按屋顶线模型评估结果
+  bool sweep = false; ///< 是否在同一进程内扫描规模、线程数和块大小
+  vector<size_t> sweep_sizes; ///< 扫描的矩阵规模, 为空表示只用matrix_size
+  vector<size_t> sweep_threads; ///< 扫描的线程数, 为空表示1、2、4...num_threads
+  vector<size_t> sweep_blocks; ///< 扫描的块大小, 为空表示只用block_size
 };
 
 /**
- * @brief 高精度性能计时器类
+ * @brief 调优缓存中的一条记录
  *
- * 提供微秒级精度的性能计时功能, 用于准确测量矩阵乘法的执行时间
+ * 以CPU型号、指令集、元素类型和规模档位为键, 保存最优的内核、块大小和线程数
  */
-class Timer
+struct TuningEntry
 {
-private:
-  std::chrono::high_resolution_clock::time_point start_time; ///< 开始时间点
-  std::chrono::high_resolution_clock::time_point end_time; ///< 结束时间点
+  string cpu_model; ///< CPU型号, 见cpu_model_name()
+  string isa; ///< SIMD指令集名称
+  string dtype; ///< 元素类型名称
+  size_t size_class = 0; ///< 规模档位, 见size_class()
+  KernelType kernel = KernelType::Blocked; ///< 最优内核
+  size_t block_size = 0; ///< 最优块大小
+  size_t num_threads = 0; ///< 最优线程数
+  double throughput = 0.0; ///< 调优时测得的性能(GFLOPS/GOPS)
+};
 
-public:
-  /**
-   * @brief 开始计时
-   *
-   * 记录当前高精度时间点作为计时起始点
-   */
-  void start();
+/**
+ * @brief 硬件性能计数器读数
+ *
+ * 各字段是samples个计时区域的累计值, 已按计数器多路复用的
+ * 运行时间比例换算; 当前CPU或内核不支持的事件为NaN
+ */
+struct CounterReadings
+{
+  size_t samples = 0; ///< 累计的计时区域数, 0表示没有读数
+  double cycles = NAN; ///< CPU周期数
+  double instructions = NAN; ///< 退休指令数
+  double l1d_misses = NAN; ///< L1数据缓存读缺失数
+  double llc_misses = NAN; ///< 末级缓存缺失数
+  double dtlb_misses = NAN; ///< 数据TLB读缺失数
+};
 
-  /**
-   * @brief 停止计时
-   *
-   * 记录当前高精度时间点作为计时结束点
-   */
-  void stop();
+/**
+ * @brief 一个内核的测量结果
+ */
+struct KernelRun
+{
+  string kernel; ///< 内核或内核变体名称
+  double operations = 0.0; ///< 每次迭代的运算量, 0表示按2mnk计算
+  double bytes = 0.0; ///< 每次迭代的有效访存量(字节), 0表示不统计带宽
+  vector<double> single_seconds; ///< 每次迭代的单线程时间(秒)
+  vector<double> multi_seconds; ///< 每次迭代的多线程时间(秒)
+  bool verified = false; ///< 结果是否与参考结果一致
+  bool converged = false; ///< 是否因置信区间足够窄而提前停止
+  CounterReadings single_counters; ///< 单线程计时区域的硬件计数器
+  CounterReadings multi_counters; ///< 多线程计时区域的硬件计数器
+  ThreadTelemetry telemetry; ///< 多线程计时区域的线程级遥测
+};
 
-  /**
-   * @brief 获取经过的时间（秒）
-   *
-   * @return 从开始到结束经过的时间, 单位为秒
-   */
-  double get_seconds() const;
+/**
+ * @brief 一组计时样本的统计量
+ *
+ * 所有字段都在全部样本上计算, 离群值只在outliers中标记
+ */
+struct SampleStats
+{
+  size_t count = 0; ///< 样本数
+  double min = 0.0; ///< 最小值
+  double median = 0.0; ///< 中位数
+  double p90 = 0.0; ///< 90%分位数
+  double max = 0.0; ///< 最大值
+  double mean = 0.0; ///< 均值
+  double stddev = 0.0; ///< 样本标准差
+  double ci_low = 0.0; ///< 中位数95%置信区间下界(bootstrap)
+  double ci_high = 0.0; ///< 中位数95%置信区间上界(bootstrap)
+  vector<size_t> outliers; ///< 按MAD判定的离群样本下标
+};
 
-  /**
-   * @brief 获取经过的时间（微秒）
-   *
-   * @return 从开始到结束经过的时间, 单位为微秒
-   */
-  long long get_microseconds() const;
+/**
+ * @brief STREAM风格的一项带宽测试结果
+ */
+struct StreamResult
+{
+  const char *name = ""; ///< 测试名称: copy、scale、add或triad
+  double single_bandwidth = 0.0; ///< 单线程带宽(GB/s)
+  double multi_bandwidth = 0.0; ///< 全部线程的带宽(GB/s)
 };
 
-// 函数声明
+/**
+ * @brief 一个工作集大小上的访存延迟和读带宽(单线程)
+ */
+struct MemoryLevelProbe
+{
+  string name; ///< 层级名称: L1、L2、L3或DRAM
+  size_t bytes = 0; ///< 工作集大小(字节)
+  double latency_ns = 0.0; ///< 随机指针追逐的平均延迟(纳秒)
+  double bandwidth = 0.0; ///< 顺序读带宽(GB/s)
+};
 
 /**
- * @brief 获取CPU缓存信息
+ * @brief 一个指令集的单线程峰值算力
+ */
+struct IsaPeak
+{
+  SimdIsa isa = SimdIsa::Scalar; ///< 指令集
+  double throughput = 0.0; ///< 峰值算力(GFLOPS/GOPS)
+};
+
+/**
+ * @brief 屋顶线模型的机器参数, 由characterize_machine()测量
  *
- * 跨平台获取CPU的L1、L2、L3缓存大小和缓存行大小信息
- * 支持Windows、Linux和macOS系统
+ * 算力上限取当前指令集的峰值, 带宽上限取STREAM triad带宽;
+ * peak_multi为0表示没有测量
+ */
+struct RooflineModel
+{
+  SimdIsa isa = SimdIsa::Scalar; ///< 测量峰值时使用的指令集
+  size_t num_threads = 0; ///< 多线程测量使用的线程数
+  vector<IsaPeak> isa_peaks; ///< 各指令集的单线程峰值
+  double peak_single = 0.0; ///< 单线程峰值算力(GFLOPS/GOPS)
+  double peak_multi = 0.0; ///< 全部线程的峰值算力(GFLOPS/GOPS)
+  vector<StreamResult> stream; ///< STREAM四项测试结果
+  double bandwidth_single = 0.0; ///< 单线程内存带宽(GB/s)
+  double bandwidth_multi = 0.0; ///< 全部线程的内存带宽(GB/s)
+  vector<MemoryLevelProbe> levels; ///< 各级缓存和内存的延迟与带宽
+};
+
+/**
+ * @brief 参数扫描中一个规模、块大小和线程数组合的测量结果
  *
- * @return CacheInfo 包含缓存信息的结构体
+ * 强扩展固定规模增加线程数, 加速比和效率相对同一规模和块大小下
+ * 最少线程数的测量; 弱扩展按线程数增大规模使每个线程的运算量不变,
+ * 效率为每线程性能之比
  */
-CacheInfo get_cache_info();
+struct SweepPoint
+{
+  bool weak = false; ///< 是否为弱扩展测量
+  size_t matrix_size = 0; ///< 矩阵规模
+  size_t block_size = 0; ///< 块大小
+  size_t num_threads = 0; ///< 线程数
+  vector<double> seconds; ///< 每次迭代的时间(秒)
+  double median = 0.0; ///< 时间中位数(秒)
+  double throughput = 0.0; ///< 按中位数计算的性能(GFLOPS/GOPS)
+  double speedup = 0.0; ///< 相对同组最少线程数的性能之比
+  double efficiency = 0.0; ///< 扩展效率(0~1)
+  bool verified = false; ///< 结果是否通过验证
+};
 
 /**
- * @brief 计算最优块大小
+ * @brief 核外模式每次迭代的平均时间分解和读写量
  *
- * 基于CPU缓存信息自动计算矩阵乘法的最优块大小
- * 考虑L1缓存大小、缓存行大小等因素
+ * 计算和等待预取在计算线程上串行发生; 预取线程读取A和B的时间
+ * 与计算重叠, 只有未被掩盖的部分计入stall_seconds
+ */
+struct OutOfCoreStats
+{
+  size_t tile = 0; ///< 内存中的分块边长, 0表示没有运行核外模式
+  double compute_seconds = 0.0; ///< 内存中分块乘法的时间(秒)
+  double stall_seconds = 0.0; ///< 等待A和B的分块预取完成的时间(秒)
+  double write_seconds = 0.0; ///< 把C的分块写回映射区的时间(秒)
+  double sync_seconds = 0.0; ///< msync把C刷到文件的时间(秒)
+  double load_seconds = 0.0; ///< 预取线程读取A和B的分块的时间(秒)
+  double bytes_read = 0.0; ///< 从A和B的文件读取的字节数
+  double bytes_written = 0.0; ///< 写入C的文件的字节数
+};
+
+/**
+ * @brief 一次运行的完整结果, 由write_report()输出为JSON或CSV
+ */
+struct BenchmarkReport
+{
+  BenchmarkConfig config; ///< 实际使用的配置(包含调优结果)
+  size_t leading_dimension = 0; ///< 矩阵行跨度
+  double memory_mb = 0.0; ///< 三个矩阵的内存占用(MB)
+  size_t nnz = 0; ///< 稀疏矩阵A的非零元个数, 稠密测试为0
+  double huge_page_mb = 0.0; ///< 初始化后进程中由大页支撑的内存(MB)
+  size_t huge_page_fallbacks = 0; ///< MAP_HUGETLB失败后回退的分配次数
+  vector<KernelRun> runs; ///< 各内核的测量结果
+  RooflineModel roofline; ///< 屋顶线模型参数, 未指定--roofline时为空
+  vector<SweepPoint> sweep; ///< 参数扫描的结果, 未指定--sweep时为空
+  OutOfCoreStats out_of_core; ///< 核外模式的时间分解, 未指定--ooc时为空
+};
+
+/**
+ * @brief 矩阵乘法内核函数类型
  *
- * @return size_t 计算得出的最优块大小
+ * 计算dst的[start, end)行: dst += src1 * src2
+ *
+ * @tparam T 元素类型
  */
-size_t calculate_optimal_block_size();
+template <typename T>
+using GemmKernel = void (*)(const Matrix<T> &src1,
+                            const Matrix<T> &src2,
+                            Matrix<T> &dst,
+                            size_t blockSize,
+                            size_t start,
+                            size_t end);
 
 /**
- * @brief 获取CPU核心数
+ * @brief 矩阵乘法子块内核函数类型
  *
- * 跨平台获取系统的CPU核心数, 支持Windows、Linux和macOS
+ * 计算任意子块: c += a * b, 用于二维分块调度
  *
- * @return size_t CPU核心数
+ * @tparam T 元素类型
  */
-size_t get_cpu_cores();
+template <typename T>
+using GemmTileKernel = void (*)(MatrixView<const T> a,
+                                MatrixView<const T> b,
+                                MatrixView<T> c,
+                                size_t blockSize);
 
 /**
- * @brief 打印系统信息
+ * @brief 已注册的矩阵乘法内核变体
  *
- * 显示CPU核心数、操作系统、架构、缓存信息等系统详细信息
+ * 用于--kernels在同一组输入上比较不同的循环顺序和访存模式
+ *
+ * @tparam T 元素类型
  */
-void print_system_info();
+template <typename T> struct KernelVariant
+{
+  const char *name; ///< --kernels中使用的名称
+  const char *description; ///< 访存模式说明
+  bool transposed_b; ///< 右操作数是否需要预先转置为B^T
+  GemmKernel<T> kernel; ///< 按行范围计算的内核函数
+};
 
 /**
- * @brief 解析命令行参数
+ * @brief 连续存储的一批小矩阵乘法C[p] += A[p] * B[p]
  *
- * 解析程序的命令行参数, 设置基准测试的各项配置
- * 支持矩阵大小、块大小、线程数、迭代次数等参数设置
+ * 每个矩阵按行紧密存储(行跨度等于列数), 相邻矩阵之间的间距
+ * 向上取整到缓存行, 每个矩阵的起始地址都按缓存行对齐
  *
- * @param argc 命令行参数个数
- * @param argv 命令行参数数组
- * @return BenchmarkConfig 解析后的配置结构体
+ * @tparam T 元素类型
  */
-BenchmarkConfig parse_args(int argc, char *argv[]);
+template <typename T> struct SmallBatch
+{
+  const T *a = nullptr; ///< 第0个A矩阵(M x K)
+  const T *b = nullptr; ///< 第0个B矩阵(K x N)
+  T *c = nullptr; ///< 第0个C矩阵(M x N)
+  size_t stride_a = 0; ///< 相邻A矩阵的间距(元素个数)
+  size_t stride_b = 0; ///< 相邻B矩阵的间距(元素个数)
+  size_t stride_c = 0; ///< 相邻C矩阵的间距(元素个数)
+  size_t m = 0; ///< A和C的行数
+  size_t n = 0; ///< B和C的列数
+  size_t k = 0; ///< 公共维度
+};
 
 /**
- * @brief 矩阵乘法核心函数
+ * @brief 批量小矩阵乘法内核函数类型
  *
- * 使用分块算法执行矩阵乘法运算, 支持指定行范围的并行计算
- * 采用ikj循环顺序优化缓存访问模式
+ * 依次计算第[start, end)个矩阵: C[p] += A[p] * B[p]
  *
- * @param src1 源矩阵1
- * @param src2 源矩阵2
- * @param dst 目标结果矩阵
- * @param blockSize 分块大小
- * @param start 起始行索引
- * @param end 结束行索引
+ * @tparam T 元素类型
  */
-void matrix_mul(vector<vector<int>> &src1,
-                vector<vector<int>> &src2,
-                vector<vector<int>> &dst,
-                size_t blockSize,
-                size_t start,
-                size_t end);
+template <typename T>
+using BatchKernel = void (*)(const SmallBatch<T> &batch,
+                             size_t start,
+                             size_t end);
 
 /**
- * @brief 简单多线程矩阵乘法
+ * @brief 压缩稀疏行(CSR)格式的稀疏矩阵
  *
- * 基于块大小创建线程的简单多线程实现
- * 每个块创建一个线程, 适用于小规模矩阵
+ * 列号使用32位整数, 每个非零元的索引开销为4字节
  *
- * @param matrix1 输入矩阵1
- * @param matrix2 输入矩阵2
- * @param result 结果矩阵
- * @param block_size 块大小
+ * @tparam T 元素类型
  */
-void parallel_computing_simple_multithread(
-    std::vector<std::vector<int>> &matrix1,
-    std::vector<std::vector<int>> &matrix2,
-    std::vector<std::vector<int>> &result,
-    size_t block_size);
+template <typename T> struct CsrMatrix
+{
+  size_t rows = 0; ///< 行数
+  size_t cols = 0; ///< 列数
+  vector<size_t> row_ptr; ///< 第i行的非零元位于[row_ptr[i], row_ptr[i + 1])
+  vector<uint32_t> col_idx; ///< 非零元的列号, 每行内升序
+  vector<T> values; ///< 非零元的值
+
+  /// 非零元个数
+  size_t nnz() const { return values.size(); }
+};
 
 /**
- * @brief 优化的多线程矩阵乘法
+ * @brief 分块压缩稀疏行(BSR)格式的稀疏矩阵
  *
- * 可控制线程数量的优化多线程实现
- * 将矩阵行均匀分配给指定数量的线程, 避免线程过多的开销
+ * 矩阵切分为block x block的稠密块, 只保存至少含一个非零元的块;
+ * 每个块只需一个列号, 块内按行主序连续存放, 块内的零也显式保存。
+ * 行数或列数不是block的整数倍时, 最后一个块行/块列超出矩阵的部分为0
  *
- * @param matrix1 输入矩阵1
- * @param matrix2 输入矩阵2
- * @param result 结果矩阵
- * @param block_size 块大小
- * @param num_threads 线程数量
+ * @tparam T 元素类型
  */
-void parallel_computing_optimized(std::vector<std::vector<int>> &matrix1,
-                                  std::vector<std::vector<int>> &matrix2,
-                                  std::vector<std::vector<int>> &result,
-                                  size_t block_size,
-                                  size_t num_threads);
+template <typename T> struct BsrMatrix
+{
+  size_t rows = 0; ///< 行数
+  size_t cols = 0; ///< 列数
+  size_t block = 0; ///< 块边长
+  vector<size_t> row_ptr; ///< 第I个块行的块位于[row_ptr[I], row_ptr[I + 1])
+  vector<uint32_t> col_idx; ///< 块的块列号, 每个块行内升序
+  vector<T> values; ///< 块的值, 每块block * block个元素
+
+  /// 块行数
+  size_t block_rows() const { return row_ptr.size() - 1; }
+
+  /// 保存的块数
+  size_t blocks() const { return col_idx.size(); }
+};
+
+/**
+ * @brief 高精度性能计时器类
+ *
+ * 基于steady_clock提供纳秒级精度的性能计时功能, 用于准确测量矩阵乘法的执行时间
+ */
+class Timer
+{
+private:
+  std::chrono::steady_clock::time_point start_time; ///< 开始时间点
+  std::chrono::steady_clock::time_point end_time; ///< 结束时间点
+
+public:
+  /**
+   * @brief 开始计时
+   *
+   * 记录当前高精度时间点作为计时起始点
+   */
+  void start();
+
+  /**
+   * @brief 停止计时
+   *
+   * 记录当前高精度时间点作为计时结束点
+   */
+  void stop();
+
+  /**
+   * @brief 获取经过的时间（秒）
+   *
+   * @return 从开始到结束经过的时间, 单位为秒
+   */
+  double get_seconds() const;
+
+  /**
+   * @brief 获取经过的时间（纳秒）
+   *
+   * @return 从开始到结束经过的时间, 单位为纳秒
+   */
+  long long get_nanoseconds() const;
+
+  /**
+   * @brief 获取经过的时间（微秒）
+   *
+   * @return 从开始到结束经过的时间, 单位为微秒
+   */
+  long long get_microseconds() const;
+};
+
+/**
+ * @brief 基于perf_event_open的硬件性能计数器组
+ *
+ * 以CPU周期为组长打开一组计数器, 组内事件同时调度, 比值(IPC等)可以直接计算。
+ * 计数器设置inherit, 之后创建的线程会继承计数, 读数包含所有工作线程;
+ * 因此必须在创建线程池之前构造。非Linux系统或容器禁止perf_event_open时
+ * available()返回false, 调用方只输出软件计时。
+ */
+class PerfCounters
+{
+private:
+  static constexpr size_t EVENT_COUNT = 5; ///< 事件数
+  int fds[EVENT_COUNT]; ///< 各事件的文件描述符, -1表示不可用
+  uint64_t start_values[EVENT_COUNT][3]; ///< start()时的计数、启用和运行时间
+  string error_message; ///< 组长打开失败的原因
+
+public:
+  /**
+   * @brief 打开计数器组, 初始为停止状态
+   */
+  PerfCounters();
+
+  /**
+   * @brief 关闭所有计数器
+   */
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  /**
+   * @brief 计数器是否可用
+   *
+   * @return bool 至少CPU周期计数器打开成功时返回true
+   */
+  bool available() const;
+
+  /**
+   * @brief 获取不可用的原因
+   *
+   * @return const string& 错误描述, 可用时为空
+   */
+  const string &error() const;
+
+  /**
+   * @brief 清零并启动计数器组
+   */
+  void start();
+
+  /**
+   * @brief 停止计数器组并把读数累加到readings
+   *
+   * @param readings 累加目标, samples加1
+   */
+  void stop(CounterReadings &readings);
+};
+
+/**
+ * @brief 记录一次并行调用中各工作线程的时间线
+ *
+ * 在并行驱动入口构造, 工作线程依次调用begin()、若干次work()和finish(),
+ * 所有线程汇合后调用commit()把本次调用累加到ThreadTelemetry。
+ * 每个线程只写自己的记录, 无需同步; telemetry为nullptr时所有方法直接返回。
+ */
+class TelemetryRecorder
+{
+private:
+  ThreadTelemetry *output; ///< 累加目标, 可以为nullptr
+  std::chrono::steady_clock::time_point origin; ///< 并行调用开始的时间点
+  vector<WorkerRecord> records; ///< 本次调用的每线程记录
+
+public:
+  /**
+   * @brief 记录调用开始时间
+   *
+   * @param telemetry 累加目标, nullptr表示不记录
+   * @param num_threads 最多参与的线程数
+   */
+  TelemetryRecorder(ThreadTelemetry *telemetry, size_t num_threads);
+
+  /**
+   * @brief 获取相对调用开始的时间
+   *
+   * @return double 秒
+   */
+  double now() const;
+
+  /**
+   * @brief 工作线程开始执行, 记录开始时刻和所在CPU
+   *
+   * @param tid 线程编号
+   */
+  void begin(size_t tid);
+
+  /**
+   * @brief 累加一段内核执行时间
+   *
+   * @param tid 线程编号
+   * @param since 内核开始时now()的返回值
+   * @param items 本次处理的工作量
+   */
+  void work(size_t tid, double since, size_t items);
+
+  /**
+   * @brief 工作线程结束执行, 记录结束时刻
+   *
+   * @param tid 线程编号
+   */
+  void finish(size_t tid);
+
+  /**
+   * @brief 所有线程汇合后计算本次调用的汇总值并累加
+   */
+  void commit();
+};
+
+// 函数声明
+
+/**
+ * @brief 获取CPU缓存信息
+ *
+ * 跨平台获取CPU的L1、L2、L3缓存大小和缓存行大小信息
+ * 支持Windows、Linux和macOS系统
+ *
+ * @return const CacheInfo& 包含缓存信息的结构体, 首次调用时检测并缓存
+ */
+const CacheInfo &get_cache_info();
+
+/**
+ * @brief 设置共享缓存的参与线程数
+ *
+ * 分块参数按min(线程数, 共享该缓存的CPU数)平分L2/L3容量, 应在计算开始前调用
+ *
+ * @param num_threads 多线程测试的线程数
+ */
+void set_blocking_threads(size_t num_threads);
+
+/**
+ * @brief 计算当前线程可用的缓存份额
+ *
+ * @param cache_size 缓存容量(字节)
+ * @param shared_cpus 共享该缓存的逻辑CPU数
+ * @return size_t 平分后的容量(字节)
+ */
+size_t cache_share(size_t cache_size, size_t shared_cpus);
+
+/**
+ * @brief 计算分块ikj内核的三级分块参数
+ *
+ * @param element_size 元素字节数
+ * @param l1_tile L1分块边长
+ * @return CacheBlocking 分块参数
+ */
+CacheBlocking calculate_cache_blocking(size_t element_size, size_t l1_tile);
+
+/**
+ * @brief 计算最优块大小
+ *
+ * 基于CPU缓存信息自动计算矩阵乘法的最优块大小
+ * 考虑L1缓存大小、缓存行大小和元素大小等因素
+ *
+ * @param element_size 元素字节数, 默认为int
+ * @return size_t 计算得出的最优块大小
+ */
+size_t calculate_optimal_block_size(size_t element_size = sizeof(int));
+
+/**
+ * @brief 计算打包GEMM的分块参数
+ *
+ * 基于L1/L2/L3缓存大小和元素大小推导KC、MC、NC
+ *
+ * @param element_size 元素字节数
+ * @return PackedBlocking 三级分块参数
+ */
+PackedBlocking calculate_packed_blocking(size_t element_size);
+
+/**
+ * @brief 获取元素类型的字节数
+ *
+ * @param dtype 元素类型
+ * @return size_t 字节数
+ */
+size_t dtype_size(DataType dtype);
+
+/**
+ * @brief 获取元素类型的名称
+ *
+ * @param dtype 元素类型
+ * @return const char* 与--dtype参数一致的名称
+ */
+const char *dtype_name(DataType dtype);
+
+/**
+ * @brief 获取吞吐量单位
+ *
+ * 浮点类型为GFLOPS, 整数类型为GOPS
+ *
+ * @param dtype 元素类型
+ * @return const char* 单位名称
+ */
+const char *throughput_unit(DataType dtype);
+
+/**
+ * @brief 打包GEMM微内核函数类型
+ *
+ * 计算一个MRxNR的C块: C[0:mr, 0:nr] += A_panel * B_panel
+ *
+ * @tparam T 元素类型
+ */
+template <typename T>
+using MicroKernel = void (*)(size_t depth,
+                             const T *a_panel,
+                             const T *b_panel,
+                             T *c,
+                             size_t ldc,
+                             size_t mr,
+                             size_t nr);
+
+/**
+ * @brief 峰值算力探测函数类型
+ *
+ * 只在寄存器中做iterations轮独立的乘加, 用于估计指令集的峰值算力
+ *
+ * @tparam T 元素类型
+ * @param iterations 迭代次数
+ * @param a 乘数
+ * @param b 累加器初值, PACK_NR<T>个元素, 按MATRIX_ALIGNMENT对齐
+ * @param sink 结果写回位置, PACK_NR<T>个元素, 按MATRIX_ALIGNMENT对齐
+ * @return size_t 执行的乘加次数(每次乘加计为2次运算)
+ */
+template <typename T>
+using PeakProbe = size_t (*)(size_t iterations, T a, const T *b, T *sink);
+
+/**
+ * @brief 顺序读内核函数类型, 返回count个元素之和
+ */
+using ReadKernel = double (*)(const double *data, size_t count);
+
+/// 量化微内核寄存器分块的行数
+constexpr size_t QUANT_MR = 8;
+
+/// 量化微内核寄存器分块的列数, 16个int32累加器正好一个512位向量
+constexpr size_t QUANT_NR = 16;
+
+/// 量化GEMM的最大公共维度: 生成的输入下int32累加不会溢出
+constexpr size_t QUANT_MAX_DEPTH = size_t(1) << 17;
+
+/// 量化打包的分组长度: 一个int32通道内相乘相加的输入元素个数
+template <typename TA> constexpr size_t QUANT_GROUP = 4 / sizeof(TA);
+
+/**
+ * @brief 量化GEMM微内核函数类型
+ *
+ * 计算完整的QUANT_MR x QUANT_NR块的int32累加结果(覆盖写入acc)。
+ * 面板按QUANT_GROUP<TA>个公共维度元素分组: a_panel依次存放每组中
+ * MR行各自的G个元素, b_panel依次存放每组中NR列各自的G个元素,
+ * 长度不足的部分补零
+ *
+ * @tparam TA A的元素类型
+ * @tparam TB B的元素类型
+ * @param groups 分组数
+ * @param a_panel 打包后的A面板
+ * @param b_panel 打包后的B面板
+ * @param acc 输出, MR x NR行主序
+ */
+template <typename TA, typename TB>
+using QuantMicroKernel = void (*)(size_t groups,
+                                  const TA *a_panel,
+                                  const TB *b_panel,
+                                  int32_t *acc);
+
+/**
+ * @brief 按指令集选择的量化微内核
+ *
+ * @tparam TA A的元素类型
+ * @tparam TB B的元素类型
+ */
+template <typename TA, typename TB> struct QuantKernel
+{
+  QuantMicroKernel<TA, TB> kernel = nullptr; ///< 微内核函数指针
+  const char *path = "scalar"; ///< 指令路径名称, 如"avx512-vnni"
+  const char *instruction = ""; ///< 核心乘加指令, 如"vpdpbusd"
+  bool signed_a = false; ///< A是否需以int8打包(uint8值减128, 供sdot使用)
+};
+
+/**
+ * @brief 检测CPU支持的最高SIMD指令集
+ *
+ * x86使用CPUID(含操作系统XSAVE状态检查), ARM使用hwcap
+ *
+ * @return SimdIsa 可用的最高指令集, 不会返回SimdIsa::Auto
+ */
+SimdIsa detect_simd_isa();
+
+/**
+ * @brief 判断当前CPU是否支持指定指令集
+ *
+ * @param isa 指令集
+ * @return bool 本程序包含该指令集的内核且CPU支持时返回true
+ */
+bool simd_isa_supported(SimdIsa isa);
+
+/**
+ * @brief 获取指令集名称
+ *
+ * @param isa 指令集
+ * @return const char* 与--isa参数一致的名称
+ */
+const char *simd_isa_name(SimdIsa isa);
+
+/**
+ * @brief 设置打包GEMM使用的指令集
+ *
+ * @param isa 指令集, SimdIsa::Auto表示使用detect_simd_isa()的结果
+ */
+void set_simd_isa(SimdIsa isa);
+
+/**
+ * @brief 获取当前使用的指令集
+ *
+ * @return SimdIsa 当前指令集, 未设置时为detect_simd_isa()的结果
+ */
+SimdIsa active_simd_isa();
+
+/**
+ * @brief 获取指令集对应的微内核
+ *
+ * 该指令集没有对应元素类型的实现时回退到标量微内核
+ *
+ * @tparam T 元素类型
+ * @param isa 指令集
+ * @return MicroKernel<T> 微内核函数指针
+ */
+template <typename T> MicroKernel<T> select_micro_kernel(SimdIsa isa);
+
+/**
+ * @brief 获取指令集对应的峰值探测函数
+ *
+ * @tparam T 元素类型
+ * @param isa 指令集
+ * @return PeakProbe<T> 峰值探测函数指针, 回退规则与微内核相同
+ */
+template <typename T> PeakProbe<T> select_peak_probe(SimdIsa isa);
+
+/**
+ * @brief 获取指令集对应的顺序读内核
+ *
+ * @param isa 指令集
+ * @return ReadKernel 顺序读内核函数指针
+ */
+ReadKernel select_read_kernel(SimdIsa isa);
+
+/**
+ * @brief 获取指令集对应的量化微内核
+ *
+ * u8 x s8: AVX-512 VNNI(vpdpbusd) > AVX2(vpmaddubsw + vpmaddwd) >
+ * NEON dotprod(sdot) > 标量; s16 x s16: AVX-512 VNNI(vpdpwssd) >
+ * AVX2(vpmaddwd) > NEON(smull) > 标量。所选路径不可用时依次回退
+ *
+ * @tparam TA A的元素类型(uint8_t或int16_t)
+ * @tparam TB B的元素类型(int8_t或int16_t)
+ * @param isa 指令集
+ * @return QuantKernel<TA, TB> 微内核及其路径
+ */
+template <typename TA, typename TB>
+QuantKernel<TA, TB> select_quant_kernel(SimdIsa isa);
+
+/**
+ * @brief 获取CPU核心数
+ *
+ * 跨平台获取系统的CPU核心数, 支持Windows、Linux和macOS
+ *
+ * @return size_t CPU核心数
+ */
+size_t get_cpu_cores();
+
+/**
+ * @brief 收集系统信息
+ *
+ * @return SystemInfo CPU、操作系统、缓存、SIMD和NUMA信息
+ */
+SystemInfo collect_system_info();
+
+/**
+ * @brief 打印系统信息
+ *
+ * 显示CPU核心数、操作系统、架构、缓存信息等系统详细信息
+ */
+void print_system_info();
+
+/**
+ * @brief 解析命令行参数
+ *
+ * 解析程序的命令行参数, 设置基准测试的各项配置
+ * 支持矩阵大小、块大小、线程数、迭代次数等参数设置
+ *
+ * @param argc 命令行参数个数
+ * @param argv 命令行参数数组
+ * @return BenchmarkConfig 解析后的配置结构体
+ */
+BenchmarkConfig parse_args(int argc, char *argv[]);
+
+/**
+ * @brief 根据配置计算矩阵的行跨度
+ *
+ * @param config 基准测试配置
+ * @param cols 矩阵列数
+ * @return size_t 行跨度, 0表示由Matrix自动选择
+ */
+size_t configured_leading_dimension(const BenchmarkConfig &config,
+                                    size_t cols);
+
+/**
+ * @brief 分块矩阵乘法子块内核
+ *
+ * 以ikj顺序分块计算c += a * b, 各参数为矩阵视图,
+ * 可以是任意行、列范围的子块
+ *
+ * @tparam T 元素类型
+ * @param a 左操作数视图
+ * @param b 右操作数视图
+ * @param c 结果子块视图
+ * @param blockSize 分块大小
+ */
+template <typename T>
+void matrix_mul_tile(MatrixView<const T> a,
+                     MatrixView<const T> b,
+                     MatrixView<T> c,
+                     size_t blockSize);
+
+/**
+ * @brief 矩阵乘法核心函数
+ *
+ * 使用分块算法执行矩阵乘法运算, 支持指定行范围的并行计算
+ * 采用ikj循环顺序优化缓存访问模式
+ *
+ * @param src1 源矩阵1
+ * @param src2 源矩阵2
+ * @param dst 目标结果矩阵
+ * @param blockSize 分块大小
+ * @tparam T 元素类型
+ * @param start 起始行索引
+ * @param end 结束行索引
+ */
+template <typename T>
+void matrix_mul(const Matrix<T> &src1,
+                const Matrix<T> &src2,
+                Matrix<T> &dst,
+                size_t blockSize,
+                size_t start,
+                size_t end);
+
+/**
+ * @brief GotoBLAS风格的打包矩阵乘法子块内核
+ *
+ * 与packed_matrix_mul()相同的算法, 作用于任意子块视图
+ *
+ * @tparam T 元素类型
+ * @param a 左操作数视图
+ * @param b 右操作数视图
+ * @param c 结果子块视图
+ * @param blockSize 未使用
+ */
+template <typename T>
+void packed_matrix_mul_tile(MatrixView<const T> a,
+                            MatrixView<const T> b,
+                            MatrixView<T> c,
+                            size_t blockSize);
+
+/**
+ * @brief GotoBLAS风格的打包矩阵乘法
+ *
+ * 按NC/KC/MC三级分块, 将A、B面板打包到连续缓冲区,
+ * 由MRxNR寄存器分块微内核完成计算。签名与matrix_mul()一致,
+ * blockSize参数被忽略, 分块参数来自calculate_packed_blocking()
+ *
+ * @param src1 源矩阵1
+ * @param src2 源矩阵2
+ * @param dst 目标结果矩阵
+ * @tparam T 元素类型
+ * @param blockSize 未使用
+ * @param start 起始行索引
+ * @param end 结束行索引
+ */
+template <typename T>
+void packed_matrix_mul(const Matrix<T> &src1,
+                       const Matrix<T> &src2,
+                       Matrix<T> &dst,
+                       size_t blockSize,
+                       size_t start,
+                       size_t end);
+
+/**
+ * @brief 获取内核类型对应的内核函数
+ *
+ * @tparam T 元素类型
+ * @param type 内核类型
+ * @return GemmKernel<T> 内核函数指针
+ */
+template <typename T> GemmKernel<T> select_kernel(KernelType type);
+
+/**
+ * @brief 获取内核类型对应的子块内核函数
+ *
+ * @tparam T 元素类型
+ * @param type 内核类型
+ * @return GemmTileKernel<T> 子块内核函数指针
+ */
+template <typename T> GemmTileKernel<T> select_tile_kernel(KernelType type);
+
+/**
+ * @brief 获取并行方式的名称
+ *
+ * @param mode 并行方式
+ * @return const char* 与--parallel参数一致的名称
+ */
+const char *parallel_mode_name(ParallelMode mode);
+
+/**
+ * @brief 获取内核类型的名称
+ *
+ * @param type 内核类型
+ * @return const char* 命令行中使用的名称
+ */
+const char *kernel_name(KernelType type);
+
+/**
+ * @brief 简单多线程矩阵乘法
+ *
+ * 基于块大小创建线程的简单多线程实现
+ * 每个块创建一个线程, 适用于小规模矩阵
+ *
+ * @tparam T 元素类型
+ * @param matrix1 输入矩阵1
+ * @param matrix2 输入矩阵2
+ * @param result 结果矩阵
+ * @param block_size 块大小
+ * @param kernel 每个线程使用的内核
+ * @param pool 线程池, nullptr表示每个块创建一个线程
+ * @param telemetry 线程级遥测输出, 可以为nullptr
+ */
+template <typename T>
+void parallel_computing_simple_multithread(
+    const Matrix<T> &matrix1,
+    const Matrix<T> &matrix2,
+    Matrix<T> &result,
+    size_t block_size,
+    GemmKernel<T> kernel,
+    ThreadPool *pool = nullptr,
+    ThreadTelemetry *telemetry = nullptr);
+
+/**
+ * @brief 优化的多线程矩阵乘法
+ *
+ * 可控制线程数量的优化多线程实现
+ * 将矩阵行均匀分配给指定数量的线程, 避免线程过多的开销
+ *
+ * @tparam T 元素类型
+ * @param matrix1 输入矩阵1
+ * @param matrix2 输入矩阵2
+ * @param result 结果矩阵
+ * @param block_size 块大小
+ * @param num_threads 线程数量
+ * @param kernel 每个线程使用的内核
+ * @param pool 线程池, nullptr表示每次调用创建线程
+ * @param telemetry 线程级遥测输出, 可以为nullptr
+ */
+template <typename T>
+void parallel_computing_optimized(const Matrix<T> &matrix1,
+                                  const Matrix<T> &matrix2,
+                                  Matrix<T> &result,
+                                  size_t block_size,
+                                  size_t num_threads,
+                                  GemmKernel<T> kernel,
+                                  ThreadPool *pool = nullptr,
+                                  ThreadTelemetry *telemetry = nullptr);
+
+/**
+ * @brief 计算工作窃取调度的默认分块边长
+ *
+ * 使分块数约为线程数的8倍, 既留有窃取余地又不至于过碎,
+ * 边长对齐到64并不小于64
+ *
+ * @param rows 结果矩阵行数
+ * @param cols 结果矩阵列数
+ * @param num_threads 线程数
+ * @return size_t 分块边长
+ */
+size_t choose_tile_size(size_t rows, size_t cols, size_t num_threads);
+
+/**
+ * @brief 按问题形状选择静态划分的线程网格
+ *
+ * 先使每个线程的乘加次数(关键路径)最小, 相同时使每个线程的访存量最小;
+ * M很小时沿列划分, N很小时沿行划分; 只有M x N网格无法让每个线程都
+ * 分到非空单元时才拆分K(split-K)
+ *
+ * @param rows 结果矩阵行数(M)
+ * @param cols 结果矩阵列数(N)
+ * @param inner 公共维度(K)
+ * @param num_threads 线程数
+ * @param element_size 元素字节数, 决定列段对齐的缓存行宽度
+ * @return ThreadGrid row_parts * col_parts * k_parts == num_threads的网格
+ */
+ThreadGrid choose_thread_grid(size_t rows,
+                              size_t cols,
+                              size_t inner,
+                              size_t num_threads,
+                              size_t element_size);
+
+/**
+ * @brief 按形状静态划分的多线程矩阵乘法(行、二维或split-K)
+ *
+ * 用choose_thread_grid()给每个线程分配一个(行段, 列段, K段)单元,
+ * 列边界对齐到缓存行; 拆分K时各K段写入私有的部分和,
+ * 汇合后按行条带并行归约到C
+ *
+ * @tparam T 元素类型
+ * @param matrix1 输入矩阵1
+ * @param matrix2 输入矩阵2
+ * @param result 结果矩阵
+ * @param block_size 内核使用的块大小
+ * @param num_threads 线程数量
+ * @param kernel 子块内核
+ * @param pool 线程池, nullptr表示每次调用创建线程
+ * @param telemetry 线程级遥测输出, 可以为nullptr
+ */
+template <typename T>
+void parallel_computing_partitioned(const Matrix<T> &matrix1,
+                                    const Matrix<T> &matrix2,
+                                    Matrix<T> &result,
+                                    size_t block_size,
+                                    size_t num_threads,
+                                    GemmTileKernel<T> kernel,
+                                    ThreadPool *pool = nullptr,
+                                    ThreadTelemetry *telemetry = nullptr);
+
+/**
+ * @brief 二维分块工作窃取的多线程矩阵乘法
+ *
+ * 将结果矩阵按(i, j)切分为分块, 预先按连续区间分配到每个线程的双端队列;
+ * 线程从自己队列的尾部取任务, 队列为空时从其他线程队列的头部窃取
+ *
+ * @tparam T 元素类型
+ * @param matrix1 输入矩阵1
+ * @param matrix2 输入矩阵2
+ * @param result 结果矩阵
+ * @param block_size 内核使用的块大小
+ * @param num_threads 线程数量
+ * @param tile_size 分块边长, 0表示使用choose_tile_size()
+ * @param kernel 子块内核
+ * @param pool 线程池, nullptr表示每次调用创建线程
+ * @param stats 统计信息输出, 可以为nullptr
+ * @param telemetry 线程级遥测输出, 可以为nullptr
+ */
+template <typename T>
+void parallel_computing_work_stealing(const Matrix<T> &matrix1,
+                                      const Matrix<T> &matrix2,
+                                      Matrix<T> &result,
+                                      size_t block_size,
+                                      size_t num_threads,
+                                      size_t tile_size,
+                                      GemmTileKernel<T> kernel,
+                                      ThreadPool *pool = nullptr,
+                                      WorkStealingStats *stats = nullptr,
+                                      ThreadTelemetry *telemetry = nullptr);
+
+/**
+ * @brief 解析Linux的CPU列表字符串
+ *
+ * 格式如"0-3,8,10-11", 与/sys中cpulist、shared_cpu_list一致
+ *
+ * @param list CPU列表字符串
+ * @return vector<int> 展开后的CPU编号
+ */
+vector<int> parse_cpu_list(const string &list);
+
+/**
+ * @brief 获取NUMA拓扑
+ *
+ * Linux从/sys/devices/system/node读取每个节点的cpulist, 结果在首次调用后缓存
+ *
+ * @return const NumaTopology& 拓扑信息, 至少包含一个节点
+ */
+const NumaTopology &get_numa_topology();
+
+/**
+ * @brief 获取绑核策略的名称
+ *
+ * @param mode 绑核策略
+ * @return const char* 与--affinity参数一致的名称
+ */
+const char *affinity_mode_name(AffinityMode mode);
+
+/**
+ * @brief 设置工作线程的绑核策略
+ *
+ * 按策略计算参与者编号到CPU的映射, 应在启动工作线程之前调用
+ *
+ * @param mode 绑核策略
+ */
+void set_thread_affinity(AffinityMode mode);
+
+/**
+ * @brief 将当前线程绑定到参与者编号对应的CPU
+ *
+ * 由并行驱动在每个工作线程开始时调用; 总是记录参与者编号供
+ * worker_buffer()使用, 策略为None时不绑核
+ *
+ * @param tid 参与者编号
+ */
+void apply_thread_affinity(size_t tid);
+
+/// 不在并行驱动中执行的线程的参与者编号
+constexpr size_t NO_WORKER = std::numeric_limits<size_t>::max();
+
+/**
+ * @brief 获取当前线程最近一次apply_thread_affinity()记录的参与者编号
+ *
+ * @return size_t 参与者编号, 从未参与并行驱动时为NO_WORKER
+ */
+size_t current_worker();
+
+/**
+ * @brief 获取当前参与者的工作缓冲区
+ *
+ * 每次调用创建线程时, thread_local缓冲区随线程退出而释放, 下一次调用的
+ * 新线程要重新分配并缺页。这里按参与者编号把缓冲区保存在进程级的表中,
+ * 同一编号的线程(线程池线程或新创建的线程)复用同一个缓冲区, 只在首次
+ * 使用(预热迭代)和容量不足时分配; 不在并行驱动中的线程使用thread_local
+ * 实例。同一编号同一时刻只有一个线程执行, 缓冲区本身不需要加锁
+ *
+ * @tparam Buffer 缓冲区类型, 可默认构造
+ * @tparam Tag 区分同一类型的不同用途(例如A面板和B面板)
+ * @return Buffer& 当前参与者的缓冲区, 在程序退出前有效
+ */
+template <typename Buffer, int Tag = 0> Buffer &worker_buffer()
+{
+  const size_t tid = current_worker();
+  if (tid == NO_WORKER)
+  {
+    thread_local Buffer own;
+    return own;
+  }
+  static std::mutex lock;
+  static std::deque<Buffer> slots;
+  std::lock_guard<std::mutex> guard(lock);
+  while (slots.size() <= tid) slots.emplace_back();
+  return slots[tid];
+}
+
+/**
+ * @brief 获取当前线程正在运行的CPU
+ *
+ * @return int CPU编号, 系统不支持查询时返回-1
+ */
+int current_cpu();
+
+/**
+ * @brief 统计一块内存的页面在各NUMA节点上的分布
+ *
+ * @param data 内存起始地址
+ * @param bytes 字节数
+ * @return vector<size_t> 按节点编号索引的页面数, 无法查询时为空
+ */
+vector<size_t> query_page_nodes(const void *data, size_t bytes);
+
+/**
+ * @brief 打印矩阵在各NUMA节点上的页面分布
+ *
+ * @param name 矩阵名称
+ * @param data 数据指针
+ * @param bytes 字节数
+ */
+void print_numa_memory_map(const char *name, const void *data, size_t bytes);
+
+/**
+ * @brief 获取页面类型的名称
+ *
+ * @param mode 页面类型
+ * @return const char* 与--pages参数一致的名称
+ */
+const char *page_mode_name(PageMode mode);
+
+/**
+ * @brief 设置之后page_alloc()使用的页面类型
+ *
+ * 应在分配矩阵之前调用; 已分配的内存不受影响, 仍能正确释放
+ *
+ * @param mode 页面类型
+ */
+void set_page_mode(PageMode mode);
+
+/**
+ * @brief 获取当前的页面类型
+ *
+ * @return PageMode 当前页面类型, 未设置时为PageMode::Transparent
+ */
+PageMode active_page_mode();
+
+/**
+ * @brief 获取MAP_HUGETLB失败后回退到透明大页的分配次数
+ *
+ * @return size_t 回退次数
+ */
+size_t huge_page_fallbacks();
+
+/**
+ * @brief 统计进程中由大页支撑的内存
+ *
+ * Linux读取/proc/self/smaps_rollup中AnonHugePages(透明大页)与
+ * Private_Hugetlb、Shared_Hugetlb(MAP_HUGETLB)之和
+ *
+ * @return size_t 字节数, 无法查询时为0
+ */
+size_t huge_page_bytes();
+
+/**
+ * @brief 按行条并行地首次写入矩阵
+ *
+ * 行划分与parallel_rows()相同, 每个线程绑核后写入自己负责的行,
+ * 使页面按first-touch策略分配到该线程所在的NUMA节点
+ *
+ * @tparam T 元素类型
+ * @param matrix 目标矩阵
+ * @param num_threads 线程数量
+ * @param pool 线程池, nullptr表示创建线程
+ * @param init 行初始化函数init(row, data), 为空时将整行清零
+ */
+template <typename T>
+void parallel_first_touch(Matrix<T> &matrix,
+                          size_t num_threads,
+                          ThreadPool *pool,
+                          const std::function<void(size_t, T *)> &init = {});
+
+/**
+ * @brief 按parallel_computing_partitioned()的线程网格首次写入矩阵
+ *
+ * 每个线程绑核后把计算阶段自己读写的A块、B块或C单元清零, 列边界向上
+ * 取整到页面起点, 使二维和split-K网格下的页面也位于使用它的线程所在的
+ * NUMA节点; 应在矩阵分配后、parallel_first_touch()写入初值之前调用
+ *
+ * @tparam T 元素类型
+ * @param matrix 目标矩阵
+ * @param grid choose_thread_grid()选出的网格
+ * @param operand 矩阵在乘法中的角色
+ * @param pool 线程池, nullptr表示创建线程
+ */
+template <typename T>
+void grid_first_touch(Matrix<T> &matrix,
+                      const ThreadGrid &grid,
+                      GridOperand operand,
+                      ThreadPool *pool);
+
+/**
+ * @brief 按行划分并行执行
+ *
+ * 划分方式与parallel_first_touch()相同, 每个线程绑核后处理连续的行区间
+ *
+ * @param rows 总行数
+ * @param num_threads 线程数量
+ * @param pool 线程池, nullptr表示创建线程
+ * @param body 处理[start, end)行的函数
+ */
+void parallel_rows(size_t rows,
+                   size_t num_threads,
+                   ThreadPool *pool,
+                   const std::function<void(size_t, size_t)> &body);
+
+/**
+ * @brief 获取CPU型号字符串
+ *
+ * @return string CPU型号, 无法获取时为"unknown"
+ */
+string cpu_model_name();
+
+/**
+ * @brief 计算矩阵规模档位
+ *
+ * 调优结果按档位共享, 相近规模的矩阵使用同一组参数
+ *
+ * @param matrix_size 矩阵大小
+ * @return size_t 不小于matrix_size的2的幂, 至少为64
+ */
+size_t size_class(size_t matrix_size);
+
+/**
+ * @brief 获取默认的调优缓存文件路径
+ *
+ * @return string 用户缓存目录下的matrixmul_tuning.tsv
+ */
+string default_tuning_cache_path();
+
+/**
+ * @brief 从调优缓存中查找记录
+ *
+ * @param path 缓存文件路径
+ * @param key 查找键, 使用其中的cpu_model、isa、dtype和size_class
+ * @param entry 找到时写入的记录
+ * @return bool 是否找到
+ */
+bool load_tuning(const string &path,
+                 const TuningEntry &key,
+                 TuningEntry &entry);
+
+/**
+ * @brief 写入调优缓存, 替换相同键的旧记录
+ *
+ * @param path 缓存文件路径
+ * @param entry 调优记录
+ * @return bool 写入是否成功
+ */
+bool save_tuning(const string &path, const TuningEntry &entry);
+
+/**
+ * @brief 经验式自动调优
+ *
+ * 在给定的矩阵规模和元素类型下搜索内核、块大小和线程数, 返回最优组合
+ *
+ * @tparam T 元素类型
+ * @param config 基准测试配置, 使用其中的matrix_size和ld_padding
+ * @return TuningEntry 最优组合及其性能
+ */
+template <typename T> TuningEntry autotune(const BenchmarkConfig &config);
+
+/**
+ * @brief 设置Strassen递归的截止规模
+ *
+ * 子问题的任一维度不大于cutoff时回退到分块内核
+ *
+ * @param cutoff 截止规模, 小于2时按2处理
+ */
+void set_strassen_cutoff(size_t cutoff);
+
+/**
+ * @brief 获取当前的Strassen截止规模
+ *
+ * @return size_t 截止规模
+ */
+size_t strassen_cutoff();
+
+/**
+ * @brief 计算Strassen递归所需的工作区大小
+ *
+ * @param rows 结果行数(m)
+ * @param inner 公共维度(k)
+ * @param cols 结果列数(n)
+ * @param element_size 元素字节数
+ * @return size_t 工作区元素个数
+ */
+size_t strassen_workspace_size(size_t rows,
+                               size_t inner,
+                               size_t cols,
+                               size_t element_size);
+
+/**
+ * @brief Strassen-Winograd矩阵乘法子块内核
+ *
+ * 计算c += a * b, 子问题不大于截止规模时使用matrix_mul_tile()
+ *
+ * @tparam T 元素类型
+ * @param a 左操作数视图
+ * @param b 右操作数视图
+ * @param c 结果子块视图
+ * @param blockSize 回退内核的分块大小
+ */
+template <typename T>
+void strassen_matrix_mul_tile(MatrixView<const T> a,
+                              MatrixView<const T> b,
+                              MatrixView<T> c,
+                              size_t blockSize);
+
+/**
+ * @brief Strassen-Winograd矩阵乘法(行范围)
+ *
+ * 签名与matrix_mul()一致, 对dst的[start, end)行调用strassen_matrix_mul_tile()
+ *
+ * @tparam T 元素类型
+ * @param src1 源矩阵1, 左操作数
+ * @param src2 源矩阵2, 右操作数
+ * @param dst 目标结果矩阵
+ * @param blockSize 回退内核的分块大小
+ * @param start 起始行索引(包含)
+ * @param end 结束行索引(不包含)
+ */
+template <typename T>
+void strassen_matrix_mul(const Matrix<T> &src1,
+                         const Matrix<T> &src2,
+                         Matrix<T> &dst,
+                         size_t blockSize,
+                         size_t start,
+                         size_t end);
+
+/**
+ * @brief 并行的Strassen-Winograd矩阵乘法
+ *
+ * 顶层的7个子乘积由num_threads个线程并行计算, 子乘积内部串行递归
+ *
+ * @tparam T 元素类型
+ * @param matrix1 输入矩阵1
+ * @param matrix2 输入矩阵2
+ * @param result 结果矩阵
+ * @param block_size 回退内核的分块大小
+ * @param num_threads 线程数量
+ * @param pool 线程池, nullptr表示创建线程
+ * @param telemetry 线程级遥测输出, 可以为nullptr
+ */
+template <typename T>
+void parallel_strassen_matrix_mul(const Matrix<T> &matrix1,
+                                  const Matrix<T> &matrix2,
+                                  Matrix<T> &result,
+                                  size_t block_size,
+                                  size_t num_threads,
+                                  ThreadPool *pool = nullptr,
+                                  ThreadTelemetry *telemetry = nullptr);
+
+/**
+ * @brief 获取已注册的内核变体
+ *
+ * @tparam T 元素类型
+ * @return const vector<KernelVariant<T>>& 内核变体列表
+ */
+template <typename T> const vector<KernelVariant<T>> &kernel_variants();
+
+/**
+ * @brief 按名称查找内核变体
+ *
+ * @tparam T 元素类型
+ * @param name 变体名称
+ * @return const KernelVariant<T>* 找到的变体, 不存在时返回nullptr
+ */
+template <typename T>
+const KernelVariant<T> *find_kernel_variant(const string &name);
+
+/**
+ * @brief 打印所有已注册的内核变体(--list-kernels)
+ */
+void print_kernel_variants();
+
+/**
+ * @brief 判断小矩阵尺寸是否有编译期特化的批量内核
+ *
+ * @param m A和C的行数
+ * @param n B和C的列数
+ * @param k 公共维度
+ * @return bool M = N = K且属于特化尺寸列表时返回true
+ */
+bool batch_kernel_specialized(size_t m, size_t n, size_t k);
+
+/**
+ * @brief 获取批量小矩阵乘法内核
+ *
+ * 有编译期特化时返回维度为常量的内核, 否则返回运行时维度的通用内核
+ *
+ * @tparam T 元素类型
+ * @param m A和C的行数
+ * @param n B和C的列数
+ * @param k 公共维度
+ * @return BatchKernel<T> 内核函数指针
+ */
+template <typename T>
+BatchKernel<T> select_batch_kernel(size_t m, size_t n, size_t k);
+
+/**
+ * @brief 批量小矩阵乘法的朴素ijk参考实现, 与被测内核相互独立
+ *
+ * 计算第[start, end)个矩阵: C[p] = A[p] * B[p]
+ *
+ * @tparam T 元素类型
+ * @param batch 批量矩阵
+ * @param start 起始矩阵索引(包含)
+ * @param end 结束矩阵索引(不包含)
+ */
+template <typename T>
+void batch_reference(const SmallBatch<T> &batch, size_t start, size_t end);
+
+/**
+ * @brief 计算批量中相邻矩阵的间距
+ *
+ * @param rows 行数
+ * @param cols 列数
+ * @param element_size 元素大小(字节)
+ * @return size_t rows * cols向上取整到缓存行的元素个数
+ */
+size_t batch_stride(size_t rows, size_t cols, size_t element_size);
+
+/**
+ * @brief 获取稀疏结构的名称
+ *
+ * @param structure 稀疏结构
+ * @return const char* 与--structure参数一致的名称
+ */
+const char *sparse_structure_name(SparseStructure structure);
+
+/**
+ * @brief 判断BSR块边长是否有编译期特化的内核
+ *
+ * @param block 块边长
+ * @return bool 块边长属于特化列表(2、4、8、16)时返回true
+ */
+bool bsr_block_supported(size_t block);
+
+/**
+ * @brief 生成指定密度和结构的稀疏矩阵
+ *
+ * 使用固定种子, 相同的参数总是生成相同的矩阵; 非零元的值为1~9的整数
+ *
+ * @tparam T 元素类型
+ * @param rows 行数
+ * @param cols 列数, 不能超过uint32_t的范围
+ * @param density 期望密度(0, 1]
+ * @param structure 非零元分布
+ * @return CsrMatrix<T> 生成的矩阵
+ */
+template <typename T>
+CsrMatrix<T> generate_sparse(size_t rows,
+                             size_t cols,
+                             double density,
+                             SparseStructure structure);
+
+/**
+ * @brief 把CSR矩阵转换为BSR格式
+ *
+ * @tparam T 元素类型
+ * @param csr 源矩阵
+ * @param block 块边长
+ * @return BsrMatrix<T> 转换后的矩阵
+ */
+template <typename T>
+BsrMatrix<T> csr_to_bsr(const CsrMatrix<T> &csr, size_t block);
+
+/**
+ * @brief 按非零元个数均衡地把行划分为连续区间
+ *
+ * @param row_ptr CSR或BSR的行指针
+ * @param parts 区间个数
+ * @return vector<size_t> parts + 1个边界, 第p段为[bounds[p], bounds[p + 1])
+ */
+vector<size_t> partition_by_nnz(const vector<size_t> &row_ptr, size_t parts);
+
+/**
+ * @brief CSR稀疏矩阵与向量相乘
+ *
+ * 计算[start, end)行: y = A * x
+ *
+ * @tparam T 元素类型
+ * @param a 稀疏矩阵
+ * @param x 长度为a.cols的向量
+ * @param y 长度为a.rows的结果向量
+ * @param start 起始行(包含)
+ * @param end 结束行(不包含)
+ */
+template <typename T>
+void csr_spmv(
+    const CsrMatrix<T> &a, const T *x, T *y, size_t start, size_t end);
+
+/**
+ * @brief CSR稀疏矩阵与稠密矩阵相乘
+ *
+ * 计算[start, end)行: C += A * B
+ *
+ * @tparam T 元素类型
+ * @param a 稀疏矩阵
+ * @param b 稠密矩阵(a.cols行)
+ * @param c 结果矩阵(a.rows行, 与b同列数)
+ * @param start 起始行(包含)
+ * @param end 结束行(不包含)
+ */
+template <typename T>
+void csr_spmm(const CsrMatrix<T> &a,
+              MatrixView<const T> b,
+              MatrixView<T> c,
+              size_t start,
+              size_t end);
+
+/**
+ * @brief BSR稀疏矩阵与向量相乘
+ *
+ * 计算[start, end)块行: y = A * x
+ *
+ * @tparam T 元素类型
+ * @param a 稀疏矩阵, 块边长必须满足bsr_block_supported()
+ * @param x 长度为a.cols的向量
+ * @param y 长度为a.rows的结果向量
+ * @param start 起始块行(包含)
+ * @param end 结束块行(不包含)
+ */
+template <typename T>
+void bsr_spmv(
+    const BsrMatrix<T> &a, const T *x, T *y, size_t start, size_t end);
+
+/**
+ * @brief BSR稀疏矩阵与稠密矩阵相乘
+ *
+ * 计算[start, end)块行: C += A * B
+ *
+ * @tparam T 元素类型
+ * @param a 稀疏矩阵, 块边长必须满足bsr_block_supported()
+ * @param b 稠密矩阵(a.cols行)
+ * @param c 结果矩阵(a.rows行, 与b同列数)
+ * @param start 起始块行(包含)
+ * @param end 结束块行(不包含)
+ */
+template <typename T>
+void bsr_spmm(const BsrMatrix<T> &a,
+              MatrixView<const T> b,
+              MatrixView<T> c,
+              size_t start,
+              size_t end);
+
+/**
+ * @brief 运行稀疏矩阵基准测试(--sparse)
+ *
+ * @tparam T 元素类型
+ * @param config 基准测试配置, 使用其中的稀疏参数和shape_m/shape_n/shape_k
+ * @param report 运行结果, 每个操作和格式追加一条记录
+ * @return int 程序退出状态码, 0表示成功, 1表示有结果验证失败
+ */
+template <typename T>
+int run_sparse(const BenchmarkConfig &config, BenchmarkReport &report);
+
+/**
+ * @brief 选择核外模式在内存中的分块边长
+ *
+ * @param memory_bytes 内存工作集上限(字节)
+ * @param element_size 元素大小(字节)
+ * @return size_t 两份A分块、两份B分块和一份C分块都能放入工作集的最大边长
+ */
+size_t choose_ooc_tile(size_t memory_bytes, size_t element_size);
+
+/**
+ * @brief 获取量化类型的名称
+ *
+ * @param type 量化类型
+ * @return const char* 与--quant参数一致的名称
+ */
+const char *quant_type_name(QuantType type);
+
+/**
+ * @brief 运行量化GEMM基准测试(--quant)
+ *
+ * @param config 基准测试配置, 使用其中的quant和shape_m/shape_n/shape_k
+ * @param report 运行结果, 追加量化路径和int32对照各一条记录
+ * @return int 程序退出状态码, 0表示成功, 1表示有结果验证失败
+ */
+int run_quantized(const BenchmarkConfig &config, BenchmarkReport &report);
+
+/**
+ * @brief 运行核外矩阵乘法基准测试(--ooc)
+ *
+ * @tparam T 元素类型
+ * @param config 基准测试配置, 使用其中的ooc_dir、ooc_memory_mb和矩阵形状
+ * @param report 运行结果, 追加一条记录并写入out_of_core
+ * @return int 程序退出状态码, 0表示成功, 1表示文件操作或结果验证失败
+ */
+template <typename T>
+int run_out_of_core(const BenchmarkConfig &config, BenchmarkReport &report);
+
+/**
+ * @brief 计算矩阵的转置
+ *
+ * @tparam T 元素类型
+ * @param matrix 源矩阵
+ * @return Matrix<T> 转置矩阵
+ */
+template <typename T> Matrix<T> transpose_matrix(const Matrix<T> &matrix);
+
+/**
+ * @brief 计算一组计时样本的统计量
+ *
+ * 在全部样本上计算分位数、标准差和中位数的bootstrap置信区间,
+ * 样本不少于5个时另外按MAD标记离群值(不剔除)
+ *
+ * @param samples 每次迭代的时间(秒)
+ * @return SampleStats 统计结果
+ */
+SampleStats compute_sample_stats(const vector<double> &samples);
+
+/**
+ * @brief 判断中位数的置信区间是否足够窄
+ *
+ * @param stats 统计结果
+ * @param target 区间宽度与中位数之比的上限
+ * @return bool 可以停止迭代时返回true
+ */
+bool ci_converged(const SampleStats &stats, double target);
+
+/**
+ * @brief 获取验证方式的名称
+ *
+ * @param mode 验证方式
+ * @return const char* 与--verify参数一致的名称
+ */
+const char *verify_mode_name(VerifyMode mode);
+
+/**
+ * @brief 获取验证的默认容差
+ *
+ * @tparam T 元素类型
+ * @param inner 公共维度
+ * @return double 浮点类型为64·sqrt(inner)·ε, 整数类型为0
+ */
+template <typename T> double default_tolerance(size_t inner);
+
+/**
+ * @brief Freivalds随机化验证 C == A * B
+ *
+ * 每轮用一个随机向量r比较A(Br)与Cr, 运算量O(n²), 与单线程结果无关
+ *
+ * @tparam T 元素类型
+ * @param a 左操作数
+ * @param b 右操作数
+ * @param c 待验证的结果
+ * @param rounds 随机向量个数
+ * @param tolerance 浮点类型的相对容差
+ * @param num_threads 线程数量
+ * @param pool 线程池, nullptr表示创建线程
+ * @return VerifyResult 验证结论, 不一致时给出出错的行
+ */
+template <typename T>
+VerifyResult freivalds_verify(const Matrix<T> &a,
+                              const Matrix<T> &b,
+                              const Matrix<T> &c,
+                              size_t rounds,
+                              double tolerance,
+                              size_t num_threads,
+                              ThreadPool *pool = nullptr);
+
+/**
+ * @brief 对矩阵视图做Freivalds随机化验证 C == A * B
+ *
+ * 用于不由Matrix持有的存储, 例如核外模式中内存映射的矩阵文件
+ *
+ * @tparam T 元素类型
+ * @param a 左操作数
+ * @param b 右操作数
+ * @param c 待验证的结果
+ * @param rounds 随机向量个数
+ * @param tolerance 浮点类型的相对容差
+ * @param num_threads 线程数量
+ * @param pool 线程池, nullptr表示创建线程
+ * @return VerifyResult 验证结论, 不一致时给出出错的行
+ */
+template <typename T>
+VerifyResult freivalds_verify(MatrixView<const T> a,
+                              MatrixView<const T> b,
+                              MatrixView<const T> c,
+                              size_t rounds,
+                              double tolerance,
+                              size_t num_threads,
+                              ThreadPool *pool = nullptr);
+
+/**
+ * @brief 并行逐元素比较两个矩阵
+ *
+ * @tparam T 元素类型
+ * @param expected 参考结果
+ * @param actual 待验证的结果
+ * @param tolerance 浮点类型的相对容差
+ * @param num_threads 线程数量
+ * @param pool 线程池, nullptr表示创建线程
+ * @return VerifyResult 验证结论, 不一致时给出第一个出错的元素
+ */
+template <typename T>
+VerifyResult compare_matrices(const Matrix<T> &expected,
+                              const Matrix<T> &actual,
+                              double tolerance,
+                              size_t num_threads,
+                              ThreadPool *pool = nullptr);
+
+/**
+ * @brief 估计指令集的峰值算力
+ *
+ * @tparam T 元素类型
+ * @param isa 指令集
+ * @param num_threads 同时运行的线程数
+ * @param pool 线程池, nullptr表示创建线程
+ * @return double 所有线程合计的峰值算力(GFLOPS/GOPS)
+ */
+template <typename T>
+double measure_peak_throughput(SimdIsa isa,
+                               size_t num_threads,
+                               ThreadPool *pool = nullptr);
+
+/**
+ * @brief STREAM风格的内存带宽测试(copy、scale、add、triad)
+ *
+ * @param num_threads 多线程测试的线程数
+ * @param pool 线程池, nullptr表示创建线程
+ * @return vector<StreamResult> 四项测试的单线程和多线程带宽
+ */
+vector<StreamResult> measure_stream_bandwidth(size_t num_threads,
+                                              ThreadPool *pool = nullptr);
+
+/**
+ * @brief 按get_cache_info()的各级缓存大小测量访存延迟和读带宽
+ *
+ * @return vector<MemoryLevelProbe> 各级缓存及内存的测量结果
+ */
+vector<MemoryLevelProbe> measure_memory_levels();
+
+/**
+ * @brief 测量屋顶线模型所需的全部机器参数
+ *
+ * @tparam T 元素类型, 决定峰值算力的测量类型
+ * @param num_threads 多线程测量的线程数
+ * @param pool 线程池, nullptr表示创建线程
+ * @return RooflineModel 机器参数
+ */
+template <typename T>
+RooflineModel characterize_machine(size_t num_threads,
+                                   ThreadPool *pool = nullptr);
+
+/**
+ * @brief 打印屋顶线模型的机器参数
+ *
+ * @param model 机器参数
+ * @param dtype 元素类型, 决定单位
+ */
+void print_roofline_model(const RooflineModel &model, DataType dtype);
+
+/**
+ * @brief 计算GEMM的算术强度
+ *
+ * @param m C的行数
+ * @param n C的列数
+ * @param k 公共维度
+ * @param element_size 元素大小(字节)
+ * @return double 运算量与最少访存字节数之比
+ */
+double gemm_intensity(size_t m, size_t n, size_t k, size_t element_size);
+
+/**
+ * @brief 计算屋顶线模型给出的性能上限
+ *
+ * @param model 机器参数
+ * @param intensity 算术强度
+ * @param multi true使用多线程参数, false使用单线程参数
+ * @return double min(峰值算力, 算术强度 × 带宽)(GFLOPS/GOPS)
+ */
+double roofline_bound(const RooflineModel &model,
+                      double intensity,
+                      bool multi);
+
+/**
+ * @brief 获取算术强度的单位
+ *
+ * @param dtype 元素类型
+ * @return const char* 浮点类型为"FLOP/字节", 整数类型为"OP/字节"
+ */
+const char *intensity_unit(DataType dtype);
+
+/**
+ * @brief 在同一进程内扫描规模、线程数和块大小
+ *
+ * 矩阵按最大规模分配一次, 各组合复用同一块内存
+ *
+ * @tparam T 元素类型
+ * @param config 基准测试配置, 使用其中的sweep_sizes、sweep_threads和
+ *               sweep_blocks
+ * @param report 运行结果, 写入配置和每个组合的测量
+ * @return int 程序退出状态码, 0表示成功, 1表示有结果验证失败
+ */
+template <typename T>
+int run_sweep(const BenchmarkConfig &config, BenchmarkReport &report);
+
+/**
+ * @brief 获取输出格式的名称
+ *
+ * @param format 输出格式
+ * @return const char* 与--format参数一致的名称
+ */
+const char *output_format_name(OutputFormat format);
+
+/**
+ * @brief 以JSON或CSV格式输出运行结果
+ *
+ * @param out 输出流
+ * @param report 运行结果
+ * @param system 系统信息
+ * @param format 输出格式, Text时不输出
+ */
+void write_report(std::ostream &out,
+                  const BenchmarkReport &report,
+                  const SystemInfo &system,
+                  OutputFormat format);
 
 #endif // MATRIXMUL_H
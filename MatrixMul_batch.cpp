@@ -0,0 +1,200 @@
+#include "MatrixMul.h"
+
+#include <utility>
+
+/**
+ * @brief 维度为编译期常量的批量小矩阵乘法内核
+ *
+ * 对每个矩阵按行计算: C的一行先读入大小为N的局部累加数组,
+ * 沿K累加A(i, k) * B(k, :)后写回。K方向用折叠表达式在编译期展开,
+ * 不依赖编译器的展开启发式; N方向的常量循环交给编译器向量化,
+ * 累加数组可以整体留在寄存器中, 没有分块循环和边界检查的开销
+ *
+ * @tparam T 元素类型
+ * @tparam M A和C的行数
+ * @tparam N B和C的列数
+ * @tparam K 公共维度
+ * @param batch 批量矩阵, 维度必须为M x N x K
+ * @param start 起始矩阵索引(包含)
+ * @param end 结束矩阵索引(不包含)
+ */
+template <typename T, size_t M, size_t N, size_t K>
+static void batch_fixed(const SmallBatch<T> &batch, size_t start, size_t end)
+{
+  for (size_t p = start; p < end; p++)
+  {
+    const T *__restrict a = batch.a + p * batch.stride_a;
+    const T *__restrict b = batch.b + p * batch.stride_b;
+    T *__restrict c = batch.c + p * batch.stride_c;
+    for (size_t i = 0; i < M; i++)
+    {
+      T acc[N];
+      for (size_t j = 0; j < N; j++)
+      {
+        acc[j] = c[i * N + j];
+      }
+      [&]<size_t... Ks>(std::index_sequence<Ks...>)
+      {
+        auto accumulate = [&](const T a_ik, const T *__restrict b_row)
+        {
+          for (size_t j = 0; j < N; j++)
+          {
+            acc[j] += a_ik * b_row[j];
+          }
+        };
+        (accumulate(a[i * K + Ks], b + Ks * N), ...);
+      }(std::make_index_sequence<K>{});
+      for (size_t j = 0; j < N; j++)
+      {
+        c[i * N + j] = acc[j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief 运行时维度的批量小矩阵乘法内核
+ *
+ * 使用与batch_fixed()相同的ikj顺序, 用于没有特化的尺寸
+ *
+ * @tparam T 元素类型
+ * @param batch 批量矩阵
+ * @param start 起始矩阵索引(包含)
+ * @param end 结束矩阵索引(不包含)
+ */
+template <typename T>
+static void batch_generic(const SmallBatch<T> &batch, size_t start, size_t end)
+{
+  const size_t m = batch.m;
+  const size_t n = batch.n;
+  const size_t k = batch.k;
+  for (size_t p = start; p < end; p++)
+  {
+    const T *__restrict a = batch.a + p * batch.stride_a;
+    const T *__restrict b = batch.b + p * batch.stride_b;
+    T *__restrict c = batch.c + p * batch.stride_c;
+    for (size_t i = 0; i < m; i++)
+    {
+      T *__restrict c_row = c + i * n;
+      for (size_t kk = 0; kk < k; kk++)
+      {
+        const T a_ik = a[i * k + kk];
+        const T *__restrict b_row = b + kk * n;
+        for (size_t j = 0; j < n; j++)
+        {
+          c_row[j] += a_ik * b_row[j];
+        }
+      }
+    }
+  }
+}
+
+/// 有编译期特化内核的方阵尺寸
+#define MM_BATCH_SIZES(X)                                                    \
+  X(2) X(3) X(4) X(5) X(6) X(8) X(12) X(16) X(24) X(32) X(48) X(64)
+
+/**
+ * @brief 判断小矩阵尺寸是否有编译期特化的批量内核
+ *
+ * @param m A和C的行数
+ * @param n B和C的列数
+ * @param k 公共维度
+ * @return bool M = N = K且属于MM_BATCH_SIZES时返回true
+ */
+bool batch_kernel_specialized(size_t m, size_t n, size_t k)
+{
+  if (m != n || n != k) return false;
+  switch (m)
+  {
+#define MM_BATCH_CASE(S)                                                     \
+  case S:                                                                    \
+    return true;
+    MM_BATCH_SIZES(MM_BATCH_CASE)
+#undef MM_BATCH_CASE
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief 获取批量小矩阵乘法内核
+ *
+ * @tparam T 元素类型
+ * @param m A和C的行数
+ * @param n B和C的列数
+ * @param k 公共维度
+ * @return BatchKernel<T> 特化尺寸返回batch_fixed(), 否则返回batch_generic()
+ */
+template <typename T>
+BatchKernel<T> select_batch_kernel(size_t m, size_t n, size_t k)
+{
+  if (m != n || n != k) return batch_generic<T>;
+  switch (m)
+  {
+#define MM_BATCH_CASE(S)                                                     \
+  case S:                                                                    \
+    return batch_fixed<T, S, S, S>;
+    MM_BATCH_SIZES(MM_BATCH_CASE)
+#undef MM_BATCH_CASE
+    default:
+      return batch_generic<T>;
+  }
+}
+
+/**
+ * @brief 批量小矩阵乘法的参考实现, 用于结果验证
+ *
+ * 与被测的batch_fixed()和batch_generic()相互独立: 每个矩阵包装为
+ * MatrixView, 按ijk顺序逐个元素求点积后写入C(覆盖而不是累加)
+ *
+ * @tparam T 元素类型
+ * @param batch 批量矩阵
+ * @param start 起始矩阵索引(包含)
+ * @param end 结束矩阵索引(不包含)
+ */
+template <typename T>
+void batch_reference(const SmallBatch<T> &batch, size_t start, size_t end)
+{
+  const size_t m = batch.m;
+  const size_t n = batch.n;
+  const size_t k = batch.k;
+  for (size_t p = start; p < end; p++)
+  {
+    const MatrixView<const T> a{batch.a + p * batch.stride_a, m, k, k};
+    const MatrixView<const T> b{batch.b + p * batch.stride_b, k, n, n};
+    const MatrixView<T> c{batch.c + p * batch.stride_c, m, n, n};
+    for (size_t i = 0; i < m; i++)
+    {
+      for (size_t j = 0; j < n; j++)
+      {
+        T sum = T(0);
+        for (size_t kk = 0; kk < k; kk++)
+        {
+          sum += a(i, kk) * b(kk, j);
+        }
+        c(i, j) = sum;
+      }
+    }
+  }
+}
+
+/**
+ * @brief 计算批量中相邻矩阵的间距
+ *
+ * @param rows 行数
+ * @param cols 列数
+ * @param element_size 元素大小(字节)
+ * @return size_t rows * cols向上取整到缓存行的元素个数
+ */
+size_t batch_stride(size_t rows, size_t cols, size_t element_size)
+{
+  const size_t line = std::max(MATRIX_ALIGNMENT / element_size, size_t(1));
+  return (rows * cols + line - 1) / line * line;
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_BATCH(T)                                              \
+  template BatchKernel<T> select_batch_kernel<T>(size_t, size_t, size_t);    \
+  template void batch_reference<T>(const SmallBatch<T> &, size_t, size_t);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_BATCH)
+#undef MM_INSTANTIATE_BATCH
@@ -0,0 +1,193 @@
+#include "MatrixMul.h"
+
+#if defined(__linux__)
+#  include <cerrno>
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#endif
+
+#if defined(__linux__)
+/**
+ * @brief 构造HW_CACHE类事件的config值
+ *
+ * @param cache 缓存类型, 例如PERF_COUNT_HW_CACHE_L1D
+ * @return uint64_t 读操作缺失事件的config
+ */
+static uint64_t cache_read_miss(uint64_t cache)
+{
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+         | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+/**
+ * @brief 打开一个只统计用户态的计数器
+ *
+ * @param type 事件类型(PERF_TYPE_*)
+ * @param config 事件编号
+ * @param group_fd 组长的文件描述符, -1表示自己是组长
+ * @return int 文件描述符, 失败时返回-1并设置errno
+ */
+static int open_counter(uint32_t type, uint64_t config, int group_fd)
+{
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+/**
+ * @brief 把perf_event_open的错误码转换为说明
+ */
+static string counter_error(int error)
+{
+  switch (error)
+  {
+    case EACCES:
+    case EPERM:
+      return "权限不足, 请检查/proc/sys/kernel/perf_event_paranoid"
+             "或容器的seccomp配置";
+    case ENOENT:
+    case EOPNOTSUPP:
+      return "CPU或虚拟机没有暴露硬件计数器";
+    case ENOSYS:
+      return "内核不支持perf_event_open";
+    default:
+      return strerror(error);
+  }
+}
+#endif
+
+/**
+ * @brief 打开硬件计数器组
+ *
+ * 依次打开CPU周期(组长)、退休指令、L1D读缺失、末级缓存缺失和dTLB读缺失。
+ * 组长打开失败时整个组不可用; 其他事件打开失败时只有该事件不可用。
+ * 只统计用户态, 在perf_event_paranoid=2的默认配置下无需特权。
+ */
+PerfCounters::PerfCounters()
+{
+  for (size_t e = 0; e < EVENT_COUNT; e++)
+  {
+    fds[e] = -1;
+    start_values[e][0] = start_values[e][1] = start_values[e][2] = 0;
+  }
+#if defined(__linux__)
+  fds[0] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+  if (fds[0] < 0)
+  {
+    error_message = counter_error(errno);
+    return;
+  }
+  fds[1] = open_counter(
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, fds[0]);
+  fds[2] = open_counter(PERF_TYPE_HW_CACHE,
+                        cache_read_miss(PERF_COUNT_HW_CACHE_L1D),
+                        fds[0]);
+  // 通用的cache-misses事件在x86和大多数ARM核心上对应末级缓存缺失
+  fds[3] = open_counter(
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, fds[0]);
+  fds[4] = open_counter(PERF_TYPE_HW_CACHE,
+                        cache_read_miss(PERF_COUNT_HW_CACHE_DTLB),
+                        fds[0]);
+#else
+  error_message = "仅Linux支持硬件计数器";
+#endif
+}
+
+/**
+ * @brief 关闭所有已打开的计数器
+ */
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+  for (int fd : fds)
+  {
+    if (fd >= 0) close(fd);
+  }
+#endif
+}
+
+bool PerfCounters::available() const
+{
+  return fds[0] >= 0;
+}
+
+const string &PerfCounters::error() const
+{
+  return error_message;
+}
+
+/**
+ * @brief 记录起始读数并启动计数器组
+ *
+ * 计数器只在start()和stop()之间运行; 起始读数用于计算差值,
+ * 因为复位操作不会清零启用和运行时间
+ */
+void PerfCounters::start()
+{
+#if defined(__linux__)
+  if (!available()) return;
+  for (size_t e = 0; e < EVENT_COUNT; e++)
+  {
+    if (fds[e] < 0) continue;
+    if (read(fds[e], start_values[e], sizeof(start_values[e]))
+        != static_cast<ssize_t>(sizeof(start_values[e])))
+    {
+      start_values[e][0] = start_values[e][1] = start_values[e][2] = 0;
+    }
+  }
+  ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+/**
+ * @brief 停止计数器组并累加本次区间的读数
+ *
+ * 读取父计数器时内核会汇总所有继承的子计数器, 包括已退出的线程。
+ * 事件被多路复用时按启用时间/运行时间比例换算; 从未运行的事件记为NaN。
+ */
+void PerfCounters::stop(CounterReadings &readings)
+{
+#if defined(__linux__)
+  if (!available()) return;
+  ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  double *targets[EVENT_COUNT] = {&readings.cycles,
+                                  &readings.instructions,
+                                  &readings.l1d_misses,
+                                  &readings.llc_misses,
+                                  &readings.dtlb_misses};
+  for (size_t e = 0; e < EVENT_COUNT; e++)
+  {
+    double value = NAN;
+    uint64_t current[3] = {0, 0, 0};
+    if (fds[e] >= 0
+        && read(fds[e], current, sizeof(current))
+               == static_cast<ssize_t>(sizeof(current)))
+    {
+      const uint64_t enabled = current[1] - start_values[e][1];
+      const uint64_t running = current[2] - start_values[e][2];
+      if (running > 0)
+      {
+        value = static_cast<double>(current[0] - start_values[e][0])
+                * static_cast<double>(enabled)
+                / static_cast<double>(running);
+      }
+    }
+    // 首次累加时替换初始的NaN
+    *targets[e] = readings.samples == 0 ? value : *targets[e] + value;
+  }
+  readings.samples++;
+#else
+  (void)readings;
+#endif
+}
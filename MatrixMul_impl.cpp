@@ -1,20 +1,88 @@
 #include "MatrixMul.h"
 
+#include <bitset>
+
+/// 共享缓存的参与线程数, 由set_blocking_threads()设置
+static std::atomic<size_t> blocking_threads{1};
+
 /**
- * @brief 获取CPU缓存信息
+ * @brief 解析sysfs中的缓存容量字符串
+ *
+ * @param text 容量字符串, 例如"48K"、"2048K"或"32M"
+ * @return size_t 字节数, 无法解析时为0
+ */
+static size_t parse_cache_size(string text)
+{
+  if (text.empty()) return 0;
+  size_t multiplier = 1;
+  switch (text.back())
+  {
+    case 'K':
+      multiplier = 1024;
+      text.pop_back();
+      break;
+    case 'M':
+      multiplier = 1024 * 1024;
+      text.pop_back();
+      break;
+    case 'G':
+      multiplier = 1024 * 1024 * 1024;
+      text.pop_back();
+      break;
+  }
+  return static_cast<size_t>(strtoull(text.c_str(), nullptr, 10)) * multiplier;
+}
+
+/**
+ * @brief 按级别和类型把一个缓存记录到CacheInfo的汇总字段
+ *
+ * L1只取数据缓存或统一缓存, 指令缓存只保留在levels列表中
+ *
+ * @param cache 缓存信息
+ * @param entry 单个缓存的描述
+ */
+static void record_cache_level(CacheInfo &cache, const CacheLevel &entry)
+{
+  cache.levels.push_back(entry);
+  if (entry.type == "Instruction" || entry.size == 0) return;
+  switch (entry.level)
+  {
+    case 1:
+      cache.l1_cache_size = entry.size;
+      if (entry.line_size != 0) cache.line_size = entry.line_size;
+      break;
+    case 2:
+      cache.l2_cache_size = entry.size;
+      cache.l2_shared_cpus = std::max(entry.shared_cpus, size_t(1));
+      break;
+    case 3:
+      cache.l3_cache_size = entry.size;
+      cache.l3_shared_cpus = std::max(entry.shared_cpus, size_t(1));
+      break;
+  }
+}
+
+/**
+ * @brief 检测CPU缓存信息
  *
  * 跨平台获取CPU的L1、L2、L3缓存大小和缓存行大小信息。
  * 支持Windows、Linux和macOS系统, 采用不同的系统API实现:
- * - Windows: 使用GetLogicalProcessorInformation API
- * - Linux: 读取/sys/devices/system/cpu/目录下的缓存信息文件
+ * - Windows: 使用GetLogicalProcessorInformation API,
+ *   由ProcessorMask统计共享CPU数
+ * - Linux: 遍历/sys/devices/system/cpu/cpu0/cache/下的每个indexN,
+ *   读取level、type、size、coherency_line_size和shared_cpu_list,
+ *   不假设index0一定是L1数据缓存
  * - macOS: 使用sysctlbyname系统调用
  *
+ * 没有L3缓存的系统(部分ARM处理器)以L2作为最后一级缓存。
+ *
  * @return CacheInfo 包含缓存层次结构信息的结构体
  * @see CacheInfo
  */
-CacheInfo get_cache_info()
+static CacheInfo discover_cache_info()
 {
   CacheInfo cache;
+  bool found_l3 = false;
 
 #ifdef _WIN32
   // Windows 实现
@@ -30,87 +98,66 @@ CacheInfo get_cache_info()
     {
       for (const auto &info : buffer)
       {
-        if (info.Relationship == RelationCache)
+        if (info.Relationship != RelationCache) continue;
+        CacheLevel entry;
+        entry.level = info.Cache.Level;
+        entry.type = info.Cache.Type == CacheInstruction ? "Instruction"
+                     : info.Cache.Type == CacheData      ? "Data"
+                                                         : "Unified";
+
+        // 同一缓存按实例重复出现, 只记录第一个实例
+        bool seen = false;
+        for (const CacheLevel &known : cache.levels)
         {
-          switch (info.Cache.Level)
-          {
-            case 1:
-              cache.l1_cache_size = info.Cache.Size;
-              cache.line_size = info.Cache.LineSize;
-              break;
-            case 2:
-              cache.l2_cache_size = info.Cache.Size;
-              break;
-            case 3:
-              cache.l3_cache_size = info.Cache.Size;
-              break;
-          }
+          seen = seen
+                 || (known.level == entry.level && known.type == entry.type);
         }
+        if (seen) continue;
+
+        entry.size = info.Cache.Size;
+        entry.line_size = info.Cache.LineSize;
+        entry.shared_cpus =
+            std::bitset<64>(static_cast<unsigned long long>(
+                                info.ProcessorMask))
+                .count();
+        record_cache_level(cache, entry);
+        found_l3 = found_l3 || entry.level == 3;
       }
     }
   }
 
 #elif defined(__linux__)
-  // Linux 实现
-  std::ifstream file;
-
-  // 尝试读取L1缓存大小
-  file.open("/sys/devices/system/cpu/cpu0/cache/index0/size");
-  if (file.is_open())
+  // Linux 实现: 遍历cpu0的所有缓存索引
+  const string base = "/sys/devices/system/cpu/cpu0/cache/index";
+  for (int index = 0;; index++)
   {
-    std::string size_str;
-    file >> size_str;
-    file.close();
+    const string dir = base + std::to_string(index) + "/";
+    std::ifstream level_file(dir + "level");
+    if (!level_file.is_open()) break;
 
-    // 解析大小 (例如 "32K" 或 "256K")
-    if (!size_str.empty())
-    {
-      size_t multiplier = 1;
-      if (size_str.back() == 'K')
-      {
-        multiplier = 1024;
-        size_str.pop_back();
-      }
-      else if (size_str.back() == 'M')
-      {
-        multiplier = 1024 * 1024;
-        size_str.pop_back();
-      }
-      cache.l1_cache_size = std::stoi(size_str) * multiplier;
-    }
-  }
+    CacheLevel entry;
+    level_file >> entry.level;
 
-  // 尝试读取L2缓存大小
-  file.open("/sys/devices/system/cpu/cpu0/cache/index2/size");
-  if (file.is_open())
-  {
-    std::string size_str;
-    file >> size_str;
-    file.close();
+    std::ifstream type_file(dir + "type");
+    type_file >> entry.type;
+
+    std::ifstream size_file(dir + "size");
+    string size_str;
+    size_file >> size_str;
+    entry.size = parse_cache_size(size_str);
+
+    std::ifstream line_file(dir + "coherency_line_size");
+    line_file >> entry.line_size;
 
-    if (!size_str.empty())
+    std::ifstream shared_file(dir + "shared_cpu_list");
+    string shared;
+    if (std::getline(shared_file, shared))
     {
-      size_t multiplier = 1;
-      if (size_str.back() == 'K')
-      {
-        multiplier = 1024;
-        size_str.pop_back();
-      }
-      else if (size_str.back() == 'M')
-      {
-        multiplier = 1024 * 1024;
-        size_str.pop_back();
-      }
-      cache.l2_cache_size = std::stoi(size_str) * multiplier;
+      entry.shared_cpus = std::max(parse_cpu_list(shared).size(), size_t(1));
     }
-  }
 
-  // 尝试读取缓存行大小
-  file.open("/sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size");
-  if (file.is_open())
-  {
-    file >> cache.line_size;
-    file.close();
+    record_cache_level(cache, entry);
+    found_l3 = found_l3 || entry.level == 3;
   }
 
 #elif defined(__APPLE__)
@@ -134,8 +181,10 @@ CacheInfo get_cache_info()
 
   // 获取L3缓存大小
   size = sizeof(size_t);
-  if (sysctlbyname("hw.l3cachesize", &cache.l3_cache_size, &size, NULL, 0)
-      != 0)
+  found_l3 =
+      sysctlbyname("hw.l3cachesize", &cache.l3_cache_size, &size, NULL, 0)
+      == 0;
+  if (!found_l3)
   {
     cache.l3_cache_size = 8388608; // 默认8MB
   }
@@ -146,41 +195,150 @@ CacheInfo get_cache_info()
   {
     cache.line_size = 64; // 默认64字节
   }
+
+  // 获取共享L2的CPU数(Apple Silicon按性能核簇共享L2)
+  uint32_t cpus_per_l2 = 0;
+  size = sizeof(cpus_per_l2);
+  if (sysctlbyname("hw.perflevel0.cpusperl2", &cpus_per_l2, &size, NULL, 0)
+          == 0
+      && cpus_per_l2 > 0)
+  {
+    cache.l2_shared_cpus = cpus_per_l2;
+  }
+
+  const CacheLevel apple_levels[] = {
+      {1, "Data", cache.l1_cache_size, cache.line_size, 1},
+      {2, "Unified", cache.l2_cache_size, cache.line_size,
+       cache.l2_shared_cpus},
+  };
+  cache.levels.assign(std::begin(apple_levels), std::end(apple_levels));
+  if (found_l3)
+  {
+    cache.levels.push_back(
+        {3, "Unified", cache.l3_cache_size, cache.line_size, 1});
+  }
 #endif
 
+  // 没有L3时以L2作为最后一级缓存
+  if (!found_l3 && !cache.levels.empty())
+  {
+    cache.l3_cache_size = cache.l2_cache_size;
+    cache.l3_shared_cpus = cache.l2_shared_cpus;
+  }
+
+  return cache;
+}
+
+/**
+ * @brief 获取CPU缓存信息
+ *
+ * 首次调用时检测并缓存结果, 之后直接返回, 可以在内核中频繁调用
+ *
+ * @return const CacheInfo& 包含缓存层次结构信息的结构体
+ * @see discover_cache_info()
+ */
+const CacheInfo &get_cache_info()
+{
+  static const CacheInfo cache = discover_cache_info();
   return cache;
 }
 
+/**
+ * @brief 设置共享缓存的参与线程数
+ *
+ * @param num_threads 多线程测试的线程数, 0按1处理
+ */
+void set_blocking_threads(size_t num_threads)
+{
+  blocking_threads.store(std::max(num_threads, size_t(1)));
+}
+
+/**
+ * @brief 计算当前线程可用的缓存份额
+ *
+ * 同时使用该缓存的线程数取参与线程数和共享CPU数中较小的一个,
+ * 缓存容量按此平分
+ *
+ * @param cache_size 缓存容量(字节)
+ * @param shared_cpus 共享该缓存的逻辑CPU数
+ * @return size_t 平分后的容量(字节)
+ */
+size_t cache_share(size_t cache_size, size_t shared_cpus)
+{
+  size_t sharers = std::min(blocking_threads.load(), shared_cpus);
+  return cache_size / std::max(sharers, size_t(1));
+}
+
+/**
+ * @brief 计算分块ikj内核的三级分块参数
+ *
+ * 在L1分块之上增加两级分块：
+ * 1. L2面板: 对固定的i块和k块, j方向遍历的l1_tile行C面板与l1_tile行B面板
+ *    占用L2份额的一半, 使C面板在k块之间保持在L2中
+ * 2. L3块: l3_block x l2_panel的B块占用L3份额的一半,
+ *    在A的所有i块之间复用而不必从内存重新读取
+ *
+ * 结果对齐到l1_tile的倍数且不小于l1_tile。
+ *
+ * @param element_size 元素字节数
+ * @param l1_tile L1分块边长
+ * @return CacheBlocking 分块参数
+ * @see cache_share()
+ */
+CacheBlocking calculate_cache_blocking(size_t element_size, size_t l1_tile)
+{
+  const CacheInfo &cache = get_cache_info();
+  CacheBlocking blocking;
+  const size_t tile = std::max(l1_tile, size_t(1));
+  blocking.l1_tile = tile;
+
+  size_t l2 = cache_share(cache.l2_cache_size, cache.l2_shared_cpus);
+  size_t panel = (l2 / 2) / (2 * tile * element_size);
+  panel -= panel % tile;
+  blocking.l2_panel = std::max(panel, tile);
+
+  size_t l3 = cache_share(cache.l3_cache_size, cache.l3_shared_cpus);
+  size_t depth = (l3 / 2) / (blocking.l2_panel * element_size);
+  depth -= depth % tile;
+  blocking.l3_block = std::max(depth, tile);
+
+  return blocking;
+}
+
 /**
  * @brief 计算最优的矩阵分块大小
  *
  * 基于CPU缓存信息自动计算矩阵乘法的最优块大小。算法考虑以下因素：
  * 1. 使用L1缓存大小的1/3(因为矩阵乘法需要访问三个矩阵块)
- * 2. 根据int类型大小(4字节)计算可存储的元素数量
+ * 2. 根据元素大小(int为4字节, double为8字节)计算可存储的元素数量
  * 3. 计算正方形矩阵块的边长
  * 4. 对齐到缓存行大小的倍数以优化内存访问
  * 5. 限制在合理范围内(32-512)
  *
+ * 该值是三级分块中的L1分块边长, L2、L3两级由calculate_cache_blocking()推导。
+ *
+ * @param element_size 元素字节数
  * @return size_t 计算得出的最优块大小
  * @see CacheInfo
  * @see get_cache_info()
+ * @see calculate_cache_blocking()
  */
-size_t calculate_optimal_block_size()
+size_t calculate_optimal_block_size(size_t element_size)
 {
-  CacheInfo cache = get_cache_info();
+  const CacheInfo &cache = get_cache_info();
 
   // 使用L1缓存大小的一部分来计算块大小
   // 考虑到矩阵乘法需要访问三个矩阵块, 我们使用L1缓存的1/3
   size_t available_cache = cache.l1_cache_size / 3;
 
-  // 每个元素是int类型(4字节), 计算可以存储多少个元素
-  size_t elements_per_cache = available_cache / sizeof(int);
+  // 计算可以存储多少个元素
+  size_t elements_per_cache = available_cache / element_size;
 
   // 计算正方形矩阵块的边长
   size_t block_size = static_cast<size_t>(sqrt(elements_per_cache));
 
   // 确保块大小是缓存行大小的倍数, 以优化内存访问
-  size_t line_elements = cache.line_size / sizeof(int);
+  size_t line_elements = cache.line_size / element_size;
   block_size =
       ((block_size + line_elements - 1) / line_elements) * line_elements;
 
@@ -191,6 +349,64 @@ size_t calculate_optimal_block_size()
   return block_size;
 }
 
+/**
+ * @brief 获取元素类型的字节数
+ *
+ * @param dtype 元素类型
+ * @return size_t 字节数
+ */
+size_t dtype_size(DataType dtype)
+{
+  switch (dtype)
+  {
+    case DataType::F32:
+      return sizeof(float);
+    case DataType::F64:
+      return sizeof(double);
+    case DataType::I32:
+      return sizeof(int);
+    case DataType::I64:
+      return sizeof(int64_t);
+  }
+  return sizeof(int);
+}
+
+/**
+ * @brief 获取元素类型的名称
+ *
+ * @param dtype 元素类型
+ * @return const char* 与--dtype参数一致的名称
+ */
+const char *dtype_name(DataType dtype)
+{
+  switch (dtype)
+  {
+    case DataType::F32:
+      return "f32";
+    case DataType::F64:
+      return "f64";
+    case DataType::I32:
+      return "i32";
+    case DataType::I64:
+      return "i64";
+  }
+  return "i32";
+}
+
+/**
+ * @brief 获取吞吐量单位
+ *
+ * 浮点类型每秒执行的是浮点运算(GFLOPS), 整数类型则是整数运算(GOPS)
+ *
+ * @param dtype 元素类型
+ * @return const char* 单位名称
+ */
+const char *throughput_unit(DataType dtype)
+{
+  return (dtype == DataType::F32 || dtype == DataType::F64) ? "GFLOPS"
+                                                            : "GOPS";
+}
+
 /**
  * @brief 获取系统CPU核心数
  *
@@ -233,80 +449,303 @@ size_t get_cpu_cores()
 }
 
 /**
- * @brief 打印详细的系统信息
+ * @brief 获取CPU型号字符串
  *
- * 显示当前系统的硬件和软件信息, 包括：
- * - CPU核心数和硬件并发数
- * - 操作系统类型(Windows/Linux/macOS)
- * - C++标准版本
- * - CPU架构(x86/x86_64/ARM/ARM64)
- * - 各级缓存大小(L1/L2/L3)
- * - 缓存行大小
- * - 自动计算的最优块大小
+ * - Linux: 读取/proc/cpuinfo的"model name"字段, ARM没有该字段时
+ *   依次使用"Hardware"和"CPU part"
+ * - macOS: 使用sysctlbyname("machdep.cpu.brand_string")
+ * - Windows: 使用PROCESSOR_IDENTIFIER环境变量
  *
- * 这些信息有助于理解性能测试结果和优化参数选择。
+ * 结果作为调优缓存的键, 不同型号的机器使用各自的调优参数
  *
- * @see get_cpu_cores()
- * @see get_cache_info()
- * @see calculate_optimal_block_size()
+ * @return string CPU型号, 无法获取时为"unknown"
  */
-void print_system_info()
+string cpu_model_name()
 {
-  cout << "=== 系统信息 ===" << endl;
-  cout << "CPU 核心数: " << get_cpu_cores() << endl;
-  cout << "硬件并发数: " << std::thread::hardware_concurrency() << endl;
+  string model;
+#ifdef _WIN32
+  const char *identifier = getenv("PROCESSOR_IDENTIFIER");
+  if (identifier != nullptr) model = identifier;
+#elif defined(__linux__)
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  string line;
+  const char *keys[] = {"model name", "Hardware", "CPU part"};
+  string found[3];
+  while (std::getline(cpuinfo, line))
+  {
+    size_t colon = line.find(':');
+    if (colon == string::npos) continue;
+    for (size_t k = 0; k < 3; k++)
+    {
+      if (found[k].empty() && line.compare(0, strlen(keys[k]), keys[k]) == 0)
+      {
+        size_t begin = line.find_first_not_of(" \t", colon + 1);
+        if (begin != string::npos) found[k] = line.substr(begin);
+      }
+    }
+  }
+  for (const string &value : found)
+  {
+    if (model.empty()) model = value;
+  }
+#elif defined(__APPLE__)
+  char brand[256] = {};
+  size_t size = sizeof(brand);
+  if (sysctlbyname("machdep.cpu.brand_string", brand, &size, NULL, 0) == 0)
+  {
+    model = brand;
+  }
+#endif
+  return model.empty() ? "unknown" : model;
+}
+
+/**
+ * @brief 收集系统信息
+ *
+ * 操作系统和CPU架构在编译时确定, 其余信息在运行时检测
+ *
+ * @return SystemInfo 系统信息
+ * @see print_system_info()
+ */
+SystemInfo collect_system_info()
+{
+  SystemInfo info;
+  info.cpu_model = cpu_model_name();
+  info.cpu_cores = get_cpu_cores();
+  info.hardware_concurrency = std::thread::hardware_concurrency();
 
 #ifdef _WIN32
-  cout << "操作系统: Windows" << endl;
+  info.os = "Windows";
 #elif defined(__linux__)
-  cout << "操作系统: Linux" << endl;
+  info.os = "Linux";
 #elif defined(__APPLE__)
-  cout << "操作系统: macOS" << endl;
+  info.os = "macOS";
 #else
-  cout << "操作系统: 未知" << endl;
+  info.os = "unknown";
 #endif
 
 #ifdef __cplusplus
-  cout << "C++ 标准: " << __cplusplus << endl;
+  info.cplusplus = __cplusplus;
 #endif
 
-  // 显示CPU架构信息
 #if defined(__x86_64__) || defined(_M_X64)
-  cout << "CPU 架构: x86_64" << endl;
+  info.arch = "x86_64";
 #elif defined(__i386__) || defined(_M_IX86)
-  cout << "CPU 架构: x86" << endl;
+  info.arch = "x86";
 #elif defined(__aarch64__) || defined(_M_ARM64)
-  cout << "CPU 架构: ARM64" << endl;
+  info.arch = "ARM64";
 #elif defined(__arm__) || defined(_M_ARM)
-  cout << "CPU 架构: ARM" << endl;
+  info.arch = "ARM";
 #else
-  cout << "CPU 架构: 未知" << endl;
+  info.arch = "unknown";
 #endif
 
+  info.cache = get_cache_info();
+  info.optimal_block_size = calculate_optimal_block_size();
+  const SimdIsa isas[] = {SimdIsa::AVX512, SimdIsa::AVX2, SimdIsa::NEON};
+  for (SimdIsa isa : isas)
+  {
+    if (simd_isa_supported(isa))
+    {
+      info.simd_supported.push_back(simd_isa_name(isa));
+    }
+  }
+  info.simd_supported.push_back(simd_isa_name(SimdIsa::Scalar));
+  info.simd_active = simd_isa_name(active_simd_isa());
+  info.numa = get_numa_topology();
+  return info;
+}
+
+/**
+ * @brief 打印详细的系统信息
+ *
+ * 显示当前系统的硬件和软件信息, 包括：
+ * - CPU型号、核心数和硬件并发数
+ * - 操作系统类型(Windows/Linux/macOS)
+ * - C++标准版本
+ * - CPU架构(x86/x86_64/ARM/ARM64)
+ * - 各级缓存大小(L1/L2/L3)
+ * - 缓存行大小
+ * - 每个缓存的级别、类型、容量和共享CPU数
+ * - 自动计算的最优块大小
+ * - 运行时检测到的SIMD指令集及打包GEMM选用的指令集
+ * - NUMA节点及每个节点的CPU列表
+ *
+ * 这些信息有助于理解性能测试结果和优化参数选择。
+ *
+ * @see collect_system_info()
+ */
+void print_system_info()
+{
+  const SystemInfo info = collect_system_info();
+  cout << "=== 系统信息 ===" << endl;
+  cout << "CPU 型号: " << info.cpu_model << endl;
+  cout << "CPU 核心数: " << info.cpu_cores << endl;
+  cout << "硬件并发数: " << info.hardware_concurrency << endl;
+  cout << "操作系统: " << (info.os == "unknown" ? "未知" : info.os) << endl;
+  if (info.cplusplus != 0)
+  {
+    cout << "C++ 标准: " << info.cplusplus << endl;
+  }
+  cout << "CPU 架构: " << (info.arch == "unknown" ? "未知" : info.arch)
+       << endl;
+
   // 显示缓存信息
-  CacheInfo cache = get_cache_info();
+  const CacheInfo &cache = info.cache;
+  for (const CacheLevel &level : cache.levels)
+  {
+    cout << "缓存 L" << level.level << " " << level.type << ": "
+         << (level.size / 1024) << " KB, 行 " << level.line_size
+         << " 字节, 共享CPU数 " << level.shared_cpus << endl;
+  }
   cout << "L1 缓存大小: " << (cache.l1_cache_size / 1024) << " KB" << endl;
   cout << "L2 缓存大小: " << (cache.l2_cache_size / 1024) << " KB" << endl;
   cout << "L3 缓存大小: " << (cache.l3_cache_size / 1024 / 1024) << " MB"
        << endl;
   cout << "缓存行大小: " << cache.line_size << " 字节" << endl;
-  cout << "最优块大小: " << calculate_optimal_block_size() << endl;
+  cout << "最优块大小: " << info.optimal_block_size << endl;
+
+  // 显示SIMD指令集
+  cout << "支持的SIMD指令集:";
+  for (const string &isa : info.simd_supported)
+  {
+    cout << " " << isa;
+  }
+  cout << endl;
+  cout << "选用的SIMD指令集: " << info.simd_active << endl;
+
+  // 显示NUMA拓扑
+  const NumaTopology &topology = info.numa;
+  cout << "NUMA 节点数: " << topology.node_ids.size() << endl;
+  for (size_t n = 0; n < topology.node_ids.size(); n++)
+  {
+    const vector<int> &cpus = topology.node_cpus[n];
+    cout << "  node" << topology.node_ids[n] << ": " << cpus.size()
+         << " 个CPU";
+    // 把连续的CPU编号合并为区间输出, 与cpulist格式一致
+    for (size_t k = 0; k < cpus.size();)
+    {
+      size_t end = k + 1;
+      while (end < cpus.size() && cpus[end] == cpus[end - 1] + 1) end++;
+      cout << (k == 0 ? " [" : ",") << cpus[k];
+      if (end - k > 1) cout << "-" << cpus[end - 1];
+      k = end;
+    }
+    cout << (cpus.empty() ? "" : "]") << endl;
+  }
 
   cout << "==================" << endl << endl;
 }
 
+/**
+ * @brief 解析逗号分隔的正整数列表
+ *
+ * 结果按升序排列并去掉重复值; 任何一项不是正整数时打印错误并退出
+ *
+ * @param text 参数值, 例如"512,1024,2048"
+ * @param option 选项名, 用于错误信息
+ * @return vector<size_t> 解析结果
+ */
+static vector<size_t> parse_size_list(const char *text, const char *option)
+{
+  vector<size_t> values;
+  std::stringstream stream(text);
+  string item;
+  while (std::getline(stream, item, ','))
+  {
+    if (item.empty()) continue;
+    char *end = nullptr;
+    const unsigned long long value = strtoull(item.c_str(), &end, 10);
+    if (*end != '\0' || value == 0 || item[0] == '-')
+    {
+      cerr << option << "的取值无效: " << item << endl;
+      exit(1);
+    }
+    values.push_back(static_cast<size_t>(value));
+  }
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  return values;
+}
+
+/**
+ * @brief 解析"MxNxK"形式的问题形状
+ *
+ * 三个维度都必须是正整数, 否则打印错误并退出
+ *
+ * @param text 参数值, 例如"65536x256x256"
+ * @param config 写入shape_m、shape_n和shape_k
+ */
+static void parse_shape(const char *text, BenchmarkConfig &config)
+{
+  size_t *dims[3] = {&config.shape_m, &config.shape_n, &config.shape_k};
+  const char *cursor = text;
+  for (size_t d = 0; d < 3; d++)
+  {
+    char *end = nullptr;
+    const unsigned long long value = strtoull(cursor, &end, 10);
+    const char expected = d < 2 ? 'x' : '\0';
+    if (end == cursor || *cursor == '-' || value == 0 || *end != expected)
+    {
+      cerr << "--shape的取值无效: " << text << " (格式为MxNxK)" << endl;
+      exit(1);
+    }
+    *dims[d] = static_cast<size_t>(value);
+    cursor = end + 1;
+  }
+}
+
 /**
  * @brief 解析和处理命令行参数
  *
  * 解析程序的命令行参数并设置基准测试的各项配置。支持的参数包括：
  * - -s, --size: 矩阵大小
+ * - -M, --rows / -N, --cols / -K, --inner: 矩形问题C(MxN) += A(MxK) * B(KxN)
+ *   的各个维度, 未指定的维度使用-s
+ * - --shape: 以MxNxK形式同时指定三个维度
+ * - --batch: 批量小矩阵乘法的矩阵个数, 每个矩阵的维度由-s或-M/-N/-K指定
+ * - --sparse: 稀疏矩阵A(M x K)的密度, 测量CSR/BSR的SpMV和SpMM并与稠密对比
+ * - --structure: 稀疏矩阵非零元的分布(uniform、banded或powerlaw)
+ * - --bsr-block: BSR格式的块边长(2、4、8或16)
+ * - --ooc: 核外模式的矩阵文件目录, A、B、C以mmap映射并分块流式计算
+ * - --ooc-memory: 核外模式内存工作集的上限(MB)
+ * - --quant: 量化GEMM的输入类型(u8s8或s16s16), 与int32 GEMM对比
  * - -b, --block: 块大小(0表示自动计算)
  * - -t, --threads: 线程数(0表示自动检测)
- * - -i, --iterations: 迭代次数
+ * - -i, --iterations: 计入统计的迭代次数
+ * - --warmup: 不计入统计的预热迭代次数
+ * - --ci-target: 中位数置信区间的相对宽度目标, 达到后停止迭代
+ * - --max-iterations: 指定--ci-target时的最多迭代次数
+ * - -p, --pad: 行跨度填充元素数(auto表示自动避开2的幂跨度)
+ * - -k, --kernel: 矩阵乘法内核(blocked、packed或strassen)
+ * - --cutoff: Strassen递归回退到分块内核的规模
+ * - --kernels: 逗号分隔的内核变体列表(all表示全部), 依次运行并对比性能
+ * - --list-kernels: 列出所有内核变体
+ * - -d, --dtype: 矩阵元素类型(f32、f64、i32或i64)
+ * - --isa: 打包GEMM微内核的SIMD指令集(auto表示运行时检测)
+ * - --pool: 多线程测试使用跨迭代复用的持久线程池
+ * - --parallel: 多线程测试的并行方式(optimized、simple或steal)
+ * - --tile: 工作窃取调度的分块边长(0表示自动计算)
+ * - --affinity: 工作线程绑核策略(compact、scatter或none)
+ * - --pages: 矩阵和工作区的页面类型(4k、thp或huge)
+ * - --autotune: 运行自动调优并把结果写入调优缓存
+ * - --tuning-cache: 调优缓存文件路径
+ * - --format: 结果格式(text、json或csv)
+ * - --output: 结果文件路径, 未指定--format时使用json
+ * - --counters: 用硬件性能计数器测量计时区域(仅Linux)
+ * - --verify: 多线程结果的验证方式(freivalds、exact或none)
+ * - --verify-rounds: Freivalds验证的随机向量个数
+ * - --tolerance: 浮点验证的相对容差
+ * - --skip-single: 跳过单线程测试
+ * - --roofline: 测量峰值算力、STREAM带宽和各级缓存, 按屋顶线模型评估结果
+ * - --sweep: 在同一进程内扫描规模、线程数和块大小
+ * - --sweep-sizes/--sweep-threads/--sweep-blocks: 逗号分隔的扫描列表,
+ *   指定任意一个即启用--sweep
  * - -v, --verbose: 详细输出模式
  * - -h, --help: 显示帮助信息
  *
- * 如果某些参数未指定或为0, 将自动使用系统检测的最优值。
+ * 如果某些参数未指定或为0, 优先使用调优缓存中与本机CPU型号、指令集、
+ * 元素类型和规模档位匹配的记录, 否则使用系统检测的最优值。
  *
  * @param argc 命令行参数个数
  * @param argv 命令行参数字符串数组
@@ -318,6 +757,8 @@ void print_system_info()
 BenchmarkConfig parse_args(int argc, char *argv[])
 {
   BenchmarkConfig config;
+  bool kernel_given = false;
+  bool format_given = false;
 
   for (int i = 1; i < argc; i++)
   {
@@ -328,106 +769,817 @@ BenchmarkConfig parse_args(int argc, char *argv[])
         config.matrix_size = static_cast<size_t>(atoi(argv[++i]));
       }
     }
-    else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--block") == 0)
+    else if (strcmp(argv[i], "-M") == 0 || strcmp(argv[i], "--rows") == 0)
     {
       if (i + 1 < argc)
       {
-        config.block_size = static_cast<size_t>(atoi(argv[++i]));
+        config.shape_m = static_cast<size_t>(atoi(argv[++i]));
       }
     }
-    else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0)
+    else if (strcmp(argv[i], "-N") == 0 || strcmp(argv[i], "--cols") == 0)
     {
       if (i + 1 < argc)
       {
-        config.num_threads = static_cast<size_t>(atoi(argv[++i]));
+        config.shape_n = static_cast<size_t>(atoi(argv[++i]));
       }
     }
-    else if (strcmp(argv[i], "-i") == 0
-             || strcmp(argv[i], "--iterations") == 0)
+    else if (strcmp(argv[i], "-K") == 0 || strcmp(argv[i], "--inner") == 0)
     {
       if (i + 1 < argc)
       {
-        config.iterations = static_cast<size_t>(atoi(argv[++i]));
+        config.shape_k = static_cast<size_t>(atoi(argv[++i]));
       }
     }
-    else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0)
+    else if (strcmp(argv[i], "--shape") == 0)
     {
-      config.verbose = true;
+      if (i + 1 < argc)
+      {
+        parse_shape(argv[++i], config);
+      }
     }
-    else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+    else if (strcmp(argv[i], "--batch") == 0)
     {
-      cout << "矩阵乘法性能测试程序" << endl;
-      cout << "用法: " << argv[0] << " [选项]" << endl;
-      cout << "选项:" << endl;
-      cout << "  -s, --size <N>       矩阵大小 (默认: 1024)" << endl;
-      cout << "  -b, --block <N>      块大小 (默认: 自动计算)" << endl;
-      cout << "  -t, --threads <N>    线程数 (默认: 自动检测)" << endl;
-      cout << "  -i, --iterations <N> 迭代次数 (默认: 1)" << endl;
-      cout << "  -v, --verbose        详细输出" << endl;
-      cout << "  -h, --help           显示帮助" << endl;
-      exit(0);
+      if (i + 1 < argc)
+      {
+        config.batch = static_cast<size_t>(atoi(argv[++i]));
+      }
     }
-  }
-
-  if (config.num_threads == 0)
-  {
-    config.num_threads = get_cpu_cores();
-  }
-
-  if (config.block_size == 0)
-  {
-    config.block_size = calculate_optimal_block_size();
-  }
-
-  return config;
-}
-
-/**
- * @brief 开始高精度计时
- *
- * 记录当前的高精度时间点作为计时的起始点。
- * 使用std::chrono::high_resolution_clock获得最高精度的时间测量。
- *
- * @see stop()
- * @see get_seconds()
- * @see get_microseconds()
- */
-void Timer::start()
-{
-  start_time = std::chrono::high_resolution_clock::now();
-}
-
-/**
- * @brief 停止高精度计时
+    else if (strcmp(argv[i], "--sparse") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.sparse_density = atof(argv[++i]);
+        if (!(config.sparse_density > 0.0 && config.sparse_density <= 1.0))
+        {
+          cerr << "--sparse的密度必须在(0, 1]范围内: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--structure") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        ++i;
+        const SparseStructure structures[] = {SparseStructure::Uniform,
+                                              SparseStructure::Banded,
+                                              SparseStructure::PowerLaw};
+        bool found = false;
+        for (SparseStructure structure : structures)
+        {
+          if (strcmp(argv[i], sparse_structure_name(structure)) == 0)
+          {
+            config.sparse_structure = structure;
+            found = true;
+          }
+        }
+        if (!found)
+        {
+          cerr << "未知稀疏结构: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--bsr-block") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.bsr_block = static_cast<size_t>(atoi(argv[++i]));
+        if (!bsr_block_supported(config.bsr_block))
+        {
+          cerr << "--bsr-block只支持2、4、8或16: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--ooc") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.ooc_dir = argv[++i];
+      }
+    }
+    else if (strcmp(argv[i], "--ooc-memory") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.ooc_memory_mb = static_cast<size_t>(atoi(argv[++i]));
+        if (config.ooc_memory_mb == 0)
+        {
+          cerr << "--ooc-memory必须为正整数(MB): " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--quant") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        ++i;
+        const QuantType types[] = {QuantType::U8S8, QuantType::S16S16};
+        bool found = false;
+        for (QuantType type : types)
+        {
+          if (strcmp(argv[i], quant_type_name(type)) == 0)
+          {
+            config.quant = type;
+            found = true;
+          }
+        }
+        if (!found)
+        {
+          cerr << "未知量化类型: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--block") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.block_size = static_cast<size_t>(atoi(argv[++i]));
+      }
+    }
+    else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.num_threads = static_cast<size_t>(atoi(argv[++i]));
+      }
+    }
+    else if (strcmp(argv[i], "-i") == 0
+             || strcmp(argv[i], "--iterations") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.iterations = static_cast<size_t>(atoi(argv[++i]));
+      }
+    }
+    else if (strcmp(argv[i], "--warmup") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.warmup = static_cast<size_t>(atoi(argv[++i]));
+      }
+    }
+    else if (strcmp(argv[i], "--ci-target") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.ci_target = atof(argv[++i]);
+      }
+    }
+    else if (strcmp(argv[i], "--max-iterations") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.max_iterations = static_cast<size_t>(atoi(argv[++i]));
+      }
+    }
+    else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--pad") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        ++i;
+        config.ld_padding =
+            strcmp(argv[i], "auto") == 0 ? -1 : atol(argv[i]);
+      }
+    }
+    else if (strcmp(argv[i], "-k") == 0 || strcmp(argv[i], "--kernel") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        ++i;
+        kernel_given = true;
+        if (strcmp(argv[i], "packed") == 0)
+        {
+          config.kernel = KernelType::Packed;
+        }
+        else if (strcmp(argv[i], "strassen") == 0)
+        {
+          config.kernel = KernelType::Strassen;
+        }
+        else if (strcmp(argv[i], "blocked") == 0)
+        {
+          config.kernel = KernelType::Blocked;
+        }
+        else
+        {
+          cerr << "未知内核: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--dtype") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        ++i;
+        const DataType dtypes[] = {
+            DataType::F32, DataType::F64, DataType::I32, DataType::I64};
+        bool found = false;
+        for (DataType dtype : dtypes)
+        {
+          if (strcmp(argv[i], dtype_name(dtype)) == 0)
+          {
+            config.dtype = dtype;
+            found = true;
+          }
+        }
+        if (!found)
+        {
+          cerr << "未知元素类型: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--isa") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        ++i;
+        const SimdIsa isas[] = {SimdIsa::Auto,
+                                SimdIsa::Scalar,
+                                SimdIsa::AVX2,
+                                SimdIsa::AVX512,
+                                SimdIsa::NEON};
+        bool found = false;
+        for (SimdIsa isa : isas)
+        {
+          if (strcmp(argv[i], simd_isa_name(isa)) == 0)
+          {
+            config.isa = isa;
+            found = true;
+          }
+        }
+        if (!found)
+        {
+          cerr << "未知指令集: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--pool") == 0)
+    {
+      config.use_pool = true;
+    }
+    else if (strcmp(argv[i], "--parallel") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        ++i;
+        const ParallelMode modes[] = {ParallelMode::Optimized,
+                                      ParallelMode::Simple,
+                                      ParallelMode::WorkStealing};
+        bool found = false;
+        for (ParallelMode mode : modes)
+        {
+          if (strcmp(argv[i], parallel_mode_name(mode)) == 0)
+          {
+            config.parallel = mode;
+            found = true;
+          }
+        }
+        if (!found)
+        {
+          cerr << "未知并行方式: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--tile") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.tile_size = static_cast<size_t>(atoi(argv[++i]));
+      }
+    }
+    else if (strcmp(argv[i], "--affinity") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        ++i;
+        const AffinityMode modes[] = {
+            AffinityMode::None, AffinityMode::Compact, AffinityMode::Scatter};
+        bool found = false;
+        for (AffinityMode mode : modes)
+        {
+          if (strcmp(argv[i], affinity_mode_name(mode)) == 0)
+          {
+            config.affinity = mode;
+            found = true;
+          }
+        }
+        if (!found)
+        {
+          cerr << "未知绑核策略: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--pages") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        ++i;
+        const PageMode modes[] = {
+            PageMode::Small, PageMode::Transparent, PageMode::Huge};
+        bool found = false;
+        for (PageMode mode : modes)
+        {
+          if (strcmp(argv[i], page_mode_name(mode)) == 0)
+          {
+            config.pages = mode;
+            found = true;
+          }
+        }
+        if (!found)
+        {
+          cerr << "未知页面类型: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--cutoff") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.strassen_cutoff = static_cast<size_t>(atoi(argv[++i]));
+      }
+    }
+    else if (strcmp(argv[i], "--kernels") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        std::stringstream stream(argv[++i]);
+        string name;
+        config.kernel_suite.clear();
+        while (std::getline(stream, name, ','))
+        {
+          if (name.empty()) continue;
+          if (name == "all")
+          {
+            for (const KernelVariant<int> &variant : kernel_variants<int>())
+            {
+              config.kernel_suite.push_back(variant.name);
+            }
+            continue;
+          }
+          if (find_kernel_variant<int>(name) == nullptr)
+          {
+            cerr << "未知内核变体: " << name << endl;
+            exit(1);
+          }
+          config.kernel_suite.push_back(name);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--list-kernels") == 0)
+    {
+      print_kernel_variants();
+      exit(0);
+    }
+    else if (strcmp(argv[i], "--autotune") == 0)
+    {
+      config.autotune = true;
+    }
+    else if (strcmp(argv[i], "--tuning-cache") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.tuning_cache = argv[++i];
+      }
+    }
+    else if (strcmp(argv[i], "--format") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        ++i;
+        format_given = true;
+        const OutputFormat formats[] = {
+            OutputFormat::Text, OutputFormat::Json, OutputFormat::Csv};
+        bool found = false;
+        for (OutputFormat format : formats)
+        {
+          if (strcmp(argv[i], output_format_name(format)) == 0)
+          {
+            config.format = format;
+            found = true;
+          }
+        }
+        if (!found)
+        {
+          cerr << "未知输出格式: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--output") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.output_file = argv[++i];
+      }
+    }
+    else if (strcmp(argv[i], "--counters") == 0)
+    {
+      config.counters = true;
+    }
+    else if (strcmp(argv[i], "--verify") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        ++i;
+        const VerifyMode modes[] = {
+            VerifyMode::Freivalds, VerifyMode::Exact, VerifyMode::None};
+        bool found = false;
+        for (VerifyMode mode : modes)
+        {
+          if (strcmp(argv[i], verify_mode_name(mode)) == 0)
+          {
+            config.verify = mode;
+            found = true;
+          }
+        }
+        if (!found)
+        {
+          cerr << "未知验证方式: " << argv[i] << endl;
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(argv[i], "--verify-rounds") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.verify_rounds = static_cast<size_t>(atoi(argv[++i]));
+      }
+    }
+    else if (strcmp(argv[i], "--tolerance") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.tolerance = atof(argv[++i]);
+      }
+    }
+    else if (strcmp(argv[i], "--skip-single") == 0)
+    {
+      config.skip_single = true;
+    }
+    else if (strcmp(argv[i], "--roofline") == 0)
+    {
+      config.roofline = true;
+    }
+    else if (strcmp(argv[i], "--sweep") == 0)
+    {
+      config.sweep = true;
+    }
+    else if (strcmp(argv[i], "--sweep-sizes") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.sweep_sizes = parse_size_list(argv[++i], "--sweep-sizes");
+        config.sweep = true;
+      }
+    }
+    else if (strcmp(argv[i], "--sweep-threads") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.sweep_threads = parse_size_list(argv[++i], "--sweep-threads");
+        config.sweep = true;
+      }
+    }
+    else if (strcmp(argv[i], "--sweep-blocks") == 0)
+    {
+      if (i + 1 < argc)
+      {
+        config.sweep_blocks = parse_size_list(argv[++i], "--sweep-blocks");
+        config.sweep = true;
+      }
+    }
+    else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0)
+    {
+      config.verbose = true;
+    }
+    else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+    {
+      cout << "矩阵乘法性能测试程序" << endl;
+      cout << "用法: " << argv[0] << " [选项]" << endl;
+      cout << "选项:" << endl;
+      cout << "  -s, --size <N>       矩阵大小 (默认: 1024)" << endl;
+      cout << "  -M, --rows <N>       A和C的行数M (默认: -s)" << endl;
+      cout << "  -N, --cols <N>       B和C的列数N (默认: -s)" << endl;
+      cout << "  -K, --inner <N>      公共维度K (默认: -s)" << endl;
+      cout << "  --shape <MxNxK>      同时指定三个维度, 如65536x256x256" << endl;
+      cout << "  --batch <N>          批量计算N个小矩阵乘法, 如--batch 100000 -s 8"
+           << endl;
+      cout << "  --sparse <density>   稀疏A的密度, 测量CSR/BSR的SpMV和SpMM, "
+              "如--sparse 0.01"
+           << endl;
+      cout << "  --structure <name>   稀疏结构: uniform, banded, powerlaw "
+              "(默认: uniform)"
+           << endl;
+      cout << "  --bsr-block <N>      BSR块边长: 2, 4, 8, 16 (默认: 4)" << endl;
+      cout << "  --ooc <dir>          核外模式: A、B、C存为dir中的文件并以mmap"
+              "分块计算"
+           << endl;
+      cout << "  --ooc-memory <MB>    核外模式的内存工作集上限 (默认: 256)"
+           << endl;
+      cout << "  --quant <type>       量化GEMM: u8s8, s16s16, int32累加并与"
+              "int32 GEMM对比"
+           << endl;
+      cout << "  -b, --block <N>      块大小 (默认: 自动计算)" << endl;
+      cout << "  -t, --threads <N>    线程数 (默认: 自动检测)" << endl;
+      cout << "  -i, --iterations <N> 计入统计的迭代次数 (默认: 1)" << endl;
+      cout << "  --warmup <N>         不计入统计的预热迭代次数 (默认: 1)"
+           << endl;
+      cout << "  --ci-target <x>      置信区间宽度/中位数不超过x时停止, "
+              "如0.02 (默认: 关闭)"
+           << endl;
+      cout << "  --max-iterations <N> 指定--ci-target时的最多迭代次数 "
+              "(默认: 100)"
+           << endl;
+      cout << "  -p, --pad <N|auto>   行跨度填充元素数 (默认: auto)" << endl;
+      cout << "  -k, --kernel <name>  内核: blocked, packed, strassen "
+              "(默认: blocked)"
+           << endl;
+      cout << "  --cutoff <N>         Strassen回退到分块内核的规模 (默认: 512)"
+           << endl;
+      cout << "  --kernels <a,b,...>  依次运行多个内核变体并对比 (all表示全部)"
+           << endl;
+      cout << "  --list-kernels       列出所有内核变体" << endl;
+      cout << "  -d, --dtype <type>   元素类型: f32, f64, i32, i64 (默认: i32)"
+           << endl;
+      cout << "  --isa <name>         SIMD指令集: auto, scalar, avx2, avx512, "
+              "neon (默认: auto)"
+           << endl;
+      cout << "  --pool               多线程测试使用持久线程池" << endl;
+      cout << "  --parallel <mode>    并行方式: optimized, simple, steal "
+              "(默认: optimized)"
+           << endl;
+      cout << "  --tile <N>           工作窃取的分块边长 (默认: 自动计算)"
+           << endl;
+      cout << "  --affinity <mode>    线程绑核: compact, scatter, none "
+              "(默认: none)"
+           << endl;
+      cout << "  --pages <mode>       矩阵和工作区的页面: 4k, thp, huge "
+              "(默认: thp)"
+           << endl;
+      cout << "  --autotune           搜索最优内核、块大小和线程数并写入调优缓存"
+           << endl;
+      cout << "  --tuning-cache <f>   调优缓存文件 (默认: "
+           << default_tuning_cache_path() << ")" << endl;
+      cout << "  --format <fmt>       结果格式: text, json, csv (默认: text)"
+           << endl;
+      cout << "  --output <file>      结果文件, 控制台仍输出文本 (默认格式: json)"
+           << endl;
+      cout << "  --counters           输出周期、IPC、缓存和TLB缺失等硬件计数器 "
+              "(仅Linux)"
+           << endl;
+      cout << "  --verify <mode>      结果验证: freivalds, exact, none "
+              "(默认: freivalds)"
+           << endl;
+      cout << "  --verify-rounds <N>  Freivalds验证的随机向量个数 (默认: 3)"
+           << endl;
+      cout << "  --tolerance <x>      浮点验证的相对容差 (默认: 64·sqrt(n)·ε)"
+           << endl;
+      cout << "  --skip-single        跳过单线程测试, 不输出加速比和效率" << endl;
+      cout << "  --roofline           测量峰值算力和内存带宽, 输出屋顶线占比"
+           << endl;
+      cout << "  --sweep              在同一进程内扫描规模×线程数×块大小, "
+              "矩阵只分配一次"
+           << endl;
+      cout << "  --sweep-sizes <list> 扫描的规模, 如512,1024,2048 (默认: -s)"
+           << endl;
+      cout << "  --sweep-threads <list> 扫描的线程数 (默认: 1,2,4...到-t)"
+           << endl;
+      cout << "  --sweep-blocks <list> 扫描的块大小 (默认: -b)" << endl;
+      cout << "  -v, --verbose        详细输出" << endl;
+      cout << "  -h, --help           显示帮助" << endl;
+      exit(0);
+    }
+  }
+
+  config.iterations = std::max(config.iterations, size_t(1));
+  if (config.shape_m == 0) config.shape_m = config.matrix_size;
+  if (config.shape_n == 0) config.shape_n = config.matrix_size;
+  if (config.shape_k == 0) config.shape_k = config.matrix_size;
+  const bool square =
+      config.shape_m == config.shape_n && config.shape_n == config.shape_k;
+  if (square) config.matrix_size = config.shape_m;
+  config.max_iterations = std::max(config.max_iterations, config.iterations);
+  config.verify_rounds = std::max(config.verify_rounds, size_t(1));
+
+  if (!config.output_file.empty() && !format_given)
+  {
+    config.format = OutputFormat::Json;
+  }
+  if (!config.output_file.empty() && config.format == OutputFormat::Text)
+  {
+    cerr << "--output需要json或csv格式" << endl;
+    exit(1);
+  }
+
+  if (!simd_isa_supported(config.isa))
+  {
+    cerr << "当前CPU不支持指令集: " << simd_isa_name(config.isa) << endl;
+    exit(1);
+  }
+  set_simd_isa(config.isa);
+  config.isa = active_simd_isa();
+  // 调优和测试的矩阵都在此之后分配
+  set_page_mode(config.pages);
+
+  // 未显式指定的参数优先使用本机的调优结果
+  if (config.tuning_cache.empty())
+  {
+    config.tuning_cache = default_tuning_cache_path();
+  }
+  TuningEntry key;
+  TuningEntry entry;
+  key.cpu_model = cpu_model_name();
+  key.isa = simd_isa_name(config.isa);
+  key.dtype = dtype_name(config.dtype);
+  key.size_class = size_class(config.matrix_size);
+  // 调优缓存按方阵规模分档, 矩形问题、批量、稀疏和核外模式不使用
+  if (!config.autotune && square && config.batch == 0
+      && config.sparse_density == 0.0 && config.ooc_dir.empty()
+      && load_tuning(config.tuning_cache, key, entry))
+  {
+    if (!kernel_given) config.kernel = entry.kernel;
+    if (config.block_size == 0) config.block_size = entry.block_size;
+    if (config.num_threads == 0) config.num_threads = entry.num_threads;
+    config.tuned = true;
+  }
+
+  if (config.num_threads == 0)
+  {
+    config.num_threads = get_cpu_cores();
+  }
+
+  if (config.block_size == 0)
+  {
+    config.block_size = calculate_optimal_block_size(dtype_size(config.dtype));
+  }
+  if (config.batch > 0
+      && (config.sweep || config.autotune || config.roofline
+          || !config.kernel_suite.empty()))
+  {
+    cerr << "--batch不能与--sweep、--autotune、--roofline或--kernels同时使用"
+         << endl;
+    exit(1);
+  }
+  if (config.sparse_density > 0.0
+      && (config.batch > 0 || config.sweep || config.autotune
+          || config.roofline || !config.kernel_suite.empty()))
+  {
+    cerr << "--sparse不能与--batch、--sweep、--autotune、--roofline或--kernels"
+            "同时使用"
+         << endl;
+    exit(1);
+  }
+  if (!config.ooc_dir.empty())
+  {
+    if (config.batch > 0 || config.sparse_density > 0.0 || config.sweep
+        || config.autotune || config.roofline || !config.kernel_suite.empty())
+    {
+      cerr << "--ooc不能与--batch、--sparse、--sweep、--autotune、--roofline"
+              "或--kernels同时使用"
+           << endl;
+      exit(1);
+    }
+    if (config.verify == VerifyMode::Exact)
+    {
+      cerr << "--ooc不计算单线程参考结果, 请使用--verify freivalds或none"
+           << endl;
+      exit(1);
+    }
+    // 核外模式只做多线程测试, 单线程在大规模下耗时过长
+    config.skip_single = true;
+  }
+  if (config.quant != QuantType::None)
+  {
+    if (config.batch > 0 || config.sparse_density > 0.0
+        || !config.ooc_dir.empty() || config.sweep || config.autotune
+        || config.roofline || !config.kernel_suite.empty())
+    {
+      cerr << "--quant不能与--batch、--sparse、--ooc、--sweep、--autotune、"
+              "--roofline或--kernels同时使用"
+           << endl;
+      exit(1);
+    }
+    // 对照路径是int32 GEMM, 元素类型只能为i32
+    if (config.dtype != DataType::I32)
+    {
+      cerr << "--quant的对照路径为int32, 不能与-d " << dtype_name(config.dtype)
+           << "同时使用" << endl;
+      exit(1);
+    }
+    if (config.shape_k > QUANT_MAX_DEPTH)
+    {
+      cerr << "--quant的公共维度K不能超过 " << QUANT_MAX_DEPTH
+           << " (int32累加可能溢出)" << endl;
+      exit(1);
+    }
+  }
+  if (!square && (config.sweep || config.autotune))
+  {
+    cerr << "--sweep和--autotune只支持方阵, 不能与-M/-N/-K或--shape的矩形形状"
+            "同时使用"
+         << endl;
+    exit(1);
+  }
+  if (config.sweep)
+  {
+    if (!config.kernel_suite.empty() || config.autotune)
+    {
+      cerr << "--sweep不能与--kernels或--autotune同时使用" << endl;
+      exit(1);
+    }
+    if (config.sweep_sizes.empty())
+    {
+      config.sweep_sizes.push_back(config.matrix_size);
+    }
+    if (config.sweep_blocks.empty())
+    {
+      config.sweep_blocks.push_back(config.block_size);
+    }
+    if (config.sweep_threads.empty())
+    {
+      for (size_t threads = 1; threads < config.num_threads; threads *= 2)
+      {
+        config.sweep_threads.push_back(threads);
+      }
+      config.sweep_threads.push_back(config.num_threads);
+    }
+  }
+  set_thread_affinity(config.affinity);
+  set_blocking_threads(config.num_threads);
+  set_strassen_cutoff(config.strassen_cutoff);
+
+  return config;
+}
+
+/**
+ * @brief 开始高精度计时
+ *
+ * 记录当前的高精度时间点作为计时的起始点。
+ * 使用单调的std::chrono::steady_clock, 不受系统时间调整影响;
+ * high_resolution_clock在部分平台上是system_clock的别名, 不适合计时。
+ *
+ * @see stop()
+ * @see get_seconds()
+ * @see get_nanoseconds()
+ */
+void Timer::start()
+{
+  start_time = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief 停止高精度计时
  *
  * 记录当前的高精度时间点作为计时的结束点。
  * 必须在调用start()之后调用, 用于计算时间间隔。
  *
  * @see start()
  * @see get_seconds()
- * @see get_microseconds()
+ * @see get_nanoseconds()
  */
 void Timer::stop()
 {
-  end_time = std::chrono::high_resolution_clock::now();
+  end_time = std::chrono::steady_clock::now();
 }
 
 /**
  * @brief 获取经过的时间(秒)
  *
  * 计算从start()到stop()之间经过的时间, 以秒为单位。
- * 提供高精度的时间测量, 适用于性能基准测试。
+ * 直接由时钟的原生精度(通常为纳秒)换算, 不先截断到微秒,
+ * 小矩阵的计时不会丢失精度。
  *
  * @return double 经过的时间, 单位为秒, 支持小数精度
  * @see start()
  * @see stop()
- * @see get_microseconds()
+ * @see get_nanoseconds()
  */
 double Timer::get_seconds() const
 {
-  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+  return std::chrono::duration<double>(end_time - start_time).count();
+}
+
+/**
+ * @brief 获取经过的时间(纳秒)
+ *
+ * @return long long 经过的时间, 单位为纳秒
+ * @see get_seconds()
+ */
+long long Timer::get_nanoseconds() const
+{
+  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
       end_time - start_time);
-  return static_cast<double>(duration.count()) / 1000000.0;
+  return duration.count();
 }
 
 /**
@@ -448,55 +1600,96 @@ long long Timer::get_microseconds() const
   return duration.count();
 }
 
+/**
+ * @brief 根据配置计算矩阵的行跨度
+ *
+ * ld_padding为负数时返回0, 由Matrix按缓存行对齐并避开页大小整数倍的跨度;
+ * 否则行跨度为列数加上指定的填充元素数。
+ *
+ * @param config 基准测试配置
+ * @param cols 矩阵列数
+ * @return size_t 行跨度, 0表示由Matrix自动选择
+ * @see default_leading_dimension()
+ */
+size_t configured_leading_dimension(const BenchmarkConfig &config,
+                                    size_t cols)
+{
+  if (config.ld_padding < 0) return 0;
+  return cols + static_cast<size_t>(config.ld_padding);
+}
+
 /**
  * @brief 分块矩阵乘法核心算法
  *
- * 实现高效的分块矩阵乘法算法, 支持指定行范围的计算。
+ * 实现高效的分块矩阵乘法算法, 计算任意子块: c += a * b。
  * 算法特点：
  * 1. 使用ikj循环顺序优化缓存访问模式
  * 2. 采用分块策略减少缓存miss
- * 3. 支持部分行范围计算, 便于并行处理
+ * 3. 通过矩阵视图支持任意行、列范围的子块计算, 便于并行处理
  * 4. 使用边界检查确保处理边缘情况
+ * 5. 三级分块: blockSize为L1分块, 外层再按L2列面板和L3深度块切分,
+ *    大矩阵的B面板超出L2时性能不会骤降
  *
  * 算法复杂度: O(n³), 其中n为矩阵大小
  *
- * @param src1 源矩阵1, 左操作数
- * @param src2 源矩阵2, 右操作数
- * @param dst 目标结果矩阵, 存储计算结果
+ * @tparam T 元素类型
+ * @param a 左操作数视图(c.rows() x K)
+ * @param b 右操作数视图(K x c.cols())
+ * @param c 结果子块视图
  * @param blockSize 分块大小, 影响缓存效率
- * @param start 起始行索引(包含)
- * @param end 结束行索引(不包含)
  *
- * @pre src1, src2, dst必须是相同大小的方阵
- * @pre start < end <= src1.size()
+ * @pre a.cols == b.rows, a.rows == c.rows, b.cols == c.cols
  * @pre blockSize > 0
  *
- * @note 使用累加操作(+=), 调用前需要确保dst已正确初始化
+ * @note 使用累加操作(+=), 调用前需要确保c已正确初始化
+ * @note 行指针使用__restrict修饰, 编译器无需考虑c与源矩阵的别名
+ * @see calculate_cache_blocking()
  */
-void matrix_mul(vector<vector<int>> &src1,
-                vector<vector<int>> &src2,
-                vector<vector<int>> &dst,
-                size_t blockSize,
-                size_t start,
-                size_t end)
+template <typename T>
+void matrix_mul_tile(MatrixView<const T> a,
+                     MatrixView<const T> b,
+                     MatrixView<T> c,
+                     size_t blockSize)
 {
-  // Perform matrix multiplication for the given block range using block ik
-  // method
-  for (size_t iblock = start; iblock < end; iblock += blockSize)
+  const size_t rows = c.rows;
+  const size_t inner = a.cols;
+  const size_t cols = c.cols;
+
+  const CacheBlocking blocking =
+      calculate_cache_blocking(sizeof(T), blockSize);
+
+  // L3块: B的[pc, pc_end) x [jc, jc_end)子块在所有i块之间复用
+  for (size_t jc = 0; jc < cols; jc += blocking.l2_panel)
   {
-    for (size_t kblock = 0; kblock < src2.size(); kblock += blockSize)
+    const size_t jc_end = min(jc + blocking.l2_panel, cols);
+    for (size_t pc = 0; pc < inner; pc += blocking.l3_block)
     {
-      for (size_t jblock = 0; jblock < dst.size(); jblock += blockSize)
+      const size_t pc_end = min(pc + blocking.l3_block, inner);
+
+      // Perform matrix multiplication for the given block range using block
+      // ikj method; C的blockSize x l2_panel面板在k块之间驻留L2
+      for (size_t iblock = 0; iblock < rows; iblock += blockSize)
       {
-        for (size_t i = iblock; i < min(iblock + blockSize, src1.size()); i++)
+        const size_t iend = min(iblock + blockSize, rows);
+        for (size_t kblock = pc; kblock < pc_end; kblock += blockSize)
         {
-          for (size_t k = kblock; k < min(kblock + blockSize, src2.size());
-               k++)
+          const size_t kend = min(kblock + blockSize, pc_end);
+          for (size_t jblock = jc; jblock < jc_end; jblock += blockSize)
           {
-            for (size_t j = jblock; j < min(jblock + blockSize, dst.size());
-                 j++)
+            const size_t jend = min(jblock + blockSize, jc_end);
+            for (size_t i = iblock; i < iend; i++)
             {
-              dst[i][j] += src1[i][k] * src2[k][j];
+              const T *__restrict a_row = a.row(i);
+              T *__restrict c_row = c.row(i);
+              for (size_t k = kblock; k < kend; k++)
+              {
+                const T a_ik = a_row[k];
+                const T *__restrict b_row = b.row(k);
+                for (size_t j = jblock; j < jend; j++)
+                {
+                  c_row[j] += a_ik * b_row[j];
+                }
+              }
             }
           }
         }
@@ -505,6 +1698,149 @@ void matrix_mul(vector<vector<int>> &src1,
   }
 }
 
+/**
+ * @brief 分块矩阵乘法(行范围)
+ *
+ * 计算dst的[start, end)行, 是matrix_mul_tile()在整行范围上的包装,
+ * 供按行划分的并行驱动函数使用。
+ *
+ * @tparam T 元素类型
+ * @param src1 源矩阵1, 左操作数
+ * @param src2 源矩阵2, 右操作数
+ * @param dst 目标结果矩阵, 存储计算结果
+ * @param blockSize 分块大小, 影响缓存效率
+ * @param start 起始行索引(包含)
+ * @param end 结束行索引(不包含)
+ *
+ * @pre src1.cols() == src2.rows(), dst的形状为src1.rows() x src2.cols()
+ * @pre start <= end <= src1.rows()
+ * @pre blockSize > 0
+ *
+ * @note 使用累加操作(+=), 调用前需要确保dst已正确初始化
+ * @see matrix_mul_tile()
+ */
+template <typename T>
+void matrix_mul(const Matrix<T> &src1,
+                const Matrix<T> &src2,
+                Matrix<T> &dst,
+                size_t blockSize,
+                size_t start,
+                size_t end)
+{
+  matrix_mul_tile(src1.tile(start, 0, end - start, src1.cols()),
+                  src2.view(),
+                  dst.tile(start, 0, end - start, dst.cols()),
+                  blockSize);
+}
+
+/**
+ * @brief 获取内核类型对应的内核函数
+ *
+ * @tparam T 元素类型
+ * @param type 内核类型
+ * @return GemmKernel<T> 内核函数指针, 可直接传给并行驱动函数
+ * @see matrix_mul()
+ * @see packed_matrix_mul()
+ * @see strassen_matrix_mul()
+ */
+template <typename T> GemmKernel<T> select_kernel(KernelType type)
+{
+  switch (type)
+  {
+    case KernelType::Packed:
+      return packed_matrix_mul<T>;
+    case KernelType::Strassen:
+      return strassen_matrix_mul<T>;
+    case KernelType::Blocked:
+      break;
+  }
+  return matrix_mul<T>;
+}
+
+/**
+ * @brief 获取内核类型的名称
+ *
+ * @param type 内核类型
+ * @return const char* 与-k参数一致的名称
+ */
+const char *kernel_name(KernelType type)
+{
+  switch (type)
+  {
+    case KernelType::Packed:
+      return "packed";
+    case KernelType::Strassen:
+      return "strassen";
+    case KernelType::Blocked:
+      break;
+  }
+  return "blocked";
+}
+
+/**
+ * @brief 获取并行方式的名称
+ *
+ * @param mode 并行方式
+ * @return const char* 与--parallel参数一致的名称
+ */
+const char *parallel_mode_name(ParallelMode mode)
+{
+  switch (mode)
+  {
+    case ParallelMode::Simple:
+      return "simple";
+    case ParallelMode::WorkStealing:
+      return "steal";
+    case ParallelMode::Optimized:
+      break;
+  }
+  return "optimized";
+}
+
+/**
+ * @brief 获取验证方式的名称
+ *
+ * @param mode 验证方式
+ * @return const char* 与--verify参数一致的名称
+ */
+const char *verify_mode_name(VerifyMode mode)
+{
+  switch (mode)
+  {
+    case VerifyMode::Exact:
+      return "exact";
+    case VerifyMode::None:
+      return "none";
+    case VerifyMode::Freivalds:
+      break;
+  }
+  return "freivalds";
+}
+
+/**
+ * @brief 获取内核类型对应的子块内核函数
+ *
+ * @tparam T 元素类型
+ * @param type 内核类型
+ * @return GemmTileKernel<T> 子块内核函数指针, 供二维分块调度使用
+ * @see matrix_mul_tile()
+ * @see packed_matrix_mul_tile()
+ * @see strassen_matrix_mul_tile()
+ */
+template <typename T> GemmTileKernel<T> select_tile_kernel(KernelType type)
+{
+  switch (type)
+  {
+    case KernelType::Packed:
+      return packed_matrix_mul_tile<T>;
+    case KernelType::Strassen:
+      return strassen_matrix_mul_tile<T>;
+    case KernelType::Blocked:
+      break;
+  }
+  return matrix_mul_tile<T>;
+}
+
 /**
  * @brief 简单的多线程矩阵乘法实现
  *
@@ -516,12 +1852,19 @@ void matrix_mul(vector<vector<int>> &src1,
  * - 每个线程处理一个连续的行块
  * - 所有线程并行执行, 最后统一等待完成
  *
+ * 传入线程池时不再为每个块创建线程, 而是由池中的线程通过原子计数器
+ * 依次领取行块。
+ *
+ * @tparam T 元素类型
  * @param matrix1 输入矩阵1(左操作数)
  * @param matrix2 输入矩阵2(右操作数)
  * @param result 结果矩阵, 存储计算结果
  * @param block_size 每个线程处理的行块大小
+ * @param kernel 每个线程使用的内核
+ * @param pool 线程池, nullptr表示每个块创建一个线程
+ * @param telemetry 线程级遥测输出, 工作量按行计, 可以为nullptr
  *
- * @pre matrix1, matrix2, result必须是相同大小的方阵
+ * @pre matrix1.cols() == matrix2.rows()
  * @pre block_size > 0
  * @pre result已正确初始化为0
  *
@@ -530,21 +1873,55 @@ void matrix_mul(vector<vector<int>> &src1,
  * @see parallel_computing_optimized() 更优化的线程控制版本
  * @see matrix_mul() 底层矩阵乘法实现
  */
-void parallel_computing_simple_multithread(
-    std::vector<std::vector<int>> &matrix1,
-    std::vector<std::vector<int>> &matrix2,
-    std::vector<std::vector<int>> &result,
-    size_t block_size)
+template <typename T>
+void parallel_computing_simple_multithread(const Matrix<T> &matrix1,
+                                           const Matrix<T> &matrix2,
+                                           Matrix<T> &result,
+                                           size_t block_size,
+                                           GemmKernel<T> kernel,
+                                           ThreadPool *pool,
+                                           ThreadTelemetry *telemetry)
 {
+  if (pool != nullptr)
+  {
+    TelemetryRecorder recorder(telemetry, pool->size());
+    std::atomic<size_t> next_block{0};
+    pool->run(
+        [&](size_t tid)
+        {
+          apply_thread_affinity(tid);
+          recorder.begin(tid);
+          size_t i;
+          while ((i = next_block.fetch_add(block_size)) < matrix1.rows())
+          {
+            size_t end = std::min(i + block_size, matrix1.rows());
+            double since = recorder.now();
+            kernel(matrix1, matrix2, result, block_size, i, end);
+            recorder.work(tid, since, end - i);
+          }
+          recorder.finish(tid);
+        });
+    recorder.commit();
+    return;
+  }
+
   std::vector<std::thread> threads;
+  TelemetryRecorder recorder(
+      telemetry, (matrix1.rows() + block_size - 1) / block_size);
 
-  for (size_t i = 0; i < matrix1.size(); i += block_size)
+  for (size_t i = 0; i < matrix1.rows(); i += block_size)
   {
     threads.push_back(std::thread(
-        [&matrix1, &matrix2, &result, block_size, i]()
+        [&matrix1, &matrix2, &result, &recorder, block_size, i, kernel]()
         {
-          size_t end = std::min(i + block_size, matrix1.size());
-          matrix_mul(matrix1, matrix2, result, block_size, i, end);
+          const size_t tid = i / block_size;
+          apply_thread_affinity(tid);
+          recorder.begin(tid);
+          size_t end = std::min(i + block_size, matrix1.rows());
+          double since = recorder.now();
+          kernel(matrix1, matrix2, result, block_size, i, end);
+          recorder.work(tid, since, end - i);
+          recorder.finish(tid);
         }));
   }
 
@@ -554,6 +1931,7 @@ void parallel_computing_simple_multithread(
   }
 
   threads.clear();
+  recorder.commit();
 }
 
 /**
@@ -574,13 +1952,20 @@ void parallel_computing_simple_multithread(
  * 3. 并行执行矩阵乘法计算
  * 4. 等待所有线程完成
  *
+ * 传入线程池时使用池中已存在的线程执行同样的行划分,
+ * 不再在每次调用时创建和销毁线程。
+ *
+ * @tparam T 元素类型
  * @param matrix1 输入矩阵1(左操作数)
  * @param matrix2 输入矩阵2(右操作数)
  * @param result 结果矩阵, 存储计算结果
  * @param block_size 分块大小, 用于缓存优化
  * @param num_threads 线程数量, 建议等于CPU核心数
+ * @param kernel 每个线程使用的内核
+ * @param pool 线程池, nullptr表示每次调用创建线程
+ * @param telemetry 线程级遥测输出, 工作量按行计, 可以为nullptr
  *
- * @pre matrix1, matrix2, result必须是相同大小的方阵
+ * @pre matrix1.cols() == matrix2.rows()
  * @pre block_size > 0
  * @pre num_threads > 0 && num_threads <= 系统最大线程数
  * @pre result已正确初始化为0
@@ -588,16 +1973,42 @@ void parallel_computing_simple_multithread(
  * @see parallel_computing_simple_multithread() 简单版本
  * @see matrix_mul() 底层矩阵乘法实现
  * @see get_cpu_cores() 获取推荐线程数
+ * @see ThreadPool
  */
-void parallel_computing_optimized(std::vector<std::vector<int>> &matrix1,
-                                  std::vector<std::vector<int>> &matrix2,
-                                  std::vector<std::vector<int>> &result,
+template <typename T>
+void parallel_computing_optimized(const Matrix<T> &matrix1,
+                                  const Matrix<T> &matrix2,
+                                  Matrix<T> &result,
                                   size_t block_size,
-                                  size_t num_threads)
+                                  size_t num_threads,
+                                  GemmKernel<T> kernel,
+                                  ThreadPool *pool,
+                                  ThreadTelemetry *telemetry)
 {
   std::vector<std::thread> threads;
-  size_t matrix_size = matrix1.size();
+  size_t matrix_size = matrix1.rows();
+  if (pool != nullptr) num_threads = std::min(num_threads, pool->size());
   size_t rows_per_thread = (matrix_size + num_threads - 1) / num_threads;
+  TelemetryRecorder recorder(telemetry, num_threads);
+
+  if (pool != nullptr)
+  {
+    pool->run(
+        [&](size_t t)
+        {
+          size_t start_row = t * rows_per_thread;
+          if (t >= num_threads || start_row >= matrix_size) return;
+          apply_thread_affinity(t);
+          recorder.begin(t);
+          size_t end_row = std::min((t + 1) * rows_per_thread, matrix_size);
+          double since = recorder.now();
+          kernel(matrix1, matrix2, result, block_size, start_row, end_row);
+          recorder.work(t, since, end_row - start_row);
+          recorder.finish(t);
+        });
+    recorder.commit();
+    return;
+  }
 
   for (size_t t = 0; t < num_threads; t++)
   {
@@ -607,10 +2018,15 @@ void parallel_computing_optimized(std::vector<std::vector<int>> &matrix1,
     size_t end_row = std::min((t + 1) * rows_per_thread, matrix_size);
 
     threads.push_back(std::thread(
-        [&matrix1, &matrix2, &result, block_size, start_row, end_row]()
+        [&matrix1, &matrix2, &result, &recorder, block_size, start_row,
+         end_row, kernel, t]()
         {
-          matrix_mul(
-              matrix1, matrix2, result, block_size, start_row, end_row);
+          apply_thread_affinity(t);
+          recorder.begin(t);
+          double since = recorder.now();
+          kernel(matrix1, matrix2, result, block_size, start_row, end_row);
+          recorder.work(t, since, end_row - start_row);
+          recorder.finish(t);
         }));
   }
 
@@ -618,4 +2034,31 @@ void parallel_computing_optimized(std::vector<std::vector<int>> &matrix1,
   {
     t.join();
   }
+  recorder.commit();
 }
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_KERNELS(T)                                            \
+  template void matrix_mul<T>(const Matrix<T> &,                             \
+                              const Matrix<T> &,                             \
+                              Matrix<T> &,                                   \
+                              size_t,                                        \
+                              size_t,                                        \
+                              size_t);                                       \
+  template void matrix_mul_tile<T>(                                          \
+      MatrixView<const T>, MatrixView<const T>, MatrixView<T>, size_t);      \
+  template GemmKernel<T> select_kernel<T>(KernelType);                       \
+  template GemmTileKernel<T> select_tile_kernel<T>(KernelType);              \
+  template void parallel_computing_simple_multithread<T>(                    \
+      const Matrix<T> &, const Matrix<T> &, Matrix<T> &, size_t,             \
+      GemmKernel<T>, ThreadPool *, ThreadTelemetry *);                       \
+  template void parallel_computing_optimized<T>(const Matrix<T> &,           \
+                                                const Matrix<T> &,           \
+                                                Matrix<T> &,                 \
+                                                size_t,                      \
+                                                size_t,                      \
+                                                GemmKernel<T>,               \
+                                                ThreadPool *,                \
+                                                ThreadTelemetry *);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_KERNELS)
+#undef MM_INSTANTIATE_KERNELS
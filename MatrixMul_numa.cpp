@@ -0,0 +1,516 @@
+#include "MatrixMul.h"
+
+#if defined(__linux__)
+#  include <sched.h>
+#  include <sys/syscall.h>
+#endif
+
+/// 按参与者编号排列的CPU, 为空表示不绑核
+static vector<int> affinity_cpus;
+
+/// 当前的绑核策略
+static AffinityMode affinity_mode = AffinityMode::None;
+
+/**
+ * @brief 解析Linux的CPU列表字符串
+ *
+ * 逗号分隔的各段为单个编号或闭区间"a-b", 忽略空白和换行
+ *
+ * @param list CPU列表字符串, 例如"0-3,8,10-11"
+ * @return vector<int> 展开后的CPU编号, 格式错误的段被跳过
+ */
+vector<int> parse_cpu_list(const string &list)
+{
+  vector<int> cpus;
+  std::stringstream stream(list);
+  string range;
+  while (std::getline(stream, range, ','))
+  {
+    int first = 0;
+    int last = 0;
+    int matched = sscanf(range.c_str(), "%d-%d", &first, &last);
+    if (matched < 1) continue;
+    if (matched == 1) last = first;
+    for (int cpu = first; cpu <= last; cpu++)
+    {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+/**
+ * @brief 读取NUMA拓扑
+ *
+ * Linux从/sys/devices/system/node/online获取在线节点,
+ * 再读取每个节点的cpulist; 其他系统或读取失败时返回包含全部CPU的单节点
+ *
+ * @return NumaTopology 拓扑信息
+ */
+static NumaTopology read_numa_topology()
+{
+  NumaTopology topology;
+#if defined(__linux__)
+  const string base = "/sys/devices/system/node/";
+  std::ifstream online(base + "online");
+  string line;
+  if (online && std::getline(online, line))
+  {
+    for (int node : parse_cpu_list(line))
+    {
+      std::ifstream cpulist(base + "node" + std::to_string(node) + "/cpulist");
+      string cpus;
+      if (!cpulist || !std::getline(cpulist, cpus)) continue;
+      topology.node_ids.push_back(node);
+      topology.node_cpus.push_back(parse_cpu_list(cpus));
+    }
+  }
+#endif
+  if (topology.node_ids.empty())
+  {
+    vector<int> cpus;
+    for (size_t cpu = 0; cpu < get_cpu_cores(); cpu++)
+    {
+      cpus.push_back(static_cast<int>(cpu));
+    }
+    topology.node_ids.push_back(0);
+    topology.node_cpus.push_back(cpus);
+  }
+  return topology;
+}
+
+/**
+ * @brief 获取NUMA拓扑
+ *
+ * @return const NumaTopology& 首次调用时读取并缓存的拓扑信息
+ * @see read_numa_topology()
+ */
+const NumaTopology &get_numa_topology()
+{
+  static const NumaTopology topology = read_numa_topology();
+  return topology;
+}
+
+/**
+ * @brief 获取绑核策略的名称
+ *
+ * @param mode 绑核策略
+ * @return const char* 与--affinity参数一致的名称
+ */
+const char *affinity_mode_name(AffinityMode mode)
+{
+  switch (mode)
+  {
+    case AffinityMode::Compact:
+      return "compact";
+    case AffinityMode::Scatter:
+      return "scatter";
+    case AffinityMode::None:
+      break;
+  }
+  return "none";
+}
+
+/**
+ * @brief 设置工作线程的绑核策略
+ *
+ * - compact: 按节点顺序排列CPU, 前几个参与者集中在同一节点, 共享L3和本地内存
+ * - scatter: 每轮从每个节点各取一个CPU, 参与者均匀分布到所有节点,
+ *   获得全部内存控制器的带宽
+ *
+ * 参与者数超过CPU数时按编号取模复用映射。
+ *
+ * @param mode 绑核策略
+ */
+void set_thread_affinity(AffinityMode mode)
+{
+  affinity_mode = mode;
+  affinity_cpus.clear();
+  if (mode == AffinityMode::None) return;
+
+  const NumaTopology &topology = get_numa_topology();
+  if (mode == AffinityMode::Compact)
+  {
+    for (const auto &cpus : topology.node_cpus)
+    {
+      affinity_cpus.insert(affinity_cpus.end(), cpus.begin(), cpus.end());
+    }
+    return;
+  }
+
+  size_t longest = 0;
+  for (const auto &cpus : topology.node_cpus)
+  {
+    longest = std::max(longest, cpus.size());
+  }
+  for (size_t k = 0; k < longest; k++)
+  {
+    for (const auto &cpus : topology.node_cpus)
+    {
+      if (k < cpus.size()) affinity_cpus.push_back(cpus[k]);
+    }
+  }
+}
+
+/// 当前线程的参与者编号, 由apply_thread_affinity()记录
+static thread_local size_t worker_id = NO_WORKER;
+
+/**
+ * @brief 将当前线程绑定到参与者编号对应的CPU
+ *
+ * 先记录参与者编号, 再按策略绑核: Linux使用sched_setaffinity,
+ * Windows使用SetThreadAffinityMask, 其他系统不支持绑核。每个线程记录
+ * 已绑定的CPU, 线程池中的线程只在首次派发时产生系统调用。
+ *
+ * @param tid 参与者编号
+ */
+void apply_thread_affinity(size_t tid)
+{
+  worker_id = tid;
+  if (affinity_mode == AffinityMode::None || affinity_cpus.empty()) return;
+
+  thread_local int pinned_cpu = -1;
+  int cpu = affinity_cpus[tid % affinity_cpus.size()];
+  if (cpu == pinned_cpu) return;
+  pinned_cpu = cpu;
+
+#if defined(__linux__)
+  // cpu_set_t只能表示[0, CPU_SETSIZE)内的CPU, 超出范围时不绑核
+  if (cpu < 0 || cpu >= CPU_SETSIZE) return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(static_cast<size_t>(cpu), &set);
+  sched_setaffinity(0, sizeof(set), &set);
+#elif defined(_WIN32)
+  if (cpu >= 0 && cpu < 64)
+  {
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+  }
+#endif
+}
+
+size_t current_worker()
+{
+  return worker_id;
+}
+
+/**
+ * @brief 获取当前线程正在运行的CPU
+ *
+ * Linux使用sched_getcpu, Windows使用GetCurrentProcessorNumber;
+ * 未绑核时线程可能随后被迁移, 结果只反映调用时刻
+ *
+ * @return int CPU编号, 系统不支持查询时返回-1
+ */
+int current_cpu()
+{
+#if defined(__linux__)
+  return sched_getcpu();
+#elif defined(_WIN32)
+  return static_cast<int>(GetCurrentProcessorNumber());
+#else
+  return -1;
+#endif
+}
+
+/**
+ * @brief 统计一块内存的页面在各NUMA节点上的分布
+ *
+ * Linux通过move_pages(2)在nodes为空时只查询不迁移的模式获取每页所在节点,
+ * 以系统调用号直接调用, 不依赖libnuma。尚未被写入的页面不计入。
+ *
+ * @param data 内存起始地址
+ * @param bytes 字节数
+ * @return vector<size_t> 按节点编号索引的页面数, 无法查询时为空
+ */
+vector<size_t> query_page_nodes(const void *data, size_t bytes)
+{
+  vector<size_t> counts;
+#if defined(__linux__) && defined(SYS_move_pages)
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  uintptr_t first = reinterpret_cast<uintptr_t>(data) & ~(page - 1);
+  uintptr_t last = reinterpret_cast<uintptr_t>(data) + bytes;
+
+  const size_t batch = 1024;
+  vector<void *> pages;
+  vector<int> status(batch);
+  pages.reserve(batch);
+  for (uintptr_t addr = first; addr < last;)
+  {
+    pages.clear();
+    for (; addr < last && pages.size() < batch; addr += page)
+    {
+      pages.push_back(reinterpret_cast<void *>(addr));
+    }
+    if (syscall(SYS_move_pages,
+                0,
+                pages.size(),
+                pages.data(),
+                nullptr,
+                status.data(),
+                0)
+        != 0)
+    {
+      return {};
+    }
+    for (size_t i = 0; i < pages.size(); i++)
+    {
+      if (status[i] < 0) continue;
+      size_t node = static_cast<size_t>(status[i]);
+      if (node >= counts.size()) counts.resize(node + 1, 0);
+      counts[node]++;
+    }
+  }
+#else
+  (void)data;
+  (void)bytes;
+#endif
+  return counts;
+}
+
+/**
+ * @brief 打印矩阵在各NUMA节点上的页面分布
+ *
+ * 每个节点输出页面数和占比, 例如"src1: node0 512页(50.0%) node1 512页(50.0%)"
+ *
+ * @param name 矩阵名称
+ * @param data 数据指针
+ * @param bytes 字节数
+ */
+void print_numa_memory_map(const char *name, const void *data, size_t bytes)
+{
+  vector<size_t> counts = query_page_nodes(data, bytes);
+  cout << name << ":";
+  size_t total = 0;
+  for (size_t count : counts)
+  {
+    total += count;
+  }
+  if (total == 0)
+  {
+    cout << " 不可用" << endl;
+    return;
+  }
+  for (size_t node = 0; node < counts.size(); node++)
+  {
+    if (counts[node] == 0) continue;
+    cout << " node" << node << " " << counts[node] << "页(" << fixed
+         << setprecision(1)
+         << 100.0 * static_cast<double>(counts[node])
+                / static_cast<double>(total)
+         << "%)";
+  }
+  cout << endl;
+}
+
+/**
+ * @brief 按行划分并行执行
+ *
+ * 每个线程先按参与者编号绑核, 再处理连续的rows/num_threads行(向上取整);
+ * 划分方式与parallel_computing_optimized()一致
+ *
+ * @param rows 总行数
+ * @param num_threads 线程数量, 使用线程池时不超过池的大小
+ * @param pool 线程池, nullptr表示创建线程
+ * @param body 处理[start, end)行的函数, 分不到行的线程不调用
+ *
+ * @see apply_thread_affinity()
+ */
+void parallel_rows(size_t rows,
+                   size_t num_threads,
+                   ThreadPool *pool,
+                   const std::function<void(size_t, size_t)> &body)
+{
+  if (pool != nullptr) num_threads = std::min(num_threads, pool->size());
+  num_threads = std::max(num_threads, size_t(1));
+  const size_t rows_per_thread = (rows + num_threads - 1) / num_threads;
+
+  auto task = [&](size_t t)
+  {
+    if (t >= num_threads) return;
+    apply_thread_affinity(t);
+    size_t start_row = std::min(t * rows_per_thread, rows);
+    size_t end_row = std::min(start_row + rows_per_thread, rows);
+    if (start_row < end_row) body(start_row, end_row);
+  };
+
+  if (pool != nullptr)
+  {
+    pool->run(task);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++)
+  {
+    threads.push_back(std::thread(task, t));
+  }
+  for (auto &t : threads)
+  {
+    t.join();
+  }
+}
+
+/**
+ * @brief 按行条并行地首次写入矩阵
+ *
+ * 每个线程先按参与者编号绑核, 再清零并初始化自己负责的连续行(包括行尾填充)。
+ * 行划分与parallel_rows()相同, 因此与按行划分的计算一致; 按二维或
+ * split-K网格计算时先用grid_first_touch()放置页面, 再用本函数写入初值,
+ * 已分配的页面不会移动。
+ *
+ * @tparam T 元素类型
+ * @param matrix 目标矩阵
+ * @param num_threads 线程数量
+ * @param pool 线程池, nullptr表示创建线程
+ * @param init 行初始化函数init(row, data), 为空时将整行清零
+ *
+ * @see apply_thread_affinity()
+ */
+template <typename T>
+void parallel_first_touch(Matrix<T> &matrix,
+                          size_t num_threads,
+                          ThreadPool *pool,
+                          const std::function<void(size_t, T *)> &init)
+{
+  parallel_rows(matrix.rows(),
+                num_threads,
+                pool,
+                [&](size_t start_row, size_t end_row)
+                {
+                  for (size_t row = start_row; row < end_row; row++)
+                  {
+                    T *data = matrix.row(row);
+                    std::fill(data, data + matrix.ld(), T{});
+                    if (init) init(row, data);
+                  }
+                });
+}
+
+/**
+ * @brief 元素下标向上取整到页面边界
+ *
+ * @param row 行首地址
+ * @param column 行内元素下标
+ * @param ld 行跨度, 结果不超过它
+ * @return size_t 地址不小于row + column且位于页面起点的元素下标
+ */
+template <typename T>
+static size_t page_boundary(const T *row, size_t column, size_t ld)
+{
+  if (column == 0 || column >= ld) return std::min(column, ld);
+  const uintptr_t address = reinterpret_cast<uintptr_t>(row + column);
+  const uintptr_t aligned =
+      (address + MATRIX_PAGE_SIZE - 1) / MATRIX_PAGE_SIZE * MATRIX_PAGE_SIZE;
+  const size_t index =
+      (aligned - reinterpret_cast<uintptr_t>(row) + sizeof(T) - 1) / sizeof(T);
+  return std::min(index, ld);
+}
+
+/**
+ * @brief 按parallel_computing_partitioned()的线程网格首次写入矩阵
+ *
+ * 线程t与计算阶段相同, 负责K段t / (row_parts * col_parts)中按行优先的
+ * (行段, 列段)单元, 绑核后把下面的区域清零:
+ * - Result(C): 第0个K段的线程写入自己的C单元
+ * - Left(A): 每个行段中列段0的线程写入(行段, K段)对应的A块,
+ *   同一行段的线程编号相邻, 紧凑绑核时位于同一节点
+ * - Right(B): 行段0的线程写入(K段, 列段)对应的B块
+ *
+ * 列方向的边界向上取整到页面起点, 每个页面只由一个线程首次写入;
+ * 窄于一个页面的列段并入相邻列段, 最后一个列段包括行尾填充。
+ * 行跨度小于一个页面时相邻两行共享页面, 由先写入的线程决定位置。
+ * 只写入0, 初值随后用parallel_first_touch()写入。
+ *
+ * @tparam T 元素类型
+ * @param matrix 目标矩阵
+ * @param grid choose_thread_grid()选出的网格
+ * @param operand 矩阵在乘法中的角色
+ * @param pool 线程池, nullptr表示创建线程
+ */
+template <typename T>
+void grid_first_touch(Matrix<T> &matrix,
+                      const ThreadGrid &grid,
+                      GridOperand operand,
+                      ThreadPool *pool)
+{
+  const size_t planes = grid.row_parts * grid.col_parts;
+  const size_t num_threads = planes * grid.k_parts;
+  auto task = [&](size_t t)
+  {
+    if (t >= num_threads) return;
+    const size_t slice = t / planes;
+    const size_t band_row = (t % planes) / grid.col_parts;
+    const size_t band_col = (t % planes) % grid.col_parts;
+    size_t row_band = 0;
+    size_t col_band = 0;
+    size_t rows_per_band = 0;
+    size_t cols_per_band = 0;
+    switch (operand)
+    {
+      case GridOperand::Result:
+        if (slice != 0) return;
+        row_band = band_row;
+        col_band = band_col;
+        rows_per_band = grid.rows_per_part;
+        cols_per_band = grid.cols_per_part;
+        break;
+      case GridOperand::Left:
+        if (band_col != 0) return;
+        row_band = band_row;
+        col_band = slice;
+        rows_per_band = grid.rows_per_part;
+        cols_per_band = grid.depth_per_part;
+        break;
+      case GridOperand::Right:
+        if (band_row != 0) return;
+        row_band = slice;
+        col_band = band_col;
+        rows_per_band = grid.depth_per_part;
+        cols_per_band = grid.cols_per_part;
+        break;
+    }
+    const size_t r0 = std::min(row_band * rows_per_band, matrix.rows());
+    const size_t r1 = std::min(r0 + rows_per_band, matrix.rows());
+    const size_t c0 = std::min(col_band * cols_per_band, matrix.cols());
+    const size_t c1 = std::min(c0 + cols_per_band, matrix.cols());
+    if (r0 >= r1 || c0 >= c1) return;
+    apply_thread_affinity(t);
+    const size_t ld = matrix.ld();
+    for (size_t row = r0; row < r1; row++)
+    {
+      T *data = matrix.row(row);
+      // 最后一个列段延伸到行跨度, 包括行尾填充
+      const size_t j0 = page_boundary(data, c0, ld);
+      const size_t j1 = c1 >= matrix.cols() ? ld : page_boundary(data, c1, ld);
+      std::fill(data + j0, data + j1, T{});
+    }
+  };
+
+  if (pool != nullptr && pool->size() >= num_threads)
+  {
+    pool->run(task);
+    return;
+  }
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++)
+  {
+    threads.push_back(std::thread(task, t));
+  }
+  for (auto &t : threads)
+  {
+    t.join();
+  }
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_NUMA(T)                                               \
+  template void parallel_first_touch<T>(                                     \
+      Matrix<T> &,                                                           \
+      size_t,                                                                \
+      ThreadPool *,                                                          \
+      const std::function<void(size_t, T *)> &);                           \
+  template void grid_first_touch<T>(                                         \
+      Matrix<T> &, const ThreadGrid &, GridOperand, ThreadPool *);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_NUMA)
+#undef MM_INSTANTIATE_NUMA
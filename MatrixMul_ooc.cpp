@@ -0,0 +1,555 @@
+#include "MatrixMul.h"
+
+#include <filesystem>
+#include <numeric>
+
+#if !defined(_WIN32)
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+/// 核外分块边长的取整粒度, 保证每个分块行都是整缓存行
+static constexpr size_t OOC_TILE_ALIGNMENT = 64;
+
+/**
+ * @brief 选择核外模式在内存中的分块边长
+ *
+ * 工作集包含正在计算和正在预取的两份A分块、两份B分块, 以及一份C分块,
+ * 共5 * tile²个元素; 结果向下取整到OOC_TILE_ALIGNMENT的倍数,
+ * 至少为OOC_TILE_ALIGNMENT
+ *
+ * @param memory_bytes 内存工作集上限(字节)
+ * @param element_size 元素大小(字节)
+ * @return size_t 分块边长
+ */
+size_t choose_ooc_tile(size_t memory_bytes, size_t element_size)
+{
+  const double elements = static_cast<double>(memory_bytes)
+                          / (5.0 * static_cast<double>(element_size));
+  const size_t tile = static_cast<size_t>(std::sqrt(elements));
+  return std::max(tile / OOC_TILE_ALIGNMENT * OOC_TILE_ALIGNMENT,
+                  OOC_TILE_ALIGNMENT);
+}
+
+#if !defined(_WIN32)
+/**
+ * @brief 以MAP_SHARED映射到内存的矩阵文件
+ *
+ * 文件按行主序紧密存放矩阵元素(行跨度等于列数), 没有文件头
+ */
+class MappedFile
+{
+private:
+  int fd = -1; ///< 文件描述符
+  char *base = nullptr; ///< 映射区起始地址
+  size_t length = 0; ///< 映射的字节数
+
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile()
+  {
+    if (base != nullptr) munmap(base, length);
+    if (fd >= 0) ::close(fd);
+  }
+
+  /**
+   * @brief 打开文件并映射, 文件不存在或大小不符时创建并调整大小
+   *
+   * @param path 文件路径
+   * @param bytes 文件大小
+   * @param reused 输出参数, 已有文件的大小恰好为bytes时为true
+   * @return bool 成功时返回true, 失败时errno给出原因
+   */
+  bool open(const string &path, size_t bytes, bool &reused)
+  {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) return false;
+    reused = static_cast<size_t>(info.st_size) == bytes;
+    if (!reused && ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+    {
+      return false;
+    }
+    void *mapped =
+        mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) return false;
+    base = static_cast<char *>(mapped);
+    length = bytes;
+    return true;
+  }
+
+  /// 映射区起始地址
+  char *data() const { return base; }
+
+  /**
+   * @brief 把映射区的脏页写回文件
+   *
+   * @return bool msync成功时返回true
+   */
+  bool sync() const { return msync(base, length, MS_SYNC) == 0; }
+
+  /**
+   * @brief 写回脏页后释放映射的页和文件的页缓存
+   *
+   * 之后的访问重新从磁盘读取, 使每次迭代都在冷缓存下测量;
+   * 不支持posix_fadvise的平台(macOS)上页缓存可能仍然保留
+   */
+  void drop_cache() const
+  {
+    msync(base, length, MS_SYNC);
+    madvise(base, length, MADV_DONTNEED);
+#  if defined(POSIX_FADV_DONTNEED)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#  endif
+  }
+
+  /**
+   * @brief 提示内核异步预读一段区间
+   *
+   * @param offset 起始字节偏移, 向下对齐到页
+   * @param bytes 字节数
+   */
+  void will_need(size_t offset, size_t bytes) const
+  {
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t start = offset / page * page;
+    madvise(base + start, offset + bytes - start, MADV_WILLNEED);
+  }
+};
+
+/**
+ * @brief 核外乘法的一个分块步骤: C(i0, j0) += A(i0, k0) * B(k0, j0)
+ */
+struct OocStep
+{
+  size_t i0 = 0; ///< C和A分块的起始行
+  size_t j0 = 0; ///< C和B分块的起始列
+  size_t k0 = 0; ///< A分块的起始列和B分块的起始行
+  size_t rows = 0; ///< C分块的行数
+  size_t cols = 0; ///< C分块的列数
+  size_t depth = 0; ///< 公共维度上的分块长度
+  bool first = false; ///< 是否为该C分块的第一个K步
+  bool last = false; ///< 是否为该C分块的最后一个K步
+};
+
+/**
+ * @brief 把映射文件中的一个子矩阵复制到内存分块
+ *
+ * 先对每一行的区间发出MADV_WILLNEED, 让内核并发地预读所有行,
+ * 再逐行复制; 复制时缺页的行等待磁盘读取完成
+ *
+ * @tparam T 元素类型
+ * @param file 映射文件
+ * @param file_cols 文件中矩阵的列数
+ * @param row0 起始行
+ * @param col0 起始列
+ * @param tile 目标分块, 尺寸即子矩阵的尺寸
+ */
+template <typename T>
+static void read_tile(const MappedFile &file,
+                      size_t file_cols,
+                      size_t row0,
+                      size_t col0,
+                      Matrix<T> &tile)
+{
+  const size_t span = tile.cols() * sizeof(T);
+  for (size_t r = 0; r < tile.rows(); r++)
+  {
+    file.will_need(((row0 + r) * file_cols + col0) * sizeof(T), span);
+  }
+  const T *source = reinterpret_cast<const T *>(file.data());
+  for (size_t r = 0; r < tile.rows(); r++)
+  {
+    memcpy(tile.row(r), source + (row0 + r) * file_cols + col0, span);
+  }
+}
+
+/**
+ * @brief 打开矩阵文件, 新建或大小不符时按与主测试相同的模式写入内容
+ *
+ * @tparam T 元素类型
+ * @param file 映射文件
+ * @param path 文件路径
+ * @param rows 行数
+ * @param cols 列数
+ * @param row_factor 初始化公式中行号的系数
+ * @param col_factor 初始化公式中列号的系数
+ * @param num_threads 并行写入的线程数
+ * @param pool 线程池, nullptr表示创建线程
+ * @return bool 成功时返回true, 失败时已输出错误信息
+ */
+template <typename T>
+static bool open_matrix_file(MappedFile &file,
+                             const string &path,
+                             size_t rows,
+                             size_t cols,
+                             size_t row_factor,
+                             size_t col_factor,
+                             size_t num_threads,
+                             ThreadPool *pool)
+{
+  const size_t bytes = rows * cols * sizeof(T);
+  bool reused = false;
+  if (!file.open(path, bytes, reused))
+  {
+    cerr << "无法映射矩阵文件 " << path << ": " << strerror(errno) << endl;
+    return false;
+  }
+  cout << "文件: " << path << " (" << fixed << setprecision(2)
+       << static_cast<double>(bytes) / (1024.0 * 1024.0) << " MB, "
+       << (reused ? "复用已有文件" : "新建") << ")" << endl;
+  if (reused || row_factor == 0) return true;
+
+  T *data = reinterpret_cast<T *>(file.data());
+  parallel_rows(rows,
+                num_threads,
+                pool,
+                [&](size_t start, size_t end)
+                {
+                  for (size_t row = start; row < end; row++)
+                  {
+                    T *values = data + row * cols;
+                    for (size_t col = 0; col < cols; col++)
+                    {
+                      values[col] = static_cast<T>(
+                          (row * row_factor + col * col_factor) % 100);
+                    }
+                  }
+                });
+  if (!file.sync())
+  {
+    cerr << "写入矩阵文件失败 " << path << ": " << strerror(errno) << endl;
+    return false;
+  }
+  return true;
+}
+#endif
+
+/**
+ * @brief 运行核外矩阵乘法基准测试(--ooc)
+ *
+ * A(M x K)、B(K x N)和C(M x N)是--ooc目录中的二进制文件, 以mmap映射,
+ * 文件名包含元素类型和形状, 大小相符的已有文件直接复用(首次运行时
+ * 按主测试的初始化公式生成)。计算C = A * B的流程:
+ *
+ * 1. 按choose_ooc_tile()把C切分为tile x tile的分块, 对每个C分块
+ *    沿K方向依次累加A和B的分块乘积, 所有步骤排成一个序列
+ * 2. 双缓冲: 计算第s步时, 预取线程把第s + 1步的A和B分块从映射区
+ *    复制到另一组内存缓冲区(先发出MADV_WILLNEED); 计算线程算完后
+ *    等待预取完成, 这段等待即I/O停顿
+ * 3. 分块乘法在内存中进行, 与--parallel optimized相同(Strassen内核
+ *    使用并行Strassen); C分块完成后复制回映射区, 最后msync写回文件
+ *
+ * 每次迭代开始前都释放三个文件的页缓存, 在冷缓存下测量; 只做多线程
+ * 测试。除--verify none外, 最后用Freivalds直接在映射区上验证C,
+ * 每轮按行顺序读一遍三个文件。
+ *
+ * @tparam T 元素类型
+ * @param config 基准测试配置, 使用其中的ooc_dir、ooc_memory_mb和矩阵形状
+ * @param report 运行结果, 追加一条记录并写入out_of_core
+ * @return int 程序退出状态码, 0表示成功, 1表示文件操作或结果验证失败
+ */
+template <typename T>
+int run_out_of_core(const BenchmarkConfig &config, BenchmarkReport &report)
+{
+#if defined(_WIN32)
+  (void)config;
+  (void)report;
+  cerr << "--ooc需要mmap, 仅支持Linux和macOS" << endl;
+  return 1;
+#else
+  const size_t m = config.shape_m;
+  const size_t n = config.shape_n;
+  const size_t k = config.shape_k;
+  const size_t threads = config.num_threads;
+  const size_t tile = choose_ooc_tile(config.ooc_memory_mb << 20, sizeof(T));
+  const size_t tile_m = std::min(tile, m);
+  const size_t tile_n = std::min(tile, n);
+  const size_t tile_k = std::min(tile, k);
+
+  vector<OocStep> steps;
+  for (size_t i0 = 0; i0 < m; i0 += tile_m)
+  {
+    for (size_t j0 = 0; j0 < n; j0 += tile_n)
+    {
+      for (size_t k0 = 0; k0 < k; k0 += tile_k)
+      {
+        OocStep step;
+        step.i0 = i0;
+        step.j0 = j0;
+        step.k0 = k0;
+        step.rows = std::min(tile_m, m - i0);
+        step.cols = std::min(tile_n, n - j0);
+        step.depth = std::min(tile_k, k - k0);
+        step.first = k0 == 0;
+        step.last = k0 + tile_k >= k;
+        steps.push_back(step);
+      }
+    }
+  }
+
+  cout << "=== 核外测试配置 ===" << endl;
+  cout << "问题形状: C(" << m << "x" << n << ") = A(" << m << "x" << k
+       << ") * B(" << k << "x" << n << ")" << endl;
+  cout << "元素类型: " << dtype_name(config.dtype) << endl;
+  cout << "内核: " << kernel_name(config.kernel) << endl;
+  cout << "线程数: " << threads << endl;
+
+  std::unique_ptr<ThreadPool> pool;
+  if (config.use_pool)
+  {
+    pool = std::make_unique<ThreadPool>(threads);
+  }
+
+  std::error_code error;
+  std::filesystem::create_directories(config.ooc_dir, error);
+  const string suffix = string("_") + dtype_name(config.dtype) + "_";
+  auto file_path = [&](const char *name, size_t rows, size_t cols)
+  {
+    return (std::filesystem::path(config.ooc_dir)
+            / (name + suffix + std::to_string(rows) + "x"
+               + std::to_string(cols) + ".bin"))
+        .string();
+  };
+  MappedFile file_a;
+  MappedFile file_b;
+  MappedFile file_c;
+  if (!open_matrix_file<T>(
+          file_a, file_path("A", m, k), m, k, 31, 17, threads, pool.get())
+      || !open_matrix_file<T>(
+          file_b, file_path("B", k, n), k, n, 17, 31, threads, pool.get())
+      || !open_matrix_file<T>(
+          file_c, file_path("C", m, n), m, n, 0, 0, threads, pool.get()))
+  {
+    return 1;
+  }
+
+  const size_t ld_a = configured_leading_dimension(config, tile_k);
+  const size_t ld_b = configured_leading_dimension(config, tile_n);
+  Matrix<T> a_tiles[2] = {Matrix<T>(tile_m, tile_k, ld_a, matrix_no_init),
+                          Matrix<T>(tile_m, tile_k, ld_a, matrix_no_init)};
+  Matrix<T> b_tiles[2] = {Matrix<T>(tile_k, tile_n, ld_b, matrix_no_init),
+                          Matrix<T>(tile_k, tile_n, ld_b, matrix_no_init)};
+  Matrix<T> c_tile(tile_m, tile_n, ld_b, matrix_no_init);
+  const double working_set_mb =
+      static_cast<double>(2 * a_tiles[0].size_bytes()
+                          + 2 * b_tiles[0].size_bytes()
+                          + c_tile.size_bytes())
+      / (1024.0 * 1024.0);
+  cout << "内存工作集: 上限 " << config.ooc_memory_mb << " MB, 分块 " << tile
+       << " (实际占用 " << working_set_mb << " MB, " << steps.size()
+       << " 个分块步骤)" << endl;
+  cout << "迭代次数: " << config.iterations << " (预热 " << config.warmup
+       << " 次)" << endl;
+  cout << "==================" << endl << endl;
+
+  report.config = config;
+  report.leading_dimension = ld_b;
+  report.memory_mb = working_set_mb;
+
+  const GemmTileKernel<T> tile_kernel = select_tile_kernel<T>(config.kernel);
+  T *map_c = reinterpret_cast<T *>(file_c.data());
+
+  OutOfCoreStats current;
+  auto load = [&](size_t s)
+  {
+    const OocStep &step = steps[s];
+    Matrix<T> &a = a_tiles[s % 2];
+    Matrix<T> &b = b_tiles[s % 2];
+    Timer load_timer;
+    load_timer.start();
+    a.reshape(step.rows, step.depth, a.ld());
+    b.reshape(step.depth, step.cols, b.ld());
+    read_tile(file_a, k, step.i0, step.k0, a);
+    read_tile(file_b, n, step.k0, step.j0, b);
+    load_timer.stop();
+    current.load_seconds += load_timer.get_seconds();
+    current.bytes_read += static_cast<double>(
+        (step.rows * step.depth + step.depth * step.cols) * sizeof(T));
+  };
+
+  Timer timer;
+  Timer phase;
+  KernelRun run;
+  run.kernel = string("ooc-") + kernel_name(config.kernel);
+  OutOfCoreStats total;
+  total.tile = tile;
+  cout << "开始核外测试..." << endl;
+  for (size_t iter = 0; iter < config.warmup + config.iterations; iter++)
+  {
+    file_a.drop_cache();
+    file_b.drop_cache();
+    file_c.drop_cache();
+    current = OutOfCoreStats();
+
+    timer.start();
+    phase.start();
+    load(0);
+    phase.stop();
+    current.stall_seconds += phase.get_seconds();
+    for (size_t s = 0; s < steps.size(); s++)
+    {
+      const OocStep &step = steps[s];
+      std::thread loader;
+      if (s + 1 < steps.size()) loader = std::thread(load, s + 1);
+
+      phase.start();
+      if (step.first)
+      {
+        c_tile.reshape(step.rows, step.cols, c_tile.ld());
+        c_tile.fill(T(0));
+      }
+      if (config.kernel == KernelType::Strassen)
+      {
+        parallel_strassen_matrix_mul(a_tiles[s % 2],
+                                     b_tiles[s % 2],
+                                     c_tile,
+                                     config.block_size,
+                                     threads,
+                                     pool.get());
+      }
+      else
+      {
+        parallel_computing_partitioned(a_tiles[s % 2],
+                                       b_tiles[s % 2],
+                                       c_tile,
+                                       config.block_size,
+                                       threads,
+                                       tile_kernel,
+                                       pool.get());
+      }
+      phase.stop();
+      current.compute_seconds += phase.get_seconds();
+
+      if (step.last)
+      {
+        phase.start();
+        for (size_t r = 0; r < step.rows; r++)
+        {
+          memcpy(map_c + (step.i0 + r) * n + step.j0,
+                 c_tile.row(r),
+                 step.cols * sizeof(T));
+        }
+        phase.stop();
+        current.write_seconds += phase.get_seconds();
+        current.bytes_written +=
+            static_cast<double>(step.rows * step.cols * sizeof(T));
+      }
+
+      phase.start();
+      if (loader.joinable()) loader.join();
+      phase.stop();
+      current.stall_seconds += phase.get_seconds();
+    }
+    phase.start();
+    const bool synced = file_c.sync();
+    phase.stop();
+    current.sync_seconds = phase.get_seconds();
+    timer.stop();
+    if (!synced)
+    {
+      cerr << "msync写回C失败: " << strerror(errno) << endl;
+      return 1;
+    }
+    if (config.verbose)
+    {
+      cout << "  第 " << iter + 1 << " 次: " << fixed << setprecision(4)
+           << timer.get_seconds() << " 秒 (等待预取 " << current.stall_seconds
+           << " 秒)" << endl;
+    }
+    if (iter < config.warmup) continue;
+
+    run.multi_seconds.push_back(timer.get_seconds());
+    total.compute_seconds += current.compute_seconds;
+    total.stall_seconds += current.stall_seconds;
+    total.write_seconds += current.write_seconds;
+    total.sync_seconds += current.sync_seconds;
+    total.load_seconds += current.load_seconds;
+    total.bytes_read += current.bytes_read;
+    total.bytes_written += current.bytes_written;
+  }
+
+  const double samples = static_cast<double>(run.multi_seconds.size());
+  OutOfCoreStats &stats = report.out_of_core;
+  stats.tile = tile;
+  stats.compute_seconds = total.compute_seconds / samples;
+  stats.stall_seconds = total.stall_seconds / samples;
+  stats.write_seconds = total.write_seconds / samples;
+  stats.sync_seconds = total.sync_seconds / samples;
+  stats.load_seconds = total.load_seconds / samples;
+  stats.bytes_read = total.bytes_read / samples;
+  stats.bytes_written = total.bytes_written / samples;
+
+  const double median = compute_sample_stats(run.multi_seconds).median;
+  const double operations = 2.0 * static_cast<double>(m)
+                            * static_cast<double>(n) * static_cast<double>(k);
+  const double wall = std::accumulate(run.multi_seconds.begin(),
+                                      run.multi_seconds.end(),
+                                      0.0)
+                      / samples;
+  auto share = [wall](double seconds) { return 100.0 * seconds / wall; };
+  const double gb = 1024.0 * 1024.0 * 1024.0;
+
+  cout << endl << "=== 核外测试结果 ===" << endl;
+  cout << fixed << setprecision(4) << "时间中位数: " << median
+       << " 秒, 性能: " << operations / (median * 1e9) << " "
+       << throughput_unit(config.dtype) << endl;
+  cout << "平均每次迭代 " << wall << " 秒: 计算 " << stats.compute_seconds
+       << " 秒 (" << setprecision(1) << share(stats.compute_seconds)
+       << "%), 等待预取 " << setprecision(4) << stats.stall_seconds << " 秒 ("
+       << setprecision(1) << share(stats.stall_seconds) << "%), 写回C "
+       << setprecision(4) << stats.write_seconds << " 秒, msync "
+       << stats.sync_seconds << " 秒" << endl;
+  cout << setprecision(2) << "磁盘读: " << stats.bytes_read / gb
+       << " GB, 带宽 " << stats.bytes_read / (stats.load_seconds * 1e9)
+       << " GB/s (预取线程耗时 " << setprecision(4) << stats.load_seconds
+       << " 秒)" << endl;
+  cout << setprecision(2) << "磁盘写: " << stats.bytes_written / gb
+       << " GB, 带宽 "
+       << stats.bytes_written
+              / ((stats.write_seconds + stats.sync_seconds) * 1e9)
+       << " GB/s" << endl;
+
+  run.verified = true;
+  if (config.verify != VerifyMode::None)
+  {
+    const double tolerance =
+        config.tolerance > 0.0 ? config.tolerance : default_tolerance<T>(k);
+    const MatrixView<const T> a{
+        reinterpret_cast<const T *>(file_a.data()), m, k, k};
+    const MatrixView<const T> b{
+        reinterpret_cast<const T *>(file_b.data()), k, n, n};
+    const MatrixView<const T> c{map_c, m, n, n};
+    timer.start();
+    const VerifyResult verdict = freivalds_verify(
+        a, b, c, config.verify_rounds, tolerance, threads, pool.get());
+    timer.stop();
+    run.verified = verdict.passed;
+    cout << "结果验证(freivalds): " << (verdict.passed ? "通过" : "失败");
+    if (!verdict.passed)
+    {
+      cout << ", " << verdict.mismatches << " 行不一致, 首个位于第 "
+           << verdict.first_row << " 行";
+    }
+    cout << ", 耗时 " << setprecision(4) << timer.get_seconds() << " 秒"
+         << endl;
+  }
+  cout << "==================" << endl;
+
+  report.runs.push_back(run);
+  return run.verified ? 0 : 1;
+#endif
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_OOC(T)                                                \
+  template int run_out_of_core<T>(const BenchmarkConfig &, BenchmarkReport &);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_OOC)
+#undef MM_INSTANTIATE_OOC
@@ -0,0 +1,253 @@
+#include "MatrixMul.h"
+
+/**
+ * @brief 计算打包GEMM的分块参数
+ *
+ * 按GotoBLAS的分层原则推导三级分块：
+ * 1. KC: B的KCxNR微面板占用L1缓存的一半, 另一半留给A的微面板和C
+ * 2. MC: A的MCxKC面板占用L2缓存的一半
+ * 3. NC: B的KCxNC面板占用L3缓存的一半
+ *
+ * NR为一个缓存行的元素个数, 因此8字节类型的KC与4字节类型相同,
+ * 而MC、NC按元素大小减半。结果分别对齐到MR、NR的倍数并限制在合理范围内。
+ * 每个线程打包各自的面板, 因此L2、L3按同时共享该缓存的线程数平分。
+ *
+ * @param element_size 元素字节数
+ * @return PackedBlocking 三级分块参数
+ * @see get_cache_info()
+ * @see cache_share()
+ */
+PackedBlocking calculate_packed_blocking(size_t element_size)
+{
+  const CacheInfo &cache = get_cache_info();
+  PackedBlocking blocking;
+  const size_t nr = MATRIX_ALIGNMENT / element_size;
+  const size_t l2 = cache_share(cache.l2_cache_size, cache.l2_shared_cpus);
+  const size_t l3 = cache_share(cache.l3_cache_size, cache.l3_shared_cpus);
+
+  size_t kc = (cache.l1_cache_size / 2) / (nr * element_size);
+  kc = std::clamp(kc, size_t(64), size_t(512));
+  kc -= kc % 8;
+
+  size_t mc = (l2 / 2) / (kc * element_size);
+  mc = std::clamp(mc, PACK_MR, size_t(1024));
+  mc -= mc % PACK_MR;
+
+  size_t nc = (l3 / 2) / (kc * element_size);
+  nc = std::clamp(nc, nr, size_t(8192));
+  nc -= nc % nr;
+
+  blocking.mc = mc;
+  blocking.kc = kc;
+  blocking.nc = nc;
+  return blocking;
+}
+
+/**
+ * @brief 打包A的一个MCxKC面板
+ *
+ * 按MR行切分成微面板, 每个微面板内按k优先排列MR个元素,
+ * 不足MR的尾部行以0填充, 使微内核无需边界判断
+ *
+ * @tparam T 元素类型
+ * @param src A矩阵视图
+ * @param row0 面板起始行
+ * @param rows 面板行数
+ * @param col0 面板起始列(k方向)
+ * @param depth 面板列数(KC)
+ * @param packed 输出缓冲区, 至少ceil(rows/MR)*MR*depth个元素
+ */
+template <typename T>
+static void pack_a_panel(MatrixView<const T> src,
+                         size_t row0,
+                         size_t rows,
+                         size_t col0,
+                         size_t depth,
+                         T *__restrict packed)
+{
+  for (size_t ir = 0; ir < rows; ir += PACK_MR)
+  {
+    const size_t mr = min(PACK_MR, rows - ir);
+    for (size_t k = 0; k < depth; k++)
+    {
+      for (size_t i = 0; i < mr; i++)
+      {
+        packed[i] = src(row0 + ir + i, col0 + k);
+      }
+      for (size_t i = mr; i < PACK_MR; i++)
+      {
+        packed[i] = T{};
+      }
+      packed += PACK_MR;
+    }
+  }
+}
+
+/**
+ * @brief 打包B的一个KCxNC面板
+ *
+ * 按NR列切分成微面板, 每个微面板内按k优先排列NR个连续元素,
+ * 不足NR的尾部列以0填充
+ *
+ * @tparam T 元素类型
+ * @param src B矩阵视图
+ * @param row0 面板起始行(k方向)
+ * @param depth 面板行数(KC)
+ * @param col0 面板起始列
+ * @param cols 面板列数
+ * @param packed 输出缓冲区, 至少depth*ceil(cols/NR)*NR个元素
+ */
+template <typename T>
+static void pack_b_panel(MatrixView<const T> src,
+                         size_t row0,
+                         size_t depth,
+                         size_t col0,
+                         size_t cols,
+                         T *__restrict packed)
+{
+  constexpr size_t NR = PACK_NR<T>;
+  for (size_t jr = 0; jr < cols; jr += NR)
+  {
+    const size_t nr = min(NR, cols - jr);
+    for (size_t k = 0; k < depth; k++)
+    {
+      const T *__restrict b_row = src.row(row0 + k) + col0 + jr;
+      for (size_t j = 0; j < nr; j++)
+      {
+        packed[j] = b_row[j];
+      }
+      for (size_t j = nr; j < NR; j++)
+      {
+        packed[j] = T{};
+      }
+      packed += NR;
+    }
+  }
+}
+
+/**
+ * @brief GotoBLAS风格的打包矩阵乘法
+ *
+ * 五层循环结构：
+ * 1. jc: 按NC切分B的列, B面板驻留L3
+ * 2. pc: 按KC切分公共维度, 打包B的KCxNC面板
+ * 3. ic: 按MC切分C的行, 打包A的MCxKC面板(驻留L2)
+ * 4. jr/ir: 按NR/MR遍历微面板, 调用寄存器分块微内核
+ *
+ * 微内核按active_simd_isa()在AVX-512/AVX2/NEON/标量实现之间选择。
+ * 打包缓冲区按参与者编号由worker_buffer()提供, 跨调用复用(每次调用创建
+ * 线程时也不重新分配), 多个线程可以安全地并行处理不同子块。
+ *
+ * @tparam T 元素类型
+ * @param a 左操作数视图(c.rows() x K)
+ * @param b 右操作数视图(K x c.cols())
+ * @param c 结果子块视图
+ * @param blockSize 未使用, 保持与matrix_mul_tile()签名一致
+ *
+ * @pre a.cols == b.rows, a.rows == c.rows, b.cols == c.cols
+ * @note 使用累加操作(+=), 调用前需要确保c已正确初始化
+ * @see calculate_packed_blocking()
+ * @see select_micro_kernel()
+ * @see matrix_mul_tile()
+ */
+template <typename T>
+void packed_matrix_mul_tile(MatrixView<const T> a,
+                            MatrixView<const T> b,
+                            MatrixView<T> c,
+                            size_t blockSize)
+{
+  (void)blockSize;
+  constexpr size_t NR = PACK_NR<T>;
+
+  static const PackedBlocking blocking = calculate_packed_blocking(sizeof(T));
+  PackBuffer<T> &a_buffer = worker_buffer<PackBuffer<T>, 0>();
+  PackBuffer<T> &b_buffer = worker_buffer<PackBuffer<T>, 1>();
+  const MicroKernel<T> micro_kernel =
+      select_micro_kernel<T>(active_simd_isa());
+
+  const size_t rows = c.rows;
+  const size_t inner = a.cols;
+  const size_t cols = c.cols;
+  const size_t ldc = c.ld;
+
+  T *a_packed = a_buffer.reserve(blocking.mc * blocking.kc);
+  T *b_packed =
+      b_buffer.reserve(blocking.kc * ((blocking.nc + NR - 1) / NR) * NR);
+
+  for (size_t jc = 0; jc < cols; jc += blocking.nc)
+  {
+    const size_t nc = min(blocking.nc, cols - jc);
+    for (size_t pc = 0; pc < inner; pc += blocking.kc)
+    {
+      const size_t kc = min(blocking.kc, inner - pc);
+      pack_b_panel(b, pc, kc, jc, nc, b_packed);
+
+      for (size_t ic = 0; ic < rows; ic += blocking.mc)
+      {
+        const size_t mc = min(blocking.mc, rows - ic);
+        pack_a_panel(a, ic, mc, pc, kc, a_packed);
+
+        for (size_t jr = 0; jr < nc; jr += NR)
+        {
+          const size_t nr = min(NR, nc - jr);
+          const T *b_panel = b_packed + jr * kc;
+          for (size_t ir = 0; ir < mc; ir += PACK_MR)
+          {
+            const size_t mr = min(PACK_MR, mc - ir);
+            micro_kernel(kc,
+                         a_packed + ir * kc,
+                         b_panel,
+                         c.row(ic + ir) + jc + jr,
+                         ldc,
+                         mr,
+                         nr);
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief 打包矩阵乘法(行范围)
+ *
+ * 计算dst的[start, end)行, 是packed_matrix_mul_tile()在整行范围上的包装,
+ * 签名与matrix_mul()一致
+ *
+ * @tparam T 元素类型
+ * @param src1 源矩阵1, 左操作数
+ * @param src2 源矩阵2, 右操作数
+ * @param dst 目标结果矩阵
+ * @param blockSize 未使用
+ * @param start 起始行索引(包含)
+ * @param end 结束行索引(不包含)
+ *
+ * @pre src1.cols() == src2.rows(), dst的形状为src1.rows() x src2.cols()
+ * @see packed_matrix_mul_tile()
+ */
+template <typename T>
+void packed_matrix_mul(const Matrix<T> &src1,
+                       const Matrix<T> &src2,
+                       Matrix<T> &dst,
+                       size_t blockSize,
+                       size_t start,
+                       size_t end)
+{
+  packed_matrix_mul_tile(src1.tile(start, 0, end - start, src1.cols()),
+                         src2.view(),
+                         dst.tile(start, 0, end - start, dst.cols()),
+                         blockSize);
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_PACKED(T)                                             \
+  template void packed_matrix_mul<T>(const Matrix<T> &,                      \
+                                     const Matrix<T> &,                      \
+                                     Matrix<T> &,                            \
+                                     size_t,                                 \
+                                     size_t,                                 \
+                                     size_t);                                \
+  template void packed_matrix_mul_tile<T>(                                   \
+      MatrixView<const T>, MatrixView<const T>, MatrixView<T>, size_t);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_PACKED)
+#undef MM_INSTANTIATE_PACKED
@@ -0,0 +1,209 @@
+#include "MatrixMul.h"
+
+#include <atomic>
+
+#if !defined(_WIN32)
+#  include <sys/mman.h>
+#endif
+
+/// --pages选择的页面类型, 由set_page_mode()设置
+static std::atomic<PageMode> selected_pages{PageMode::Transparent};
+
+/// MAP_HUGETLB失败后回退到透明大页的次数
+static std::atomic<size_t> hugetlb_fallbacks{0};
+
+#if !defined(_WIN32)
+/**
+ * @brief 把大块分配的长度取整到HUGE_PAGE_SIZE
+ *
+ * page_alloc()和page_free()用同一公式计算映射长度, 释放时无需记录分配方式
+ */
+static size_t mapping_length(size_t bytes)
+{
+  return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+/**
+ * @brief 映射起始地址按HUGE_PAGE_SIZE对齐的匿名内存
+ *
+ * 多映射一个大页, 再裁掉首尾的多余部分; 对齐后内核才能用大页
+ * 支撑整个区域, 而不是只有中间完整的2 MiB段
+ *
+ * @param length 长度, HUGE_PAGE_SIZE的倍数
+ * @return void* 起始地址, 失败时为nullptr
+ */
+static void *map_aligned(size_t length)
+{
+  const size_t padded = length + HUGE_PAGE_SIZE;
+  void *raw = mmap(nullptr,
+                   padded,
+                   PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS,
+                   -1,
+                   0);
+  if (raw == MAP_FAILED) return nullptr;
+  char *const start = static_cast<char *>(raw);
+  const size_t misalignment =
+      reinterpret_cast<uintptr_t>(start) % HUGE_PAGE_SIZE;
+  const size_t head = misalignment == 0 ? 0 : HUGE_PAGE_SIZE - misalignment;
+  if (head > 0) munmap(start, head);
+  const size_t tail = padded - head - length;
+  if (tail > 0) munmap(start + head + length, tail);
+  return start + head;
+}
+#endif
+
+/**
+ * @brief 为矩阵和工作区分配内存
+ *
+ * 不小于HUGE_PAGE_SIZE的分配直接用mmap申请:
+ * - PageMode::Huge: 先尝试MAP_HUGETLB的2 MiB大页, 需要预先设置
+ *   vm.nr_hugepages; 失败时计入huge_page_fallbacks()并按透明大页处理
+ * - PageMode::Transparent: 2 MiB对齐的匿名映射并设置MADV_HUGEPAGE,
+ *   首次写入时由内核直接分配大页(取决于/sys/kernel/mm/transparent_hugepage)
+ * - PageMode::Small: 同样的映射但设置MADV_NOHUGEPAGE, 保证使用4 KiB页
+ *
+ * 映射的内存由内核清零且尚未分配物理页, 首次写入决定NUMA节点的行为
+ * 与posix_memalign相同。Windows的大页需要SeLockMemoryPrivilege权限,
+ * 始终使用_aligned_malloc
+ *
+ * @param bytes 分配的字节数
+ * @return void* 按MATRIX_ALIGNMENT(大块按HUGE_PAGE_SIZE)对齐的内存指针
+ * @throws std::bad_alloc 分配失败时抛出
+ */
+void *page_alloc(size_t bytes)
+{
+#if defined(_WIN32)
+  return aligned_malloc(bytes, MATRIX_ALIGNMENT);
+#else
+  if (bytes < HUGE_PAGE_SIZE) return aligned_malloc(bytes, MATRIX_ALIGNMENT);
+  const size_t length = mapping_length(bytes);
+  const PageMode mode = active_page_mode();
+  if (mode == PageMode::Huge)
+  {
+#  if defined(MAP_HUGETLB)
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#    if defined(MAP_HUGE_2MB)
+    flags |= MAP_HUGE_2MB;
+#    endif
+    void *ptr =
+        mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (ptr != MAP_FAILED) return ptr;
+#  endif
+    hugetlb_fallbacks.fetch_add(1, std::memory_order_relaxed);
+  }
+  void *ptr = map_aligned(length);
+  if (ptr == nullptr) throw std::bad_alloc();
+#  if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+  madvise(ptr,
+          length,
+          mode == PageMode::Small ? MADV_NOHUGEPAGE : MADV_HUGEPAGE);
+#  endif
+  return ptr;
+#endif
+}
+
+/**
+ * @brief 释放page_alloc()分配的内存
+ *
+ * @param ptr 内存指针, 可以为nullptr
+ * @param bytes 分配时传入的字节数, 决定释放方式和映射长度
+ */
+void page_free(void *ptr, size_t bytes)
+{
+  if (ptr == nullptr) return;
+#if defined(_WIN32)
+  (void)bytes;
+  aligned_free(ptr);
+#else
+  if (bytes < HUGE_PAGE_SIZE)
+  {
+    aligned_free(ptr);
+    return;
+  }
+  munmap(ptr, mapping_length(bytes));
+#endif
+}
+
+/**
+ * @brief 获取页面类型的名称
+ *
+ * @param mode 页面类型
+ * @return const char* 与--pages参数一致的名称
+ */
+const char *page_mode_name(PageMode mode)
+{
+  switch (mode)
+  {
+    case PageMode::Small:
+      return "4k";
+    case PageMode::Transparent:
+      return "thp";
+    case PageMode::Huge:
+      return "huge";
+  }
+  return "unknown";
+}
+
+/**
+ * @brief 设置之后page_alloc()使用的页面类型
+ *
+ * @param mode 页面类型
+ */
+void set_page_mode(PageMode mode)
+{
+  selected_pages.store(mode, std::memory_order_relaxed);
+}
+
+/**
+ * @brief 获取当前的页面类型
+ *
+ * @return PageMode 当前页面类型
+ */
+PageMode active_page_mode()
+{
+  return selected_pages.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief 获取MAP_HUGETLB失败后回退到透明大页的分配次数
+ *
+ * @return size_t 回退次数
+ */
+size_t huge_page_fallbacks()
+{
+  return hugetlb_fallbacks.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief 统计进程中由大页支撑的内存
+ *
+ * 优先读取汇总的/proc/self/smaps_rollup(Linux 4.14+), 否则累加
+ * /proc/self/smaps中每个映射的同名字段; 两者的字段格式相同(单位kB)
+ *
+ * @return size_t 字节数, 非Linux系统或无法读取时为0
+ */
+size_t huge_page_bytes()
+{
+#if defined(__linux__)
+  std::ifstream smaps("/proc/self/smaps_rollup");
+  if (!smaps.is_open()) smaps.open("/proc/self/smaps");
+  size_t total_kb = 0;
+  string line;
+  while (std::getline(smaps, line))
+  {
+    std::istringstream fields(line);
+    string key;
+    size_t kb = 0;
+    fields >> key >> kb;
+    if (key == "AnonHugePages:" || key == "Private_Hugetlb:"
+        || key == "Shared_Hugetlb:")
+    {
+      total_kb += kb;
+    }
+  }
+  return total_kb * 1024;
+#else
+  return 0;
+#endif
+}
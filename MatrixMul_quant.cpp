@@ -0,0 +1,573 @@
+#include "MatrixMul.h"
+
+#include <utility>
+
+/// uint8激活的零点, 实际值为a - QUANT_ZERO_POINT
+static constexpr int32_t QUANT_ZERO_POINT = 128;
+
+/**
+ * @brief 获取量化类型的名称
+ *
+ * @param type 量化类型
+ * @return const char* 与--quant参数一致的名称
+ */
+const char *quant_type_name(QuantType type)
+{
+  switch (type)
+  {
+    case QuantType::U8S8:
+      return "u8s8";
+    case QuantType::S16S16:
+      return "s16s16";
+    case QuantType::None:
+      break;
+  }
+  return "none";
+}
+
+/**
+ * @brief 按微内核的分组格式预先打包的B矩阵
+ *
+ * 推理中的权重不随输入变化, 因此只在计时之外打包一次: 每QUANT_NR列
+ * 一个面板, 面板内按QUANT_GROUP个公共维度元素分组连续存放,
+ * 超出K和N的部分补零; 同时保存每列之和, 用于A的零点修正
+ *
+ * @tparam TB B的元素类型
+ */
+template <typename TB> struct QuantPackedB
+{
+  Matrix<TB> panels; ///< 第p行为第p个列面板
+  vector<int32_t> column_sums; ///< 各列元素之和, 长度为面板数 * QUANT_NR
+};
+
+/**
+ * @brief 打包B矩阵并计算列和
+ *
+ * @tparam G 分组长度
+ * @tparam TB B的元素类型
+ * @param b K x N的B矩阵
+ * @return QuantPackedB<TB> 打包结果
+ */
+template <size_t G, typename TB>
+static QuantPackedB<TB> pack_quant_b(const Matrix<TB> &b)
+{
+  const size_t k = b.rows();
+  const size_t n = b.cols();
+  const size_t groups = (k + G - 1) / G;
+  const size_t panel_count = (n + QUANT_NR - 1) / QUANT_NR;
+  QuantPackedB<TB> packed{Matrix<TB>(panel_count, groups * QUANT_NR * G),
+                          vector<int32_t>(panel_count * QUANT_NR, 0)};
+  for (size_t p = 0; p < panel_count; p++)
+  {
+    TB *panel = packed.panels.row(p);
+    for (size_t kk = 0; kk < k; kk++)
+    {
+      const TB *b_row = b.row(kk);
+      TB *group = panel + (kk / G) * QUANT_NR * G + kk % G;
+      for (size_t jj = 0; jj < QUANT_NR && p * QUANT_NR + jj < n; jj++)
+      {
+        group[jj * G] = b_row[p * QUANT_NR + jj];
+        packed.column_sums[p * QUANT_NR + jj] += b_row[p * QUANT_NR + jj];
+      }
+    }
+  }
+  return packed;
+}
+
+/**
+ * @brief 打包A的一个行面板
+ *
+ * @tparam G 分组长度
+ * @tparam TA A的元素类型
+ * @param a M x K的A矩阵
+ * @param row0 面板的起始行
+ * @param signed_a 是否按int8打包(uint8值减128)
+ * @param panel 输出, QUANT_MR * 分组数 * G个元素, 超出M和K的部分补零
+ */
+template <size_t G, typename TA>
+static void pack_quant_a(const Matrix<TA> &a,
+                         size_t row0,
+                         bool signed_a,
+                         TA *panel)
+{
+  const size_t k = a.cols();
+  const size_t groups = (k + G - 1) / G;
+  std::fill(panel, panel + QUANT_MR * groups * G, TA(0));
+  for (size_t i = 0; i < QUANT_MR && row0 + i < a.rows(); i++)
+  {
+    const TA *a_row = a.row(row0 + i);
+    for (size_t kk = 0; kk < k; kk++)
+    {
+      TA value = a_row[kk];
+      if constexpr (sizeof(TA) == 1)
+      {
+        // 翻转最高位即减去128后的int8补码
+        if (signed_a) value = static_cast<TA>(value ^ 0x80);
+      }
+      panel[(kk / G) * QUANT_MR * G + i * G + kk % G] = value;
+    }
+  }
+}
+
+/**
+ * @brief 把int32累加结果重新量化为int8
+ *
+ * @param acc 零点修正后的累加结果
+ * @param multiplier 输出比例(int8单位 / int32单位)
+ * @return int8_t round(acc * multiplier)饱和到[-128, 127]
+ */
+static int8_t requantize(int32_t acc, float multiplier)
+{
+  const float scaled = std::nearbyint(static_cast<float>(acc) * multiplier);
+  return static_cast<int8_t>(std::clamp(scaled, -128.0f, 127.0f));
+}
+
+/**
+ * @brief 量化GEMM的计算过程
+ *
+ * 计算C = (A - za) * B的[first, last)行面板: 外层按B列块循环, 一个列块
+ * 约占当前线程L2份额的一半, 在该块内依次打包A的行面板并调用微内核;
+ * 微内核的int32累加结果在写回时融合零点修正和输出转换, 不经过
+ * 中间的int32矩阵
+ *
+ * @tparam TA A的元素类型
+ * @tparam TB B的元素类型
+ * @tparam Out 输出类型: int8_t时重新量化, int32_t时保留累加结果(验证用)
+ */
+template <typename TA, typename TB, typename Out> struct QuantGemm
+{
+  const Matrix<TA> &a; ///< M x K的A矩阵
+  const QuantPackedB<TB> &b; ///< 打包后的B矩阵
+  QuantKernel<TA, TB> kernel; ///< 微内核
+  int32_t zero_point; ///< A的零点修正量(已扣除signed_a打包减去的128)
+  float multiplier; ///< 输出比例, 仅Out为int8_t时使用
+  size_t panels_per_block; ///< 每个B列块包含的面板数
+
+  void operator()(Matrix<Out> &c, size_t first, size_t last) const
+  {
+    constexpr size_t G = QUANT_GROUP<TA>;
+    const size_t m = c.rows();
+    const size_t n = c.cols();
+    const size_t groups = (a.cols() + G - 1) / G;
+    const size_t panel_count = b.panels.rows();
+    PackBuffer<TA> &a_buffer = worker_buffer<PackBuffer<TA>>();
+    TA *a_panel = a_buffer.reserve(QUANT_MR * groups * G);
+    alignas(64) int32_t acc[QUANT_MR * QUANT_NR];
+    for (size_t p0 = 0; p0 < panel_count; p0 += panels_per_block)
+    {
+      const size_t p1 = std::min(p0 + panels_per_block, panel_count);
+      for (size_t ip = first; ip < last; ip++)
+      {
+        const size_t row0 = ip * QUANT_MR;
+        const size_t rows = std::min(QUANT_MR, m - row0);
+        pack_quant_a<G>(a, row0, kernel.signed_a, a_panel);
+        for (size_t p = p0; p < p1; p++)
+        {
+          kernel.kernel(groups, a_panel, b.panels.row(p), acc);
+          const size_t col0 = p * QUANT_NR;
+          const size_t cols = std::min(QUANT_NR, n - col0);
+          const int32_t *sums = b.column_sums.data() + col0;
+          for (size_t i = 0; i < rows; i++)
+          {
+            Out *c_row = c.row(row0 + i) + col0;
+            for (size_t j = 0; j < cols; j++)
+            {
+              const int32_t value =
+                  acc[i * QUANT_NR + j] - zero_point * sums[j];
+              if constexpr (std::is_same_v<Out, int8_t>)
+              {
+                c_row[j] = requantize(value, multiplier);
+              }
+              else
+              {
+                c_row[j] = value;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+/**
+ * @brief 逐元素比较两个int8矩阵
+ *
+ * compare_matrices()只为MM_FOR_EACH_DTYPE中的类型实例化, int8输出在此比较
+ *
+ * @param expected 参考结果
+ * @param actual 待验证的结果
+ * @return VerifyResult 验证结论, 不一致时给出第一个出错的元素
+ */
+static VerifyResult compare_int8(const Matrix<int8_t> &expected,
+                                 const Matrix<int8_t> &actual)
+{
+  VerifyResult result;
+  for (size_t i = 0; i < expected.rows(); i++)
+  {
+    for (size_t j = 0; j < expected.cols(); j++)
+    {
+      if (expected(i, j) == actual(i, j)) continue;
+      if (result.passed)
+      {
+        result.first_row = i;
+        result.first_col = j;
+      }
+      result.passed = false;
+      result.mismatches++;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief s16s16输入的取值上界
+ *
+ * 输入取[-R, R]时每个乘积不超过R², K个乘积之和不超过K * R², 取满足
+ * K * R² <= INT32_MAX的最大R(不超过32767), 使int32累加和int32对照
+ * 都不溢出; vpmaddwd的相邻两项之和不超过2 * 32767², 同样不饱和
+ *
+ * @param k 公共维度
+ * @return int32_t 上界R
+ */
+static int32_t s16_input_bound(size_t k)
+{
+  const double limit = static_cast<double>(std::numeric_limits<int32_t>::max())
+                       / static_cast<double>(std::max(k, size_t(1)));
+  const auto bound = static_cast<int32_t>(std::sqrt(limit));
+  return std::clamp(bound, int32_t(1), int32_t(32767));
+}
+
+/**
+ * @brief 以指定输入类型运行量化GEMM基准测试
+ *
+ * 执行流程：
+ * 1. 生成量化输入A(M x K)和B(K x N)及其int32副本; uint8的A带零点
+ *    QUANT_ZERO_POINT, int8的B取[-64, 63](7位权重, 保证AVX2的
+ *    vpmaddubsw不饱和); int16的输入取s16_input_bound(K)给出的[-R, R],
+ *    K不超过131071时超出int8范围, 覆盖int16乘积和int32累加的高位
+ * 2. 用config.kernel在int32副本上测量int32 GEMM作为对照, 并按
+ *    --verify验证其结果
+ * 3. 以int32结果的最大绝对值标定输出比例, 使int8输出覆盖[-127, 127]
+ * 4. 在计时之外打包B, 测量量化路径: 行面板按parallel_rows()划分,
+ *    每个线程先打包A的面板再调用微内核, 写回时融合重新量化
+ * 5. 除--verify none外, 另外以int32输出运行一次量化路径, 要求与int32
+ *    结果逐元素相等, 并要求int8输出与int32结果的重新量化逐元素相等;
+ *    --verify none时两条路径都不标记为通过, 结果表显示"未验证"
+ *
+ * 两条路径的运算量都按2mnk计算, 性能单位为GOPS。
+ *
+ * @tparam TA A的元素类型
+ * @tparam TB B的元素类型
+ * @param config 基准测试配置
+ * @param report 运行结果
+ * @return int 程序退出状态码, 0表示成功或未验证, 1表示有结果验证失败
+ */
+template <typename TA, typename TB>
+static int run_quantized_typed(const BenchmarkConfig &config,
+                               BenchmarkReport &report)
+{
+  constexpr size_t G = QUANT_GROUP<TA>;
+  constexpr bool bytes = sizeof(TA) == 1;
+  const size_t m = config.shape_m;
+  const size_t n = config.shape_n;
+  const size_t k = config.shape_k;
+  const size_t threads = config.num_threads;
+
+  const QuantKernel<TA, TB> kernel =
+      select_quant_kernel<TA, TB>(active_simd_isa());
+  const int32_t zero_point = bytes ? QUANT_ZERO_POINT : 0;
+  const int32_t zero_correction = zero_point - (kernel.signed_a ? 128 : 0);
+
+  std::unique_ptr<ThreadPool> pool;
+  if (config.use_pool)
+  {
+    pool = std::make_unique<ThreadPool>(threads);
+  }
+
+  // 量化输入与值相同的int32副本(A已减去零点); int16输入在[-R, R]内
+  // 均匀散列, 包括两端
+  const int32_t bound = s16_input_bound(k);
+  const size_t span = static_cast<size_t>(2 * bound + 1);
+  auto s16_value = [&](size_t hash)
+  {
+    return static_cast<int>(hash * 2654435761u % span) - bound;
+  };
+  Matrix<TA> a(m, k, 0, matrix_no_init);
+  Matrix<TB> b(k, n, 0, matrix_no_init);
+  const size_t ld_a = configured_leading_dimension(config, k);
+  const size_t ld_b = configured_leading_dimension(config, n);
+  Matrix<int> a32(m, k, ld_a, matrix_no_init);
+  Matrix<int> b32(k, n, ld_b, matrix_no_init);
+  parallel_rows(m,
+                threads,
+                pool.get(),
+                [&](size_t start, size_t end)
+                {
+                  for (size_t i = start; i < end; i++)
+                  {
+                    for (size_t j = 0; j < k; j++)
+                    {
+                      const size_t hash = i * 31 + j * 17;
+                      a(i, j) = static_cast<TA>(
+                          bytes ? static_cast<int>(hash % 256)
+                                : s16_value(hash));
+                      a32(i, j) = static_cast<int>(a(i, j)) - zero_point;
+                    }
+                  }
+                });
+  parallel_rows(k,
+                threads,
+                pool.get(),
+                [&](size_t start, size_t end)
+                {
+                  for (size_t i = start; i < end; i++)
+                  {
+                    for (size_t j = 0; j < n; j++)
+                    {
+                      const size_t hash = i * 17 + j * 31;
+                      b(i, j) = static_cast<TB>(
+                          bytes ? static_cast<int>(hash % 128) - 64
+                                : s16_value(hash + 1));
+                      b32(i, j) = b(i, j);
+                    }
+                  }
+                });
+  Matrix<int> c32(m, n, ld_b, matrix_no_init);
+  Matrix<int8_t> c8(m, n, 0, matrix_no_init);
+
+  const QuantPackedB<TB> packed = pack_quant_b<G>(b);
+  const CacheInfo &cache = get_cache_info();
+  const size_t panel_bytes = packed.panels.cols() * sizeof(TB);
+  const size_t panels_per_block = std::max<size_t>(
+      cache_share(cache.l2_cache_size, cache.l2_shared_cpus) / 2 / panel_bytes,
+      1);
+  const size_t row_panels = (m + QUANT_MR - 1) / QUANT_MR;
+
+  const double quant_mb =
+      static_cast<double>(a.size_bytes() + packed.panels.size_bytes()
+                          + c8.size_bytes())
+      / (1024.0 * 1024.0);
+  const double int32_mb =
+      static_cast<double>(a32.size_bytes() + b32.size_bytes()
+                          + c32.size_bytes())
+      / (1024.0 * 1024.0);
+  report.config = config;
+  report.leading_dimension = b32.ld();
+  report.memory_mb = quant_mb + int32_mb;
+
+  cout << "=== 量化GEMM测试配置 ===" << endl;
+  cout << "问题形状: C(" << m << "x" << n << ") = A(" << m << "x" << k
+       << ") * B(" << k << "x" << n << ")" << endl;
+  cout << "输入类型: " << quant_type_name(config.quant) << " ("
+       << (bytes ? "uint8激活, 零点 " : "int16激活, 零点 ") << zero_point
+       << (bytes ? "; int8权重" : "; int16权重") << "), int32累加, int8输出"
+       << endl;
+  if (!bytes)
+  {
+    cout << "int16取值范围: [" << -bound << ", " << bound
+         << "] (K * R²不超过int32上限)" << endl;
+  }
+  cout << "量化路径: " << kernel.path;
+  if (*kernel.instruction != '\0') cout << " (" << kernel.instruction << ")";
+  cout << ", 微内核 " << QUANT_MR << "x" << QUANT_NR << ", B列块 "
+       << std::min(panels_per_block, packed.panels.rows()) * QUANT_NR
+       << " 列" << endl;
+  cout << "int32对照: " << kernel_name(config.kernel) << endl;
+  cout << "线程数: " << threads << endl;
+  cout << "迭代次数: " << config.iterations << " (预热 " << config.warmup
+       << " 次)" << endl;
+  cout << "内存使用量约: " << fixed << setprecision(2)
+       << quant_mb + int32_mb << " MB (量化 " << quant_mb << " MB, int32 "
+       << int32_mb << " MB)" << endl;
+  cout << "==================" << endl << endl;
+
+  // 测量一条路径, single和multi分别执行单线程和多线程计算
+  Timer timer;
+  auto measure = [&](const string &name,
+                     const std::function<void()> &reset,
+                     const std::function<void()> &single,
+                     const std::function<void()> &multi)
+  {
+    KernelRun run;
+    run.kernel = name;
+    run.operations = 2.0 * static_cast<double>(m) * static_cast<double>(n)
+                     * static_cast<double>(k);
+    for (size_t iter = 0; iter < config.warmup + config.iterations; iter++)
+    {
+      const bool warm = iter < config.warmup;
+      if (!config.skip_single)
+      {
+        reset();
+        timer.start();
+        single();
+        timer.stop();
+        if (!warm) run.single_seconds.push_back(timer.get_seconds());
+      }
+      reset();
+      timer.start();
+      multi();
+      timer.stop();
+      if (!warm) run.multi_seconds.push_back(timer.get_seconds());
+    }
+    if (config.verbose)
+    {
+      cout << "  " << name << ": " << fixed << setprecision(6)
+           << compute_sample_stats(run.multi_seconds).median << " 秒" << endl;
+    }
+    return run;
+  };
+
+  cout << "开始量化测试..." << endl;
+  const GemmKernel<int> dense_kernel = select_kernel<int>(config.kernel);
+  auto int32_multi = [&](Matrix<int> &c, KernelType type)
+  {
+    if (type == KernelType::Strassen)
+    {
+      parallel_strassen_matrix_mul(
+          a32, b32, c, config.block_size, threads, pool.get());
+    }
+    else
+    {
+      parallel_computing_partitioned(a32,
+                                     b32,
+                                     c,
+                                     config.block_size,
+                                     threads,
+                                     select_tile_kernel<int>(type),
+                                     pool.get());
+    }
+  };
+  KernelRun int32_run = measure(
+      string("int32-") + kernel_name(config.kernel),
+      [&] { parallel_first_touch(c32, threads, pool.get()); },
+      [&] { dense_kernel(a32, b32, c32, config.block_size, 0, m); },
+      [&] { int32_multi(c32, config.kernel); });
+
+  // int32对照的验证方式与稠密测试相同
+  VerifyResult int32_verdict;
+  if (config.verify == VerifyMode::Freivalds)
+  {
+    int32_verdict = freivalds_verify(
+        a32, b32, c32, config.verify_rounds, 0.0, threads, pool.get());
+  }
+  else if (config.verify == VerifyMode::Exact)
+  {
+    Matrix<int> reference(m, n, ld_b, matrix_no_init);
+    parallel_first_touch(reference, threads, pool.get());
+    int32_multi(reference,
+                config.kernel == KernelType::Blocked ? KernelType::Packed
+                                                     : KernelType::Blocked);
+    int32_verdict =
+        compare_matrices(reference, c32, 0.0, threads, pool.get());
+  }
+  const bool checked = config.verify != VerifyMode::None;
+  int32_run.verified = checked && int32_verdict.passed;
+
+  // 输出比例: int32结果的最大绝对值映射到127
+  int64_t max_abs = 1;
+  for (size_t i = 0; i < m; i++)
+  {
+    for (size_t j = 0; j < n; j++)
+    {
+      max_abs = std::max(max_abs, std::abs(static_cast<int64_t>(c32(i, j))));
+    }
+  }
+  const float multiplier = 127.0f / static_cast<float>(max_abs);
+
+  const QuantGemm<TA, TB, int8_t> gemm{
+      a, packed, kernel, zero_correction, multiplier, panels_per_block};
+  KernelRun quant_run = measure(
+      string(quant_type_name(config.quant)) + "-" + kernel.path,
+      [] {},
+      [&] { gemm(c8, 0, row_panels); },
+      [&]
+      {
+        parallel_rows(row_panels,
+                      threads,
+                      pool.get(),
+                      [&](size_t start, size_t end) { gemm(c8, start, end); });
+      });
+
+  if (checked)
+  {
+    // 累加结果要与int32对照逐元素相等, 输出要与对照的重新量化逐元素相等
+    Matrix<int> acc32(m, n, ld_b, matrix_no_init);
+    const QuantGemm<TA, TB, int> accumulate{
+        a, packed, kernel, zero_correction, multiplier, panels_per_block};
+    parallel_rows(row_panels,
+                  threads,
+                  pool.get(),
+                  [&](size_t start, size_t end)
+                  { accumulate(acc32, start, end); });
+    Matrix<int8_t> expected(m, n, 0, matrix_no_init);
+    for (size_t i = 0; i < m; i++)
+    {
+      for (size_t j = 0; j < n; j++)
+      {
+        expected(i, j) = requantize(c32(i, j), multiplier);
+      }
+    }
+    const VerifyResult accumulated =
+        compare_matrices(c32, acc32, 0.0, threads, pool.get());
+    quant_run.verified = int32_run.verified && accumulated.passed
+                         && compare_int8(expected, c8).passed;
+  }
+
+  report.runs.push_back(quant_run);
+  report.runs.push_back(int32_run);
+
+  const double int32_multi_seconds =
+      compute_sample_stats(int32_run.multi_seconds).median;
+  cout << endl << "=== 量化GEMM结果 (GOPS) ===" << endl;
+  // 表头按显示宽度手工对齐(setw按字节计数, 不适用于中文)
+  cout << "路径                  单线程(秒)     多线程(秒)      单线程"
+          "      多线程  对int32加速  验证"
+       << endl;
+  for (const KernelRun &run : report.runs)
+  {
+    const double single = compute_sample_stats(run.single_seconds).median;
+    const double multi = compute_sample_stats(run.multi_seconds).median;
+    cout << std::left << setw(20) << run.kernel << std::right << fixed
+         << setprecision(6);
+    if (config.skip_single)
+    {
+      cout << setw(12) << "-" << setw(15) << multi << setprecision(2)
+           << setw(12) << "-";
+    }
+    else
+    {
+      cout << setw(12) << single << setw(15) << multi << setprecision(2)
+           << setw(12) << run.operations / (single * 1e9);
+    }
+    cout << setw(12) << run.operations / (multi * 1e9) << setw(12)
+         << int32_multi_seconds / multi << "x"
+         << (!checked ? "  未验证" : run.verified ? "  通过" : "  失败")
+         << endl;
+  }
+  cout << "==================" << endl;
+  cout << "量化路径不含B的打包(权重只打包一次), 含A的打包和int8重新量化; "
+          "输出比例 "
+       << scientific << setprecision(3) << multiplier << fixed << endl;
+  if (!checked) return 0;
+  cout << "结果验证(" << verify_mode_name(config.verify) << "): "
+       << (quant_run.verified && int32_run.verified ? "通过" : "失败") << endl;
+  return quant_run.verified && int32_run.verified ? 0 : 1;
+}
+
+/**
+ * @brief 运行量化GEMM基准测试(--quant)
+ *
+ * @param config 基准测试配置, 使用其中的quant和shape_m/shape_n/shape_k
+ * @param report 运行结果, 追加量化路径和int32对照各一条记录
+ * @return int 程序退出状态码, 0表示成功, 1表示有结果验证失败
+ * @see run_quantized_typed()
+ */
+int run_quantized(const BenchmarkConfig &config, BenchmarkReport &report)
+{
+  if (config.quant == QuantType::S16S16)
+  {
+    return run_quantized_typed<int16_t, int16_t>(config, report);
+  }
+  return run_quantized_typed<uint8_t, int8_t>(config, report);
+}
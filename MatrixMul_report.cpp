@@ -0,0 +1,808 @@
+#include "MatrixMul.h"
+
+#include <ctime>
+
+/// 结果格式版本, 字段含义变化时递增
+static constexpr int REPORT_SCHEMA_VERSION = 1;
+
+/**
+ * @brief 由每次迭代的时间推导出的指标
+ */
+struct RunMetrics
+{
+  double single_avg = 0.0; ///< 单线程平均时间(秒)
+  double multi_avg = 0.0; ///< 多线程平均时间(秒)
+  double speedup = 0.0; ///< 加速比
+  double efficiency = 0.0; ///< 并行效率(0~1)
+  double single_throughput = 0.0; ///< 单线程性能(GFLOPS/GOPS)
+  double multi_throughput = 0.0; ///< 多线程性能(GFLOPS/GOPS)
+  double single_bandwidth = 0.0; ///< 单线程有效带宽(GB/s), 未统计时为0
+  double multi_bandwidth = 0.0; ///< 多线程有效带宽(GB/s), 未统计时为0
+  double intensity = 0.0; ///< 算术强度, 见gemm_intensity()
+  double single_roofline = NAN; ///< 单线程性能占屋顶线上限的比例
+  double multi_roofline = NAN; ///< 多线程性能占屋顶线上限的比例
+};
+
+/**
+ * @brief 计算一个内核的平均时间、加速比和性能
+ *
+ * 运算量按2mnk计算(批量模式再乘以矩阵个数), 与控制台输出一致;
+ * 记录了每次迭代的运算量和访存量时(稀疏模式)改用记录值, 并给出有效带宽,
+ * 算术强度为两者之比。测量了屋顶线模型时同时给出性能占屋顶线上限的比例
+ *
+ * @param run 测量结果
+ * @param report 运行结果, 使用其中的配置和屋顶线模型
+ * @return RunMetrics 推导指标
+ */
+static RunMetrics compute_metrics(const KernelRun &run,
+                                  const BenchmarkReport &report)
+{
+  const BenchmarkConfig &config = report.config;
+  RunMetrics metrics;
+  for (double seconds : run.single_seconds)
+  {
+    metrics.single_avg += seconds;
+  }
+  for (double seconds : run.multi_seconds)
+  {
+    metrics.multi_avg += seconds;
+  }
+  if (!run.single_seconds.empty())
+  {
+    metrics.single_avg /= static_cast<double>(run.single_seconds.size());
+  }
+  if (!run.multi_seconds.empty())
+  {
+    metrics.multi_avg /= static_cast<double>(run.multi_seconds.size());
+  }
+
+  const double matrices =
+      static_cast<double>(std::max(config.batch, size_t(1)));
+  const double operations = run.operations > 0.0
+                                ? run.operations
+                                : 2.0 * matrices
+                                      * static_cast<double>(config.shape_m)
+                                      * static_cast<double>(config.shape_n)
+                                      * static_cast<double>(config.shape_k);
+  if (metrics.multi_avg > 0.0)
+  {
+    metrics.multi_throughput = operations / (metrics.multi_avg * 1e9);
+    metrics.multi_bandwidth = run.bytes / (metrics.multi_avg * 1e9);
+  }
+  if (metrics.multi_avg > 0.0 && metrics.single_avg > 0.0)
+  {
+    metrics.speedup = metrics.single_avg / metrics.multi_avg;
+    metrics.efficiency =
+        metrics.speedup / static_cast<double>(config.num_threads);
+  }
+  if (metrics.single_avg > 0.0)
+  {
+    metrics.single_throughput = operations / (metrics.single_avg * 1e9);
+    metrics.single_bandwidth = run.bytes / (metrics.single_avg * 1e9);
+  }
+
+  metrics.intensity = run.bytes > 0.0
+                          ? operations / run.bytes
+                          : gemm_intensity(config.shape_m,
+                                           config.shape_n,
+                                           config.shape_k,
+                                           dtype_size(config.dtype));
+  const RooflineModel &model = report.roofline;
+  if (model.peak_multi > 0.0 && metrics.single_avg > 0.0)
+  {
+    metrics.single_roofline =
+        metrics.single_throughput
+        / roofline_bound(model, metrics.intensity, false);
+  }
+  if (model.peak_multi > 0.0 && metrics.multi_avg > 0.0)
+  {
+    metrics.multi_roofline =
+        metrics.multi_throughput
+        / roofline_bound(model, metrics.intensity, true);
+  }
+  return metrics;
+}
+
+/**
+ * @brief 获取当前UTC时间的ISO 8601字符串
+ *
+ * @return string 例如"2025-01-31T08:00:00Z"
+ */
+static string utc_timestamp()
+{
+  std::time_t now = std::time(nullptr);
+  std::tm utc{};
+#ifdef _WIN32
+  gmtime_s(&utc, &now);
+#else
+  gmtime_r(&now, &utc);
+#endif
+  char buffer[32];
+  std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+  return buffer;
+}
+
+/**
+ * @brief 转义JSON字符串并加上引号
+ *
+ * @param text 原始字符串(UTF-8)
+ * @return string JSON字符串字面量
+ */
+static string json_string(const string &text)
+{
+  std::ostringstream out;
+  out << '"';
+  for (char ch : text)
+  {
+    const unsigned char byte = static_cast<unsigned char>(ch);
+    switch (ch)
+    {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (byte < 0x20)
+        {
+          out << "\\u" << std::hex << setw(4) << std::setfill('0')
+              << static_cast<int>(byte) << std::dec << std::setfill(' ');
+        }
+        else
+        {
+          out << ch;
+        }
+    }
+  }
+  out << '"';
+  return out.str();
+}
+
+/**
+ * @brief 把浮点数格式化为JSON数值
+ *
+ * 保留足够的有效数字以便还原; 非有限值输出为null
+ */
+static string json_number(double value)
+{
+  if (!std::isfinite(value)) return "null";
+  std::ostringstream out;
+  out << std::setprecision(10) << value;
+  return out.str();
+}
+
+/**
+ * @brief 把浮点数组格式化为JSON数组
+ */
+static string json_array(const vector<double> &values)
+{
+  string result = "[";
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    if (i > 0) result += ", ";
+    result += json_number(values[i]);
+  }
+  return result + "]";
+}
+
+/**
+ * @brief 把字符串数组格式化为JSON数组
+ */
+static string json_array(const vector<string> &values)
+{
+  string result = "[";
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    if (i > 0) result += ", ";
+    result += json_string(values[i]);
+  }
+  return result + "]";
+}
+
+/**
+ * @brief 把整数数组格式化为JSON数组
+ */
+static string json_array(const vector<size_t> &values)
+{
+  string result = "[";
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    if (i > 0) result += ", ";
+    result += std::to_string(values[i]);
+  }
+  return result + "]";
+}
+
+/**
+ * @brief 把样本统计量格式化为JSON对象
+ */
+static string json_stats(const SampleStats &stats)
+{
+  string outliers = "[";
+  for (size_t i = 0; i < stats.outliers.size(); i++)
+  {
+    if (i > 0) outliers += ", ";
+    outliers += std::to_string(stats.outliers[i]);
+  }
+  outliers += "]";
+  return "{\"count\": " + std::to_string(stats.count)
+         + ", \"min\": " + json_number(stats.min)
+         + ", \"median\": " + json_number(stats.median)
+         + ", \"p90\": " + json_number(stats.p90)
+         + ", \"max\": " + json_number(stats.max)
+         + ", \"mean\": " + json_number(stats.mean)
+         + ", \"stddev\": " + json_number(stats.stddev)
+         + ", \"ci_low\": " + json_number(stats.ci_low)
+         + ", \"ci_high\": " + json_number(stats.ci_high)
+         + ", \"outliers\": " + outliers + "}";
+}
+
+/**
+ * @brief 把硬件计数器读数格式化为JSON对象
+ *
+ * 字段为每次迭代的平均值, 不支持的事件为null; 没有读数时返回null
+ */
+static string json_counters(const CounterReadings &readings)
+{
+  if (readings.samples == 0) return "null";
+  const double samples = static_cast<double>(readings.samples);
+  return "{\"samples\": " + std::to_string(readings.samples)
+         + ", \"cycles\": " + json_number(readings.cycles / samples)
+         + ", \"instructions\": "
+         + json_number(readings.instructions / samples)
+         + ", \"l1d_misses\": " + json_number(readings.l1d_misses / samples)
+         + ", \"llc_misses\": " + json_number(readings.llc_misses / samples)
+         + ", \"dtlb_misses\": "
+         + json_number(readings.dtlb_misses / samples) + "}";
+}
+
+/**
+ * @brief 把线程级遥测格式化为JSON对象
+ *
+ * 汇总字段和每个线程的时间线都是每次调用的平均值(秒), 工作量为累计值;
+ * 没有记录时返回null
+ */
+static string json_telemetry(const ThreadTelemetry &telemetry)
+{
+  if (telemetry.calls == 0) return "null";
+  const double calls = static_cast<double>(telemetry.calls);
+  string workers = "[";
+  for (size_t t = 0; t < telemetry.workers.size(); t++)
+  {
+    const WorkerRecord &worker = telemetry.workers[t];
+    if (!worker.active) continue;
+    if (workers.size() > 1) workers += ", ";
+    workers += "{\"thread\": " + std::to_string(t)
+               + ", \"cpu\": " + std::to_string(worker.cpu)
+               + ", \"start\": " + json_number(worker.start / calls)
+               + ", \"end\": " + json_number(worker.end / calls)
+               + ", \"busy\": " + json_number(worker.busy / calls)
+               + ", \"work_items\": " + std::to_string(worker.work_items)
+               + "}";
+  }
+  workers += "]";
+  const double avg_busy = telemetry.avg_busy / calls;
+  const double max_busy = telemetry.max_busy / calls;
+  return "{\"calls\": " + std::to_string(telemetry.calls)
+         + ", \"wall\": " + json_number(telemetry.wall / calls)
+         + ", \"fork\": " + json_number(telemetry.fork / calls)
+         + ", \"join\": " + json_number(telemetry.join / calls)
+         + ", \"max_busy\": " + json_number(max_busy)
+         + ", \"min_busy\": " + json_number(telemetry.min_busy / calls)
+         + ", \"avg_busy\": " + json_number(avg_busy)
+         + ", \"imbalance\": "
+         + json_number(avg_busy > 0.0 ? max_busy / avg_busy : 0.0)
+         + ", \"workers\": " + workers + "}";
+}
+
+/**
+ * @brief 把屋顶线模型的机器参数格式化为JSON对象
+ *
+ * 峰值为GFLOPS/GOPS, 带宽为GB/s, 延迟为纳秒; 没有测量时返回null
+ */
+static string json_roofline(const RooflineModel &model)
+{
+  if (model.peak_multi <= 0.0) return "null";
+  string peaks = "[";
+  for (size_t i = 0; i < model.isa_peaks.size(); i++)
+  {
+    if (i > 0) peaks += ", ";
+    peaks += "{\"isa\": " + json_string(simd_isa_name(model.isa_peaks[i].isa))
+             + ", \"throughput\": "
+             + json_number(model.isa_peaks[i].throughput) + "}";
+  }
+  peaks += "]";
+  string stream = "[";
+  for (size_t i = 0; i < model.stream.size(); i++)
+  {
+    const StreamResult &result = model.stream[i];
+    if (i > 0) stream += ", ";
+    stream += "{\"name\": " + json_string(result.name)
+              + ", \"single\": " + json_number(result.single_bandwidth)
+              + ", \"multi\": " + json_number(result.multi_bandwidth) + "}";
+  }
+  stream += "]";
+  string levels = "[";
+  for (size_t i = 0; i < model.levels.size(); i++)
+  {
+    const MemoryLevelProbe &probe = model.levels[i];
+    if (i > 0) levels += ", ";
+    levels += "{\"name\": " + json_string(probe.name)
+              + ", \"bytes\": " + std::to_string(probe.bytes)
+              + ", \"latency_ns\": " + json_number(probe.latency_ns)
+              + ", \"bandwidth\": " + json_number(probe.bandwidth) + "}";
+  }
+  levels += "]";
+  return "{\"isa\": " + json_string(simd_isa_name(model.isa))
+         + ", \"num_threads\": " + std::to_string(model.num_threads)
+         + ", \"isa_peaks\": " + peaks
+         + ", \"peak_single\": " + json_number(model.peak_single)
+         + ", \"peak_multi\": " + json_number(model.peak_multi)
+         + ", \"bandwidth_single\": " + json_number(model.bandwidth_single)
+         + ", \"bandwidth_multi\": " + json_number(model.bandwidth_multi)
+         + ", \"stream\": " + stream + ", \"levels\": " + levels + "}";
+}
+
+/**
+ * @brief 核外模式的磁盘读带宽(GB/s), 按预取线程的读取时间计算
+ */
+static double ooc_read_bandwidth(const OutOfCoreStats &stats)
+{
+  if (stats.load_seconds <= 0.0) return 0.0;
+  return stats.bytes_read / (stats.load_seconds * 1e9);
+}
+
+/**
+ * @brief 核外模式的磁盘写带宽(GB/s), 按写回映射区和msync的时间计算
+ */
+static double ooc_write_bandwidth(const OutOfCoreStats &stats)
+{
+  const double seconds = stats.write_seconds + stats.sync_seconds;
+  if (seconds <= 0.0) return 0.0;
+  return stats.bytes_written / (seconds * 1e9);
+}
+
+/**
+ * @brief 把核外模式的时间分解格式化为JSON对象
+ *
+ * 时间为每次迭代的平均秒数, 带宽为GB/s; 没有运行核外模式时返回null
+ */
+static string json_out_of_core(const OutOfCoreStats &stats)
+{
+  if (stats.tile == 0) return "null";
+  return "{\"tile\": " + std::to_string(stats.tile)
+         + ", \"compute_seconds\": " + json_number(stats.compute_seconds)
+         + ", \"io_stall_seconds\": " + json_number(stats.stall_seconds)
+         + ", \"write_seconds\": " + json_number(stats.write_seconds)
+         + ", \"sync_seconds\": " + json_number(stats.sync_seconds)
+         + ", \"load_seconds\": " + json_number(stats.load_seconds)
+         + ", \"bytes_read\": " + json_number(stats.bytes_read)
+         + ", \"bytes_written\": " + json_number(stats.bytes_written)
+         + ", \"read_bandwidth\": " + json_number(ooc_read_bandwidth(stats))
+         + ", \"write_bandwidth\": "
+         + json_number(ooc_write_bandwidth(stats)) + "}";
+}
+
+/**
+ * @brief 输出JSON格式的运行结果
+ *
+ * 顶层对象包含schema、timestamp、config、system、roofline、out_of_core、
+ * runs和sweep八个字段, runs中每个内核保存每次迭代的时间和推导指标,
+ * sweep中每个参数组合保存每次迭代的时间和扩展效率
+ */
+static void write_json(std::ostream &out,
+                       const BenchmarkReport &report,
+                       const SystemInfo &system)
+{
+  const BenchmarkConfig &config = report.config;
+  const char *source = config.autotune ? "autotune"
+                       : config.tuned  ? "tuning-cache"
+                                       : "default";
+
+  out << "{" << endl;
+  out << "  \"schema\": " << REPORT_SCHEMA_VERSION << "," << endl;
+  out << "  \"timestamp\": " << json_string(utc_timestamp()) << "," << endl;
+
+  out << "  \"config\": {" << endl;
+  out << "    \"matrix_size\": " << config.matrix_size << "," << endl;
+  out << "    \"m\": " << config.shape_m << "," << endl;
+  out << "    \"n\": " << config.shape_n << "," << endl;
+  out << "    \"k\": " << config.shape_k << "," << endl;
+  out << "    \"batch\": " << config.batch << "," << endl;
+  out << "    \"sparse_density\": " << json_number(config.sparse_density)
+      << "," << endl;
+  out << "    \"sparse_structure\": "
+      << json_string(sparse_structure_name(config.sparse_structure)) << ","
+      << endl;
+  out << "    \"bsr_block\": " << config.bsr_block << "," << endl;
+  out << "    \"nnz\": " << report.nnz << "," << endl;
+  out << "    \"ooc_dir\": " << json_string(config.ooc_dir) << "," << endl;
+  out << "    \"ooc_memory_mb\": " << config.ooc_memory_mb << "," << endl;
+  out << "    \"quant\": " << json_string(quant_type_name(config.quant)) << ","
+      << endl;
+  out << "    \"dtype\": " << json_string(dtype_name(config.dtype)) << ","
+      << endl;
+  out << "    \"kernel\": " << json_string(kernel_name(config.kernel)) << ","
+      << endl;
+  out << "    \"kernel_suite\": " << json_array(config.kernel_suite) << ","
+      << endl;
+  out << "    \"block_size\": " << config.block_size << "," << endl;
+  out << "    \"num_threads\": " << config.num_threads << "," << endl;
+  out << "    \"iterations\": " << config.iterations << "," << endl;
+  out << "    \"warmup\": " << config.warmup << "," << endl;
+  out << "    \"ci_target\": " << json_number(config.ci_target) << "," << endl;
+  out << "    \"max_iterations\": " << config.max_iterations << "," << endl;
+  out << "    \"counters\": " << (config.counters ? "true" : "false") << ","
+      << endl;
+  out << "    \"verify\": " << json_string(verify_mode_name(config.verify))
+      << "," << endl;
+  out << "    \"verify_rounds\": " << config.verify_rounds << "," << endl;
+  out << "    \"tolerance\": " << json_number(config.tolerance) << "," << endl;
+  out << "    \"skip_single\": " << (config.skip_single ? "true" : "false")
+      << "," << endl;
+  out << "    \"roofline\": " << (config.roofline ? "true" : "false") << ","
+      << endl;
+  out << "    \"sweep\": " << (config.sweep ? "true" : "false") << "," << endl;
+  out << "    \"sweep_sizes\": " << json_array(config.sweep_sizes) << ","
+      << endl;
+  out << "    \"sweep_threads\": " << json_array(config.sweep_threads) << ","
+      << endl;
+  out << "    \"sweep_blocks\": " << json_array(config.sweep_blocks) << ","
+      << endl;
+  out << "    \"leading_dimension\": " << report.leading_dimension << ","
+      << endl;
+  out << "    \"isa\": " << json_string(simd_isa_name(config.isa)) << ","
+      << endl;
+  out << "    \"use_pool\": " << (config.use_pool ? "true" : "false") << ","
+      << endl;
+  out << "    \"parallel\": "
+      << json_string(parallel_mode_name(config.parallel)) << "," << endl;
+  out << "    \"tile_size\": " << config.tile_size << "," << endl;
+  out << "    \"affinity\": "
+      << json_string(affinity_mode_name(config.affinity)) << "," << endl;
+  out << "    \"pages\": " << json_string(page_mode_name(config.pages)) << ","
+      << endl;
+  out << "    \"huge_page_mb\": " << json_number(report.huge_page_mb) << ","
+      << endl;
+  out << "    \"huge_page_fallbacks\": " << report.huge_page_fallbacks << ","
+      << endl;
+  out << "    \"strassen_cutoff\": " << config.strassen_cutoff << "," << endl;
+  out << "    \"parameter_source\": " << json_string(source) << "," << endl;
+  out << "    \"memory_mb\": " << json_number(report.memory_mb) << endl;
+  out << "  }," << endl;
+
+  out << "  \"system\": {" << endl;
+  out << "    \"cpu_model\": " << json_string(system.cpu_model) << "," << endl;
+  out << "    \"cpu_cores\": " << system.cpu_cores << "," << endl;
+  out << "    \"hardware_concurrency\": " << system.hardware_concurrency << ","
+      << endl;
+  out << "    \"os\": " << json_string(system.os) << "," << endl;
+  out << "    \"arch\": " << json_string(system.arch) << "," << endl;
+  out << "    \"cplusplus\": " << system.cplusplus << "," << endl;
+  out << "    \"l1_cache_size\": " << system.cache.l1_cache_size << ","
+      << endl;
+  out << "    \"l2_cache_size\": " << system.cache.l2_cache_size << ","
+      << endl;
+  out << "    \"l3_cache_size\": " << system.cache.l3_cache_size << ","
+      << endl;
+  out << "    \"line_size\": " << system.cache.line_size << "," << endl;
+  out << "    \"caches\": [";
+  for (size_t c = 0; c < system.cache.levels.size(); c++)
+  {
+    const CacheLevel &level = system.cache.levels[c];
+    out << (c > 0 ? "," : "") << endl
+        << "      {\"level\": " << level.level
+        << ", \"type\": " << json_string(level.type)
+        << ", \"size\": " << level.size
+        << ", \"line_size\": " << level.line_size
+        << ", \"shared_cpus\": " << level.shared_cpus << "}";
+  }
+  out << (system.cache.levels.empty() ? "" : "\n    ") << "]," << endl;
+  out << "    \"optimal_block_size\": " << system.optimal_block_size << ","
+      << endl;
+  out << "    \"simd_supported\": " << json_array(system.simd_supported) << ","
+      << endl;
+  out << "    \"simd_active\": " << json_string(system.simd_active) << ","
+      << endl;
+  out << "    \"numa_nodes\": [";
+  for (size_t node = 0; node < system.numa.node_ids.size(); node++)
+  {
+    out << (node > 0 ? ", " : "") << "{\"node\": " << system.numa.node_ids[node]
+        << ", \"cpus\": [";
+    const vector<int> &cpus = system.numa.node_cpus[node];
+    for (size_t k = 0; k < cpus.size(); k++)
+    {
+      out << (k > 0 ? ", " : "") << cpus[k];
+    }
+    out << "]}";
+  }
+  out << "]" << endl;
+  out << "  }," << endl;
+  out << "  \"roofline\": " << json_roofline(report.roofline) << "," << endl;
+  out << "  \"out_of_core\": " << json_out_of_core(report.out_of_core) << ","
+      << endl;
+
+  out << "  \"runs\": [";
+  for (size_t r = 0; r < report.runs.size(); r++)
+  {
+    const KernelRun &run = report.runs[r];
+    const RunMetrics metrics = compute_metrics(run, report);
+    out << (r > 0 ? "," : "") << endl;
+    out << "    {" << endl;
+    out << "      \"kernel\": " << json_string(run.kernel) << "," << endl;
+    out << "      \"single_seconds\": " << json_array(run.single_seconds)
+        << "," << endl;
+    out << "      \"multi_seconds\": " << json_array(run.multi_seconds) << ","
+        << endl;
+    out << "      \"single_avg_seconds\": " << json_number(metrics.single_avg)
+        << "," << endl;
+    out << "      \"multi_avg_seconds\": " << json_number(metrics.multi_avg)
+        << "," << endl;
+    out << "      \"speedup\": " << json_number(metrics.speedup) << "," << endl;
+    out << "      \"efficiency\": " << json_number(metrics.efficiency) << ","
+        << endl;
+    out << "      \"single_throughput\": "
+        << json_number(metrics.single_throughput) << "," << endl;
+    out << "      \"multi_throughput\": "
+        << json_number(metrics.multi_throughput) << "," << endl;
+    out << "      \"throughput_unit\": "
+        << json_string(throughput_unit(config.dtype)) << "," << endl;
+    out << "      \"operations\": " << json_number(run.operations) << ","
+        << endl;
+    out << "      \"bytes\": " << json_number(run.bytes) << "," << endl;
+    out << "      \"single_bandwidth\": "
+        << json_number(metrics.single_bandwidth) << "," << endl;
+    out << "      \"multi_bandwidth\": "
+        << json_number(metrics.multi_bandwidth) << "," << endl;
+    out << "      \"intensity\": " << json_number(metrics.intensity) << ","
+        << endl;
+    out << "      \"single_roofline\": "
+        << json_number(metrics.single_roofline) << "," << endl;
+    out << "      \"multi_roofline\": " << json_number(metrics.multi_roofline)
+        << "," << endl;
+    out << "      \"single_stats\": "
+        << json_stats(compute_sample_stats(run.single_seconds)) << ","
+        << endl;
+    out << "      \"multi_stats\": "
+        << json_stats(compute_sample_stats(run.multi_seconds)) << "," << endl;
+    out << "      \"converged\": " << (run.converged ? "true" : "false")
+        << "," << endl;
+    out << "      \"single_counters\": " << json_counters(run.single_counters)
+        << "," << endl;
+    out << "      \"multi_counters\": " << json_counters(run.multi_counters)
+        << "," << endl;
+    out << "      \"telemetry\": " << json_telemetry(run.telemetry) << ","
+        << endl;
+    out << "      \"verified\": " << (run.verified ? "true" : "false") << endl;
+    out << "    }";
+  }
+  out << (report.runs.empty() ? "" : "\n  ") << "]," << endl;
+
+  out << "  \"sweep\": [";
+  for (size_t p = 0; p < report.sweep.size(); p++)
+  {
+    const SweepPoint &point = report.sweep[p];
+    out << (p > 0 ? "," : "") << endl
+        << "    {\"scaling\": " << json_string(point.weak ? "weak" : "strong")
+        << ", \"matrix_size\": " << point.matrix_size
+        << ", \"block_size\": " << point.block_size
+        << ", \"num_threads\": " << point.num_threads
+        << ", \"seconds\": " << json_array(point.seconds)
+        << ", \"median_seconds\": " << json_number(point.median)
+        << ", \"throughput\": " << json_number(point.throughput)
+        << ", \"speedup\": " << json_number(point.speedup)
+        << ", \"efficiency\": " << json_number(point.efficiency)
+        << ", \"verified\": " << (point.verified ? "true" : "false") << "}";
+  }
+  out << (report.sweep.empty() ? "" : "\n  ") << "]" << endl;
+  out << "}" << endl;
+}
+
+/**
+ * @brief 按RFC 4180转义CSV字段
+ *
+ * 包含逗号、引号或换行的字段加上引号, 其中的引号写两次
+ */
+static string csv_field(const string &text)
+{
+  if (text.find_first_of(",\"\n") == string::npos) return text;
+  string result = "\"";
+  for (char ch : text)
+  {
+    if (ch == '"') result += '"';
+    result += ch;
+  }
+  return result + "\"";
+}
+
+/**
+ * @brief 把每次迭代的时间拼接为分号分隔的单个CSV字段
+ */
+static string csv_times(const vector<double> &values)
+{
+  string result;
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    if (i > 0) result += ';';
+    result += json_number(values[i]);
+  }
+  return result;
+}
+
+/**
+ * @brief 输出CSV格式的运行结果
+ *
+ * 第一行为表头, 之后每个内核一行; 配置和系统信息在每行重复,
+ * 后加入的统计列追加在末尾, 按列位置读取的旧脚本不受影响;
+ * 多次运行的结果可以直接拼接(去掉后续文件的表头)后导入
+ */
+static void write_csv(std::ostream &out,
+                      const BenchmarkReport &report,
+                      const SystemInfo &system)
+{
+  const BenchmarkConfig &config = report.config;
+  out << "schema,timestamp,cpu_model,os,arch,cpu_cores,numa_nodes,"
+         "l1_cache_size,l2_cache_size,l3_cache_size,simd_active,"
+         "matrix_size,dtype,kernel,block_size,num_threads,iterations,"
+         "leading_dimension,parallel,affinity,use_pool,"
+         "single_avg_seconds,multi_avg_seconds,speedup,efficiency,"
+         "single_throughput,multi_throughput,throughput_unit,verified,"
+         "single_seconds,multi_seconds,warmup,single_median_seconds,"
+         "multi_median_seconds,multi_p90_seconds,multi_stddev_seconds,"
+         "multi_ci_low,multi_ci_high,outliers,converged,intensity,"
+         "single_roofline,multi_roofline,m,n,k,batch,sparse_density,"
+         "sparse_structure,bsr_block,nnz,single_bandwidth,multi_bandwidth,"
+         "ooc_tile,compute_seconds,io_stall_seconds,read_bandwidth,"
+         "write_bandwidth,pages,huge_page_mb,quant"
+      << endl;
+
+  const string timestamp = utc_timestamp();
+  const OutOfCoreStats &ooc = report.out_of_core;
+  for (const KernelRun &run : report.runs)
+  {
+    const RunMetrics metrics = compute_metrics(run, report);
+    const SampleStats single = compute_sample_stats(run.single_seconds);
+    const SampleStats multi = compute_sample_stats(run.multi_seconds);
+    out << REPORT_SCHEMA_VERSION << "," << timestamp << ","
+        << csv_field(system.cpu_model) << "," << system.os << ","
+        << system.arch << "," << system.cpu_cores << ","
+        << system.numa.node_ids.size() << "," << system.cache.l1_cache_size
+        << "," << system.cache.l2_cache_size << ","
+        << system.cache.l3_cache_size << "," << system.simd_active << ","
+        << config.matrix_size << "," << dtype_name(config.dtype) << ","
+        << csv_field(run.kernel) << "," << config.block_size << ","
+        << config.num_threads << "," << config.iterations << ","
+        << report.leading_dimension << ","
+        << parallel_mode_name(config.parallel) << ","
+        << affinity_mode_name(config.affinity) << ","
+        << (config.use_pool ? "true" : "false") << ","
+        << json_number(metrics.single_avg) << ","
+        << json_number(metrics.multi_avg) << ","
+        << json_number(metrics.speedup) << ","
+        << json_number(metrics.efficiency) << ","
+        << json_number(metrics.single_throughput) << ","
+        << json_number(metrics.multi_throughput) << ","
+        << throughput_unit(config.dtype) << ","
+        << (run.verified ? "true" : "false") << ","
+        << csv_times(run.single_seconds) << ","
+        << csv_times(run.multi_seconds) << "," << config.warmup << ","
+        << json_number(single.median) << "," << json_number(multi.median)
+        << "," << json_number(multi.p90) << "," << json_number(multi.stddev)
+        << "," << json_number(multi.ci_low) << ","
+        << json_number(multi.ci_high) << ","
+        << single.outliers.size() + multi.outliers.size() << ","
+        << (run.converged ? "true" : "false") << ","
+        << json_number(metrics.intensity) << ","
+        << json_number(metrics.single_roofline) << ","
+        << json_number(metrics.multi_roofline) << "," << config.shape_m
+        << "," << config.shape_n << "," << config.shape_k << ","
+        << config.batch << "," << json_number(config.sparse_density) << ","
+        << sparse_structure_name(config.sparse_structure) << ","
+        << config.bsr_block << "," << report.nnz << ","
+        << json_number(metrics.single_bandwidth) << ","
+        << json_number(metrics.multi_bandwidth) << "," << ooc.tile << ","
+        << json_number(ooc.compute_seconds) << ","
+        << json_number(ooc.stall_seconds) << ","
+        << json_number(ooc_read_bandwidth(ooc)) << ","
+        << json_number(ooc_write_bandwidth(ooc)) << ","
+        << page_mode_name(config.pages) << ","
+        << json_number(report.huge_page_mb) << ","
+        << quant_type_name(config.quant) << endl;
+  }
+}
+
+/**
+ * @brief 输出CSV格式的参数扫描结果
+ *
+ * 每个参数组合一行, scaling列区分强扩展(strong)和弱扩展(weak)
+ */
+static void write_sweep_csv(std::ostream &out,
+                            const BenchmarkReport &report,
+                            const SystemInfo &system)
+{
+  const BenchmarkConfig &config = report.config;
+  out << "schema,timestamp,cpu_model,simd_active,dtype,kernel,scaling,"
+         "matrix_size,block_size,num_threads,median_seconds,throughput,"
+         "throughput_unit,speedup,efficiency,verified,seconds"
+      << endl;
+
+  const string timestamp = utc_timestamp();
+  for (const SweepPoint &point : report.sweep)
+  {
+    out << REPORT_SCHEMA_VERSION << "," << timestamp << ","
+        << csv_field(system.cpu_model) << "," << system.simd_active << ","
+        << dtype_name(config.dtype) << "," << kernel_name(config.kernel)
+        << "," << (point.weak ? "weak" : "strong") << ","
+        << point.matrix_size << "," << point.block_size << ","
+        << point.num_threads << "," << json_number(point.median) << ","
+        << json_number(point.throughput) << ","
+        << throughput_unit(config.dtype) << ","
+        << json_number(point.speedup) << ","
+        << json_number(point.efficiency) << ","
+        << (point.verified ? "true" : "false") << ","
+        << csv_times(point.seconds) << endl;
+  }
+}
+
+/**
+ * @brief 获取输出格式的名称
+ *
+ * @param format 输出格式
+ * @return const char* 与--format参数一致的名称
+ */
+const char *output_format_name(OutputFormat format)
+{
+  switch (format)
+  {
+    case OutputFormat::Json:
+      return "json";
+    case OutputFormat::Csv:
+      return "csv";
+    case OutputFormat::Text:
+      break;
+  }
+  return "text";
+}
+
+/**
+ * @brief 以JSON或CSV格式输出运行结果
+ *
+ * 字段名固定为英文, 与控制台文本的措辞无关,
+ * 供report_generator.py和其他脚本直接解析
+ *
+ * @param out 输出流
+ * @param report 运行结果
+ * @param system 系统信息
+ * @param format 输出格式, Text时不输出
+ */
+void write_report(std::ostream &out,
+                  const BenchmarkReport &report,
+                  const SystemInfo &system,
+                  OutputFormat format)
+{
+  switch (format)
+  {
+    case OutputFormat::Json:
+      write_json(out, report, system);
+      break;
+    case OutputFormat::Csv:
+      if (report.sweep.empty())
+      {
+        write_csv(out, report, system);
+      }
+      else
+      {
+        write_sweep_csv(out, report, system);
+      }
+      break;
+    case OutputFormat::Text:
+      break;
+  }
+}
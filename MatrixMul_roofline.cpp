@@ -0,0 +1,519 @@
+#include "MatrixMul.h"
+
+#include <numeric>
+#include <random>
+
+/// STREAM数组每行的元素数, 行是并行划分的单位
+static constexpr size_t STREAM_ROW = 4096;
+
+/// STREAM数组的最小字节数, 末级缓存较小时也要远大于缓存
+static constexpr size_t STREAM_MIN_BYTES = size_t(32) << 20;
+
+/// STREAM数组的最大字节数, 服务器报告的共享L3很大时限制内存占用和耗时
+static constexpr size_t STREAM_MAX_BYTES = size_t(256) << 20;
+
+/// 每项带宽测试的计时次数, 取最短时间
+static constexpr size_t BANDWIDTH_TRIALS = 5;
+
+/// 指针追逐的步数
+static constexpr size_t CHASE_STEPS = size_t(1) << 22;
+
+/// 逐级读带宽测试每次计时至少读取的字节数
+static constexpr size_t READ_BYTES = size_t(256) << 20;
+
+/// 峰值探测单次计时的最短时间(秒)
+static constexpr double PEAK_MIN_SECONDS = 0.02;
+
+/// 峰值探测的计时次数, 取最短时间
+static constexpr size_t PEAK_TRIALS = 3;
+
+/// 保存测量循环的结果, 防止编译器把循环整个删掉
+static volatile double probe_sink;
+
+/**
+ * @brief 测量内存时使用的工作集大小
+ *
+ * @param cache 缓存信息
+ * @return size_t 4 × L3, 限制在[STREAM_MIN_BYTES, STREAM_MAX_BYTES]之间
+ */
+static size_t memory_working_set(const CacheInfo &cache)
+{
+  return std::clamp(
+      4 * cache.l3_cache_size, STREAM_MIN_BYTES, STREAM_MAX_BYTES);
+}
+
+/**
+ * @brief 估计指令集的峰值算力
+ *
+ * 先用单线程把迭代次数加倍到单次耗时超过PEAK_MIN_SECONDS,
+ * 再让num_threads个线程同时运行相同的迭代次数, 取PEAK_TRIALS次中最短的
+ * 墙钟时间。乘数来自volatile变量, 编译器无法在编译期确定计算结果。
+ *
+ * 测得的是只在寄存器中做乘加的吞吐, 不包括访存,
+ * 是任何GEMM内核在该指令集下可以达到的上限
+ *
+ * @tparam T 元素类型
+ * @param isa 指令集
+ * @param num_threads 同时运行的线程数
+ * @param pool 线程池, nullptr表示创建线程
+ * @return double 所有线程合计的峰值算力(GFLOPS/GOPS)
+ *
+ * @see select_peak_probe()
+ */
+template <typename T>
+double measure_peak_throughput(SimdIsa isa,
+                               size_t num_threads,
+                               ThreadPool *pool)
+{
+  const PeakProbe<T> probe = select_peak_probe<T>(isa);
+  static volatile T multiplier = T{};
+  const T a = multiplier;
+  if (pool != nullptr) num_threads = std::min(num_threads, pool->size());
+  num_threads = std::max(num_threads, size_t(1));
+
+  alignas(MATRIX_ALIGNMENT) T b[PACK_NR<T>];
+  alignas(MATRIX_ALIGNMENT) T sink[PACK_NR<T>];
+  std::fill(std::begin(b), std::end(b), static_cast<T>(1));
+  size_t iterations = 1024;
+  Timer timer;
+  for (;;)
+  {
+    timer.start();
+    probe(iterations, a, b, sink);
+    timer.stop();
+    if (timer.get_seconds() >= PEAK_MIN_SECONDS) break;
+    iterations *= 2;
+  }
+
+  vector<size_t> madds(num_threads);
+  double fastest = std::numeric_limits<double>::infinity();
+  for (size_t trial = 0; trial < PEAK_TRIALS; trial++)
+  {
+    timer.start();
+    parallel_rows(num_threads,
+                  num_threads,
+                  pool,
+                  [&](size_t start, size_t end)
+                  {
+                    alignas(MATRIX_ALIGNMENT) T local_b[PACK_NR<T>];
+                    alignas(MATRIX_ALIGNMENT) T local_sink[PACK_NR<T>];
+                    std::fill(std::begin(local_b),
+                              std::end(local_b),
+                              static_cast<T>(1));
+                    for (size_t t = start; t < end; t++)
+                    {
+                      madds[t] = probe(iterations, a, local_b, local_sink);
+                    }
+                  });
+    timer.stop();
+    fastest = std::min(fastest, timer.get_seconds());
+  }
+  const size_t total = std::accumulate(madds.begin(), madds.end(), size_t(0));
+  return 2.0 * static_cast<double>(total) / (fastest * 1e9);
+}
+
+/**
+ * @brief STREAM风格的内存带宽测试
+ *
+ * 三个double数组各为4 × L3(限制在32 MB~256 MB), 按行由各线程首次写入,
+ * 依次执行STREAM的四项测试(s为标量)：
+ * - copy:  c = a       每个元素读写16字节
+ * - scale: b = s * c   每个元素读写16字节
+ * - add:   c = a + b   每个元素读写24字节
+ * - triad: a = b + s*c 每个元素读写24字节
+ *
+ * 每项分别用单线程(调用线程)和num_threads个线程各计时BANDWIDTH_TRIALS次,
+ * 取最短时间。与原版STREAM一样, 写分配产生的额外读不计入字节数。
+ *
+ * @param num_threads 多线程测试的线程数
+ * @param pool 线程池, nullptr表示创建线程
+ * @return vector<StreamResult> 四项测试的结果, 按上述顺序
+ */
+vector<StreamResult> measure_stream_bandwidth(size_t num_threads,
+                                              ThreadPool *pool)
+{
+  const CacheInfo &cache = get_cache_info();
+  const size_t bytes = memory_working_set(cache);
+  const size_t rows = (bytes / sizeof(double) + STREAM_ROW - 1) / STREAM_ROW;
+  Matrix<double> a(rows, STREAM_ROW, STREAM_ROW, matrix_no_init);
+  Matrix<double> b(rows, STREAM_ROW, STREAM_ROW, matrix_no_init);
+  Matrix<double> c(rows, STREAM_ROW, STREAM_ROW, matrix_no_init);
+  auto fill = [](double value)
+  {
+    return [value](size_t, double *data)
+    { std::fill(data, data + STREAM_ROW, value); };
+  };
+  parallel_first_touch<double>(a, num_threads, pool, fill(1.0));
+  parallel_first_touch<double>(b, num_threads, pool, fill(2.0));
+  parallel_first_touch<double>(c, num_threads, pool, fill(0.0));
+
+  const double s = 3.0;
+  struct StreamTest
+  {
+    const char *name;
+    double bytes_per_element;
+    std::function<void(size_t, size_t)> body;
+  };
+  const StreamTest tests[] = {
+      {"copy",
+       16.0,
+       [&](size_t start, size_t end)
+       {
+         const double *__restrict src = a.row(start);
+         double *__restrict dst = c.row(start);
+         for (size_t i = 0; i < (end - start) * STREAM_ROW; i++)
+         {
+           dst[i] = src[i];
+         }
+       }},
+      {"scale",
+       16.0,
+       [&](size_t start, size_t end)
+       {
+         const double *__restrict src = c.row(start);
+         double *__restrict dst = b.row(start);
+         for (size_t i = 0; i < (end - start) * STREAM_ROW; i++)
+         {
+           dst[i] = s * src[i];
+         }
+       }},
+      {"add",
+       24.0,
+       [&](size_t start, size_t end)
+       {
+         const double *__restrict x = a.row(start);
+         const double *__restrict y = b.row(start);
+         double *__restrict dst = c.row(start);
+         for (size_t i = 0; i < (end - start) * STREAM_ROW; i++)
+         {
+           dst[i] = x[i] + y[i];
+         }
+       }},
+      {"triad",
+       24.0,
+       [&](size_t start, size_t end)
+       {
+         const double *__restrict x = b.row(start);
+         const double *__restrict y = c.row(start);
+         double *__restrict dst = a.row(start);
+         for (size_t i = 0; i < (end - start) * STREAM_ROW; i++)
+         {
+           dst[i] = x[i] + s * y[i];
+         }
+       }},
+  };
+
+  const double elements = static_cast<double>(rows * STREAM_ROW);
+  vector<StreamResult> results;
+  Timer timer;
+  for (const StreamTest &test : tests)
+  {
+    double single = std::numeric_limits<double>::infinity();
+    double multi = std::numeric_limits<double>::infinity();
+    for (size_t trial = 0; trial < BANDWIDTH_TRIALS; trial++)
+    {
+      timer.start();
+      test.body(0, rows);
+      timer.stop();
+      single = std::min(single, timer.get_seconds());
+
+      timer.start();
+      parallel_rows(rows, num_threads, pool, test.body);
+      timer.stop();
+      multi = std::min(multi, timer.get_seconds());
+    }
+    StreamResult result;
+    result.name = test.name;
+    result.single_bandwidth = test.bytes_per_element * elements / single / 1e9;
+    result.multi_bandwidth = test.bytes_per_element * elements / multi / 1e9;
+    results.push_back(result);
+  }
+  return results;
+}
+
+/**
+ * @brief 随机指针追逐测量访存延迟
+ *
+ * 工作集按缓存行划分, 用Sattolo算法生成经过所有缓存行的单个随机环,
+ * 每个缓存行的第一个字保存下一个缓存行的下标。每次加载的地址依赖
+ * 上一次加载的结果, 乱序执行和硬件预取都无法隐藏延迟。
+ *
+ * @param bytes 工作集大小(字节)
+ * @param line_size 缓存行大小(字节)
+ * @return double 平均每次加载的延迟(纳秒)
+ */
+static double chase_latency(size_t bytes, size_t line_size)
+{
+  const size_t stride = std::max(line_size / sizeof(size_t), size_t(1));
+  const size_t lines = std::max(bytes / (stride * sizeof(size_t)), size_t(2));
+  vector<size_t> order(lines);
+  std::iota(order.begin(), order.end(), size_t(0));
+  std::mt19937_64 generator(0x5eed);
+  for (size_t i = lines - 1; i > 0; i--)
+  {
+    std::uniform_int_distribution<size_t> pick(0, i - 1);
+    std::swap(order[i], order[pick(generator)]);
+  }
+  vector<size_t> chain(lines * stride);
+  for (size_t i = 0; i < lines; i++)
+  {
+    chain[i * stride] = order[i] * stride;
+  }
+
+  // 先走一圈把工作集调入缓存
+  size_t index = 0;
+  for (size_t step = 0; step < lines; step++)
+  {
+    index = chain[index];
+  }
+  Timer timer;
+  timer.start();
+  for (size_t step = 0; step < CHASE_STEPS; step++)
+  {
+    index = chain[index];
+  }
+  timer.stop();
+  probe_sink = static_cast<double>(index);
+  return timer.get_seconds() * 1e9 / static_cast<double>(CHASE_STEPS);
+}
+
+/**
+ * @brief 单线程顺序读带宽
+ *
+ * 使用当前指令集的顺序读内核反复读取同一个工作集,
+ * 每次计时至少读取READ_BYTES字节, 取BANDWIDTH_TRIALS次中的最短时间
+ *
+ * @param bytes 工作集大小(字节)
+ * @return double 读带宽(GB/s)
+ */
+static double read_bandwidth(size_t bytes)
+{
+  const size_t count = std::max(bytes / sizeof(double), size_t(1));
+  Matrix<double> data(1, count, count, matrix_no_init);
+  std::fill(data.data(), data.data() + count, 1.0);
+  const ReadKernel kernel = select_read_kernel(active_simd_isa());
+  const size_t repeats = std::max(READ_BYTES / bytes, size_t(1));
+
+  kernel(data.data(), count);
+  Timer timer;
+  double fastest = std::numeric_limits<double>::infinity();
+  double total = 0.0;
+  for (size_t trial = 0; trial < BANDWIDTH_TRIALS; trial++)
+  {
+    timer.start();
+    for (size_t r = 0; r < repeats; r++)
+    {
+      total += kernel(data.data(), count);
+    }
+    timer.stop();
+    fastest = std::min(fastest, timer.get_seconds());
+  }
+  probe_sink = total;
+  return static_cast<double>(repeats * count * sizeof(double)) / fastest
+         / 1e9;
+}
+
+/**
+ * @brief 按各级缓存大小测量访存延迟和读带宽
+ *
+ * get_cache_info()中的每个数据缓存和统一缓存取一半容量作为工作集,
+ * 保证工作集驻留在该级缓存而超出上一级; 最后以与STREAM相同的
+ * 工作集测量内存。没有检测到缓存列表时使用L1/L2/L3三个大小。
+ *
+ * @return vector<MemoryLevelProbe> 各级缓存及内存的测量结果, 按容量从小到大
+ */
+vector<MemoryLevelProbe> measure_memory_levels()
+{
+  const CacheInfo &cache = get_cache_info();
+  vector<MemoryLevelProbe> probes;
+  for (const CacheLevel &level : cache.levels)
+  {
+    if (level.type == "Instruction" || level.size == 0) continue;
+    MemoryLevelProbe probe;
+    probe.name = "L";
+    probe.name += std::to_string(level.level);
+    probe.bytes = level.size / 2;
+    probes.push_back(probe);
+  }
+  if (probes.empty())
+  {
+    const size_t sizes[] = {
+        cache.l1_cache_size, cache.l2_cache_size, cache.l3_cache_size};
+    for (size_t level = 0; level < 3; level++)
+    {
+      MemoryLevelProbe probe;
+      probe.name = "L";
+      probe.name += std::to_string(level + 1);
+      probe.bytes = sizes[level] / 2;
+      probes.push_back(probe);
+    }
+  }
+  MemoryLevelProbe dram;
+  dram.name = "DRAM";
+  dram.bytes = memory_working_set(cache);
+  probes.push_back(dram);
+
+  for (MemoryLevelProbe &probe : probes)
+  {
+    probe.latency_ns = chase_latency(probe.bytes, cache.line_size);
+    probe.bandwidth = read_bandwidth(probe.bytes);
+  }
+  return probes;
+}
+
+/**
+ * @brief 测量屋顶线模型所需的全部机器参数
+ *
+ * - 峰值算力: 对每个可用且有独立实现的指令集测量单线程峰值,
+ *   再用num_threads个线程测量当前指令集的峰值
+ * - 内存带宽: STREAM四项测试, 屋顶线使用triad的结果
+ * - 各级缓存: 延迟和单线程读带宽
+ *
+ * @tparam T 元素类型, 决定峰值算力的测量类型
+ * @param num_threads 多线程测量的线程数
+ * @param pool 线程池, nullptr表示创建线程
+ * @return RooflineModel 机器参数
+ */
+template <typename T>
+RooflineModel characterize_machine(size_t num_threads, ThreadPool *pool)
+{
+  RooflineModel model;
+  model.isa = active_simd_isa();
+  model.num_threads = num_threads;
+
+  const PeakProbe<T> scalar_probe = select_peak_probe<T>(SimdIsa::Scalar);
+  const PeakProbe<T> active_probe = select_peak_probe<T>(model.isa);
+  const SimdIsa candidates[] = {
+      SimdIsa::Scalar, SimdIsa::AVX2, SimdIsa::AVX512, SimdIsa::NEON};
+  for (SimdIsa isa : candidates)
+  {
+    if (!simd_isa_supported(isa)) continue;
+    const PeakProbe<T> probe = select_peak_probe<T>(isa);
+    // 该类型没有此指令集的实现时与标量相同, 不重复测量
+    if (isa != SimdIsa::Scalar && probe == scalar_probe) continue;
+    IsaPeak peak;
+    peak.isa = isa;
+    peak.throughput = measure_peak_throughput<T>(isa, 1);
+    model.isa_peaks.push_back(peak);
+    // 记录实际执行的指令集, 例如int64在AVX-512下实际使用标量实现
+    if (probe == active_probe)
+    {
+      model.isa = isa;
+      model.peak_single = peak.throughput;
+    }
+  }
+  model.peak_multi =
+      measure_peak_throughput<T>(model.isa, num_threads, pool);
+
+  model.stream = measure_stream_bandwidth(num_threads, pool);
+  model.bandwidth_single = model.stream.back().single_bandwidth;
+  model.bandwidth_multi = model.stream.back().multi_bandwidth;
+  model.levels = measure_memory_levels();
+  return model;
+}
+
+/**
+ * @brief 获取算术强度的单位
+ *
+ * @param dtype 元素类型
+ * @return const char* 浮点类型为"FLOP/字节", 整数类型为"OP/字节"
+ */
+const char *intensity_unit(DataType dtype)
+{
+  return (dtype == DataType::F32 || dtype == DataType::F64) ? "FLOP/字节"
+                                                            : "OP/字节";
+}
+
+/**
+ * @brief 打印屋顶线模型的机器参数
+ *
+ * 脊点(峰值算力/带宽)是由带宽受限转为计算受限的算术强度
+ *
+ * @param model 机器参数
+ * @param dtype 元素类型, 决定单位
+ */
+void print_roofline_model(const RooflineModel &model, DataType dtype)
+{
+  const char *unit = throughput_unit(dtype);
+  cout << "=== 屋顶线模型 ===" << endl;
+  cout << "单线程峰值算力 (" << dtype_name(dtype) << "):" << endl;
+  for (const IsaPeak &peak : model.isa_peaks)
+  {
+    cout << "  " << std::left << setw(8) << simd_isa_name(peak.isa)
+         << std::right << fixed << setprecision(2) << setw(10)
+         << peak.throughput << " " << unit
+         << (peak.isa == model.isa ? " (当前)" : "") << endl;
+  }
+  cout << model.num_threads << " 线程峰值算力 (" << simd_isa_name(model.isa)
+       << "): " << model.peak_multi << " " << unit << endl;
+
+  // 表头按显示宽度手工对齐(setw按字节计数, 不适用于中文)
+  cout << "STREAM带宽(GB/s)   单线程    " << model.num_threads << " 线程"
+       << endl;
+  for (const StreamResult &result : model.stream)
+  {
+    cout << "  " << std::left << setw(8) << result.name << std::right
+         << setw(17) << result.single_bandwidth << setw(10)
+         << result.multi_bandwidth << endl;
+  }
+
+  cout << "逐级访存(单线程)  工作集      延迟      读带宽" << endl;
+  for (const MemoryLevelProbe &probe : model.levels)
+  {
+    cout << "  " << std::left << setw(6) << probe.name << std::right
+         << setw(11) << probe.bytes / 1024 << " KB"
+         << setw(8) << probe.latency_ns << " ns" << setw(8)
+         << probe.bandwidth << " GB/s" << endl;
+  }
+
+  cout << "脊点: 单线程 " << model.peak_single / model.bandwidth_single
+       << " " << intensity_unit(dtype) << ", " << model.num_threads
+       << " 线程 " << model.peak_multi / model.bandwidth_multi << " "
+       << intensity_unit(dtype) << endl;
+  cout << "==================" << endl << endl;
+}
+
+/**
+ * @brief 计算GEMM的算术强度
+ *
+ * 按最少访存量计算: A和B各读一次, C读写各一次,
+ * 即(mk + kn + 2mn) × element_size字节; 运算量为2mnk
+ *
+ * @param m C的行数
+ * @param n C的列数
+ * @param k 公共维度
+ * @param element_size 元素大小(字节)
+ * @return double 算术强度(FLOP/字节或OP/字节)
+ */
+double gemm_intensity(size_t m, size_t n, size_t k, size_t element_size)
+{
+  const double rows = static_cast<double>(m);
+  const double cols = static_cast<double>(n);
+  const double inner = static_cast<double>(k);
+  const double bytes = (rows * inner + inner * cols + 2.0 * rows * cols)
+                       * static_cast<double>(element_size);
+  return 2.0 * rows * cols * inner / bytes;
+}
+
+/**
+ * @brief 计算屋顶线模型给出的性能上限
+ *
+ * @param model 机器参数
+ * @param intensity 算术强度
+ * @param multi true使用多线程参数, false使用单线程参数
+ * @return double min(峰值算力, 算术强度 × 带宽)(GFLOPS/GOPS)
+ */
+double roofline_bound(const RooflineModel &model, double intensity, bool multi)
+{
+  const double peak = multi ? model.peak_multi : model.peak_single;
+  const double bandwidth =
+      multi ? model.bandwidth_multi : model.bandwidth_single;
+  return std::min(peak, intensity * bandwidth);
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_ROOFLINE(T)                                           \
+  template double measure_peak_throughput<T>(SimdIsa, size_t, ThreadPool *); \
+  template RooflineModel characterize_machine<T>(size_t, ThreadPool *);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_ROOFLINE)
+#undef MM_INSTANTIATE_ROOFLINE
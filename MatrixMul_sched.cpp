@@ -0,0 +1,607 @@
+#include "MatrixMul.h"
+
+#include <deque>
+#include <mutex>
+
+/// split-K每段K深度的下限, 更浅的分段归约开销超过并行收益
+static constexpr size_t SPLIT_K_MIN_DEPTH = 64;
+
+/**
+ * @brief 二维分块任务, 记录结果矩阵中分块的左上角坐标
+ */
+struct TileTask
+{
+  size_t row0; ///< 分块起始行
+  size_t col0; ///< 分块起始列
+};
+
+/**
+ * @brief 每个线程私有的分块任务队列
+ *
+ * 所有者从尾部取任务, 窃取者从头部取任务, 两端由同一把互斥锁保护。
+ * 分块计算量远大于加锁开销, 因此不需要无锁的Chase-Lev队列。
+ * 按缓存行对齐, 避免相邻队列的锁之间产生伪共享。
+ */
+struct alignas(MATRIX_ALIGNMENT) TileQueue
+{
+  std::mutex lock; ///< 保护tasks
+  std::deque<TileTask> tasks; ///< 待执行的分块
+
+  /**
+   * @brief 所有者从尾部取出一个任务
+   *
+   * @param task 取出的任务
+   * @return bool 队列为空时返回false
+   */
+  bool pop_back(TileTask &task)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (tasks.empty()) return false;
+    task = tasks.back();
+    tasks.pop_back();
+    return true;
+  }
+
+  /**
+   * @brief 窃取者从头部取出一个任务
+   *
+   * @param task 取出的任务
+   * @return bool 队列为空时返回false
+   */
+  bool steal_front(TileTask &task)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (tasks.empty()) return false;
+    task = tasks.front();
+    tasks.pop_front();
+    return true;
+  }
+};
+
+/**
+ * @brief 计算工作窃取调度的默认分块边长
+ *
+ * 目标分块数为线程数的8倍: 分块过少时窃取无法平衡负载,
+ * 过多时每个分块重复读取A、B面板的开销变大
+ *
+ * @param rows 结果矩阵行数
+ * @param cols 结果矩阵列数
+ * @param num_threads 线程数
+ * @return size_t 分块边长, 64的倍数且不小于64
+ */
+size_t choose_tile_size(size_t rows, size_t cols, size_t num_threads)
+{
+  const size_t target_tiles = std::max(num_threads, size_t(1)) * 8;
+  double area = static_cast<double>(rows) * static_cast<double>(cols);
+  size_t tile = static_cast<size_t>(
+      std::sqrt(area / static_cast<double>(target_tiles)));
+  tile -= tile % 64;
+  return std::max(tile, size_t(64));
+}
+
+/**
+ * @brief 二维分块工作窃取的多线程矩阵乘法
+ *
+ * 调度流程：
+ * 1. 将结果矩阵切分为tile_size x tile_size的分块(边缘分块较小)
+ * 2. 按行优先顺序把分块均分为num_threads段连续区间, 放入各线程的队列
+ * 3. 每个线程先处理自己队列中的分块(从尾部取)
+ * 4. 自己的队列为空后, 从下一个线程开始依次尝试窃取其他队列头部的分块
+ * 5. 所有队列均为空时线程退出
+ *
+ * 分块在开始前全部入队, 执行过程中不会产生新任务,
+ * 因此一轮窃取全部失败即可确定没有剩余工作。
+ * 每个分块计算c(i, j) += A(i, :) * B(:, j), 不同分块写入的结果区域互不重叠。
+ *
+ * @tparam T 元素类型
+ * @param matrix1 输入矩阵1(左操作数)
+ * @param matrix2 输入矩阵2(右操作数)
+ * @param result 结果矩阵, 存储计算结果
+ * @param block_size 内核使用的块大小
+ * @param num_threads 线程数量
+ * @param tile_size 分块边长, 0表示使用choose_tile_size()
+ * @param kernel 子块内核
+ * @param pool 线程池, nullptr表示每次调用创建线程
+ * @param stats 统计信息输出, 按线程累加执行和窃取的分块数, 可以为nullptr
+ * @param telemetry 线程级遥测输出, 工作量按分块计, 可以为nullptr
+ *
+ * @pre matrix1.cols() == matrix2.rows()
+ * @pre result已正确初始化为0
+ *
+ * @see parallel_computing_optimized() 静态行划分版本
+ * @see select_tile_kernel()
+ */
+template <typename T>
+void parallel_computing_work_stealing(const Matrix<T> &matrix1,
+                                      const Matrix<T> &matrix2,
+                                      Matrix<T> &result,
+                                      size_t block_size,
+                                      size_t num_threads,
+                                      size_t tile_size,
+                                      GemmTileKernel<T> kernel,
+                                      ThreadPool *pool,
+                                      WorkStealingStats *stats,
+                                      ThreadTelemetry *telemetry)
+{
+  const size_t rows = result.rows();
+  const size_t cols = result.cols();
+  const size_t inner = matrix1.cols();
+  if (pool != nullptr) num_threads = std::min(num_threads, pool->size());
+  num_threads = std::max(num_threads, size_t(1));
+  if (tile_size == 0) tile_size = choose_tile_size(rows, cols, num_threads);
+
+  const size_t tile_rows = (rows + tile_size - 1) / tile_size;
+  const size_t tile_cols = (cols + tile_size - 1) / tile_size;
+  const size_t total_tiles = tile_rows * tile_cols;
+
+  std::vector<TileQueue> queues(num_threads);
+  for (size_t t = 0; t < num_threads; t++)
+  {
+    size_t first = t * total_tiles / num_threads;
+    size_t last = (t + 1) * total_tiles / num_threads;
+    for (size_t id = first; id < last; id++)
+    {
+      queues[t].tasks.push_back(
+          {(id / tile_cols) * tile_size, (id % tile_cols) * tile_size});
+    }
+  }
+
+  std::vector<size_t> executed(num_threads, 0);
+  std::vector<size_t> stolen(num_threads, 0);
+  TelemetryRecorder recorder(telemetry, num_threads);
+
+  auto worker = [&](size_t t)
+  {
+    if (t >= num_threads) return;
+    apply_thread_affinity(t);
+    recorder.begin(t);
+    TileTask task;
+    for (;;)
+    {
+      bool own = queues[t].pop_back(task);
+      bool found = own;
+      for (size_t v = 1; !found && v < num_threads; v++)
+      {
+        found = queues[(t + v) % num_threads].steal_front(task);
+      }
+      if (!found) break;
+
+      size_t mi = std::min(tile_size, rows - task.row0);
+      size_t nj = std::min(tile_size, cols - task.col0);
+      double since = recorder.now();
+      kernel(matrix1.tile(task.row0, 0, mi, inner),
+             matrix2.tile(0, task.col0, inner, nj),
+             result.tile(task.row0, task.col0, mi, nj),
+             block_size);
+      recorder.work(t, since, 1);
+      executed[t]++;
+      if (!own) stolen[t]++;
+    }
+    recorder.finish(t);
+  };
+
+  if (pool != nullptr)
+  {
+    pool->run(worker);
+  }
+  else
+  {
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++)
+    {
+      threads.push_back(std::thread(worker, t));
+    }
+    for (auto &t : threads)
+    {
+      t.join();
+    }
+  }
+  recorder.commit();
+
+  if (stats != nullptr)
+  {
+    if (stats->tiles_executed.size() < num_threads)
+    {
+      stats->tiles_executed.resize(num_threads, 0);
+      stats->tiles_stolen.resize(num_threads, 0);
+    }
+    for (size_t t = 0; t < num_threads; t++)
+    {
+      stats->tiles_executed[t] += executed[t];
+      stats->tiles_stolen[t] += stolen[t];
+    }
+  }
+}
+
+/**
+ * @brief 按问题形状选择静态划分的线程网格
+ *
+ * 遍历num_threads的所有因数分解row_parts x col_parts x k_parts,
+ * 各段大小与parallel_computing_partitioned()的切分相同: 行段和K段向上
+ * 取整, 列段再向上取整到缓存行的整数倍, 因此部分行段或列段可能为空,
+ * 对应的线程空闲; 每段K深度不小于SPLIT_K_MIN_DEPTH, 且没有空的K段
+ * (例如K = 4225时k_parts = 66的最后一段为空)。
+ *
+ * 只要C按行和缓存行宽的列片切出的单元数不少于线程数, 就只在
+ * k_parts = 1的网格中选择: split-K为每个额外K段分配M x N的部分和并增加
+ * 一轮归约, 只在M和N太小、无法分给所有线程时才值得。在候选网格中:
+ * 1. 首先比较每个线程的乘加次数rows_per_part * cols_per_part
+ *    * depth_per_part, 它决定了静态划分的关键路径
+ * 2. 其次比较空闲线程数
+ * 3. 最后比较每个线程的访存量: A行条、B列条和C单元,
+ *    拆分K时再加上归约阶段读取部分和、写回C的元素数
+ *
+ * 从纯行划分开始遍历且只在严格更优时替换, 全部相同时保持行划分。
+ * 例如8线程、int32时65536x256x256选择8x1x1, 256x65536x256选择1x8x1,
+ * 1024x1024x1024选择4x2x1, 1x1x65536选择1x1x8
+ *
+ * @param rows 结果矩阵行数(M)
+ * @param cols 结果矩阵列数(N)
+ * @param inner 公共维度(K)
+ * @param num_threads 线程数
+ * @param element_size 元素字节数, 决定列段对齐的缓存行宽度
+ * @return ThreadGrid row_parts * col_parts * k_parts == num_threads的网格
+ */
+ThreadGrid choose_thread_grid(size_t rows,
+                              size_t cols,
+                              size_t inner,
+                              size_t num_threads,
+                              size_t element_size)
+{
+  num_threads = std::max(num_threads, size_t(1));
+  rows = std::max(rows, size_t(1));
+  cols = std::max(cols, size_t(1));
+  inner = std::max(inner, size_t(1));
+  const size_t line =
+      std::max(MATRIX_ALIGNMENT / std::max(element_size, size_t(1)), size_t(1));
+  const double threads = static_cast<double>(num_threads);
+  const double output = static_cast<double>(rows) * static_cast<double>(cols);
+
+  // 按partitioned的切分计算一个网格的各段大小和非空单元数
+  auto split = [&](size_t row_parts, size_t col_parts, size_t k_parts)
+  {
+    ThreadGrid grid;
+    grid.row_parts = row_parts;
+    grid.col_parts = col_parts;
+    grid.k_parts = k_parts;
+    grid.rows_per_part = (rows + row_parts - 1) / row_parts;
+    grid.cols_per_part = ((cols + col_parts - 1) / col_parts + line - 1)
+                         / line * line;
+    grid.depth_per_part = (inner + k_parts - 1) / k_parts;
+    return grid;
+  };
+  auto active_cells = [&](const ThreadGrid &grid)
+  {
+    return ((rows + grid.rows_per_part - 1) / grid.rows_per_part)
+           * ((cols + grid.cols_per_part - 1) / grid.cols_per_part);
+  };
+  // 按行和缓存行宽的列片最多能切出的单元数, 足够每个线程一个时不拆分K
+  const bool enough_cells = rows * ((cols + line - 1) / line) >= num_threads;
+
+  ThreadGrid best = split(num_threads, 1, 1);
+  double best_work = std::numeric_limits<double>::infinity();
+  size_t best_idle = num_threads;
+  double best_traffic = std::numeric_limits<double>::infinity();
+  for (size_t k_parts = 1; k_parts <= num_threads; k_parts++)
+  {
+    if (num_threads % k_parts != 0) continue;
+    if (k_parts > 1 && enough_cells) break;
+    if (k_parts > 1 && inner / k_parts < SPLIT_K_MIN_DEPTH) break;
+    const size_t slice_depth = (inner + k_parts - 1) / k_parts;
+    if ((k_parts - 1) * slice_depth >= inner) continue;
+    const size_t planes = num_threads / k_parts;
+    for (size_t row_parts = planes; row_parts >= 1; row_parts--)
+    {
+      if (planes % row_parts != 0) continue;
+      const ThreadGrid grid = split(row_parts, planes / row_parts, k_parts);
+      const size_t idle = (planes - active_cells(grid)) * k_parts;
+      const double cell_rows = static_cast<double>(grid.rows_per_part);
+      const double cell_cols =
+          static_cast<double>(std::min(grid.cols_per_part, cols));
+      const double depth = static_cast<double>(grid.depth_per_part);
+      const double work = cell_rows * cell_cols * depth;
+      double traffic = depth * (cell_rows + cell_cols) + cell_rows * cell_cols;
+      if (k_parts > 1)
+      {
+        traffic += output * static_cast<double>(k_parts + 1) / threads;
+      }
+      if (work < best_work
+          || (work == best_work
+              && (idle < best_idle
+                  || (idle == best_idle && traffic < best_traffic))))
+      {
+        best = grid;
+        best_work = work;
+        best_idle = idle;
+        best_traffic = traffic;
+      }
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief 按形状静态划分的多线程矩阵乘法(行、二维或split-K)
+ *
+ * 线程t负责K段t / (row_parts * col_parts), 在该K段内按行优先
+ * 负责一个(行段, 列段)单元; 同一行段的线程编号相邻, 紧凑绑核时共享
+ * A行条所在的缓存。列段宽度向上取整到缓存行的整数倍, 相邻线程写入的
+ * C行片段不会落在同一缓存行上(伪共享)。
+ *
+ * k_parts > 1时分两个阶段:
+ * 1. 第0个K段直接累加到C, 其余K段先把自己的单元清零, 再累加到
+ *    调用线程的thread_local工作区中各自的部分和矩阵
+ * 2. 汇合后按行条带并行归约: 每个线程把所有部分和的同一行区间加到C,
+ *    每个元素的加法顺序固定, 结果与线程调度无关
+ *
+ * 网格为num_threads x 1 x 1时与parallel_computing_optimized()的行划分相同。
+ *
+ * @tparam T 元素类型
+ * @param matrix1 输入矩阵1(左操作数)
+ * @param matrix2 输入矩阵2(右操作数)
+ * @param result 结果矩阵, 存储计算结果
+ * @param block_size 内核使用的块大小
+ * @param num_threads 线程数量
+ * @param kernel 子块内核
+ * @param pool 线程池, nullptr表示每次调用创建线程
+ * @param telemetry 线程级遥测输出, 工作量按乘加次数计, 两个阶段合并为
+ *        一次调用, 可以为nullptr
+ *
+ * @pre matrix1.cols() == matrix2.rows()
+ * @pre result已正确初始化为0
+ *
+ * @see choose_thread_grid()
+ * @see select_tile_kernel()
+ */
+template <typename T>
+void parallel_computing_partitioned(const Matrix<T> &matrix1,
+                                    const Matrix<T> &matrix2,
+                                    Matrix<T> &result,
+                                    size_t block_size,
+                                    size_t num_threads,
+                                    GemmTileKernel<T> kernel,
+                                    ThreadPool *pool,
+                                    ThreadTelemetry *telemetry)
+{
+  const size_t rows = result.rows();
+  const size_t cols = result.cols();
+  const size_t inner = matrix1.cols();
+  if (pool != nullptr) num_threads = std::min(num_threads, pool->size());
+  num_threads = std::max(num_threads, size_t(1));
+
+  const ThreadGrid grid =
+      choose_thread_grid(rows, cols, inner, num_threads, sizeof(T));
+  const size_t planes = grid.row_parts * grid.col_parts;
+  const size_t rows_per_part = grid.rows_per_part;
+  const size_t cols_per_part = grid.cols_per_part;
+  const size_t depth_per_part = grid.depth_per_part;
+  // 实际非空的K段数; choose_thread_grid()保证与k_parts相同,
+  // 这里仍按它归约, 空K段的部分和从未写入, 不能加到C
+  const size_t slices = grid.k_parts > 1
+                            ? (inner + depth_per_part - 1) / depth_per_part
+                            : 1;
+
+  // 部分和与C使用相同的行跨度, 归约时逐行对齐; 工作区只增不减
+  const size_t ld = result.ld();
+  const size_t partial_elements = rows * ld;
+  thread_local Matrix<T> workspace;
+  T *partials = nullptr;
+  if (grid.k_parts > 1)
+  {
+    const size_t needed = (grid.k_parts - 1) * partial_elements;
+    if (workspace.size_bytes() < needed * sizeof(T))
+    {
+      workspace = Matrix<T>(grid.k_parts - 1, partial_elements,
+                            partial_elements, matrix_no_init);
+    }
+    // thread_local变量在工作线程中指向各自的实例, 因此先取出调用线程的地址
+    partials = workspace.data();
+  }
+
+  TelemetryRecorder recorder(telemetry, num_threads);
+  auto compute = [&](size_t t)
+  {
+    const size_t slice = t / planes;
+    const size_t cell = t % planes;
+    const size_t row0 = (cell / grid.col_parts) * rows_per_part;
+    const size_t col0 = (cell % grid.col_parts) * cols_per_part;
+    const size_t k0 = slice * depth_per_part;
+    if (row0 >= rows || col0 >= cols || k0 >= inner) return;
+    apply_thread_affinity(t);
+    recorder.begin(t);
+    const size_t mi = std::min(rows_per_part, rows - row0);
+    const size_t nj = std::min(cols_per_part, cols - col0);
+    const size_t kd = std::min(depth_per_part, inner - k0);
+    double since = recorder.now();
+    MatrixView<T> target = result.tile(row0, col0, mi, nj);
+    if (slice > 0)
+    {
+      MatrixView<T> partial{
+          partials + (slice - 1) * partial_elements, rows, cols, ld};
+      target = partial.tile(row0, col0, mi, nj);
+      for (size_t i = 0; i < mi; i++)
+      {
+        std::fill(target.row(i), target.row(i) + nj, T{});
+      }
+    }
+    kernel(matrix1.tile(row0, k0, mi, kd),
+           matrix2.tile(k0, col0, kd, nj),
+           target,
+           block_size);
+    recorder.work(t, since, mi * nj * kd);
+  };
+
+  const size_t rows_per_thread = (rows + num_threads - 1) / num_threads;
+  auto reduce = [&](size_t t)
+  {
+    const size_t r0 = std::min(t * rows_per_thread, rows);
+    const size_t r1 = std::min(r0 + rows_per_thread, rows);
+    if (r0 < r1)
+    {
+      double since = recorder.now();
+      for (size_t i = r0; i < r1; i++)
+      {
+        T *__restrict c_row = result.row(i);
+        for (size_t p = 0; p + 1 < slices; p++)
+        {
+          const T *__restrict partial_row =
+              partials + p * partial_elements + i * ld;
+          for (size_t j = 0; j < cols; j++)
+          {
+            c_row[j] += partial_row[j];
+          }
+        }
+      }
+      recorder.work(t, since, 0);
+    }
+    recorder.finish(t);
+  };
+
+  auto run_all = [&](const std::function<void(size_t)> &task)
+  {
+    if (pool != nullptr)
+    {
+      pool->run(
+          [&](size_t t)
+          {
+            if (t < num_threads) task(t);
+          });
+      return;
+    }
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++)
+    {
+      threads.push_back(std::thread(task, t));
+    }
+    for (auto &t : threads)
+    {
+      t.join();
+    }
+  };
+
+  if (grid.k_parts == 1)
+  {
+    run_all(
+        [&](size_t t)
+        {
+          compute(t);
+          recorder.finish(t);
+        });
+  }
+  else
+  {
+    run_all(compute);
+    run_all(reduce);
+  }
+  recorder.commit();
+}
+
+/**
+ * @brief 记录调用开始时间并为每个线程准备记录
+ */
+TelemetryRecorder::TelemetryRecorder(ThreadTelemetry *telemetry,
+                                     size_t num_threads)
+    : output(telemetry), origin(std::chrono::steady_clock::now())
+{
+  if (output != nullptr) records.resize(num_threads);
+}
+
+double TelemetryRecorder::now() const
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                       - origin)
+      .count();
+}
+
+void TelemetryRecorder::begin(size_t tid)
+{
+  if (output == nullptr || tid >= records.size()) return;
+  records[tid].active = true;
+  records[tid].start = now();
+  records[tid].cpu = current_cpu();
+}
+
+void TelemetryRecorder::work(size_t tid, double since, size_t items)
+{
+  if (output == nullptr || tid >= records.size()) return;
+  records[tid].busy += now() - since;
+  records[tid].work_items += items;
+}
+
+void TelemetryRecorder::finish(size_t tid)
+{
+  if (output == nullptr || tid >= records.size()) return;
+  records[tid].end = now();
+}
+
+/**
+ * @brief 汇总本次调用并累加到ThreadTelemetry
+ *
+ * 派发开销取最后一个线程开始执行的时刻, 汇合开销取最后一个线程结束
+ * 到commit()的时间; 忙碌时间的最大、最小和平均值只统计参与计算的线程
+ */
+void TelemetryRecorder::commit()
+{
+  if (output == nullptr) return;
+  const double wall = now();
+  double last_start = 0.0;
+  double last_end = 0.0;
+  double max_busy = 0.0;
+  double min_busy = std::numeric_limits<double>::infinity();
+  double total_busy = 0.0;
+  size_t active = 0;
+  if (output->workers.size() < records.size())
+  {
+    output->workers.resize(records.size());
+  }
+  for (size_t t = 0; t < records.size(); t++)
+  {
+    const WorkerRecord &record = records[t];
+    if (!record.active) continue;
+    last_start = std::max(last_start, record.start);
+    last_end = std::max(last_end, record.end);
+    max_busy = std::max(max_busy, record.busy);
+    min_busy = std::min(min_busy, record.busy);
+    total_busy += record.busy;
+    active++;
+
+    WorkerRecord &sum = output->workers[t];
+    sum.active = true;
+    sum.start += record.start;
+    sum.end += record.end;
+    sum.busy += record.busy;
+    sum.work_items += record.work_items;
+    sum.cpu = record.cpu;
+  }
+  if (active == 0) return;
+  output->calls++;
+  output->wall += wall;
+  output->fork += last_start;
+  output->join += wall - last_end;
+  output->max_busy += max_busy;
+  output->min_busy += min_busy;
+  output->avg_busy += total_busy / static_cast<double>(active);
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_SCHED(T)                                              \
+  template void parallel_computing_work_stealing<T>(const Matrix<T> &,       \
+                                                    const Matrix<T> &,       \
+                                                    Matrix<T> &,             \
+                                                    size_t,                  \
+                                                    size_t,                  \
+                                                    size_t,                  \
+                                                    GemmTileKernel<T>,       \
+                                                    ThreadPool *,            \
+                                                    WorkStealingStats *,     \
+                                                    ThreadTelemetry *);      \
+  template void parallel_computing_partitioned<T>(const Matrix<T> &,         \
+                                                  const Matrix<T> &,         \
+                                                  Matrix<T> &,               \
+                                                  size_t,                    \
+                                                  size_t,                    \
+                                                  GemmTileKernel<T>,         \
+                                                  ThreadPool *,              \
+                                                  ThreadTelemetry *);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_SCHED)
+#undef MM_INSTANTIATE_SCHED
@@ -0,0 +1,1172 @@
+#include "MatrixMul.h"
+
+#include <atomic>
+
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64))            \
+    && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#  define MM_SIMD_X86 1
+#  include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#  define MM_SIMD_NEON 1
+#  include <arm_neon.h>
+#endif
+
+#if defined(__linux__) && (defined(__arm__) || defined(__aarch64__))
+#  include <sys/auxv.h>
+#  include <asm/hwcap.h>
+#endif
+
+// GCC/Clang 通过函数属性为单个函数启用指令集, 整个程序仍按通用目标编译
+#if defined(__GNUC__) || defined(__clang__)
+#  define MM_TARGET(isa) __attribute__((target(isa)))
+#else
+#  define MM_TARGET(isa)
+#endif
+
+/// 当前选用的指令集, SimdIsa::Auto表示尚未设置
+static std::atomic<SimdIsa> selected_isa{SimdIsa::Auto};
+
+/**
+ * @brief 将累加器写回C块
+ *
+ * SIMD微内核在边缘块(mr < MR或nr < NR)时先把寄存器存入局部数组,
+ * 再由此函数只写回有效区域
+ *
+ * @tparam T 元素类型
+ * @param acc 累加器数组, MRxNR行主序
+ * @param c C块左上角指针
+ * @param ldc C的行跨度
+ * @param mr 有效行数
+ * @param nr 有效列数
+ */
+template <typename T>
+static void store_edge(const T *acc, T *c, size_t ldc, size_t mr, size_t nr)
+{
+  for (size_t i = 0; i < mr; i++)
+  {
+    for (size_t j = 0; j < nr; j++)
+    {
+      c[i * ldc + j] += acc[i * PACK_NR<T> + j];
+    }
+  }
+}
+
+/**
+ * @brief 标量微内核
+ *
+ * 可移植的MRxNR寄存器分块实现, 依赖编译器自动向量化,
+ * 作为不支持任何SIMD扩展或没有对应类型实现时的回退
+ *
+ * @tparam T 元素类型
+ * @param depth 公共维度长度(KC)
+ * @param a_panel 打包后的A微面板
+ * @param b_panel 打包后的B微面板
+ * @param c C块左上角指针
+ * @param ldc C的行跨度
+ * @param mr 有效行数
+ * @param nr 有效列数
+ */
+template <typename T>
+static void micro_kernel_scalar(size_t depth,
+                                const T *__restrict a_panel,
+                                const T *__restrict b_panel,
+                                T *__restrict c,
+                                size_t ldc,
+                                size_t mr,
+                                size_t nr)
+{
+  constexpr size_t NR = PACK_NR<T>;
+  T acc[PACK_MR][NR] = {};
+
+  for (size_t k = 0; k < depth; k++)
+  {
+    T b[NR];
+    for (size_t j = 0; j < NR; j++)
+    {
+      b[j] = b_panel[j];
+    }
+    for (size_t i = 0; i < PACK_MR; i++)
+    {
+      const T a = a_panel[i];
+      for (size_t j = 0; j < NR; j++)
+      {
+        acc[i][j] += a * b[j];
+      }
+    }
+    a_panel += PACK_MR;
+    b_panel += NR;
+  }
+
+  store_edge(&acc[0][0], c, ldc, mr, nr);
+}
+
+/**
+ * @brief 定义一个SIMD微内核模板
+ *
+ * 各指令集的微内核结构相同, 只是向量操作(Ops)和函数的目标指令集属性不同:
+ * 每行NR个元素正好占用NR/lanes个向量寄存器, MR行共MR*NR/lanes个累加器;
+ * 每步加载B的一行向量, 广播A的MR个元素做乘加。完整块直接累加回C,
+ * 边缘块先存入对齐的局部数组再由store_edge()写回有效区域。
+ *
+ * @param NAME 函数模板名
+ * @param TARGET 目标指令集属性, 可以为空
+ * @param OPS 向量操作模板, OPS<T>提供V、lanes、zero、load、loadu、
+ *            store、storeu、add、madd
+ */
+#define MM_DEFINE_SIMD_MICRO_KERNEL(NAME, TARGET, OPS)                       \
+  template <typename T>                                                      \
+  TARGET static void NAME(size_t depth,                                      \
+                          const T *__restrict a_panel,                       \
+                          const T *__restrict b_panel,                       \
+                          T *__restrict c,                                   \
+                          size_t ldc,                                        \
+                          size_t mr,                                         \
+                          size_t nr)                                         \
+  {                                                                          \
+    using Ops = OPS<T>;                                                      \
+    using V = typename Ops::V;                                               \
+    constexpr size_t NR = PACK_NR<T>;                                        \
+    constexpr size_t VECS = NR / Ops::lanes;                                 \
+                                                                             \
+    V acc[PACK_MR][VECS];                                                    \
+    for (size_t i = 0; i < PACK_MR; i++)                                     \
+    {                                                                        \
+      for (size_t v = 0; v < VECS; v++)                                      \
+      {                                                                      \
+        acc[i][v] = Ops::zero();                                             \
+      }                                                                      \
+    }                                                                        \
+                                                                             \
+    for (size_t k = 0; k < depth; k++)                                       \
+    {                                                                        \
+      V b[VECS];                                                             \
+      for (size_t v = 0; v < VECS; v++)                                      \
+      {                                                                      \
+        b[v] = Ops::load(b_panel + v * Ops::lanes);                          \
+      }                                                                      \
+      for (size_t i = 0; i < PACK_MR; i++)                                   \
+      {                                                                      \
+        const T a = a_panel[i];                                              \
+        for (size_t v = 0; v < VECS; v++)                                    \
+        {                                                                    \
+          acc[i][v] = Ops::madd(acc[i][v], a, b[v]);                         \
+        }                                                                    \
+      }                                                                      \
+      a_panel += PACK_MR;                                                    \
+      b_panel += NR;                                                         \
+    }                                                                        \
+                                                                             \
+    if (mr == PACK_MR && nr == NR)                                           \
+    {                                                                        \
+      for (size_t i = 0; i < PACK_MR; i++)                                   \
+      {                                                                      \
+        T *c_row = c + i * ldc;                                              \
+        for (size_t v = 0; v < VECS; v++)                                    \
+        {                                                                    \
+          T *p = c_row + v * Ops::lanes;                                     \
+          Ops::storeu(p, Ops::add(Ops::loadu(p), acc[i][v]));                \
+        }                                                                    \
+      }                                                                      \
+      return;                                                                \
+    }                                                                        \
+                                                                             \
+    alignas(MATRIX_ALIGNMENT) T spill[PACK_MR * NR];                         \
+    for (size_t i = 0; i < PACK_MR; i++)                                     \
+    {                                                                        \
+      for (size_t v = 0; v < VECS; v++)                                      \
+      {                                                                      \
+        Ops::store(spill + i * NR + v * Ops::lanes, acc[i][v]);              \
+      }                                                                      \
+    }                                                                        \
+    store_edge(spill, c, ldc, mr, nr);                                       \
+  }
+
+/// 峰值探测的独立累加器向量数, 足以覆盖乘加指令的延迟与吞吐之积
+static constexpr size_t PEAK_VECTORS = 12;
+
+/// 顺序读内核的独立累加器向量数
+static constexpr size_t READ_VECTORS = 8;
+
+/**
+ * @brief 标量峰值探测
+ *
+ * 与SIMD版本结构相同, 每步用上一步的相邻累加器作为乘数, 编译器无法把乘法
+ * 提到循环外或合并为一次乘法; 实际是否向量化取决于编译器
+ *
+ * @tparam T 元素类型
+ * @param iterations 迭代次数
+ * @param a 乘数, 调用方传入运行时才知道的值(通常为0, 数值保持不变)
+ * @param b 累加器初值, 至少PACK_NR<T>个元素
+ * @param sink 写入累加器之和, 防止计算被优化掉
+ * @return size_t 执行的乘加次数
+ */
+template <typename T>
+static size_t peak_probe_scalar(size_t iterations,
+                                T a,
+                                const T *b,
+                                T *sink)
+{
+  T acc[PEAK_VECTORS];
+  for (size_t i = 0; i < PEAK_VECTORS; i++)
+  {
+    acc[i] = b[i % PACK_NR<T>];
+  }
+  for (size_t it = 0; it < iterations; it++)
+  {
+    T next[PEAK_VECTORS];
+    for (size_t i = 0; i < PEAK_VECTORS; i++)
+    {
+      next[i] = acc[i] + a * acc[i ^ 1];
+    }
+    for (size_t i = 0; i < PEAK_VECTORS; i++)
+    {
+      acc[i] = next[i];
+    }
+  }
+  T total = T{};
+  for (size_t i = 0; i < PEAK_VECTORS; i++)
+  {
+    total += acc[i];
+  }
+  sink[0] = total;
+  return iterations * PEAK_VECTORS;
+}
+
+/**
+ * @brief 定义一个SIMD峰值探测模板
+ *
+ * PEAK_VECTORS个向量累加器互相独立地做乘加, 没有访存,
+ * 测得的是该指令集乘加单元的吞吐上限。每个累加器的乘数取自上一步的
+ * 相邻累加器(acc[i ^ 1]), 整数类型的乘法也无法被提到循环外。
+ *
+ * @param NAME 函数模板名
+ * @param TARGET 目标指令集属性, 可以为空
+ * @param OPS 向量操作模板, 与MM_DEFINE_SIMD_MICRO_KERNEL相同
+ */
+#define MM_DEFINE_PEAK_PROBE(NAME, TARGET, OPS)                              \
+  template <typename T>                                                      \
+  TARGET static size_t NAME(size_t iterations, T a, const T *b, T *sink)     \
+  {                                                                          \
+    using Ops = OPS<T>;                                                      \
+    using V = typename Ops::V;                                               \
+    constexpr size_t VECS = PACK_NR<T> / Ops::lanes;                         \
+                                                                             \
+    V acc[PEAK_VECTORS];                                                     \
+    for (size_t i = 0; i < PEAK_VECTORS; i++)                                \
+    {                                                                        \
+      acc[i] = Ops::load(b + (i % VECS) * Ops::lanes);                       \
+    }                                                                        \
+    for (size_t it = 0; it < iterations; it++)                               \
+    {                                                                        \
+      V next[PEAK_VECTORS];                                                  \
+      for (size_t i = 0; i < PEAK_VECTORS; i++)                              \
+      {                                                                      \
+        next[i] = Ops::madd(acc[i], a, acc[i ^ 1]);                          \
+      }                                                                      \
+      for (size_t i = 0; i < PEAK_VECTORS; i++)                              \
+      {                                                                      \
+        acc[i] = next[i];                                                    \
+      }                                                                      \
+    }                                                                        \
+    V total = acc[0];                                                        \
+    for (size_t i = 1; i < PEAK_VECTORS; i++)                                \
+    {                                                                        \
+      total = Ops::add(total, acc[i]);                                       \
+    }                                                                        \
+    Ops::store(sink, total);                                                 \
+    return iterations * PEAK_VECTORS * Ops::lanes;                           \
+  }
+
+/**
+ * @brief 标量顺序读内核
+ *
+ * @param data 数据起始地址
+ * @param count 元素个数
+ * @return double 所有元素之和
+ */
+static double read_kernel_scalar(const double *data, size_t count)
+{
+  double sums[READ_VECTORS] = {};
+  size_t i = 0;
+  for (; i + READ_VECTORS <= count; i += READ_VECTORS)
+  {
+    for (size_t v = 0; v < READ_VECTORS; v++)
+    {
+      sums[v] += data[i + v];
+    }
+  }
+  double total = 0.0;
+  for (size_t v = 0; v < READ_VECTORS; v++)
+  {
+    total += sums[v];
+  }
+  for (; i < count; i++)
+  {
+    total += data[i];
+  }
+  return total;
+}
+
+/**
+ * @brief 定义一个SIMD顺序读内核
+ *
+ * READ_VECTORS个向量累加器轮流累加连续的向量, 加法链不会成为瓶颈,
+ * 测得的是各级缓存和内存的读带宽
+ *
+ * @param NAME 函数名
+ * @param TARGET 目标指令集属性, 可以为空
+ * @param OPS 向量操作模板, 需要提供OPS<double>
+ */
+#define MM_DEFINE_READ_KERNEL(NAME, TARGET, OPS)                             \
+  TARGET static double NAME(const double *data, size_t count)                \
+  {                                                                          \
+    using Ops = OPS<double>;                                                 \
+    using V = typename Ops::V;                                               \
+    constexpr size_t STEP = READ_VECTORS * Ops::lanes;                       \
+                                                                             \
+    V sums[READ_VECTORS];                                                    \
+    for (size_t v = 0; v < READ_VECTORS; v++)                                \
+    {                                                                        \
+      sums[v] = Ops::zero();                                                 \
+    }                                                                        \
+    size_t i = 0;                                                            \
+    for (; i + STEP <= count; i += STEP)                                     \
+    {                                                                        \
+      for (size_t v = 0; v < READ_VECTORS; v++)                              \
+      {                                                                      \
+        sums[v] = Ops::add(sums[v], Ops::loadu(data + i + v * Ops::lanes));  \
+      }                                                                      \
+    }                                                                        \
+    for (size_t v = 1; v < READ_VECTORS; v++)                                \
+    {                                                                        \
+      sums[0] = Ops::add(sums[0], sums[v]);                                  \
+    }                                                                        \
+    alignas(MATRIX_ALIGNMENT) double spill[Ops::lanes];                      \
+    Ops::store(spill, sums[0]);                                              \
+    double total = 0.0;                                                      \
+    for (size_t lane = 0; lane < Ops::lanes; lane++)                         \
+    {                                                                        \
+      total += spill[lane];                                                  \
+    }                                                                        \
+    for (; i < count; i++)                                                   \
+    {                                                                        \
+      total += data[i];                                                      \
+    }                                                                        \
+    return total;                                                            \
+  }
+
+#ifdef MM_SIMD_X86
+#  define MM_AVX2 MM_TARGET("avx2,fma")
+#  define MM_AVX512 MM_TARGET("avx512f")
+
+/// AVX2向量操作, 只为有对应指令的类型特化
+template <typename T> struct Avx2Ops;
+
+template <> struct Avx2Ops<int>
+{
+  using V = __m256i;
+  static constexpr size_t lanes = 8;
+  MM_AVX2 static V zero() { return _mm256_setzero_si256(); }
+  MM_AVX2 static V load(const int *p)
+  {
+    return _mm256_load_si256(reinterpret_cast<const V *>(p));
+  }
+  MM_AVX2 static V loadu(const int *p)
+  {
+    return _mm256_loadu_si256(reinterpret_cast<const V *>(p));
+  }
+  MM_AVX2 static void store(int *p, V v)
+  {
+    _mm256_store_si256(reinterpret_cast<V *>(p), v);
+  }
+  MM_AVX2 static void storeu(int *p, V v)
+  {
+    _mm256_storeu_si256(reinterpret_cast<V *>(p), v);
+  }
+  MM_AVX2 static V add(V x, V y) { return _mm256_add_epi32(x, y); }
+  MM_AVX2 static V madd(V acc, int a, V b)
+  {
+    return _mm256_add_epi32(acc, _mm256_mullo_epi32(_mm256_set1_epi32(a), b));
+  }
+};
+
+template <> struct Avx2Ops<float>
+{
+  using V = __m256;
+  static constexpr size_t lanes = 8;
+  MM_AVX2 static V zero() { return _mm256_setzero_ps(); }
+  MM_AVX2 static V load(const float *p) { return _mm256_load_ps(p); }
+  MM_AVX2 static V loadu(const float *p) { return _mm256_loadu_ps(p); }
+  MM_AVX2 static void store(float *p, V v) { _mm256_store_ps(p, v); }
+  MM_AVX2 static void storeu(float *p, V v) { _mm256_storeu_ps(p, v); }
+  MM_AVX2 static V add(V x, V y) { return _mm256_add_ps(x, y); }
+  MM_AVX2 static V madd(V acc, float a, V b)
+  {
+    return _mm256_fmadd_ps(_mm256_set1_ps(a), b, acc);
+  }
+};
+
+template <> struct Avx2Ops<double>
+{
+  using V = __m256d;
+  static constexpr size_t lanes = 4;
+  MM_AVX2 static V zero() { return _mm256_setzero_pd(); }
+  MM_AVX2 static V load(const double *p) { return _mm256_load_pd(p); }
+  MM_AVX2 static V loadu(const double *p) { return _mm256_loadu_pd(p); }
+  MM_AVX2 static void store(double *p, V v) { _mm256_store_pd(p, v); }
+  MM_AVX2 static void storeu(double *p, V v) { _mm256_storeu_pd(p, v); }
+  MM_AVX2 static V add(V x, V y) { return _mm256_add_pd(x, y); }
+  MM_AVX2 static V madd(V acc, double a, V b)
+  {
+    return _mm256_fmadd_pd(_mm256_set1_pd(a), b, acc);
+  }
+};
+
+/// AVX-512向量操作, 只为有对应指令的类型特化
+template <typename T> struct Avx512Ops;
+
+template <> struct Avx512Ops<int>
+{
+  using V = __m512i;
+  static constexpr size_t lanes = 16;
+  MM_AVX512 static V zero() { return _mm512_setzero_si512(); }
+  MM_AVX512 static V load(const int *p) { return _mm512_load_si512(p); }
+  MM_AVX512 static V loadu(const int *p) { return _mm512_loadu_si512(p); }
+  MM_AVX512 static void store(int *p, V v) { _mm512_store_si512(p, v); }
+  MM_AVX512 static void storeu(int *p, V v) { _mm512_storeu_si512(p, v); }
+  MM_AVX512 static V add(V x, V y) { return _mm512_add_epi32(x, y); }
+  MM_AVX512 static V madd(V acc, int a, V b)
+  {
+    return _mm512_add_epi32(acc, _mm512_mullo_epi32(_mm512_set1_epi32(a), b));
+  }
+};
+
+template <> struct Avx512Ops<float>
+{
+  using V = __m512;
+  static constexpr size_t lanes = 16;
+  MM_AVX512 static V zero() { return _mm512_setzero_ps(); }
+  MM_AVX512 static V load(const float *p) { return _mm512_load_ps(p); }
+  MM_AVX512 static V loadu(const float *p) { return _mm512_loadu_ps(p); }
+  MM_AVX512 static void store(float *p, V v) { _mm512_store_ps(p, v); }
+  MM_AVX512 static void storeu(float *p, V v) { _mm512_storeu_ps(p, v); }
+  MM_AVX512 static V add(V x, V y) { return _mm512_add_ps(x, y); }
+  MM_AVX512 static V madd(V acc, float a, V b)
+  {
+    return _mm512_fmadd_ps(_mm512_set1_ps(a), b, acc);
+  }
+};
+
+template <> struct Avx512Ops<double>
+{
+  using V = __m512d;
+  static constexpr size_t lanes = 8;
+  MM_AVX512 static V zero() { return _mm512_setzero_pd(); }
+  MM_AVX512 static V load(const double *p) { return _mm512_load_pd(p); }
+  MM_AVX512 static V loadu(const double *p) { return _mm512_loadu_pd(p); }
+  MM_AVX512 static void store(double *p, V v) { _mm512_store_pd(p, v); }
+  MM_AVX512 static void storeu(double *p, V v) { _mm512_storeu_pd(p, v); }
+  MM_AVX512 static V add(V x, V y) { return _mm512_add_pd(x, y); }
+  MM_AVX512 static V madd(V acc, double a, V b)
+  {
+    return _mm512_fmadd_pd(_mm512_set1_pd(a), b, acc);
+  }
+};
+
+MM_DEFINE_SIMD_MICRO_KERNEL(micro_kernel_avx2, MM_AVX2, Avx2Ops)
+MM_DEFINE_SIMD_MICRO_KERNEL(micro_kernel_avx512, MM_AVX512, Avx512Ops)
+MM_DEFINE_PEAK_PROBE(peak_probe_avx2, MM_AVX2, Avx2Ops)
+MM_DEFINE_PEAK_PROBE(peak_probe_avx512, MM_AVX512, Avx512Ops)
+MM_DEFINE_READ_KERNEL(read_kernel_avx2, MM_AVX2, Avx2Ops)
+MM_DEFINE_READ_KERNEL(read_kernel_avx512, MM_AVX512, Avx512Ops)
+#endif // MM_SIMD_X86
+
+#ifdef MM_SIMD_NEON
+/// NEON向量操作, 只为有对应指令的类型特化
+template <typename T> struct NeonOps;
+
+template <> struct NeonOps<int>
+{
+  using V = int32x4_t;
+  static constexpr size_t lanes = 4;
+  static V zero() { return vdupq_n_s32(0); }
+  static V load(const int *p) { return vld1q_s32(p); }
+  static V loadu(const int *p) { return vld1q_s32(p); }
+  static void store(int *p, V v) { vst1q_s32(p, v); }
+  static void storeu(int *p, V v) { vst1q_s32(p, v); }
+  static V add(V x, V y) { return vaddq_s32(x, y); }
+  static V madd(V acc, int a, V b) { return vmlaq_n_s32(acc, b, a); }
+};
+
+template <> struct NeonOps<float>
+{
+  using V = float32x4_t;
+  static constexpr size_t lanes = 4;
+  static V zero() { return vdupq_n_f32(0.0f); }
+  static V load(const float *p) { return vld1q_f32(p); }
+  static V loadu(const float *p) { return vld1q_f32(p); }
+  static void store(float *p, V v) { vst1q_f32(p, v); }
+  static void storeu(float *p, V v) { vst1q_f32(p, v); }
+  static V add(V x, V y) { return vaddq_f32(x, y); }
+  static V madd(V acc, float a, V b)
+  {
+    return vmlaq_f32(acc, b, vdupq_n_f32(a));
+  }
+};
+
+#  if defined(__aarch64__) || defined(_M_ARM64)
+#    define MM_NEON_F64 1
+template <> struct NeonOps<double>
+{
+  using V = float64x2_t;
+  static constexpr size_t lanes = 2;
+  static V zero() { return vdupq_n_f64(0.0); }
+  static V load(const double *p) { return vld1q_f64(p); }
+  static V loadu(const double *p) { return vld1q_f64(p); }
+  static void store(double *p, V v) { vst1q_f64(p, v); }
+  static void storeu(double *p, V v) { vst1q_f64(p, v); }
+  static V add(V x, V y) { return vaddq_f64(x, y); }
+  static V madd(V acc, double a, V b) { return vfmaq_n_f64(acc, b, a); }
+};
+#  endif
+
+MM_DEFINE_SIMD_MICRO_KERNEL(micro_kernel_neon, , NeonOps)
+MM_DEFINE_PEAK_PROBE(peak_probe_neon, , NeonOps)
+#  ifdef MM_NEON_F64
+MM_DEFINE_READ_KERNEL(read_kernel_neon, , NeonOps)
+#  endif
+#endif // MM_SIMD_NEON
+
+/**
+ * @brief 标量量化微内核
+ *
+ * 可移植的实现, 也是所有SIMD路径的参考: 对每组G个元素先求点积,
+ * 再累加到int32; 输入范围保证int32不溢出时与各SIMD路径结果完全相同
+ *
+ * @tparam TA A的元素类型
+ * @tparam TB B的元素类型
+ * @param groups 分组数
+ * @param a_panel 打包后的A面板
+ * @param b_panel 打包后的B面板
+ * @param acc 输出, MR x NR行主序
+ */
+template <typename TA, typename TB>
+static void quant_kernel_scalar(size_t groups,
+                                const TA *__restrict a_panel,
+                                const TB *__restrict b_panel,
+                                int32_t *__restrict acc)
+{
+  constexpr size_t G = QUANT_GROUP<TA>;
+  int32_t sum[QUANT_MR][QUANT_NR] = {};
+  for (size_t g = 0; g < groups; g++)
+  {
+    for (size_t i = 0; i < QUANT_MR; i++)
+    {
+      for (size_t j = 0; j < QUANT_NR; j++)
+      {
+        int32_t dot = 0;
+        for (size_t t = 0; t < G; t++)
+        {
+          dot += static_cast<int32_t>(a_panel[i * G + t])
+                 * static_cast<int32_t>(b_panel[j * G + t]);
+        }
+        sum[i][j] += dot;
+      }
+    }
+    a_panel += QUANT_MR * G;
+    b_panel += QUANT_NR * G;
+  }
+  memcpy(acc, sum, sizeof(sum));
+}
+
+/**
+ * @brief 读取A面板中一行的一组元素, 作为广播用的32位整数
+ */
+template <typename TA> static int32_t quant_group_word(const TA *group)
+{
+  int32_t word;
+  memcpy(&word, group, sizeof(word));
+  return word;
+}
+
+#ifdef MM_SIMD_X86
+#  define MM_AVX512_VNNI MM_TARGET("avx512f,avx512vnni")
+
+/**
+ * @brief AVX2量化微内核
+ *
+ * u8 x s8使用vpmaddubsw把相邻两对乘积相加为int16, 再用vpmaddwd乘1
+ * 扩展为int32; vpmaddubsw的int16结果会饱和, 因此|b| <= 64时才保证精确
+ * (与FBGEMM等库在无VNNI的x86上把权重限制为7位相同)。s16 x s16直接
+ * 使用vpmaddwd。16个累加器和两个B向量会占满16个寄存器,
+ * 因此MR行分两遍计算, 每遍4行
+ */
+template <typename TA, typename TB>
+MM_AVX2 static void quant_kernel_avx2(size_t groups,
+                                      const TA *__restrict a_panel,
+                                      const TB *__restrict b_panel,
+                                      int32_t *__restrict acc)
+{
+  constexpr size_t G = QUANT_GROUP<TA>;
+  constexpr size_t ROWS = QUANT_MR / 2;
+  const __m256i ones = _mm256_set1_epi16(1);
+  for (size_t r0 = 0; r0 < QUANT_MR; r0 += ROWS)
+  {
+    __m256i c[ROWS][2];
+    for (size_t i = 0; i < ROWS; i++)
+    {
+      c[i][0] = _mm256_setzero_si256();
+      c[i][1] = _mm256_setzero_si256();
+    }
+    const TA *a = a_panel + r0 * G;
+    const __m256i *b = reinterpret_cast<const __m256i *>(b_panel);
+    for (size_t g = 0; g < groups; g++)
+    {
+      const __m256i b0 = _mm256_loadu_si256(b);
+      const __m256i b1 = _mm256_loadu_si256(b + 1);
+      for (size_t i = 0; i < ROWS; i++)
+      {
+        const __m256i av = _mm256_set1_epi32(quant_group_word(a + i * G));
+        if constexpr (sizeof(TA) == 1)
+        {
+          c[i][0] = _mm256_add_epi32(
+              c[i][0], _mm256_madd_epi16(_mm256_maddubs_epi16(av, b0), ones));
+          c[i][1] = _mm256_add_epi32(
+              c[i][1], _mm256_madd_epi16(_mm256_maddubs_epi16(av, b1), ones));
+        }
+        else
+        {
+          c[i][0] = _mm256_add_epi32(c[i][0], _mm256_madd_epi16(av, b0));
+          c[i][1] = _mm256_add_epi32(c[i][1], _mm256_madd_epi16(av, b1));
+        }
+      }
+      a += QUANT_MR * G;
+      b += QUANT_NR * G * sizeof(TB) / sizeof(__m256i);
+    }
+    for (size_t i = 0; i < ROWS; i++)
+    {
+      __m256i *out = reinterpret_cast<__m256i *>(acc + (r0 + i) * QUANT_NR);
+      _mm256_storeu_si256(out, c[i][0]);
+      _mm256_storeu_si256(out + 1, c[i][1]);
+    }
+  }
+}
+
+/**
+ * @brief AVX-512 VNNI量化微内核
+ *
+ * vpdpbusd(u8 x s8)和vpdpwssd(s16 x s16)一条指令完成一组乘积的求和
+ * 与int32累加, 中间结果不饱和; 每行一个512位累加器
+ */
+template <typename TA, typename TB>
+MM_AVX512_VNNI static void quant_kernel_vnni(size_t groups,
+                                             const TA *__restrict a_panel,
+                                             const TB *__restrict b_panel,
+                                             int32_t *__restrict acc)
+{
+  constexpr size_t G = QUANT_GROUP<TA>;
+  __m512i c[QUANT_MR];
+  for (size_t i = 0; i < QUANT_MR; i++)
+  {
+    c[i] = _mm512_setzero_si512();
+  }
+  for (size_t g = 0; g < groups; g++)
+  {
+    const __m512i bv = _mm512_loadu_si512(b_panel);
+    for (size_t i = 0; i < QUANT_MR; i++)
+    {
+      const __m512i av = _mm512_set1_epi32(quant_group_word(a_panel + i * G));
+      if constexpr (sizeof(TA) == 1)
+      {
+        c[i] = _mm512_dpbusd_epi32(c[i], av, bv);
+      }
+      else
+      {
+        c[i] = _mm512_dpwssd_epi32(c[i], av, bv);
+      }
+    }
+    a_panel += QUANT_MR * G;
+    b_panel += QUANT_NR * G;
+  }
+  for (size_t i = 0; i < QUANT_MR; i++)
+  {
+    _mm512_storeu_si512(acc + i * QUANT_NR, c[i]);
+  }
+}
+
+/**
+ * @brief 判断CPU是否支持AVX-512 VNNI
+ *
+ * @return bool AVX-512F可用且CPUID.(EAX=7):ECX[11]置位时返回true
+ */
+static bool avx512_vnni_supported()
+{
+  if (!simd_isa_supported(SimdIsa::AVX512)) return false;
+#  if defined(__GNUC__) || defined(__clang__)
+  return __builtin_cpu_supports("avx512vnni");
+#  else
+  int regs[4];
+  __cpuidex(regs, 7, 0);
+  return (regs[2] & (1 << 11)) != 0;
+#  endif
+}
+#endif // MM_SIMD_X86
+
+#if defined(MM_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#  define MM_NEON_QUANT 1
+
+/**
+ * @brief NEON int16量化微内核
+ *
+ * 每组两个int16: smull/smull2把A的一对元素与4列各自的一对元素相乘,
+ * addp把相邻乘积相加得到4列的点积。MR行分两遍计算, 每遍4行
+ */
+static void quant_kernel_neon_s16(size_t groups,
+                                  const int16_t *__restrict a_panel,
+                                  const int16_t *__restrict b_panel,
+                                  int32_t *__restrict acc)
+{
+  constexpr size_t G = QUANT_GROUP<int16_t>;
+  constexpr size_t ROWS = QUANT_MR / 2;
+  constexpr size_t VECTORS = QUANT_NR * G / 8;
+  for (size_t r0 = 0; r0 < QUANT_MR; r0 += ROWS)
+  {
+    int32x4_t c[ROWS][VECTORS];
+    for (size_t i = 0; i < ROWS; i++)
+    {
+      for (size_t q = 0; q < VECTORS; q++)
+      {
+        c[i][q] = vdupq_n_s32(0);
+      }
+    }
+    const int16_t *a = a_panel + r0 * G;
+    const int16_t *b = b_panel;
+    for (size_t g = 0; g < groups; g++)
+    {
+      int16x8_t bv[VECTORS];
+      for (size_t q = 0; q < VECTORS; q++)
+      {
+        bv[q] = vld1q_s16(b + q * 8);
+      }
+      for (size_t i = 0; i < ROWS; i++)
+      {
+        const int16x8_t av =
+            vreinterpretq_s16_s32(vdupq_n_s32(quant_group_word(a + i * G)));
+        for (size_t q = 0; q < VECTORS; q++)
+        {
+          const int32x4_t lo = vmull_s16(vget_low_s16(av), vget_low_s16(bv[q]));
+          const int32x4_t hi = vmull_high_s16(av, bv[q]);
+          c[i][q] = vaddq_s32(c[i][q], vpaddq_s32(lo, hi));
+        }
+      }
+      a += QUANT_MR * G;
+      b += QUANT_NR * G;
+    }
+    for (size_t i = 0; i < ROWS; i++)
+    {
+      for (size_t q = 0; q < VECTORS; q++)
+      {
+        vst1q_s32(acc + (r0 + i) * QUANT_NR + q * 4, c[i][q]);
+      }
+    }
+  }
+}
+
+// sdot属于ARMv8.2的可选扩展dotprod: GCC和较新的Clang可以只为单个函数启用,
+// 其他编译器只在整个程序按dotprod编译时(如Apple Silicon)使用
+#  if defined(__ARM_FEATURE_DOTPROD)
+#    define MM_NEON_DOTPROD
+#  elif defined(__clang__) && __clang_major__ >= 16
+#    define MM_NEON_DOTPROD MM_TARGET("dotprod")
+#  elif defined(__GNUC__) && !defined(__clang__)
+#    define MM_NEON_DOTPROD MM_TARGET("arch=armv8.2-a+dotprod")
+#  endif
+
+#  ifdef MM_NEON_DOTPROD
+/**
+ * @brief NEON dotprod量化微内核
+ *
+ * sdot只支持有符号乘有符号, 因此A按uint8值减128打包为int8
+ * (QuantKernel::signed_a), 调用方把多减的128 * B列和补回零点修正;
+ * 每条sdot完成4列各4个int8乘积的求和与累加。MR行分两遍计算, 每遍4行
+ */
+MM_NEON_DOTPROD static void quant_kernel_neon_dot(
+    size_t groups,
+    const uint8_t *__restrict a_panel,
+    const int8_t *__restrict b_panel,
+    int32_t *__restrict acc)
+{
+  constexpr size_t G = QUANT_GROUP<uint8_t>;
+  constexpr size_t ROWS = QUANT_MR / 2;
+  constexpr size_t VECTORS = QUANT_NR * G / 16;
+  for (size_t r0 = 0; r0 < QUANT_MR; r0 += ROWS)
+  {
+    int32x4_t c[ROWS][VECTORS];
+    for (size_t i = 0; i < ROWS; i++)
+    {
+      for (size_t q = 0; q < VECTORS; q++)
+      {
+        c[i][q] = vdupq_n_s32(0);
+      }
+    }
+    const uint8_t *a = a_panel + r0 * G;
+    const int8_t *b = b_panel;
+    for (size_t g = 0; g < groups; g++)
+    {
+      int8x16_t bv[VECTORS];
+      for (size_t q = 0; q < VECTORS; q++)
+      {
+        bv[q] = vld1q_s8(b + q * 16);
+      }
+      for (size_t i = 0; i < ROWS; i++)
+      {
+        const int8x16_t av =
+            vreinterpretq_s8_s32(vdupq_n_s32(quant_group_word(a + i * G)));
+        for (size_t q = 0; q < VECTORS; q++)
+        {
+          c[i][q] = vdotq_s32(c[i][q], av, bv[q]);
+        }
+      }
+      a += QUANT_MR * G;
+      b += QUANT_NR * G;
+    }
+    for (size_t i = 0; i < ROWS; i++)
+    {
+      for (size_t q = 0; q < VECTORS; q++)
+      {
+        vst1q_s32(acc + (r0 + i) * QUANT_NR + q * 4, c[i][q]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief 判断CPU是否支持dotprod扩展
+ *
+ * Linux读取AT_HWCAP中的HWCAP_ASIMDDP位; 整个程序按dotprod编译时
+ * (包括所有Apple Silicon)直接返回true
+ *
+ * @return bool 支持sdot时返回true
+ */
+static bool neon_dotprod_supported()
+{
+#    if defined(__ARM_FEATURE_DOTPROD)
+  return true;
+#    elif defined(__linux__) && defined(HWCAP_ASIMDDP)
+  return (getauxval(AT_HWCAP) & HWCAP_ASIMDDP) != 0;
+#    else
+  return false;
+#    endif
+}
+#  endif // MM_NEON_DOTPROD
+#endif // MM_NEON_QUANT
+
+/**
+ * @brief 判断当前CPU是否支持指定指令集
+ *
+ * 只有程序中编译了对应内核、且运行时检测通过的指令集才视为支持：
+ * - x86: GCC/Clang使用__builtin_cpu_supports(会检查XCR0中的寄存器状态),
+ *   MSVC使用__cpuidex和_xgetbv; AVX2内核同时使用FMA, 因此两者都需要支持
+ * - ARM64: NEON为架构必选特性
+ * - 32位ARM Linux: 读取AT_HWCAP中的HWCAP_NEON位
+ *
+ * @param isa 指令集
+ * @return bool 支持时返回true
+ */
+bool simd_isa_supported(SimdIsa isa)
+{
+  switch (isa)
+  {
+    case SimdIsa::Auto:
+    case SimdIsa::Scalar:
+      return true;
+    case SimdIsa::AVX2:
+    case SimdIsa::AVX512:
+#ifdef MM_SIMD_X86
+#  if defined(__GNUC__) || defined(__clang__)
+      __builtin_cpu_init();
+      if (isa == SimdIsa::AVX2)
+      {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+      }
+      return __builtin_cpu_supports("avx512f");
+#  else
+    {
+      int regs[4];
+      __cpuidex(regs, 1, 0);
+      bool osxsave = (regs[2] & (1 << 27)) != 0;
+      if (!osxsave) return false;
+      unsigned long long xcr0 = _xgetbv(0);
+      __cpuidex(regs, 7, 0);
+      if (isa == SimdIsa::AVX2)
+      {
+        __cpuidex(regs, 1, 0);
+        bool fma = (regs[2] & (1 << 12)) != 0;
+        __cpuidex(regs, 7, 0);
+        return (xcr0 & 0x6) == 0x6 && (regs[1] & (1 << 5)) != 0 && fma;
+      }
+      return (xcr0 & 0xE6) == 0xE6 && (regs[1] & (1 << 16)) != 0;
+    }
+#  endif
+#else
+      return false;
+#endif
+    case SimdIsa::NEON:
+#if defined(MM_SIMD_NEON) && defined(__linux__) && defined(__arm__)
+      return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#elif defined(MM_SIMD_NEON)
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+/**
+ * @brief 检测CPU支持的最高SIMD指令集
+ *
+ * 按AVX-512 > AVX2 > NEON > 标量的优先级返回第一个可用的指令集
+ *
+ * @return SimdIsa 可用的最高指令集
+ * @see simd_isa_supported()
+ */
+SimdIsa detect_simd_isa()
+{
+  const SimdIsa candidates[] = {SimdIsa::AVX512, SimdIsa::AVX2, SimdIsa::NEON};
+  for (SimdIsa isa : candidates)
+  {
+    if (simd_isa_supported(isa)) return isa;
+  }
+  return SimdIsa::Scalar;
+}
+
+/**
+ * @brief 获取指令集名称
+ *
+ * @param isa 指令集
+ * @return const char* 与--isa参数一致的名称
+ */
+const char *simd_isa_name(SimdIsa isa)
+{
+  switch (isa)
+  {
+    case SimdIsa::Auto:
+      return "auto";
+    case SimdIsa::Scalar:
+      return "scalar";
+    case SimdIsa::AVX2:
+      return "avx2";
+    case SimdIsa::AVX512:
+      return "avx512";
+    case SimdIsa::NEON:
+      return "neon";
+  }
+  return "unknown";
+}
+
+/**
+ * @brief 设置打包GEMM使用的指令集
+ *
+ * @param isa 指令集, SimdIsa::Auto表示使用detect_simd_isa()的结果
+ * @pre simd_isa_supported(isa)
+ */
+void set_simd_isa(SimdIsa isa)
+{
+  if (isa == SimdIsa::Auto) isa = detect_simd_isa();
+  selected_isa.store(isa, std::memory_order_relaxed);
+}
+
+/**
+ * @brief 获取当前使用的指令集
+ *
+ * 首次调用且尚未通过set_simd_isa()设置时执行检测并缓存结果
+ *
+ * @return SimdIsa 当前指令集
+ */
+SimdIsa active_simd_isa()
+{
+  SimdIsa isa = selected_isa.load(std::memory_order_relaxed);
+  if (isa == SimdIsa::Auto)
+  {
+    isa = detect_simd_isa();
+    selected_isa.store(isa, std::memory_order_relaxed);
+  }
+  return isa;
+}
+
+/**
+ * @brief 获取指令集对应的微内核
+ *
+ * 程序中未编译的指令集, 以及没有向量乘法指令的类型(AVX2/AVX-512F/NEON
+ * 均无int64乘法, 32位ARM的NEON无double)回退到标量实现
+ *
+ * @tparam T 元素类型
+ * @param isa 指令集
+ * @return MicroKernel<T> 微内核函数指针
+ */
+template <typename T> MicroKernel<T> select_micro_kernel(SimdIsa isa)
+{
+  if constexpr (!std::is_same_v<T, int64_t>)
+  {
+    switch (isa)
+    {
+#ifdef MM_SIMD_X86
+      case SimdIsa::AVX2:
+        return micro_kernel_avx2<T>;
+      case SimdIsa::AVX512:
+        return micro_kernel_avx512<T>;
+#endif
+#ifdef MM_SIMD_NEON
+      case SimdIsa::NEON:
+#  ifndef MM_NEON_F64
+        if constexpr (std::is_same_v<T, double>) break;
+        else
+#  endif
+          return micro_kernel_neon<T>;
+#endif
+      default:
+        break;
+    }
+  }
+  return micro_kernel_scalar<T>;
+}
+
+/**
+ * @brief 获取指令集对应的峰值探测函数
+ *
+ * 回退规则与select_micro_kernel()相同
+ *
+ * @tparam T 元素类型
+ * @param isa 指令集
+ * @return PeakProbe<T> 峰值探测函数指针
+ */
+template <typename T> PeakProbe<T> select_peak_probe(SimdIsa isa)
+{
+  if constexpr (!std::is_same_v<T, int64_t>)
+  {
+    switch (isa)
+    {
+#ifdef MM_SIMD_X86
+      case SimdIsa::AVX2:
+        return peak_probe_avx2<T>;
+      case SimdIsa::AVX512:
+        return peak_probe_avx512<T>;
+#endif
+#ifdef MM_SIMD_NEON
+      case SimdIsa::NEON:
+#  ifndef MM_NEON_F64
+        if constexpr (std::is_same_v<T, double>) break;
+        else
+#  endif
+          return peak_probe_neon<T>;
+#endif
+      default:
+        break;
+    }
+  }
+  return peak_probe_scalar<T>;
+}
+
+/**
+ * @brief 获取指令集对应的顺序读内核
+ *
+ * @param isa 指令集
+ * @return ReadKernel 顺序读内核函数指针, 没有对应实现时为标量版本
+ */
+ReadKernel select_read_kernel(SimdIsa isa)
+{
+  switch (isa)
+  {
+#ifdef MM_SIMD_X86
+    case SimdIsa::AVX2:
+      return read_kernel_avx2;
+    case SimdIsa::AVX512:
+      return read_kernel_avx512;
+#endif
+#ifdef MM_NEON_F64
+    case SimdIsa::NEON:
+      return read_kernel_neon;
+#endif
+    default:
+      break;
+  }
+  return read_kernel_scalar;
+}
+
+/**
+ * @brief 获取指令集对应的量化微内核
+ *
+ * 按AVX-512 VNNI(vpdpbusd/vpdpwssd) > AVX2(vpmaddubsw/vpmaddwd) >
+ * NEON(sdot或smull) > 标量的顺序选择isa允许且CPU支持的实现:
+ * --isa avx512在没有VNNI的CPU上使用AVX2内核, --isa scalar强制使用
+ * 可移植实现
+ *
+ * @tparam TA A的元素类型(uint8_t或int16_t)
+ * @tparam TB B的元素类型(int8_t或int16_t)
+ * @param isa 指令集
+ * @return QuantKernel<TA, TB> 微内核及其路径名称
+ */
+template <typename TA, typename TB>
+QuantKernel<TA, TB> select_quant_kernel(SimdIsa isa)
+{
+  constexpr bool bytes = sizeof(TA) == 1;
+  switch (isa)
+  {
+#ifdef MM_SIMD_X86
+    case SimdIsa::AVX512:
+      if (avx512_vnni_supported())
+      {
+        return {quant_kernel_vnni<TA, TB>,
+                "avx512-vnni",
+                bytes ? "vpdpbusd" : "vpdpwssd",
+                false};
+      }
+      [[fallthrough]];
+    case SimdIsa::AVX2:
+      if (simd_isa_supported(SimdIsa::AVX2))
+      {
+        return {quant_kernel_avx2<TA, TB>,
+                "avx2",
+                bytes ? "vpmaddubsw+vpmaddwd" : "vpmaddwd",
+                false};
+      }
+      break;
+#endif
+#ifdef MM_NEON_QUANT
+    case SimdIsa::NEON:
+      if constexpr (bytes)
+      {
+#  ifdef MM_NEON_DOTPROD
+        if (neon_dotprod_supported())
+        {
+          return {quant_kernel_neon_dot, "neon-dotprod", "sdot", true};
+        }
+#  endif
+      }
+      else
+      {
+        return {quant_kernel_neon_s16, "neon", "smull+addp", false};
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+  return {quant_kernel_scalar<TA, TB>, "scalar", "", false};
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_MICRO_KERNEL(T)                                       \
+  template MicroKernel<T> select_micro_kernel<T>(SimdIsa);                   \
+  template PeakProbe<T> select_peak_probe<T>(SimdIsa);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_MICRO_KERNEL)
+#undef MM_INSTANTIATE_MICRO_KERNEL
+
+// 量化GEMM支持的输入类型组合
+template QuantKernel<uint8_t, int8_t>
+select_quant_kernel<uint8_t, int8_t>(SimdIsa);
+template QuantKernel<int16_t, int16_t>
+select_quant_kernel<int16_t, int16_t>(SimdIsa);
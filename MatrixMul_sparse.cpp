@@ -0,0 +1,1024 @@
+#include "MatrixMul.h"
+
+#include <random>
+#include <utility>
+
+/// 幂律结构中第i行权重1/(i+1)^a的指数a
+static constexpr double POWER_LAW_EXPONENT = 1.0;
+
+/// 稠密对照中A矩阵的最大字节数, 超过时跳过稠密对照
+static constexpr size_t DENSE_REFERENCE_LIMIT = size_t(1) << 30;
+
+/// 有编译期特化内核的BSR块边长
+#define MM_BSR_BLOCKS(X) X(2) X(4) X(8) X(16)
+
+/**
+ * @brief 获取稀疏结构的名称
+ *
+ * @param structure 稀疏结构
+ * @return const char* 与--structure参数一致的名称
+ */
+const char *sparse_structure_name(SparseStructure structure)
+{
+  switch (structure)
+  {
+    case SparseStructure::Banded:
+      return "banded";
+    case SparseStructure::PowerLaw:
+      return "powerlaw";
+    case SparseStructure::Uniform:
+      break;
+  }
+  return "uniform";
+}
+
+/**
+ * @brief 判断BSR块边长是否有编译期特化的内核
+ *
+ * @param block 块边长
+ * @return bool 块边长属于MM_BSR_BLOCKS时返回true
+ */
+bool bsr_block_supported(size_t block)
+{
+  switch (block)
+  {
+#define MM_BSR_CASE(B)                                                       \
+  case B:                                                                    \
+    return true;
+    MM_BSR_BLOCKS(MM_BSR_CASE)
+#undef MM_BSR_CASE
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief 以概率p独立地选中一行中的每一列, 追加到CSR矩阵末尾
+ *
+ * 按几何分布直接跳到下一个被选中的列, 耗时与非零元个数成正比,
+ * 而不是与列数成正比; 生成的列号自然升序
+ *
+ * @tparam T 元素类型
+ * @param matrix 目标矩阵, 追加到values和col_idx末尾
+ * @param p 每列被选中的概率
+ * @param generator 随机数发生器
+ */
+template <typename T>
+static void append_random_columns(CsrMatrix<T> &matrix,
+                                  double p,
+                                  std::mt19937_64 &generator)
+{
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::uniform_int_distribution<int> value(1, 9);
+  const double cols = static_cast<double>(matrix.cols);
+  if (p >= 1.0)
+  {
+    for (size_t col = 0; col < matrix.cols; col++)
+    {
+      matrix.col_idx.push_back(static_cast<uint32_t>(col));
+      matrix.values.push_back(static_cast<T>(value(generator)));
+    }
+    return;
+  }
+  if (p <= 0.0) return;
+  const double log_q = std::log1p(-p);
+  double col = -1.0;
+  for (;;)
+  {
+    col += 1.0 + std::floor(std::log(1.0 - uniform(generator)) / log_q);
+    if (col >= cols) break;
+    matrix.col_idx.push_back(static_cast<uint32_t>(col));
+    matrix.values.push_back(static_cast<T>(value(generator)));
+  }
+}
+
+/**
+ * @brief 生成指定密度和结构的稀疏矩阵
+ *
+ * - uniform: 每个元素以density的概率独立地成为非零元
+ * - banded: 第i行的非零元是以i * cols / rows为中心、宽度为density * cols
+ *   的连续列(至少1列), 带内全部非零
+ * - powerlaw: 第i行的密度与1/(i+1)^POWER_LAW_EXPONENT成正比, 总非零元
+ *   个数与uniform相同(单行密度超过1时截断), 前几行远比其他行稠密,
+ *   按行数等分会造成严重的负载不均衡
+ *
+ * @tparam T 元素类型
+ * @param rows 行数
+ * @param cols 列数, 不能超过uint32_t的范围
+ * @param density 期望密度(0, 1]
+ * @param structure 非零元分布
+ * @return CsrMatrix<T> 生成的矩阵
+ */
+template <typename T>
+CsrMatrix<T> generate_sparse(size_t rows,
+                             size_t cols,
+                             double density,
+                             SparseStructure structure)
+{
+  std::mt19937_64 generator(0x5eed);
+  std::uniform_int_distribution<int> value(1, 9);
+  CsrMatrix<T> matrix;
+  matrix.rows = rows;
+  matrix.cols = cols;
+  matrix.row_ptr.reserve(rows + 1);
+  matrix.row_ptr.push_back(0);
+
+  double weight_sum = 0.0;
+  if (structure == SparseStructure::PowerLaw)
+  {
+    for (size_t i = 0; i < rows; i++)
+    {
+      weight_sum +=
+          std::pow(static_cast<double>(i + 1), -POWER_LAW_EXPONENT);
+    }
+  }
+  const size_t width = std::clamp(
+      static_cast<size_t>(std::llround(density * static_cast<double>(cols))),
+      size_t(1),
+      cols);
+
+  for (size_t i = 0; i < rows; i++)
+  {
+    switch (structure)
+    {
+      case SparseStructure::Banded:
+      {
+        const size_t center = i * cols / rows;
+        const size_t first =
+            std::min(center >= width / 2 ? center - width / 2 : 0,
+                     cols - width);
+        for (size_t col = first; col < first + width; col++)
+        {
+          matrix.col_idx.push_back(static_cast<uint32_t>(col));
+          matrix.values.push_back(static_cast<T>(value(generator)));
+        }
+        break;
+      }
+      case SparseStructure::PowerLaw:
+      {
+        const double weight =
+            std::pow(static_cast<double>(i + 1), -POWER_LAW_EXPONENT);
+        append_random_columns(matrix,
+                              density * static_cast<double>(rows) * weight
+                                  / weight_sum,
+                              generator);
+        break;
+      }
+      case SparseStructure::Uniform:
+        append_random_columns(matrix, density, generator);
+        break;
+    }
+    matrix.row_ptr.push_back(matrix.values.size());
+  }
+  return matrix;
+}
+
+/**
+ * @brief 把CSR矩阵转换为BSR格式
+ *
+ * 对每个块行, 先收集其中各行非零元所在的块列并排序, 再把非零元
+ * 散布到对应块中; slot数组记录块列到块下标的映射, 处理完一个块行后
+ * 只恢复用到的项, 总耗时与非零元个数和块数成正比
+ *
+ * @tparam T 元素类型
+ * @param csr 源矩阵
+ * @param block 块边长
+ * @return BsrMatrix<T> 转换后的矩阵
+ */
+template <typename T>
+BsrMatrix<T> csr_to_bsr(const CsrMatrix<T> &csr, size_t block)
+{
+  constexpr size_t unused = std::numeric_limits<size_t>::max();
+  BsrMatrix<T> bsr;
+  bsr.rows = csr.rows;
+  bsr.cols = csr.cols;
+  bsr.block = block;
+  const size_t block_rows = (csr.rows + block - 1) / block;
+  const size_t block_cols = (csr.cols + block - 1) / block;
+  bsr.row_ptr.reserve(block_rows + 1);
+  bsr.row_ptr.push_back(0);
+
+  vector<size_t> slot(block_cols, unused);
+  vector<uint32_t> touched;
+  for (size_t bi = 0; bi < block_rows; bi++)
+  {
+    const size_t row_end = std::min((bi + 1) * block, csr.rows);
+    touched.clear();
+    for (size_t row = bi * block; row < row_end; row++)
+    {
+      for (size_t p = csr.row_ptr[row]; p < csr.row_ptr[row + 1]; p++)
+      {
+        const size_t bj = csr.col_idx[p] / block;
+        if (slot[bj] == unused)
+        {
+          slot[bj] = 0;
+          touched.push_back(static_cast<uint32_t>(bj));
+        }
+      }
+    }
+    std::sort(touched.begin(), touched.end());
+    const size_t base = bsr.col_idx.size();
+    for (size_t t = 0; t < touched.size(); t++)
+    {
+      slot[touched[t]] = base + t;
+      bsr.col_idx.push_back(touched[t]);
+    }
+    bsr.values.resize(bsr.col_idx.size() * block * block, T(0));
+    for (size_t row = bi * block; row < row_end; row++)
+    {
+      for (size_t p = csr.row_ptr[row]; p < csr.row_ptr[row + 1]; p++)
+      {
+        const size_t col = csr.col_idx[p];
+        bsr.values[slot[col / block] * block * block
+                   + (row - bi * block) * block + col % block] =
+            csr.values[p];
+      }
+    }
+    for (uint32_t bj : touched)
+    {
+      slot[bj] = unused;
+    }
+    bsr.row_ptr.push_back(bsr.col_idx.size());
+  }
+  return bsr;
+}
+
+/**
+ * @brief 按非零元个数均衡地把行划分为连续区间
+ *
+ * 每行的代价按非零元个数加1计算(1代表行首开销和结果写回),
+ * 第p个边界是前缀代价首次达到总代价p / parts的行;
+ * 单行非零元过多时该行仍只属于一个区间
+ *
+ * @param row_ptr CSR或BSR的行指针
+ * @param parts 区间个数
+ * @return vector<size_t> parts + 1个边界, 第p段为[bounds[p], bounds[p + 1])
+ */
+vector<size_t> partition_by_nnz(const vector<size_t> &row_ptr, size_t parts)
+{
+  const size_t rows = row_ptr.size() - 1;
+  const double total = static_cast<double>(row_ptr[rows] + rows);
+  vector<size_t> bounds(parts + 1, rows);
+  bounds[0] = 0;
+  size_t row = 0;
+  for (size_t p = 1; p < parts; p++)
+  {
+    const double target =
+        total * static_cast<double>(p) / static_cast<double>(parts);
+    while (row < rows && static_cast<double>(row_ptr[row] + row) < target)
+    {
+      row++;
+    }
+    bounds[p] = row;
+  }
+  return bounds;
+}
+
+/**
+ * @brief CSR稀疏矩阵与向量相乘
+ *
+ * 每行的点积累加在局部变量中, x按列号间接访问
+ *
+ * @tparam T 元素类型
+ * @param a 稀疏矩阵
+ * @param x 长度为a.cols的向量
+ * @param y 长度为a.rows的结果向量
+ * @param start 起始行(包含)
+ * @param end 结束行(不包含)
+ */
+template <typename T>
+void csr_spmv(
+    const CsrMatrix<T> &a, const T *x, T *y, size_t start, size_t end)
+{
+  const size_t *row_ptr = a.row_ptr.data();
+  const uint32_t *col_idx = a.col_idx.data();
+  const T *values = a.values.data();
+  for (size_t i = start; i < end; i++)
+  {
+    T sum = T(0);
+    for (size_t p = row_ptr[i]; p < row_ptr[i + 1]; p++)
+    {
+      sum += values[p] * x[col_idx[p]];
+    }
+    y[i] = sum;
+  }
+}
+
+/**
+ * @brief CSR稀疏矩阵与稠密矩阵相乘
+ *
+ * 每个非零元A(i, k)把B的第k行乘以该值累加到C的第i行,
+ * 最内层沿列连续访问, 可以向量化
+ *
+ * @tparam T 元素类型
+ * @param a 稀疏矩阵
+ * @param b 稠密矩阵(a.cols行)
+ * @param c 结果矩阵(a.rows行, 与b同列数)
+ * @param start 起始行(包含)
+ * @param end 结束行(不包含)
+ */
+template <typename T>
+void csr_spmm(const CsrMatrix<T> &a,
+              MatrixView<const T> b,
+              MatrixView<T> c,
+              size_t start,
+              size_t end)
+{
+  const size_t n = c.cols;
+  for (size_t i = start; i < end; i++)
+  {
+    T *__restrict c_row = c.row(i);
+    for (size_t p = a.row_ptr[i]; p < a.row_ptr[i + 1]; p++)
+    {
+      const T value = a.values[p];
+      const T *__restrict b_row = b.row(a.col_idx[p]);
+      for (size_t j = 0; j < n; j++)
+      {
+        c_row[j] += value * b_row[j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief 块边长为编译期常量的BSR稀疏矩阵与向量相乘
+ *
+ * 一个块行的B个结果累加在局部数组中, 块内循环完全展开;
+ * 超出矩阵右边界的最后一个块列只访问有效的列
+ *
+ * @tparam T 元素类型
+ * @tparam B 块边长
+ * @param a 稀疏矩阵
+ * @param x 长度为a.cols的向量
+ * @param y 长度为a.rows的结果向量
+ * @param start 起始块行(包含)
+ * @param end 结束块行(不包含)
+ */
+template <typename T, size_t B>
+static void bsr_spmv_fixed(
+    const BsrMatrix<T> &a, const T *x, T *y, size_t start, size_t end)
+{
+  for (size_t bi = start; bi < end; bi++)
+  {
+    T acc[B] = {};
+    for (size_t p = a.row_ptr[bi]; p < a.row_ptr[bi + 1]; p++)
+    {
+      const T *block = a.values.data() + p * B * B;
+      const size_t col0 = a.col_idx[p] * B;
+      const size_t width = std::min(B, a.cols - col0);
+      if (width == B)
+      {
+        for (size_t r = 0; r < B; r++)
+        {
+          for (size_t cc = 0; cc < B; cc++)
+          {
+            acc[r] += block[r * B + cc] * x[col0 + cc];
+          }
+        }
+      }
+      else
+      {
+        for (size_t r = 0; r < B; r++)
+        {
+          for (size_t cc = 0; cc < width; cc++)
+          {
+            acc[r] += block[r * B + cc] * x[col0 + cc];
+          }
+        }
+      }
+    }
+    const size_t row0 = bi * B;
+    const size_t height = std::min(B, a.rows - row0);
+    for (size_t r = 0; r < height; r++)
+    {
+      y[row0 + r] = acc[r];
+    }
+  }
+}
+
+/**
+ * @brief 块边长为编译期常量的BSR稀疏矩阵与稠密矩阵相乘
+ *
+ * 对每个块, C的每一行沿列方向一次累加该块一整行与B的B行的乘积,
+ * C的每个元素每块只读写一次(CSR每个非零元读写一次);
+ * 边界上不完整的块按实际行数和列数处理
+ *
+ * @tparam T 元素类型
+ * @tparam B 块边长
+ * @param a 稀疏矩阵
+ * @param b 稠密矩阵(a.cols行)
+ * @param c 结果矩阵(a.rows行, 与b同列数)
+ * @param start 起始块行(包含)
+ * @param end 结束块行(不包含)
+ */
+template <typename T, size_t B>
+static void bsr_spmm_fixed(const BsrMatrix<T> &a,
+                           MatrixView<const T> b,
+                           MatrixView<T> c,
+                           size_t start,
+                           size_t end)
+{
+  const size_t n = c.cols;
+  for (size_t bi = start; bi < end; bi++)
+  {
+    const size_t row0 = bi * B;
+    const size_t height = std::min(B, a.rows - row0);
+    for (size_t p = a.row_ptr[bi]; p < a.row_ptr[bi + 1]; p++)
+    {
+      const T *block = a.values.data() + p * B * B;
+      const size_t col0 = a.col_idx[p] * B;
+      const size_t width = std::min(B, a.cols - col0);
+      if (height == B && width == B)
+      {
+        const T *b_rows[B];
+        for (size_t cc = 0; cc < B; cc++)
+        {
+          b_rows[cc] = b.row(col0 + cc);
+        }
+        for (size_t r = 0; r < B; r++)
+        {
+          T *__restrict c_row = c.row(row0 + r);
+          const T *weights = block + r * B;
+          for (size_t j = 0; j < n; j++)
+          {
+            T sum = c_row[j];
+            for (size_t cc = 0; cc < B; cc++)
+            {
+              sum += weights[cc] * b_rows[cc][j];
+            }
+            c_row[j] = sum;
+          }
+        }
+        continue;
+      }
+      for (size_t r = 0; r < height; r++)
+      {
+        T *__restrict c_row = c.row(row0 + r);
+        for (size_t cc = 0; cc < width; cc++)
+        {
+          const T value = block[r * B + cc];
+          const T *__restrict b_row = b.row(col0 + cc);
+          for (size_t j = 0; j < n; j++)
+          {
+            c_row[j] += value * b_row[j];
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief BSR稀疏矩阵与向量相乘
+ *
+ * 按块边长分派到bsr_spmv_fixed()
+ *
+ * @tparam T 元素类型
+ * @param a 稀疏矩阵, 块边长必须满足bsr_block_supported()
+ * @param x 长度为a.cols的向量
+ * @param y 长度为a.rows的结果向量
+ * @param start 起始块行(包含)
+ * @param end 结束块行(不包含)
+ */
+template <typename T>
+void bsr_spmv(
+    const BsrMatrix<T> &a, const T *x, T *y, size_t start, size_t end)
+{
+  switch (a.block)
+  {
+#define MM_BSR_CASE(B)                                                       \
+  case B:                                                                    \
+    bsr_spmv_fixed<T, B>(a, x, y, start, end);                               \
+    break;
+    MM_BSR_BLOCKS(MM_BSR_CASE)
+#undef MM_BSR_CASE
+    default:
+      throw std::invalid_argument("不支持的BSR块边长");
+  }
+}
+
+/**
+ * @brief BSR稀疏矩阵与稠密矩阵相乘
+ *
+ * 按块边长分派到bsr_spmm_fixed()
+ *
+ * @tparam T 元素类型
+ * @param a 稀疏矩阵, 块边长必须满足bsr_block_supported()
+ * @param b 稠密矩阵(a.cols行)
+ * @param c 结果矩阵(a.rows行, 与b同列数)
+ * @param start 起始块行(包含)
+ * @param end 结束块行(不包含)
+ */
+template <typename T>
+void bsr_spmm(const BsrMatrix<T> &a,
+              MatrixView<const T> b,
+              MatrixView<T> c,
+              size_t start,
+              size_t end)
+{
+  switch (a.block)
+  {
+#define MM_BSR_CASE(B)                                                       \
+  case B:                                                                    \
+    bsr_spmm_fixed<T, B>(a, b, c, start, end);                               \
+    break;
+    MM_BSR_BLOCKS(MM_BSR_CASE)
+#undef MM_BSR_CASE
+    default:
+      throw std::invalid_argument("不支持的BSR块边长");
+  }
+}
+
+/**
+ * @brief 稠密矩阵与向量相乘, 作为SpMV的稠密对照
+ *
+ * @tparam T 元素类型
+ * @param a 稠密矩阵
+ * @param x 长度为a.cols()的向量
+ * @param y 长度为a.rows()的结果向量
+ * @param start 起始行(包含)
+ * @param end 结束行(不包含)
+ */
+template <typename T>
+static void dense_gemv(
+    const Matrix<T> &a, const T *x, T *y, size_t start, size_t end)
+{
+  const size_t cols = a.cols();
+  for (size_t i = start; i < end; i++)
+  {
+    const T *__restrict a_row = a.row(i);
+    T sum = T(0);
+    for (size_t k = 0; k < cols; k++)
+    {
+      sum += a_row[k] * x[k];
+    }
+    y[i] = sum;
+  }
+}
+
+/**
+ * @brief 计算一种行划分的负载不均衡度
+ *
+ * @param row_ptr 行指针
+ * @param bounds 划分边界
+ * @return double 最重区间的代价 / 平均代价, 代价与partition_by_nnz()相同
+ */
+static double partition_imbalance(const vector<size_t> &row_ptr,
+                                  const vector<size_t> &bounds)
+{
+  const size_t parts = bounds.size() - 1;
+  double heaviest = 0.0;
+  for (size_t p = 0; p < parts; p++)
+  {
+    heaviest = std::max(heaviest,
+                        static_cast<double>(row_ptr[bounds[p + 1]]
+                                            - row_ptr[bounds[p]]
+                                            + bounds[p + 1] - bounds[p]));
+  }
+  const size_t rows = row_ptr.size() - 1;
+  const double average =
+      static_cast<double>(row_ptr[rows] + rows) / static_cast<double>(parts);
+  return average > 0.0 ? heaviest / average : 1.0;
+}
+
+/**
+ * @brief 计算按行数等分的划分边界
+ *
+ * 与parallel_rows()的划分相同, 用于和按非零元均衡的划分对比
+ *
+ * @param rows 行数
+ * @param parts 区间个数
+ * @return vector<size_t> parts + 1个边界
+ */
+static vector<size_t> partition_by_rows(size_t rows, size_t parts)
+{
+  const size_t rows_per_part = (rows + parts - 1) / parts;
+  vector<size_t> bounds(parts + 1);
+  for (size_t p = 0; p <= parts; p++)
+  {
+    bounds[p] = std::min(p * rows_per_part, rows);
+  }
+  return bounds;
+}
+
+/**
+ * @brief 运行稀疏矩阵基准测试(--sparse)
+ *
+ * 执行流程：
+ * 1. 按--structure和--sparse生成M x K的CSR矩阵A, 再转换为BSR;
+ *    稠密A不超过DENSE_REFERENCE_LIMIT时同时生成稠密对照
+ * 2. 对SpMV(y = A * x)和SpMM(C += A * B, B为K x N)分别测量
+ *    CSR、BSR和稠密三条路径; 多线程按partition_by_nnz()划分行(块行),
+ *    每个线程一个区间; 稠密SpMM与--parallel optimized相同
+ * 3. 每条路径先预热config.warmup次, 再计时config.iterations次;
+ *    除--verify none外, 多线程结果与单线程CSR的参考结果逐元素比较
+ *
+ * 稀疏路径的运算量按2 * nnz(SpMM再乘以N)计算, BSR块内显式保存的零
+ * 不计入; 有效带宽按每次迭代必须读写的数据量计算: 矩阵的值和索引、
+ * 输入向量(矩阵)各读一次、结果写一次(SpMM的C读写各一次)。
+ *
+ * @tparam T 元素类型
+ * @param config 基准测试配置, 使用其中的稀疏参数和shape_m/shape_n/shape_k
+ * @param report 运行结果, 每个操作和格式追加一条记录
+ * @return int 程序退出状态码, 0表示成功, 1表示有结果验证失败
+ */
+template <typename T>
+int run_sparse(const BenchmarkConfig &config, BenchmarkReport &report)
+{
+  const size_t m = config.shape_m;
+  const size_t n = config.shape_n;
+  const size_t k = config.shape_k;
+  const size_t threads = config.num_threads;
+  const double element = static_cast<double>(sizeof(T));
+  const char *unit = throughput_unit(config.dtype);
+
+  const CsrMatrix<T> csr =
+      generate_sparse<T>(m, k, config.sparse_density, config.sparse_structure);
+  const BsrMatrix<T> bsr = csr_to_bsr(csr, config.bsr_block);
+  const size_t nnz = csr.nnz();
+  const bool dense_enabled = m * k * sizeof(T) <= DENSE_REFERENCE_LIMIT;
+
+  size_t longest_row = 0;
+  for (size_t i = 0; i < m; i++)
+  {
+    longest_row = std::max(longest_row, csr.row_ptr[i + 1] - csr.row_ptr[i]);
+  }
+  const vector<size_t> csr_bounds = partition_by_nnz(csr.row_ptr, threads);
+  const vector<size_t> bsr_bounds = partition_by_nnz(bsr.row_ptr, threads);
+
+  const double csr_bytes =
+      static_cast<double>(nnz) * (element + sizeof(uint32_t))
+      + static_cast<double>(m + 1) * sizeof(size_t);
+  const double bsr_bytes =
+      static_cast<double>(bsr.values.size()) * element
+      + static_cast<double>(bsr.blocks()) * sizeof(uint32_t)
+      + static_cast<double>(bsr.block_rows() + 1) * sizeof(size_t);
+  const double dense_bytes =
+      static_cast<double>(m) * static_cast<double>(k) * element;
+
+  cout << "=== 稀疏矩阵测试配置 ===" << endl;
+  cout << "稀疏矩阵A: " << m << "x" << k
+       << ", 结构: " << sparse_structure_name(config.sparse_structure)
+       << ", 目标密度: " << config.sparse_density << endl;
+  cout << "非零元: " << nnz << " (实际密度 " << scientific << setprecision(3)
+       << static_cast<double>(nnz)
+              / (static_cast<double>(m) * static_cast<double>(k))
+       << fixed << setprecision(2) << ", 平均每行 "
+       << static_cast<double>(nnz) / static_cast<double>(m) << ", 最多 "
+       << longest_row << ")" << endl;
+  cout << "BSR: " << config.bsr_block << "x" << config.bsr_block << " 块 "
+       << bsr.blocks() << " 个, 块内非零比例 "
+       << 100.0 * static_cast<double>(nnz)
+              / static_cast<double>(std::max(bsr.values.size(), size_t(1)))
+       << "%" << endl;
+  cout << "SpMM右侧稠密矩阵B: " << k << "x" << n << endl;
+  cout << "元素类型: " << dtype_name(config.dtype) << endl;
+  cout << "线程数: " << threads << endl;
+  cout << "线程派发: " << (config.use_pool ? "线程池" : "每次创建线程") << endl;
+  cout << "行划分负载(最重/平均): 按非零元均衡 "
+       << partition_imbalance(csr.row_ptr, csr_bounds) << ", 按行数等分 "
+       << partition_imbalance(csr.row_ptr, partition_by_rows(m, threads))
+       << endl;
+  cout << "迭代次数: " << config.iterations << " (预热 " << config.warmup
+       << " 次)" << endl;
+
+  std::unique_ptr<ThreadPool> pool;
+  if (config.use_pool)
+  {
+    pool = std::make_unique<ThreadPool>(threads);
+  }
+
+  Matrix<T> x(1, k, 0, matrix_no_init);
+  Matrix<T> y(1, m, 0, matrix_no_init);
+  Matrix<T> y_ref(1, m, 0, matrix_no_init);
+  for (size_t col = 0; col < k; col++)
+  {
+    x(0, col) = static_cast<T>((col * 17) % 100);
+  }
+  const size_t ld_b = configured_leading_dimension(config, n);
+  Matrix<T> b(k, n, ld_b, matrix_no_init);
+  Matrix<T> c(m, n, ld_b, matrix_no_init);
+  Matrix<T> c_ref(m, n, ld_b, matrix_no_init);
+  parallel_first_touch<T>(b,
+                          threads,
+                          pool.get(),
+                          [n](size_t row, T *b_row)
+                          {
+                            for (size_t col = 0; col < n; col++)
+                            {
+                              b_row[col] =
+                                  static_cast<T>((row * 17 + col * 31) % 100);
+                            }
+                          });
+  parallel_first_touch(c_ref, threads, pool.get());
+  Matrix<T> a_dense(dense_enabled ? m : 0,
+                    dense_enabled ? k : 0,
+                    configured_leading_dimension(config, k),
+                    matrix_no_init);
+  if (dense_enabled)
+  {
+    parallel_first_touch<T>(a_dense,
+                            threads,
+                            pool.get(),
+                            [&csr](size_t row, T *a_row)
+                            {
+                              for (size_t p = csr.row_ptr[row];
+                                   p < csr.row_ptr[row + 1];
+                                   p++)
+                              {
+                                a_row[csr.col_idx[p]] = csr.values[p];
+                              }
+                            });
+  }
+
+  const double vector_bytes = static_cast<double>(k + m) * element;
+  const double spmm_bytes = static_cast<double>(k * n + 2 * m * n) * element;
+  const double memory_mb =
+      (csr_bytes + bsr_bytes + (dense_enabled ? dense_bytes : 0.0)
+       + static_cast<double>(b.size_bytes() + 2 * c.size_bytes()))
+      / (1024.0 * 1024.0);
+  report.config = config;
+  report.leading_dimension = b.ld();
+  report.memory_mb = memory_mb;
+  report.nnz = nnz;
+  cout << "内存使用量约: " << memory_mb << " MB (CSR "
+       << csr_bytes / (1024.0 * 1024.0) << " MB, BSR "
+       << bsr_bytes / (1024.0 * 1024.0) << " MB, 稠密A ";
+  if (dense_enabled)
+  {
+    cout << dense_bytes / (1024.0 * 1024.0) << " MB)" << endl;
+  }
+  else
+  {
+    cout << "超过 " << (DENSE_REFERENCE_LIMIT >> 20)
+         << " MB, 跳过稠密对照)" << endl;
+  }
+  cout << "==================" << endl << endl;
+
+  // 参考结果: 单线程CSR
+  csr_spmv(csr, x.data(), y_ref.data(), 0, m);
+  csr_spmm(csr, std::as_const(b).view(), c_ref.view(), 0, m);
+
+  const double tolerance =
+      config.tolerance > 0.0 ? config.tolerance : default_tolerance<T>(k);
+  const GemmKernel<T> dense_kernel = select_kernel<T>(config.kernel);
+  const GemmTileKernel<T> tile_kernel = select_tile_kernel<T>(config.kernel);
+
+  // 测量一条路径: reset在每次计时前清零输出, single和multi分别执行
+  // 单线程和多线程计算; 结束后输出中保留最后一次多线程的结果
+  Timer timer;
+  bool all_verified = true;
+  auto measure = [&](const string &name,
+                     double operations,
+                     double bytes,
+                     const std::function<void()> &reset,
+                     const std::function<void()> &single,
+                     const std::function<void()> &multi,
+                     const Matrix<T> &expected,
+                     const Matrix<T> &actual)
+  {
+    KernelRun run;
+    run.kernel = name;
+    run.operations = operations;
+    run.bytes = bytes;
+    for (size_t iter = 0; iter < config.warmup + config.iterations; iter++)
+    {
+      const bool warm = iter < config.warmup;
+      if (!config.skip_single)
+      {
+        reset();
+        timer.start();
+        single();
+        timer.stop();
+        if (!warm) run.single_seconds.push_back(timer.get_seconds());
+      }
+      reset();
+      timer.start();
+      multi();
+      timer.stop();
+      if (!warm) run.multi_seconds.push_back(timer.get_seconds());
+    }
+    run.verified = true;
+    if (config.verify != VerifyMode::None)
+    {
+      run.verified = compare_matrices(
+                         expected, actual, tolerance, threads, pool.get())
+                         .passed;
+    }
+    all_verified = all_verified && run.verified;
+    if (config.verbose)
+    {
+      cout << "  " << name << ": " << fixed << setprecision(6)
+           << compute_sample_stats(run.multi_seconds).median << " 秒" << endl;
+    }
+    report.runs.push_back(run);
+  };
+
+  auto over_parts = [&](const vector<size_t> &bounds,
+                        const std::function<void(size_t, size_t)> &body)
+  {
+    parallel_rows(threads,
+                  threads,
+                  pool.get(),
+                  [&](size_t first, size_t last)
+                  {
+                    for (size_t part = first; part < last; part++)
+                    {
+                      body(bounds[part], bounds[part + 1]);
+                    }
+                  });
+  };
+  auto reset_y = [&] { y.fill(T(0)); };
+  auto reset_c = [&] { parallel_first_touch(c, threads, pool.get()); };
+  const MatrixView<const T> b_view = std::as_const(b).view();
+  const double spmv_ops = 2.0 * static_cast<double>(nnz);
+  const double spmm_ops = spmv_ops * static_cast<double>(n);
+
+  cout << "开始稀疏测试..." << endl;
+  measure(
+      "spmv-csr",
+      spmv_ops,
+      csr_bytes + vector_bytes,
+      reset_y,
+      [&] { csr_spmv(csr, x.data(), y.data(), 0, m); },
+      [&]
+      {
+        over_parts(csr_bounds,
+                   [&](size_t start, size_t end)
+                   { csr_spmv(csr, x.data(), y.data(), start, end); });
+      },
+      y_ref,
+      y);
+  measure(
+      "spmv-bsr",
+      spmv_ops,
+      bsr_bytes + vector_bytes,
+      reset_y,
+      [&] { bsr_spmv(bsr, x.data(), y.data(), 0, bsr.block_rows()); },
+      [&]
+      {
+        over_parts(bsr_bounds,
+                   [&](size_t start, size_t end)
+                   { bsr_spmv(bsr, x.data(), y.data(), start, end); });
+      },
+      y_ref,
+      y);
+  if (dense_enabled)
+  {
+    measure(
+        "spmv-dense",
+        2.0 * static_cast<double>(m) * static_cast<double>(k),
+        dense_bytes + vector_bytes,
+        reset_y,
+        [&] { dense_gemv(a_dense, x.data(), y.data(), 0, m); },
+        [&]
+        {
+          parallel_rows(m,
+                        threads,
+                        pool.get(),
+                        [&](size_t start, size_t end)
+                        {
+                          dense_gemv(a_dense, x.data(), y.data(), start, end);
+                        });
+        },
+        y_ref,
+        y);
+  }
+  measure(
+      "spmm-csr",
+      spmm_ops,
+      csr_bytes + spmm_bytes,
+      reset_c,
+      [&] { csr_spmm(csr, b_view, c.view(), 0, m); },
+      [&]
+      {
+        over_parts(csr_bounds,
+                   [&](size_t start, size_t end)
+                   { csr_spmm(csr, b_view, c.view(), start, end); });
+      },
+      c_ref,
+      c);
+  measure(
+      "spmm-bsr",
+      spmm_ops,
+      bsr_bytes + spmm_bytes,
+      reset_c,
+      [&] { bsr_spmm(bsr, b_view, c.view(), 0, bsr.block_rows()); },
+      [&]
+      {
+        over_parts(bsr_bounds,
+                   [&](size_t start, size_t end)
+                   { bsr_spmm(bsr, b_view, c.view(), start, end); });
+      },
+      c_ref,
+      c);
+  if (dense_enabled)
+  {
+    measure(
+        "spmm-dense",
+        2.0 * static_cast<double>(m) * static_cast<double>(n)
+            * static_cast<double>(k),
+        dense_bytes + spmm_bytes,
+        reset_c,
+        [&] { dense_kernel(a_dense, b, c, config.block_size, 0, m); },
+        [&]
+        {
+          if (config.kernel == KernelType::Strassen)
+          {
+            parallel_strassen_matrix_mul(
+                a_dense, b, c, config.block_size, threads, pool.get());
+          }
+          else
+          {
+            parallel_computing_partitioned(a_dense,
+                                           b,
+                                           c,
+                                           config.block_size,
+                                           threads,
+                                           tile_kernel,
+                                           pool.get());
+          }
+        },
+        c_ref,
+        c);
+  }
+
+  cout << endl
+       << "=== 稀疏矩阵结果 (" << unit << ", 有效带宽 GB/s) ===" << endl;
+  // 表头按显示宽度手工对齐(setw按字节计数, 不适用于中文)
+  cout << "路径           单线程(秒)     多线程(秒)        性能      带宽  "
+          "加速比  稠密时间比  验证"
+       << endl;
+  for (const KernelRun &run : report.runs)
+  {
+    const double single = compute_sample_stats(run.single_seconds).median;
+    const double multi = compute_sample_stats(run.multi_seconds).median;
+    const string op = run.kernel.substr(0, run.kernel.find('-'));
+    double dense_multi = 0.0;
+    for (const KernelRun &other : report.runs)
+    {
+      if (other.kernel == op + "-dense")
+      {
+        dense_multi = compute_sample_stats(other.multi_seconds).median;
+      }
+    }
+    cout << std::left << setw(12) << run.kernel << std::right << fixed
+         << setprecision(6);
+    if (config.skip_single)
+    {
+      cout << setw(12) << "-";
+    }
+    else
+    {
+      cout << setw(12) << single;
+    }
+    cout << setw(14) << multi
+         << setprecision(2) << setw(12) << run.operations / (multi * 1e9)
+         << setw(10) << run.bytes / (multi * 1e9);
+    if (config.skip_single)
+    {
+      cout << setw(8) << "-";
+    }
+    else
+    {
+      cout << setw(7) << single / multi << "x";
+    }
+    if (dense_multi > 0.0)
+    {
+      cout << setw(11) << setprecision(3) << multi / dense_multi << "x";
+    }
+    else
+    {
+      cout << setw(12) << "-";
+    }
+    cout << (run.verified ? "  通过" : "  失败") << endl;
+  }
+  cout << "==================" << endl;
+  cout << "稀疏路径的性能只计非零元的运算; 稠密时间比 = 多线程时间 / "
+          "同一操作稠密路径的多线程时间"
+       << endl;
+  return all_verified ? 0 : 1;
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_SPARSE(T)                                             \
+  template CsrMatrix<T> generate_sparse<T>(                                  \
+      size_t, size_t, double, SparseStructure);                              \
+  template BsrMatrix<T> csr_to_bsr<T>(const CsrMatrix<T> &, size_t);         \
+  template void csr_spmv<T>(                                                 \
+      const CsrMatrix<T> &, const T *, T *, size_t, size_t);                 \
+  template void csr_spmm<T>(const CsrMatrix<T> &,                            \
+                            MatrixView<const T>,                             \
+                            MatrixView<T>,                                   \
+                            size_t,                                          \
+                            size_t);                                         \
+  template void bsr_spmv<T>(                                                 \
+      const BsrMatrix<T> &, const T *, T *, size_t, size_t);                 \
+  template void bsr_spmm<T>(const BsrMatrix<T> &,                            \
+                            MatrixView<const T>,                             \
+                            MatrixView<T>,                                   \
+                            size_t,                                          \
+                            size_t);                                         \
+  template int run_sparse<T>(const BenchmarkConfig &, BenchmarkReport &);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_SPARSE)
+#undef MM_INSTANTIATE_SPARSE
@@ -0,0 +1,143 @@
+#include "MatrixMul.h"
+
+#include <random>
+
+/// bootstrap重采样次数
+static constexpr size_t BOOTSTRAP_RESAMPLES = 2000;
+
+/// 置信区间的置信水平
+static constexpr double CONFIDENCE_LEVEL = 0.95;
+
+/// 修正z分数超过该值的样本视为离群值(Iglewicz-Hoaglin推荐值)
+static constexpr double MAD_OUTLIER_THRESHOLD = 3.5;
+
+/// 判断置信区间是否收敛所需的最少样本数
+static constexpr size_t MIN_CI_SAMPLES = 5;
+
+/// 标记离群值所需的最少样本数, 更少时MAD本身不可靠
+static constexpr size_t MIN_OUTLIER_SAMPLES = 5;
+
+/**
+ * @brief 计算已排序样本的分位数
+ *
+ * 使用相邻两个次序统计量的线性插值(与numpy默认方法一致)
+ *
+ * @param sorted 升序排列的样本, 不能为空
+ * @param q 分位点(0~1)
+ * @return double 分位数
+ */
+static double sorted_quantile(const vector<double> &sorted, double q)
+{
+  const double position = q * static_cast<double>(sorted.size() - 1);
+  const size_t lower = static_cast<size_t>(position);
+  const size_t upper = std::min(lower + 1, sorted.size() - 1);
+  const double fraction = position - static_cast<double>(lower);
+  return sorted[lower] + (sorted[upper] - sorted[lower]) * fraction;
+}
+
+/**
+ * @brief 计算样本的中位数
+ *
+ * @param values 样本, 函数内部会重新排序
+ * @return double 中位数
+ */
+static double median_of(vector<double> values)
+{
+  std::sort(values.begin(), values.end());
+  return sorted_quantile(values, 0.5);
+}
+
+/**
+ * @brief 计算一组计时样本的统计量
+ *
+ * 处理流程：
+ * 1. 在全部样本上计算min/median/p90/max、均值和样本标准差
+ * 2. 对全部样本做BOOTSTRAP_RESAMPLES次有放回重采样,
+ *    取重采样中位数的2.5%和97.5%分位数作为中位数的95%置信区间
+ * 3. 以中位数绝对偏差(MAD)计算每个样本的修正z分数
+ *    0.6745 * (x - median) / MAD, 绝对值超过3.5的样本标记为离群值
+ *
+ * 离群值只标记、不剔除, 所有统计量与调用者用全部样本算出的均值、
+ * 加速比和性能一致。重采样使用固定种子, 相同的样本总是得到相同的区间。
+ * 样本少于MIN_OUTLIER_SAMPLES或MAD为0(例如大部分样本完全相同)时
+ * 不标记离群值。
+ *
+ * @param samples 每次迭代的时间(秒)
+ * @return SampleStats 统计结果, samples为空时所有字段为0
+ */
+SampleStats compute_sample_stats(const vector<double> &samples)
+{
+  SampleStats stats;
+  if (samples.empty()) return stats;
+
+  vector<double> sorted = samples;
+  std::sort(sorted.begin(), sorted.end());
+  stats.count = sorted.size();
+  stats.min = sorted.front();
+  stats.max = sorted.back();
+  stats.median = sorted_quantile(sorted, 0.5);
+  stats.p90 = sorted_quantile(sorted, 0.9);
+  for (double sample : samples)
+  {
+    stats.mean += sample;
+  }
+  stats.mean /= static_cast<double>(samples.size());
+  if (samples.size() > 1)
+  {
+    double squares = 0.0;
+    for (double sample : samples)
+    {
+      squares += (sample - stats.mean) * (sample - stats.mean);
+    }
+    stats.stddev = std::sqrt(squares / static_cast<double>(samples.size() - 1));
+  }
+
+  if (samples.size() >= MIN_OUTLIER_SAMPLES)
+  {
+    vector<double> deviations;
+    for (double sample : samples)
+    {
+      deviations.push_back(std::abs(sample - stats.median));
+    }
+    const double mad = median_of(deviations);
+    for (size_t i = 0; i < samples.size() && mad > 0.0; i++)
+    {
+      if (0.6745 * std::abs(samples[i] - stats.median) / mad
+          > MAD_OUTLIER_THRESHOLD)
+      {
+        stats.outliers.push_back(i);
+      }
+    }
+  }
+
+  std::mt19937_64 generator(0x5eed);
+  std::uniform_int_distribution<size_t> pick(0, samples.size() - 1);
+  vector<double> medians(BOOTSTRAP_RESAMPLES);
+  vector<double> resample(samples.size());
+  for (double &median : medians)
+  {
+    for (double &value : resample)
+    {
+      value = samples[pick(generator)];
+    }
+    median = median_of(resample);
+  }
+  std::sort(medians.begin(), medians.end());
+  const double alpha = 1.0 - CONFIDENCE_LEVEL;
+  stats.ci_low = sorted_quantile(medians, alpha / 2);
+  stats.ci_high = sorted_quantile(medians, 1.0 - alpha / 2);
+  return stats;
+}
+
+/**
+ * @brief 判断中位数的置信区间是否足够窄
+ *
+ * @param stats 统计结果
+ * @param target 区间宽度与中位数之比的上限, 例如0.02表示2%
+ * @return bool 样本数不少于MIN_CI_SAMPLES且区间相对宽度不超过target时返回true
+ */
+bool ci_converged(const SampleStats &stats, double target)
+{
+  if (stats.count < MIN_CI_SAMPLES || stats.median <= 0.0) return false;
+  return (stats.ci_high - stats.ci_low) / stats.median <= target;
+}
@@ -0,0 +1,672 @@
+#include "MatrixMul.h"
+
+/// 子问题任一维度不大于该值时回退到分块内核
+static std::atomic<size_t> cutoff_size{512};
+
+/**
+ * @brief Winograd变体中7个子乘积对C四个象限的系数
+ *
+ * WINOGRAD_COEF[p][q]为第p+1个子乘积累加到象限q(C11、C12、C21、C22)时的符号:
+ * - C11 = P1 + P2
+ * - C12 = P1 + P6 + P5 + P3
+ * - C21 = P1 + P6 + P7 - P4
+ * - C22 = P1 + P6 + P7 + P5
+ */
+static constexpr int WINOGRAD_COEF[7][4] = {
+    {1, 1, 1, 1},
+    {1, 0, 0, 0},
+    {0, 1, 0, 0},
+    {0, 0, -1, 0},
+    {0, 1, 0, 1},
+    {0, 1, 1, 1},
+    {0, 0, 1, 1},
+};
+
+/**
+ * @brief 连续分配的Strassen工作区
+ *
+ * 递归开始前按strassen_workspace_size()一次性用page_alloc()分配,
+ * 递归中按栈的方式分配和释放临时矩阵(mark/release), 不再调用malloc。
+ * 也可以作为不拥有内存的视图, 管理大工作区中的一段。
+ *
+ * @tparam T 元素类型
+ */
+template <typename T> class StrassenArena
+{
+private:
+  T *base = nullptr; ///< 工作区起始地址, 按缓存行对齐
+  size_t capacity = 0; ///< 容量(元素个数)
+  size_t used = 0; ///< 已分配的元素个数
+  bool owner = false; ///< 是否由本对象释放内存
+
+public:
+  StrassenArena() = default;
+
+  /**
+   * @brief 在已有内存上构造不拥有内存的工作区
+   *
+   * @param memory 起始地址, 需按缓存行对齐
+   * @param elements 容量(元素个数)
+   */
+  StrassenArena(T *memory, size_t elements) : base(memory), capacity(elements)
+  {
+  }
+
+  ~StrassenArena()
+  {
+    if (owner) page_free(base, capacity * sizeof(T));
+  }
+
+  StrassenArena(const StrassenArena &) = delete;
+  StrassenArena &operator=(const StrassenArena &) = delete;
+
+  /**
+   * @brief 确保容量至少为elements并清空已分配部分
+   *
+   * @param elements 需要的元素个数
+   */
+  void reserve(size_t elements)
+  {
+    if (elements > capacity)
+    {
+      if (owner) page_free(base, capacity * sizeof(T));
+      base = nullptr;
+      capacity = 0;
+      base = static_cast<T *>(page_alloc(elements * sizeof(T)));
+      capacity = elements;
+      owner = true;
+    }
+    used = 0;
+  }
+
+  /**
+   * @brief 获取起始地址
+   */
+  T *data() const { return base; }
+
+  /**
+   * @brief 分配一个rows x cols的临时矩阵
+   *
+   * @param rows 行数
+   * @param cols 列数
+   * @return MatrixView<T> 行跨度对齐到缓存行的矩阵视图
+   * @throws std::bad_alloc 超出容量时抛出
+   */
+  MatrixView<T> take(size_t rows, size_t cols)
+  {
+    const size_t line = MATRIX_ALIGNMENT / sizeof(T);
+    const size_t ld = (cols + line - 1) / line * line;
+    if (used + rows * ld > capacity) throw std::bad_alloc();
+    MatrixView<T> view{base + used, rows, cols, ld};
+    used += rows * ld;
+    return view;
+  }
+
+  /// 记录当前分配位置
+  size_t mark() const { return used; }
+
+  /// 释放mark()之后分配的所有临时矩阵
+  void release(size_t position) { used = position; }
+};
+
+/**
+ * @brief 计算工作区中一个临时矩阵占用的元素个数
+ *
+ * 与StrassenArena::take()使用相同的行跨度对齐规则
+ */
+static size_t arena_elements(size_t rows, size_t cols, size_t element_size)
+{
+  const size_t line = MATRIX_ALIGNMENT / element_size;
+  return rows * ((cols + line - 1) / line * line);
+}
+
+/**
+ * @brief 判断子问题是否回退到分块内核
+ */
+static bool strassen_leaf(size_t rows, size_t inner, size_t cols)
+{
+  const size_t cutoff = cutoff_size.load(std::memory_order_relaxed);
+  return rows <= cutoff || inner <= cutoff || cols <= cutoff;
+}
+
+/**
+ * @brief 设置Strassen递归的截止规模
+ *
+ * @param cutoff 截止规模, 小于2时按2处理, 保证每次递归的子问题非空
+ */
+void set_strassen_cutoff(size_t cutoff)
+{
+  cutoff_size.store(std::max(cutoff, size_t(2)));
+}
+
+/**
+ * @brief 获取当前的Strassen截止规模
+ *
+ * @return size_t 截止规模
+ */
+size_t strassen_cutoff()
+{
+  return cutoff_size.load();
+}
+
+/**
+ * @brief 计算Strassen递归所需的工作区大小
+ *
+ * 每层递归需要一个A象限大小的S、一个B象限大小的T和一个C象限大小的M,
+ * 再加上下一层递归的工作区, 总量约为(mk + kn + mn) / 3
+ *
+ * @param rows 结果行数(m)
+ * @param inner 公共维度(k)
+ * @param cols 结果列数(n)
+ * @param element_size 元素字节数
+ * @return size_t 工作区元素个数
+ */
+size_t strassen_workspace_size(size_t rows,
+                               size_t inner,
+                               size_t cols,
+                               size_t element_size)
+{
+  size_t total = 0;
+  while (!strassen_leaf(rows, inner, cols))
+  {
+    rows /= 2;
+    inner /= 2;
+    cols /= 2;
+    total += arena_elements(rows, inner, element_size)
+             + arena_elements(inner, cols, element_size)
+             + arena_elements(rows, cols, element_size);
+  }
+  return total;
+}
+
+/**
+ * @brief 把可写视图转换为只读视图
+ */
+template <typename T> static MatrixView<const T> read_only(MatrixView<T> view)
+{
+  return {view.data, view.rows, view.cols, view.ld};
+}
+
+/**
+ * @brief 逐元素计算out = x + sign * y
+ *
+ * out可以与x或y是同一块内存(原地更新), 因此不使用__restrict
+ */
+template <typename T>
+static void view_combine(MatrixView<const T> x,
+                         MatrixView<const T> y,
+                         int sign,
+                         MatrixView<T> out)
+{
+  for (size_t i = 0; i < out.rows; i++)
+  {
+    const T *x_row = x.row(i);
+    const T *y_row = y.row(i);
+    T *out_row = out.row(i);
+    if (sign > 0)
+    {
+      for (size_t j = 0; j < out.cols; j++) out_row[j] = x_row[j] + y_row[j];
+    }
+    else
+    {
+      for (size_t j = 0; j < out.cols; j++) out_row[j] = x_row[j] - y_row[j];
+    }
+  }
+}
+
+/**
+ * @brief 逐元素计算c += sign * m
+ */
+template <typename T>
+static void view_accumulate(MatrixView<T> c, MatrixView<const T> m, int sign)
+{
+  for (size_t i = 0; i < c.rows; i++)
+  {
+    T *__restrict c_row = c.row(i);
+    const T *__restrict m_row = m.row(i);
+    if (sign > 0)
+    {
+      for (size_t j = 0; j < c.cols; j++) c_row[j] += m_row[j];
+    }
+    else
+    {
+      for (size_t j = 0; j < c.cols; j++) c_row[j] -= m_row[j];
+    }
+  }
+}
+
+/**
+ * @brief 将视图清零
+ */
+template <typename T> static void view_zero(MatrixView<T> m)
+{
+  for (size_t i = 0; i < m.rows; i++)
+  {
+    std::fill(m.row(i), m.row(i) + m.cols, T{});
+  }
+}
+
+/**
+ * @brief 矩阵的四个象限视图
+ */
+template <typename T> struct Quadrants
+{
+  MatrixView<T> q11, q12, q21, q22;
+
+  /**
+   * @brief 把rows x cols的左上角区域切分为四个象限
+   *
+   * @param view 源视图
+   * @param half_rows 象限行数
+   * @param half_cols 象限列数
+   */
+  Quadrants(MatrixView<T> view, size_t half_rows, size_t half_cols)
+      : q11(view.tile(0, 0, half_rows, half_cols)),
+        q12(view.tile(0, half_cols, half_rows, half_cols)),
+        q21(view.tile(half_rows, 0, half_rows, half_cols)),
+        q22(view.tile(half_rows, half_cols, half_rows, half_cols))
+  {
+  }
+
+  /// 按编号(0: 11, 1: 12, 2: 21, 3: 22)获取象限
+  MatrixView<T> operator[](size_t q) const
+  {
+    const MatrixView<T> all[4] = {q11, q12, q21, q22};
+    return all[q];
+  }
+};
+
+/**
+ * @brief 构造第p+1个子乘积的两个操作数
+ *
+ * Winograd变体的操作数：
+ * - S1 = A21 + A22, S2 = S1 - A11, S3 = A11 - A21, S4 = A12 - S2
+ * - T1 = B12 - B11, T2 = B22 - T1, T3 = B22 - B12, T4 = T2 - B21
+ * - P1 = A11 B11, P2 = A12 B21, P3 = S4 B22, P4 = A22 T4,
+ *   P5 = S1 T1, P6 = S2 T2, P7 = S3 T3
+ *
+ * 需要组合的操作数写入s、t, 直接使用象限的操作数不占用缓冲区
+ *
+ * @tparam T 元素类型
+ * @param p 子乘积编号(0~6)
+ * @param a A的四个象限
+ * @param b B的四个象限
+ * @param s A侧临时矩阵
+ * @param t B侧临时矩阵
+ * @param x 输出: 左操作数
+ * @param y 输出: 右操作数
+ */
+template <typename T>
+static void winograd_operands(size_t p,
+                              const Quadrants<const T> &a,
+                              const Quadrants<const T> &b,
+                              MatrixView<T> s,
+                              MatrixView<T> t,
+                              MatrixView<const T> &x,
+                              MatrixView<const T> &y)
+{
+  const MatrixView<const T> sr = read_only(s);
+  const MatrixView<const T> tr = read_only(t);
+  switch (p)
+  {
+    case 0:
+      x = a.q11;
+      y = b.q11;
+      break;
+    case 1:
+      x = a.q12;
+      y = b.q21;
+      break;
+    case 2:
+      view_combine(a.q21, a.q22, 1, s); // S1
+      view_combine(sr, a.q11, -1, s); // S2
+      view_combine(a.q12, sr, -1, s); // S4
+      x = sr;
+      y = b.q22;
+      break;
+    case 3:
+      view_combine(b.q12, b.q11, -1, t); // T1
+      view_combine(b.q22, tr, -1, t); // T2
+      view_combine(tr, b.q21, -1, t); // T4
+      x = a.q22;
+      y = tr;
+      break;
+    case 4:
+      view_combine(a.q21, a.q22, 1, s); // S1
+      view_combine(b.q12, b.q11, -1, t); // T1
+      x = sr;
+      y = tr;
+      break;
+    case 5:
+      view_combine(a.q21, a.q22, 1, s); // S1
+      view_combine(sr, a.q11, -1, s); // S2
+      view_combine(b.q12, b.q11, -1, t); // T1
+      view_combine(b.q22, tr, -1, t); // T2
+      x = sr;
+      y = tr;
+      break;
+    default:
+      view_combine(a.q11, a.q21, -1, s); // S3
+      view_combine(b.q22, b.q12, -1, t); // T3
+      x = sr;
+      y = tr;
+      break;
+  }
+}
+
+/**
+ * @brief 处理奇数维度剥离出的边缘部分
+ *
+ * 递归只计算偶数部分(me x ke) * (ke x ne), 剩余部分用分块内核补齐：
+ * 1. k为奇数: 偶数区域加上最后一列A与最后一行B的外积
+ * 2. n为奇数: 最后一列C使用完整的A计算
+ * 3. m为奇数: 最后一行C(偶数列部分)使用完整的B计算
+ */
+template <typename T>
+static void strassen_peel(MatrixView<const T> a,
+                          MatrixView<const T> b,
+                          MatrixView<T> c,
+                          size_t me,
+                          size_t ke,
+                          size_t ne,
+                          size_t blockSize)
+{
+  const size_t m = c.rows;
+  const size_t k = a.cols;
+  const size_t n = c.cols;
+  if (ke < k)
+  {
+    matrix_mul_tile(a.tile(0, ke, me, k - ke),
+                    b.tile(ke, 0, k - ke, ne),
+                    c.tile(0, 0, me, ne),
+                    blockSize);
+  }
+  if (ne < n)
+  {
+    matrix_mul_tile(a, b.tile(0, ne, k, n - ne), c.tile(0, ne, m, n - ne),
+                    blockSize);
+  }
+  if (me < m)
+  {
+    matrix_mul_tile(a.tile(me, 0, m - me, k),
+                    b.tile(0, 0, k, ne),
+                    c.tile(me, 0, m - me, ne),
+                    blockSize);
+  }
+}
+
+/**
+ * @brief 串行的Strassen-Winograd递归
+ *
+ * 每层只使用一组S、T、M临时矩阵: 依次构造每个子乘积的操作数,
+ * 递归计算到M后立即按WINOGRAD_COEF累加到C的各个象限
+ *
+ * @tparam T 元素类型
+ * @param a 左操作数视图
+ * @param b 右操作数视图
+ * @param c 结果视图, 计算c += a * b
+ * @param blockSize 回退内核的分块大小
+ * @param arena 工作区
+ */
+template <typename T>
+static void strassen_recursive(MatrixView<const T> a,
+                               MatrixView<const T> b,
+                               MatrixView<T> c,
+                               size_t blockSize,
+                               StrassenArena<T> &arena)
+{
+  const size_t m = c.rows;
+  const size_t k = a.cols;
+  const size_t n = c.cols;
+  if (strassen_leaf(m, k, n))
+  {
+    matrix_mul_tile(a, b, c, blockSize);
+    return;
+  }
+
+  const size_t m2 = m / 2;
+  const size_t k2 = k / 2;
+  const size_t n2 = n / 2;
+  const Quadrants<const T> qa(a, m2, k2);
+  const Quadrants<const T> qb(b, k2, n2);
+  const Quadrants<T> qc(c, m2, n2);
+
+  const size_t position = arena.mark();
+  MatrixView<T> s = arena.take(m2, k2);
+  MatrixView<T> t = arena.take(k2, n2);
+  MatrixView<T> product = arena.take(m2, n2);
+
+  for (size_t p = 0; p < 7; p++)
+  {
+    MatrixView<const T> x;
+    MatrixView<const T> y;
+    winograd_operands(p, qa, qb, s, t, x, y);
+    view_zero(product);
+    strassen_recursive(x, y, product, blockSize, arena);
+    for (size_t q = 0; q < 4; q++)
+    {
+      if (WINOGRAD_COEF[p][q] != 0)
+      {
+        view_accumulate(qc[q], read_only(product), WINOGRAD_COEF[p][q]);
+      }
+    }
+  }
+  arena.release(position);
+
+  strassen_peel(a, b, c, 2 * m2, 2 * k2, 2 * n2, blockSize);
+}
+
+/**
+ * @brief Strassen-Winograd矩阵乘法子块内核
+ *
+ * 使用worker_buffer()按参与者编号复用的工作区, 只在容量不足时于递归
+ * 开始前重新分配;
+ * 奇数维度通过剥离(peeling)处理, 不需要填充到2的幂
+ *
+ * @tparam T 元素类型
+ * @param a 左操作数视图
+ * @param b 右操作数视图
+ * @param c 结果子块视图
+ * @param blockSize 回退内核的分块大小
+ *
+ * @note 使用累加操作(+=), 调用前需要确保c已正确初始化
+ * @see set_strassen_cutoff()
+ */
+template <typename T>
+void strassen_matrix_mul_tile(MatrixView<const T> a,
+                              MatrixView<const T> b,
+                              MatrixView<T> c,
+                              size_t blockSize)
+{
+  StrassenArena<T> &arena = worker_buffer<StrassenArena<T>>();
+  arena.reserve(strassen_workspace_size(c.rows, a.cols, c.cols, sizeof(T)));
+  strassen_recursive(a, b, c, blockSize, arena);
+}
+
+/**
+ * @brief Strassen-Winograd矩阵乘法(行范围)
+ *
+ * @tparam T 元素类型
+ * @param src1 源矩阵1, 左操作数
+ * @param src2 源矩阵2, 右操作数
+ * @param dst 目标结果矩阵
+ * @param blockSize 回退内核的分块大小
+ * @param start 起始行索引(包含)
+ * @param end 结束行索引(不包含)
+ */
+template <typename T>
+void strassen_matrix_mul(const Matrix<T> &src1,
+                         const Matrix<T> &src2,
+                         Matrix<T> &dst,
+                         size_t blockSize,
+                         size_t start,
+                         size_t end)
+{
+  strassen_matrix_mul_tile(src1.tile(start, 0, end - start, src1.cols()),
+                           src2.view(),
+                           dst.tile(start, 0, end - start, dst.cols()),
+                           blockSize);
+}
+
+/**
+ * @brief 并行的Strassen-Winograd矩阵乘法
+ *
+ * 顶层的7个子乘积相互独立, 分别写入各自的M缓冲区:
+ * 1. 工作区按子乘积均分为7段, 每段包含该子乘积的S、T、M和下层递归所需空间
+ * 2. 线程通过原子计数器领取子乘积, 构造操作数并串行递归
+ * 3. 全部完成后按行划分并行地把7个M累加到C的四个象限
+ * 4. 最后处理奇数维度的剥离部分
+ *
+ * 并行度最多为7, 多余的线程在第1阶段空闲。
+ *
+ * @tparam T 元素类型
+ * @param matrix1 输入矩阵1
+ * @param matrix2 输入矩阵2
+ * @param result 结果矩阵
+ * @param block_size 回退内核的分块大小
+ * @param num_threads 线程数量
+ * @param pool 线程池, nullptr表示创建线程
+ * @param telemetry 线程级遥测输出, 工作量按子乘积计, 两个阶段合并为
+ *        一次调用, 可以为nullptr
+ *
+ * @pre result已正确初始化为0
+ */
+template <typename T>
+void parallel_strassen_matrix_mul(const Matrix<T> &matrix1,
+                                  const Matrix<T> &matrix2,
+                                  Matrix<T> &result,
+                                  size_t block_size,
+                                  size_t num_threads,
+                                  ThreadPool *pool,
+                                  ThreadTelemetry *telemetry)
+{
+  const MatrixView<const T> a = matrix1.view();
+  const MatrixView<const T> b = matrix2.view();
+  const MatrixView<T> c = result.view();
+  const size_t m = c.rows;
+  const size_t k = a.cols;
+  const size_t n = c.cols;
+  if (pool != nullptr) num_threads = std::min(num_threads, pool->size());
+  num_threads = std::max(num_threads, size_t(1));
+  if (num_threads == 1 || strassen_leaf(m, k, n))
+  {
+    strassen_matrix_mul_tile(a, b, c, block_size);
+    return;
+  }
+
+  const size_t m2 = m / 2;
+  const size_t k2 = k / 2;
+  const size_t n2 = n / 2;
+  const Quadrants<const T> qa(a, m2, k2);
+  const Quadrants<const T> qb(b, k2, n2);
+  const Quadrants<T> qc(c, m2, n2);
+
+  // 每段按缓存行对齐, 各子乘积的工作区互不重叠
+  const size_t line = MATRIX_ALIGNMENT / sizeof(T);
+  size_t per_product = arena_elements(m2, k2, sizeof(T))
+                       + arena_elements(k2, n2, sizeof(T))
+                       + arena_elements(m2, n2, sizeof(T))
+                       + strassen_workspace_size(m2, k2, n2, sizeof(T));
+  per_product = (per_product + line - 1) / line * line;
+  thread_local StrassenArena<T> workspace;
+  workspace.reserve(7 * per_product);
+  // thread_local变量在工作线程中指向各自的实例, 因此先取出调用线程的地址
+  T *const memory = workspace.data();
+
+  MatrixView<T> products[7];
+  std::atomic<size_t> next_product{0};
+  TelemetryRecorder recorder(telemetry, num_threads);
+  auto compute = [&](size_t tid)
+  {
+    apply_thread_affinity(tid);
+    recorder.begin(tid);
+    size_t p;
+    while ((p = next_product.fetch_add(1)) < 7)
+    {
+      double since = recorder.now();
+      StrassenArena<T> arena(memory + p * per_product, per_product);
+      MatrixView<T> s = arena.take(m2, k2);
+      MatrixView<T> t = arena.take(k2, n2);
+      products[p] = arena.take(m2, n2);
+      MatrixView<const T> x;
+      MatrixView<const T> y;
+      winograd_operands(p, qa, qb, s, t, x, y);
+      view_zero(products[p]);
+      strassen_recursive(x, y, products[p], block_size, arena);
+      recorder.work(tid, since, 1);
+    }
+  };
+
+  const size_t rows_per_thread = (m2 + num_threads - 1) / num_threads;
+  auto combine = [&](size_t tid)
+  {
+    size_t r0 = std::min(tid * rows_per_thread, m2);
+    size_t r1 = std::min(r0 + rows_per_thread, m2);
+    if (r0 >= r1)
+    {
+      recorder.finish(tid);
+      return;
+    }
+    double since = recorder.now();
+    for (size_t q = 0; q < 4; q++)
+    {
+      MatrixView<T> target = qc[q].tile(r0, 0, r1 - r0, n2);
+      for (size_t p = 0; p < 7; p++)
+      {
+        if (WINOGRAD_COEF[p][q] == 0) continue;
+        view_accumulate(target,
+                        read_only(products[p].tile(r0, 0, r1 - r0, n2)),
+                        WINOGRAD_COEF[p][q]);
+      }
+    }
+    recorder.work(tid, since, 0);
+    recorder.finish(tid);
+  };
+
+  auto run_all = [&](const std::function<void(size_t)> &task)
+  {
+    if (pool != nullptr)
+    {
+      pool->run(
+          [&](size_t tid)
+          {
+            if (tid < num_threads) task(tid);
+          });
+      return;
+    }
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++)
+    {
+      threads.push_back(std::thread(task, t));
+    }
+    for (auto &t : threads)
+    {
+      t.join();
+    }
+  };
+
+  run_all(compute);
+  run_all(combine);
+  recorder.commit();
+  strassen_peel(a, b, c, 2 * m2, 2 * k2, 2 * n2, block_size);
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_STRASSEN(T)                                           \
+  template void strassen_matrix_mul<T>(const Matrix<T> &,                    \
+                                       const Matrix<T> &,                    \
+                                       Matrix<T> &,                          \
+                                       size_t,                               \
+                                       size_t,                               \
+                                       size_t);                              \
+  template void strassen_matrix_mul_tile<T>(                                 \
+      MatrixView<const T>, MatrixView<const T>, MatrixView<T>, size_t);      \
+  template void parallel_strassen_matrix_mul<T>(const Matrix<T> &,          \
+                                                const Matrix<T> &,           \
+                                                Matrix<T> &,                 \
+                                                size_t,                      \
+                                                size_t,                      \
+                                                ThreadPool *,                \
+                                                ThreadTelemetry *);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_STRASSEN)
+#undef MM_INSTANTIATE_STRASSEN
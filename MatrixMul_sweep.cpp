@@ -0,0 +1,272 @@
+#include "MatrixMul.h"
+
+/// 弱扩展规模的取整粒度, 保证各元素类型的行都是整缓存行
+static constexpr size_t WEAK_SIZE_ALIGNMENT = 16;
+
+/**
+ * @brief 计算弱扩展的矩阵规模
+ *
+ * 运算量与n³成正比, 线程数变为t/t0倍时规模变为cbrt(t/t0)倍,
+ * 每个线程的运算量保持不变; 结果向最近的WEAK_SIZE_ALIGNMENT倍数取整,
+ * 基准线程数下直接返回base_size
+ *
+ * @param base_size 最少线程数下的规模
+ * @param base_threads 最少线程数
+ * @param threads 线程数
+ * @return size_t 弱扩展规模
+ */
+static size_t weak_scaling_size(size_t base_size,
+                                size_t base_threads,
+                                size_t threads)
+{
+  if (threads == base_threads) return base_size;
+  const double scale = std::cbrt(static_cast<double>(threads)
+                                 / static_cast<double>(base_threads));
+  const double size = static_cast<double>(base_size) * scale
+                      / static_cast<double>(WEAK_SIZE_ALIGNMENT);
+  return std::max(static_cast<size_t>(std::llround(size)), size_t(1))
+         * WEAK_SIZE_ALIGNMENT;
+}
+
+/**
+ * @brief 在同一进程内扫描规模、线程数和块大小
+ *
+ * 执行流程：
+ * 1. 按最大规模(包括弱扩展的最大规模)分配三个矩阵并用最多线程数首次写入,
+ *    之后只通过Matrix::reshape()改变尺寸, 不再分配内存
+ * 2. 强扩展: 对每个规模和块大小, 依次测量线程数列表中的每个线程数
+ * 3. 弱扩展: 以最小规模和第一个块大小为基准, 按weak_scaling_size()
+ *    随线程数增大规模
+ *
+ * 规模变化时按新的行跨度重新写入A和B; 每个组合先做config.warmup次预热,
+ * 再计时config.iterations次并取中位数。多线程与--parallel optimized相同,
+ * 使用parallel_computing_partitioned()的形状网格(Strassen内核使用
+ * parallel_strassen_matrix_mul()), 其他--parallel设置不影响扫描。
+ * 除--verify none外, 每个组合的结果都用Freivalds验证;
+ * --verify none时所有组合标记为未验证。
+ *
+ * @tparam T 元素类型
+ * @param config 基准测试配置
+ * @param report 运行结果, 写入配置和每个组合的测量
+ * @return int 程序退出状态码, 0表示成功, 1表示有结果验证失败
+ */
+template <typename T>
+int run_sweep(const BenchmarkConfig &config, BenchmarkReport &report)
+{
+  const vector<size_t> &sizes = config.sweep_sizes;
+  const vector<size_t> &thread_counts = config.sweep_threads;
+  const vector<size_t> &blocks = config.sweep_blocks;
+  const size_t base_threads = thread_counts.front();
+  const size_t max_threads = thread_counts.back();
+
+  vector<size_t> weak_sizes;
+  for (size_t threads : thread_counts)
+  {
+    weak_sizes.push_back(
+        weak_scaling_size(sizes.front(), base_threads, threads));
+  }
+  const size_t max_size = std::max(sizes.back(), weak_sizes.back());
+  const char *unit = throughput_unit(config.dtype);
+
+  cout << "=== 参数扫描 ===" << endl;
+  cout << "元素类型: " << dtype_name(config.dtype) << endl;
+  cout << "内核: " << kernel_name(config.kernel) << endl;
+  cout << "规模:";
+  for (size_t size : sizes)
+  {
+    cout << " " << size;
+  }
+  cout << endl << "线程数:";
+  for (size_t threads : thread_counts)
+  {
+    cout << " " << threads;
+  }
+  cout << endl << "块大小:";
+  for (size_t block : blocks)
+  {
+    cout << " " << block;
+  }
+  cout << endl << "弱扩展规模:";
+  for (size_t size : weak_sizes)
+  {
+    cout << " " << size;
+  }
+  cout << endl;
+  cout << "迭代次数: " << config.iterations << " (预热 " << config.warmup
+       << " 次)" << endl;
+
+  std::unique_ptr<ThreadPool> pool;
+  if (config.use_pool)
+  {
+    pool = std::make_unique<ThreadPool>(max_threads);
+  }
+
+  // 按最大规模分配一次, 之后各组合复用同一块内存
+  const size_t max_ld = configured_leading_dimension(config, max_size);
+  Matrix<T> a(max_size, max_size, max_ld, matrix_no_init);
+  Matrix<T> b(max_size, max_size, max_ld, matrix_no_init);
+  Matrix<T> c(max_size, max_size, max_ld, matrix_no_init);
+  parallel_first_touch(a, max_threads, pool.get());
+  parallel_first_touch(b, max_threads, pool.get());
+  parallel_first_touch(c, max_threads, pool.get());
+  cout << "内存使用量约: " << fixed << setprecision(2)
+       << 3.0 * static_cast<double>(a.size_bytes()) / (1024.0 * 1024.0)
+       << " MB (按最大规模 " << max_size << " 分配一次)" << endl;
+  cout << "==================" << endl << endl;
+
+  report.config = config;
+  report.leading_dimension = a.ld();
+  report.memory_mb =
+      3.0 * static_cast<double>(a.size_bytes()) / (1024.0 * 1024.0);
+
+  GemmTileKernel<T> kernel = select_tile_kernel<T>(config.kernel);
+  size_t current_size = 0;
+  auto prepare = [&](size_t n)
+  {
+    if (n == current_size) return;
+    const size_t ld = configured_leading_dimension(config, n);
+    a.reshape(n, n, ld);
+    b.reshape(n, n, ld);
+    c.reshape(n, n, ld);
+    parallel_first_touch<T>(a,
+                            max_threads,
+                            pool.get(),
+                            [n](size_t row, T *a_row)
+                            {
+                              for (size_t col = 0; col < n; col++)
+                              {
+                                a_row[col] =
+                                    static_cast<T>((row * 31 + col * 17) % 100);
+                              }
+                            });
+    parallel_first_touch<T>(b,
+                            max_threads,
+                            pool.get(),
+                            [n](size_t row, T *b_row)
+                            {
+                              for (size_t col = 0; col < n; col++)
+                              {
+                                b_row[col] =
+                                    static_cast<T>((row * 17 + col * 31) % 100);
+                              }
+                            });
+    current_size = n;
+  };
+
+  // --verify none时不验证, verified保持false, 结果表显示"未验证"
+  const bool checked = config.verify != VerifyMode::None;
+  Timer timer;
+  auto measure = [&](bool weak, size_t n, size_t block, size_t threads)
+  {
+    prepare(n);
+    set_blocking_threads(threads);
+    SweepPoint point;
+    point.weak = weak;
+    point.matrix_size = n;
+    point.block_size = block;
+    point.num_threads = threads;
+    for (size_t iter = 0; iter < config.warmup + config.iterations; iter++)
+    {
+      parallel_first_touch(c, max_threads, pool.get());
+      timer.start();
+      if (config.kernel == KernelType::Strassen)
+      {
+        parallel_strassen_matrix_mul(a, b, c, block, threads, pool.get());
+      }
+      else
+      {
+        parallel_computing_partitioned(
+            a, b, c, block, threads, kernel, pool.get());
+      }
+      timer.stop();
+      if (iter >= config.warmup) point.seconds.push_back(timer.get_seconds());
+    }
+
+    const double operations = 2.0 * static_cast<double>(n)
+                              * static_cast<double>(n)
+                              * static_cast<double>(n);
+    point.median = compute_sample_stats(point.seconds).median;
+    point.throughput = operations / (point.median * 1e9);
+    if (checked)
+    {
+      const double tolerance = config.tolerance > 0.0
+                                   ? config.tolerance
+                                   : default_tolerance<T>(n);
+      point.verified = freivalds_verify(a,
+                                        b,
+                                        c,
+                                        config.verify_rounds,
+                                        tolerance,
+                                        max_threads,
+                                        pool.get())
+                           .passed;
+    }
+    if (config.verbose)
+    {
+      cout << "  " << (weak ? "弱" : "强") << " n=" << n << " 块=" << block
+           << " 线程=" << threads << ": " << fixed << setprecision(4)
+           << point.median << " 秒" << endl;
+    }
+    return point;
+  };
+
+  cout << "开始参数扫描..." << endl;
+  vector<SweepPoint> &points = report.sweep;
+  for (size_t n : sizes)
+  {
+    for (size_t block : blocks)
+    {
+      const size_t first = points.size();
+      for (size_t threads : thread_counts)
+      {
+        points.push_back(measure(false, n, block, threads));
+        SweepPoint &point = points.back();
+        point.speedup = point.throughput / points[first].throughput;
+        point.efficiency = point.speedup
+                           * static_cast<double>(base_threads)
+                           / static_cast<double>(threads);
+      }
+    }
+  }
+  const size_t weak_first = points.size();
+  for (size_t t = 0; t < thread_counts.size(); t++)
+  {
+    points.push_back(
+        measure(true, weak_sizes[t], blocks.front(), thread_counts[t]));
+    SweepPoint &point = points.back();
+    point.speedup = point.throughput / points[weak_first].throughput;
+    point.efficiency = point.speedup * static_cast<double>(base_threads)
+                       / static_cast<double>(thread_counts[t]);
+  }
+  set_blocking_threads(config.num_threads);
+
+  bool all_verified = true;
+  cout << endl << "=== 参数扫描结果 (" << unit << ") ===" << endl;
+  // 表头按显示宽度手工对齐(setw按字节计数, 不适用于中文)
+  cout << "扩展  规模    块  线程    中位数(秒)        性能    加速比    效率"
+          "  验证"
+       << endl;
+  for (const SweepPoint &point : points)
+  {
+    all_verified = all_verified && (!checked || point.verified);
+    cout << (point.weak ? "弱  " : "强  ") << setw(6) << point.matrix_size
+         << setw(6) << point.block_size << setw(6) << point.num_threads
+         << fixed << setprecision(6) << setw(14) << point.median
+         << setprecision(2) << setw(12) << point.throughput << setw(9)
+         << point.speedup << "x" << setw(7) << point.efficiency * 100.0
+         << "%"
+         << (!checked ? "  未验证" : point.verified ? "  通过" : "  失败")
+         << endl;
+  }
+  cout << "==================" << endl;
+  cout << "强扩展效率 = 加速比 × " << base_threads
+       << " / 线程数; 弱扩展效率 = 每线程性能 / " << base_threads
+       << " 线程时的每线程性能" << endl;
+  return all_verified ? 0 : 1;
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_SWEEP(T)                                              \
+  template int run_sweep<T>(const BenchmarkConfig &, BenchmarkReport &);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_SWEEP)
+#undef MM_INSTANTIATE_SWEEP
@@ -0,0 +1,322 @@
+#include "MatrixMul.h"
+
+#include <filesystem>
+
+/// 单个候选的最多计时次数, 取最短时间
+static constexpr size_t TUNE_TRIALS = 3;
+
+/// 首次计时超过当前最优的该倍数时提前淘汰候选
+static constexpr double TUNE_PRUNE_RATIO = 1.5;
+
+/**
+ * @brief 计算矩阵规模档位
+ *
+ * @param matrix_size 矩阵大小
+ * @return size_t 不小于matrix_size的2的幂, 至少为64
+ */
+size_t size_class(size_t matrix_size)
+{
+  size_t size = 64;
+  while (size < matrix_size)
+  {
+    size *= 2;
+  }
+  return size;
+}
+
+/**
+ * @brief 获取默认的调优缓存文件路径
+ *
+ * - Windows: %LOCALAPPDATA%\matrixmul_tuning.tsv
+ * - 其他系统: $XDG_CACHE_HOME/matrixmul_tuning.tsv,
+ *   未设置时为$HOME/.cache/matrixmul_tuning.tsv
+ *
+ * 以上环境变量都不存在时使用当前目录。
+ *
+ * @return string 调优缓存文件路径
+ */
+string default_tuning_cache_path()
+{
+  const char *file_name = "matrixmul_tuning.tsv";
+#ifdef _WIN32
+  const char *local = getenv("LOCALAPPDATA");
+  if (local != nullptr) return string(local) + "\\" + file_name;
+#else
+  const char *xdg = getenv("XDG_CACHE_HOME");
+  if (xdg != nullptr && xdg[0] != '\0') return string(xdg) + "/" + file_name;
+  const char *home = getenv("HOME");
+  if (home != nullptr) return string(home) + "/.cache/" + file_name;
+#endif
+  return file_name;
+}
+
+/**
+ * @brief 把一行缓存记录按制表符拆分并解析
+ *
+ * 每行依次为: CPU型号、指令集、元素类型、规模档位、内核、块大小、线程数、性能。
+ * CPU型号可能包含空格, 因此字段以制表符分隔。
+ *
+ * @param line 缓存文件中的一行
+ * @param entry 解析结果
+ * @return bool 格式正确时返回true
+ */
+static bool parse_tuning_line(const string &line, TuningEntry &entry)
+{
+  if (line.empty() || line[0] == '#') return false;
+  vector<string> fields;
+  std::stringstream stream(line);
+  string field;
+  while (std::getline(stream, field, '\t'))
+  {
+    fields.push_back(field);
+  }
+  if (fields.size() != 8) return false;
+
+  entry.cpu_model = fields[0];
+  entry.isa = fields[1];
+  entry.dtype = fields[2];
+  entry.size_class = strtoull(fields[3].c_str(), nullptr, 10);
+  const KernelType kernels[] = {
+      KernelType::Blocked, KernelType::Packed, KernelType::Strassen};
+  bool found = false;
+  for (KernelType kernel : kernels)
+  {
+    if (fields[4] == kernel_name(kernel))
+    {
+      entry.kernel = kernel;
+      found = true;
+    }
+  }
+  entry.block_size = strtoull(fields[5].c_str(), nullptr, 10);
+  entry.num_threads = strtoull(fields[6].c_str(), nullptr, 10);
+  entry.throughput = strtod(fields[7].c_str(), nullptr);
+  return found && entry.block_size > 0 && entry.num_threads > 0;
+}
+
+/**
+ * @brief 判断两条记录的键是否相同
+ */
+static bool same_tuning_key(const TuningEntry &a, const TuningEntry &b)
+{
+  return a.cpu_model == b.cpu_model && a.isa == b.isa && a.dtype == b.dtype
+         && a.size_class == b.size_class;
+}
+
+/**
+ * @brief 从调优缓存中查找记录
+ *
+ * @param path 缓存文件路径
+ * @param key 查找键, 使用其中的cpu_model、isa、dtype和size_class
+ * @param entry 找到时写入的记录
+ * @return bool 是否找到, 文件不存在时返回false
+ */
+bool load_tuning(const string &path,
+                 const TuningEntry &key,
+                 TuningEntry &entry)
+{
+  std::ifstream file(path);
+  string line;
+  while (std::getline(file, line))
+  {
+    TuningEntry candidate;
+    if (parse_tuning_line(line, candidate) && same_tuning_key(candidate, key))
+    {
+      entry = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 写入调优缓存, 替换相同键的旧记录
+ *
+ * 读取已有记录, 去掉与entry键相同的行后追加新记录并整体重写文件;
+ * 目录不存在时自动创建
+ *
+ * @param path 缓存文件路径
+ * @param entry 调优记录
+ * @return bool 写入是否成功
+ */
+bool save_tuning(const string &path, const TuningEntry &entry)
+{
+  vector<string> lines;
+  {
+    std::ifstream file(path);
+    string line;
+    while (std::getline(file, line))
+    {
+      TuningEntry existing;
+      if (parse_tuning_line(line, existing)
+          && !same_tuning_key(existing, entry))
+      {
+        lines.push_back(line);
+      }
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::path parent = std::filesystem::path(path).parent_path();
+  if (!parent.empty()) std::filesystem::create_directories(parent, error);
+
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) return false;
+  file << "# cpu_model\tisa\tdtype\tsize_class\tkernel\tblock_size\t"
+          "num_threads\tthroughput"
+       << endl;
+  for (const string &line : lines)
+  {
+    file << line << endl;
+  }
+  file << entry.cpu_model << '\t' << entry.isa << '\t' << entry.dtype << '\t'
+       << entry.size_class << '\t' << kernel_name(entry.kernel) << '\t'
+       << entry.block_size << '\t' << entry.num_threads << '\t' << fixed
+       << setprecision(4) << entry.throughput << endl;
+  return static_cast<bool>(file);
+}
+
+/**
+ * @brief 经验式自动调优
+ *
+ * 搜索分两个阶段, 以减少需要计时的组合数：
+ * 1. 使用全部CPU核心, 比较分块内核的各个块大小(16~256及公式推导值)
+ *    和打包内核
+ * 2. 固定第1阶段的最优内核和块大小, 比较1、2、4...直到CPU核心数的线程数
+ *
+ * 每个候选最多计时TUNE_TRIALS次并取最短时间; 首次计时已超过当前最优
+ * TUNE_PRUNE_RATIO倍的候选直接淘汰, 不再重复计时。
+ * 多线程候选通过同一个线程池派发, 避免线程创建开销干扰比较。
+ *
+ * @tparam T 元素类型
+ * @param config 基准测试配置, 使用其中的matrix_size和ld_padding
+ * @return TuningEntry 最优组合及其性能, 键字段已按当前机器填好
+ *
+ * @see save_tuning()
+ */
+template <typename T> TuningEntry autotune(const BenchmarkConfig &config)
+{
+  const size_t n = config.matrix_size;
+  const size_t max_threads = std::max(get_cpu_cores(), size_t(1));
+  const double operations =
+      2.0 * static_cast<double>(n) * static_cast<double>(n)
+      * static_cast<double>(n);
+
+  ThreadPool pool(max_threads);
+  size_t ld = configured_leading_dimension(config, n);
+  Matrix<T> a(n, n, ld, matrix_no_init);
+  Matrix<T> b(n, n, ld, matrix_no_init);
+  Matrix<T> c(n, n, ld, matrix_no_init);
+  parallel_first_touch<T>(a,
+                          max_threads,
+                          &pool,
+                          [n](size_t row, T *data)
+                          {
+                            for (size_t col = 0; col < n; col++)
+                            {
+                              data[col] =
+                                  static_cast<T>((row * 31 + col * 17) % 100);
+                            }
+                          });
+  parallel_first_touch<T>(b,
+                          max_threads,
+                          &pool,
+                          [n](size_t row, T *data)
+                          {
+                            for (size_t col = 0; col < n; col++)
+                            {
+                              data[col] =
+                                  static_cast<T>((row * 17 + col * 31) % 100);
+                            }
+                          });
+
+  TuningEntry best;
+  best.cpu_model = cpu_model_name();
+  best.isa = simd_isa_name(active_simd_isa());
+  best.dtype = dtype_name(config.dtype);
+  best.size_class = size_class(n);
+  double best_time = std::numeric_limits<double>::infinity();
+
+  auto measure = [&](KernelType kernel, size_t block, size_t threads)
+  {
+    set_blocking_threads(threads);
+    GemmKernel<T> function = select_kernel<T>(kernel);
+    GemmTileKernel<T> tile_function = select_tile_kernel<T>(kernel);
+    Timer timer;
+    double fastest = std::numeric_limits<double>::infinity();
+    bool pruned = false;
+    for (size_t trial = 0; trial < TUNE_TRIALS; trial++)
+    {
+      parallel_first_touch(c, max_threads, &pool);
+      timer.start();
+      if (threads == 1)
+      {
+        function(a, b, c, block, 0, n);
+      }
+      else
+      {
+        parallel_computing_partitioned(
+            a, b, c, block, threads, tile_function, &pool);
+      }
+      timer.stop();
+      fastest = std::min(fastest, timer.get_seconds());
+      if (trial == 0 && fastest > best_time * TUNE_PRUNE_RATIO)
+      {
+        pruned = true;
+        break;
+      }
+    }
+
+    cout << "  " << setw(7) << kernel_name(kernel) << " 块=" << setw(4)
+         << block << " 线程=" << setw(3) << threads << ": " << fixed
+         << setprecision(4) << fastest << " 秒, " << setprecision(2)
+         << operations / (fastest * 1e9) << " "
+         << throughput_unit(config.dtype) << (pruned ? " (提前淘汰)" : "")
+         << endl;
+
+    if (fastest < best_time)
+    {
+      best_time = fastest;
+      best.kernel = kernel;
+      best.block_size = block;
+      best.num_threads = threads;
+    }
+  };
+
+  cout << "=== 自动调优 ===" << endl;
+  cout << "阶段1: 内核与块大小 (线程=" << max_threads << ")" << endl;
+  vector<size_t> blocks = {16, 32, 64, 128, 256};
+  blocks.push_back(calculate_optimal_block_size(sizeof(T)));
+  std::sort(blocks.begin(), blocks.end());
+  blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+  for (size_t block : blocks)
+  {
+    if (block > n && block != blocks.front()) break;
+    measure(KernelType::Blocked, block, max_threads);
+  }
+  measure(KernelType::Packed,
+          calculate_optimal_block_size(sizeof(T)),
+          max_threads);
+
+  cout << "阶段2: 线程数 (内核=" << kernel_name(best.kernel)
+       << ", 块=" << best.block_size << ")" << endl;
+  const KernelType best_kernel = best.kernel;
+  const size_t best_block = best.block_size;
+  for (size_t threads = 1; threads < max_threads; threads *= 2)
+  {
+    measure(best_kernel, best_block, threads);
+  }
+
+  best.throughput = operations / (best_time * 1e9);
+  cout << "最优: 内核=" << kernel_name(best.kernel)
+       << " 块=" << best.block_size << " 线程=" << best.num_threads << " ("
+       << fixed << setprecision(2) << best.throughput << " "
+       << throughput_unit(config.dtype) << ")" << endl;
+  cout << "==================" << endl << endl;
+  return best;
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_TUNE(T)                                               \
+  template TuningEntry autotune<T>(const BenchmarkConfig &);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_TUNE)
+#undef MM_INSTANTIATE_TUNE
@@ -0,0 +1,261 @@
+#include "MatrixMul.h"
+
+/**
+ * @brief 朴素ijk循环
+ *
+ * 内层循环沿B的列访问, 每次迭代跨越一整行(ld个元素), 几乎每次访问都会
+ * 产生缓存miss, 作为访存模式最差的基线
+ *
+ * @tparam T 元素类型
+ * @param src1 源矩阵1, 左操作数
+ * @param src2 源矩阵2, 右操作数
+ * @param dst 目标结果矩阵
+ * @param blockSize 未使用
+ * @param start 起始行索引(包含)
+ * @param end 结束行索引(不包含)
+ */
+template <typename T>
+static void variant_ijk(const Matrix<T> &src1,
+                        const Matrix<T> &src2,
+                        Matrix<T> &dst,
+                        size_t blockSize,
+                        size_t start,
+                        size_t end)
+{
+  (void)blockSize;
+  const size_t inner = src1.cols();
+  const size_t cols = dst.cols();
+  for (size_t i = start; i < end; i++)
+  {
+    const T *__restrict a_row = src1.row(i);
+    T *__restrict c_row = dst.row(i);
+    for (size_t j = 0; j < cols; j++)
+    {
+      T sum = T{};
+      for (size_t k = 0; k < inner; k++)
+      {
+        sum += a_row[k] * src2(k, j);
+      }
+      c_row[j] += sum;
+    }
+  }
+}
+
+/**
+ * @brief 朴素ikj循环(不分块)
+ *
+ * 内层循环连续访问B和C的同一行, 可以向量化, 但矩阵较大时B的整行
+ * 无法驻留缓存; 与分块内核比较即可看出分块的收益
+ *
+ * @tparam T 元素类型
+ * @param src1 源矩阵1, 左操作数
+ * @param src2 源矩阵2, 右操作数
+ * @param dst 目标结果矩阵
+ * @param blockSize 未使用
+ * @param start 起始行索引(包含)
+ * @param end 结束行索引(不包含)
+ */
+template <typename T>
+static void variant_ikj(const Matrix<T> &src1,
+                        const Matrix<T> &src2,
+                        Matrix<T> &dst,
+                        size_t blockSize,
+                        size_t start,
+                        size_t end)
+{
+  (void)blockSize;
+  const size_t inner = src1.cols();
+  const size_t cols = dst.cols();
+  for (size_t i = start; i < end; i++)
+  {
+    const T *__restrict a_row = src1.row(i);
+    T *__restrict c_row = dst.row(i);
+    for (size_t k = 0; k < inner; k++)
+    {
+      const T a_ik = a_row[k];
+      const T *__restrict b_row = src2.row(k);
+      for (size_t j = 0; j < cols; j++)
+      {
+        c_row[j] += a_ik * b_row[j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief 朴素jki循环
+ *
+ * 列主序下的最优顺序: 内层循环沿A和C的列访问, 在行主序存储中
+ * A和C都是跨步访问, 用于观察硬件预取器对跨步访问的处理能力
+ *
+ * @tparam T 元素类型
+ * @param src1 源矩阵1, 左操作数
+ * @param src2 源矩阵2, 右操作数
+ * @param dst 目标结果矩阵
+ * @param blockSize 未使用
+ * @param start 起始行索引(包含)
+ * @param end 结束行索引(不包含)
+ */
+template <typename T>
+static void variant_jki(const Matrix<T> &src1,
+                        const Matrix<T> &src2,
+                        Matrix<T> &dst,
+                        size_t blockSize,
+                        size_t start,
+                        size_t end)
+{
+  (void)blockSize;
+  const size_t inner = src1.cols();
+  const size_t cols = dst.cols();
+  for (size_t j = 0; j < cols; j++)
+  {
+    for (size_t k = 0; k < inner; k++)
+    {
+      const T b_kj = src2(k, j);
+      for (size_t i = start; i < end; i++)
+      {
+        dst(i, j) += src1(i, k) * b_kj;
+      }
+    }
+  }
+}
+
+/**
+ * @brief 预转置B的点积内核
+ *
+ * src2为B^T(cols x inner), 每个结果元素是A的一行与B^T的一行的点积,
+ * 两个操作数都连续访问; 转置在计时之外完成
+ *
+ * @tparam T 元素类型
+ * @param src1 源矩阵1, 左操作数
+ * @param src2 右操作数的转置B^T
+ * @param dst 目标结果矩阵
+ * @param blockSize 未使用
+ * @param start 起始行索引(包含)
+ * @param end 结束行索引(不包含)
+ *
+ * @see transpose_matrix()
+ */
+template <typename T>
+static void variant_ijk_bt(const Matrix<T> &src1,
+                           const Matrix<T> &src2,
+                           Matrix<T> &dst,
+                           size_t blockSize,
+                           size_t start,
+                           size_t end)
+{
+  (void)blockSize;
+  const size_t inner = src1.cols();
+  const size_t cols = dst.cols();
+  for (size_t i = start; i < end; i++)
+  {
+    const T *__restrict a_row = src1.row(i);
+    T *__restrict c_row = dst.row(i);
+    for (size_t j = 0; j < cols; j++)
+    {
+      const T *__restrict bt_row = src2.row(j);
+      T sum = T{};
+      for (size_t k = 0; k < inner; k++)
+      {
+        sum += a_row[k] * bt_row[k];
+      }
+      c_row[j] += sum;
+    }
+  }
+}
+
+/**
+ * @brief 获取已注册的内核变体
+ *
+ * 按访存模式从差到好排列, 名称在所有元素类型之间一致
+ *
+ * @tparam T 元素类型
+ * @return const vector<KernelVariant<T>>& 内核变体列表
+ */
+template <typename T> const vector<KernelVariant<T>> &kernel_variants()
+{
+  static const vector<KernelVariant<T>> variants = {
+      {"ijk", "朴素ijk, 内层沿B的列跨步访问", false, variant_ijk<T>},
+      {"jki", "朴素jki, 内层沿A和C的列跨步访问", false, variant_jki<T>},
+      {"ikj", "朴素ikj(不分块), 内层连续访问B和C的行", false, variant_ikj<T>},
+      {"ijk-bt", "预转置B的点积, A和B^T都连续访问", true, variant_ijk_bt<T>},
+      {"blocked", "L1/L2/L3三级分块的ikj(-k blocked)", false, matrix_mul<T>},
+      {"packed", "打包GEMM与SIMD微内核(-k packed)", false, packed_matrix_mul<T>},
+      {"strassen",
+       "Strassen-Winograd递归(-k strassen)",
+       false,
+       strassen_matrix_mul<T>},
+  };
+  return variants;
+}
+
+/**
+ * @brief 按名称查找内核变体
+ *
+ * @tparam T 元素类型
+ * @param name 变体名称
+ * @return const KernelVariant<T>* 找到的变体, 不存在时返回nullptr
+ */
+template <typename T>
+const KernelVariant<T> *find_kernel_variant(const string &name)
+{
+  for (const KernelVariant<T> &variant : kernel_variants<T>())
+  {
+    if (name == variant.name) return &variant;
+  }
+  return nullptr;
+}
+
+/**
+ * @brief 打印所有已注册的内核变体(--list-kernels)
+ */
+void print_kernel_variants()
+{
+  cout << "可用内核变体:" << endl;
+  for (const KernelVariant<int> &variant : kernel_variants<int>())
+  {
+    cout << "  " << std::left << setw(10) << variant.name << std::right
+         << variant.description << endl;
+  }
+}
+
+/**
+ * @brief 计算矩阵的转置
+ *
+ * 按64x64分块转置, 读写两侧都保持在缓存内
+ *
+ * @tparam T 元素类型
+ * @param matrix 源矩阵
+ * @return Matrix<T> cols x rows的转置矩阵, 使用默认行跨度
+ */
+template <typename T> Matrix<T> transpose_matrix(const Matrix<T> &matrix)
+{
+  const size_t rows = matrix.rows();
+  const size_t cols = matrix.cols();
+  const size_t block = 64;
+  Matrix<T> result(cols, rows);
+  for (size_t ib = 0; ib < rows; ib += block)
+  {
+    const size_t iend = min(ib + block, rows);
+    for (size_t jb = 0; jb < cols; jb += block)
+    {
+      const size_t jend = min(jb + block, cols);
+      for (size_t i = ib; i < iend; i++)
+      {
+        for (size_t j = jb; j < jend; j++)
+        {
+          result(j, i) = matrix(i, j);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_VARIANTS(T)                                           \
+  template const vector<KernelVariant<T>> &kernel_variants<T>();             \
+  template const KernelVariant<T> *find_kernel_variant<T>(const string &);   \
+  template Matrix<T> transpose_matrix<T>(const Matrix<T> &);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_VARIANTS)
+#undef MM_INSTANTIATE_VARIANTS
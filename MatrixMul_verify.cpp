@@ -0,0 +1,343 @@
+#include "MatrixMul.h"
+
+#include <random>
+
+/**
+ * @brief 获取验证的默认容差
+ *
+ * 浮点累加的舍入误差通常随sqrt(inner)增长, 再留出64倍余量以容纳
+ * 不同内核的累加顺序和Strassen的额外加减; 整数类型要求完全相等
+ *
+ * @tparam T 元素类型
+ * @param inner 公共维度
+ * @return double 相对容差, 整数类型为0
+ */
+template <typename T> double default_tolerance(size_t inner)
+{
+  if constexpr (std::is_floating_point_v<T>)
+  {
+    return 64.0 * std::sqrt(static_cast<double>(std::max(inner, size_t(1))))
+           * static_cast<double>(std::numeric_limits<T>::epsilon());
+  }
+  else
+  {
+    (void)inner;
+    return 0.0;
+  }
+}
+
+/**
+ * @brief Freivalds随机化验证 C == A * B
+ *
+ * 每轮生成随机向量r, 计算A(Br)和Cr并逐行比较, 只需O(n²)次运算,
+ * 不依赖单线程结果。C错误时每轮漏检的概率不超过1/2,
+ * 实际使用连续分布(浮点)或全位宽(整数)的随机数, 漏检概率远小于此。
+ *
+ * - 整数类型在同位宽的无符号类型中按模2^w运算, 与内核溢出后的回绕
+ *   结果一致, 要求完全相等
+ * - 浮点类型以double累加, 第i行允许的误差为
+ *   tolerance / sqrt(k) * (|A|(|B||r|) + |C||r|)_i;
+ *   该上界已包含k项累加的最坏情况, 而实际舍入误差随sqrt(k)增长,
+ *   除以sqrt(k)后容差的含义与compare_matrices()一致
+ *
+ * 三次矩阵向量乘法都按行并行, 每轮按行顺序读一遍A、B和C,
+ * 因此也适用于核外模式中内存映射的矩阵文件。不一致时记录出错的行,
+ * 便于定位某个线程负责的行区间。
+ *
+ * @tparam T 元素类型
+ * @param a 左操作数(m x k)
+ * @param b 右操作数(k x n)
+ * @param c 待验证的结果(m x n)
+ * @param rounds 随机向量个数
+ * @param tolerance 浮点类型的相对容差
+ * @param num_threads 线程数量
+ * @param pool 线程池, nullptr表示创建线程
+ * @return VerifyResult mismatches为出错的行数(各轮取并集)
+ */
+template <typename T>
+VerifyResult freivalds_verify(MatrixView<const T> a,
+                              MatrixView<const T> b,
+                              MatrixView<const T> c,
+                              size_t rounds,
+                              double tolerance,
+                              size_t num_threads,
+                              ThreadPool *pool)
+{
+  // 整数类型在同位宽的无符号类型中运算, 浮点类型以double累加
+  using Acc = typename std::conditional_t<std::is_floating_point_v<T>,
+                                          std::type_identity<double>,
+                                          std::make_unsigned<T>>::type;
+  const size_t m = c.rows;
+  const size_t k = a.cols;
+  const size_t n = c.cols;
+
+  VerifyResult result;
+  const double row_tolerance =
+      tolerance / std::sqrt(static_cast<double>(std::max(k, size_t(1))));
+  vector<char> bad_rows(m, 0);
+  std::mt19937_64 generator(std::random_device{}());
+  vector<Acc> r(n);
+  vector<Acc> br(k);
+  vector<double> br_bound(k);
+  vector<double> row_error(m);
+
+  for (size_t round = 0; round < rounds; round++)
+  {
+    for (Acc &value : r)
+    {
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        value = std::uniform_real_distribution<double>(-1.0, 1.0)(generator);
+      }
+      else
+      {
+        value = static_cast<Acc>(generator());
+      }
+    }
+
+    // Br及其绝对值上界|B||r|
+    parallel_rows(k,
+                  num_threads,
+                  pool,
+                  [&](size_t start, size_t end)
+                  {
+                    for (size_t i = start; i < end; i++)
+                    {
+                      const T *row = b.row(i);
+                      Acc sum = 0;
+                      double bound = 0.0;
+                      for (size_t j = 0; j < n; j++)
+                      {
+                        sum += static_cast<Acc>(row[j]) * r[j];
+                        if constexpr (std::is_floating_point_v<T>)
+                        {
+                          bound += std::abs(static_cast<double>(row[j]) * r[j]);
+                        }
+                      }
+                      br[i] = sum;
+                      br_bound[i] = bound;
+                    }
+                  });
+
+    // 逐行比较A(Br)与Cr
+    parallel_rows(
+        m,
+        num_threads,
+        pool,
+        [&](size_t start, size_t end)
+        {
+          for (size_t i = start; i < end; i++)
+          {
+            const T *a_row = a.row(i);
+            const T *c_row = c.row(i);
+            Acc abr = 0;
+            Acc cr = 0;
+            double bound = 0.0;
+            for (size_t p = 0; p < k; p++)
+            {
+              abr += static_cast<Acc>(a_row[p]) * br[p];
+              if constexpr (std::is_floating_point_v<T>)
+              {
+                bound += std::abs(static_cast<double>(a_row[p])) * br_bound[p];
+              }
+            }
+            for (size_t j = 0; j < n; j++)
+            {
+              cr += static_cast<Acc>(c_row[j]) * r[j];
+              if constexpr (std::is_floating_point_v<T>)
+              {
+                bound += std::abs(static_cast<double>(c_row[j]) * r[j]);
+              }
+            }
+            if constexpr (std::is_floating_point_v<T>)
+            {
+              const double error = std::abs(abr - cr);
+              row_error[i] = bound > 0.0 ? error / bound : error;
+              if (!(error <= row_tolerance * bound)) bad_rows[i] = 1;
+            }
+            else
+            {
+              row_error[i] = abr == cr ? 0.0 : 1.0;
+              if (abr != cr) bad_rows[i] = 1;
+            }
+          }
+        });
+
+    for (size_t i = 0; i < m; i++)
+    {
+      result.max_error = std::max(result.max_error, row_error[i]);
+    }
+  }
+
+  for (size_t i = 0; i < m; i++)
+  {
+    if (!bad_rows[i]) continue;
+    if (result.mismatches == 0) result.first_row = i;
+    result.mismatches++;
+  }
+  result.passed = result.mismatches == 0;
+  return result;
+}
+
+/**
+ * @brief Freivalds随机化验证 C == A * B
+ *
+ * @tparam T 元素类型
+ * @param a 左操作数(m x k)
+ * @param b 右操作数(k x n)
+ * @param c 待验证的结果(m x n)
+ * @param rounds 随机向量个数
+ * @param tolerance 浮点类型的相对容差
+ * @param num_threads 线程数量
+ * @param pool 线程池, nullptr表示创建线程
+ * @return VerifyResult mismatches为出错的行数(各轮取并集)
+ */
+template <typename T>
+VerifyResult freivalds_verify(const Matrix<T> &a,
+                              const Matrix<T> &b,
+                              const Matrix<T> &c,
+                              size_t rounds,
+                              double tolerance,
+                              size_t num_threads,
+                              ThreadPool *pool)
+{
+  return freivalds_verify(
+      a.view(), b.view(), c.view(), rounds, tolerance, num_threads, pool);
+}
+
+/**
+ * @brief 并行逐元素比较两个矩阵
+ *
+ * 整数类型要求完全相等; 浮点类型要求
+ * |actual - expected| <= tolerance * max(max|expected|, 1)。
+ * 使用整个矩阵的最大元素作为尺度(按范数比较), 因为Strassen等算法
+ * 只保证按范数的误差界, 结果接近0的元素上逐元素相对误差没有意义。
+ *
+ * @tparam T 元素类型
+ * @param expected 参考结果
+ * @param actual 待验证的结果, 尺寸与expected相同
+ * @param tolerance 浮点类型的相对容差
+ * @param num_threads 线程数量
+ * @param pool 线程池, nullptr表示创建线程
+ * @return VerifyResult mismatches为不一致的元素数,
+ *         max_error为最大误差与尺度之比(整数类型为最大绝对误差)
+ */
+template <typename T>
+VerifyResult compare_matrices(const Matrix<T> &expected,
+                              const Matrix<T> &actual,
+                              double tolerance,
+                              size_t num_threads,
+                              ThreadPool *pool)
+{
+  const size_t rows = expected.rows();
+  const size_t cols = expected.cols();
+  if (pool != nullptr) num_threads = std::min(num_threads, pool->size());
+  num_threads = std::max(num_threads, size_t(1));
+
+  // 每个线程写自己的局部结果, 最后按行顺序合并, 首个位置与串行比较一致
+  vector<VerifyResult> partial(num_threads);
+  const size_t rows_per_thread = (rows + num_threads - 1) / num_threads;
+
+  double scale = 1.0;
+  if constexpr (std::is_floating_point_v<T>)
+  {
+    vector<double> row_max(rows, 0.0);
+    parallel_rows(rows,
+                  num_threads,
+                  pool,
+                  [&](size_t start, size_t end)
+                  {
+                    for (size_t i = start; i < end; i++)
+                    {
+                      const T *e_row = expected.row(i);
+                      for (size_t j = 0; j < cols; j++)
+                      {
+                        const double value = static_cast<double>(e_row[j]);
+                        row_max[i] = std::max(row_max[i], std::abs(value));
+                      }
+                    }
+                  });
+    for (double value : row_max)
+    {
+      scale = std::max(scale, value);
+    }
+  }
+
+  parallel_rows(
+      rows,
+      num_threads,
+      pool,
+      [&](size_t start, size_t end)
+      {
+        VerifyResult &local = partial[start / rows_per_thread];
+        for (size_t i = start; i < end; i++)
+        {
+          const T *e_row = expected.row(i);
+          const T *a_row = actual.row(i);
+          for (size_t j = 0; j < cols; j++)
+          {
+            const double e = static_cast<double>(e_row[j]);
+            const double x = static_cast<double>(a_row[j]);
+            double error = 0.0;
+            bool match;
+            if constexpr (std::is_floating_point_v<T>)
+            {
+              error = std::abs(x - e) / scale;
+              match = error <= tolerance;
+            }
+            else
+            {
+              error = std::abs(x - e);
+              match = e_row[j] == a_row[j];
+            }
+            local.max_error = std::max(local.max_error, error);
+            if (match) continue;
+            if (local.mismatches == 0)
+            {
+              local.first_row = i;
+              local.first_col = j;
+            }
+            local.mismatches++;
+          }
+        }
+      });
+
+  VerifyResult result;
+  for (const VerifyResult &local : partial)
+  {
+    if (result.mismatches == 0 && local.mismatches > 0)
+    {
+      result.first_row = local.first_row;
+      result.first_col = local.first_col;
+    }
+    result.mismatches += local.mismatches;
+    result.max_error = std::max(result.max_error, local.max_error);
+  }
+  result.passed = result.mismatches == 0;
+  return result;
+}
+
+// 显式实例化所有支持的元素类型
+#define MM_INSTANTIATE_VERIFY(T)                                             \
+  template double default_tolerance<T>(size_t);                              \
+  template VerifyResult freivalds_verify<T>(const Matrix<T> &,               \
+                                            const Matrix<T> &,               \
+                                            const Matrix<T> &,               \
+                                            size_t,                          \
+                                            double,                          \
+                                            size_t,                          \
+                                            ThreadPool *);                   \
+  template VerifyResult freivalds_verify<T>(MatrixView<const T>,             \
+                                            MatrixView<const T>,             \
+                                            MatrixView<const T>,             \
+                                            size_t,                          \
+                                            double,                          \
+                                            size_t,                          \
+                                            ThreadPool *);                   \
+  template VerifyResult compare_matrices<T>(const Matrix<T> &,               \
+                                            const Matrix<T> &,               \
+                                            double,                          \
+                                            size_t,                          \
+                                            ThreadPool *);
+MM_FOR_EACH_DTYPE(MM_INSTANTIATE_VERIFY)
+#undef MM_INSTANTIATE_VERIFY
@@ -0,0 +1,193 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#  include <immintrin.h>
+#endif
+
+/**
+ * @brief 自旋等待提示
+ *
+ * x86使用pause指令, ARM使用yield指令, 降低自旋时的功耗和对
+ * 超线程兄弟核的干扰
+ */
+static inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief 创建线程池
+ *
+ * 创建num_threads-1个后台工作线程, 调用线程作为0号参与者。
+ * 参与者数超过硬件线程数时自旋只会抢占正在工作的线程, 因此直接挂起。
+ *
+ * @param num_threads 参与者总数(包括调用线程), 0按1处理
+ * @param spins 挂起前的自旋次数
+ */
+ThreadPool::ThreadPool(size_t num_threads, size_t spins) : spin_count(spins)
+{
+  num_threads = std::max(num_threads, size_t(1));
+  size_t hardware_threads = std::thread::hardware_concurrency();
+  if (hardware_threads != 0 && num_threads > hardware_threads)
+  {
+    spin_count = 0;
+  }
+  workers.reserve(num_threads - 1);
+  for (size_t tid = 1; tid < num_threads; tid++)
+  {
+    workers.emplace_back([this, tid]() { worker_loop(tid); });
+  }
+}
+
+/**
+ * @brief 通知并等待所有工作线程退出
+ *
+ * 设置退出标志后递增代数, 使等待中的工作线程醒来并检查退出标志
+ */
+ThreadPool::~ThreadPool()
+{
+  stopping.store(true, std::memory_order_release);
+  generation.fetch_add(1, std::memory_order_release);
+  generation.notify_all();
+  for (auto &t : workers)
+  {
+    t.join();
+  }
+}
+
+/**
+ * @brief 工作线程主循环
+ *
+ * 等待代数变化(先自旋后挂起), 执行当前任务后递减pending计数;
+ * 最后一个完成的工作线程唤醒在run()中等待的调用线程
+ *
+ * @param tid 参与者编号
+ */
+void ThreadPool::worker_loop(size_t tid)
+{
+  uint64_t seen = 0;
+  for (;;)
+  {
+    uint64_t gen;
+    size_t spins = 0;
+    while ((gen = generation.load(std::memory_order_acquire)) == seen)
+    {
+      if (spins < spin_count)
+      {
+        cpu_relax();
+        spins++;
+      }
+      else
+      {
+        generation.wait(seen, std::memory_order_acquire);
+      }
+    }
+    seen = gen;
+
+    if (stopping.load(std::memory_order_acquire)) return;
+
+    (*current_task)(tid);
+
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      pending.notify_one();
+    }
+  }
+}
+
+/**
+ * @brief 在所有参与者上执行任务并等待完成
+ *
+ * fork: 发布任务指针并递增代数(release语义保证工作线程看到任务);
+ * 调用线程随后执行0号任务;
+ * join: 等待pending归零, 同样先自旋后挂起
+ *
+ * @param task 任务函数, task(tid)在每个参与者上各执行一次
+ */
+void ThreadPool::run(const std::function<void(size_t)> &task)
+{
+  if (workers.empty())
+  {
+    task(0);
+    return;
+  }
+
+  current_task = &task;
+  pending.store(workers.size(), std::memory_order_relaxed);
+  generation.fetch_add(1, std::memory_order_release);
+  generation.notify_all();
+
+  task(0);
+
+  size_t spins = 0;
+  size_t remaining;
+  while ((remaining = pending.load(std::memory_order_acquire)) != 0)
+  {
+    if (spins < spin_count)
+    {
+      cpu_relax();
+      spins++;
+    }
+    else
+    {
+      pending.wait(remaining, std::memory_order_acquire);
+    }
+  }
+}
+
+/**
+ * @brief 测量fork/join派发延迟
+ *
+ * 先预热一轮, 再对rounds轮空任务派发计时取平均。
+ * 结果反映线程创建/销毁(或线程池唤醒/屏障)本身的开销,
+ * 与矩阵规模无关。
+ *
+ * @param num_threads 线程数
+ * @param pool 线程池, nullptr表示每次创建线程
+ * @param rounds 测量轮数
+ * @return double 平均每次派发的延迟, 单位为微秒
+ */
+double measure_dispatch_latency(size_t num_threads,
+                                ThreadPool *pool,
+                                size_t rounds)
+{
+  std::atomic<size_t> sink{0};
+  auto dispatch = [&]()
+  {
+    if (pool != nullptr)
+    {
+      pool->run([&sink](size_t tid)
+                { sink.fetch_add(tid, std::memory_order_relaxed); });
+      return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_t tid = 0; tid < num_threads; tid++)
+    {
+      threads.emplace_back(
+          [&sink, tid]() { sink.fetch_add(tid, std::memory_order_relaxed); });
+    }
+    for (auto &t : threads)
+    {
+      t.join();
+    }
+  };
+
+  rounds = std::max(rounds, size_t(1));
+  dispatch();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++)
+  {
+    dispatch();
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::micro> elapsed = end - start;
+  return elapsed.count() / static_cast<double>(rounds);
+}
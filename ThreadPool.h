@@ -0,0 +1,92 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 持久化的fork/join线程池
+ *
+ * 工作线程在构造时创建并在多次矩阵乘法之间复用, 避免每次调用都创建和
+ * 销毁std::thread。派发采用基于屏障的fork/join模型:
+ * - fork: 调用线程发布任务并递增代数(generation), 唤醒所有工作线程
+ * - join: 每个参与者完成后递减计数, 最后一个到达者唤醒调用线程
+ *
+ * 等待时先自旋一段时间(适合连续迭代的短间隔), 超过自旋次数后通过
+ * std::atomic::wait挂起, 不会长期占用CPU。
+ *
+ * 调用线程本身作为0号参与者执行任务, 因此size()个参与者只需要
+ * size()-1个后台线程。run()不可重入, 同一时刻只能由一个线程调用。
+ */
+class ThreadPool
+{
+private:
+  std::vector<std::thread> workers; ///< 后台工作线程
+  std::atomic<uint64_t> generation{0}; ///< 任务代数, 每次fork递增
+  std::atomic<size_t> pending{0}; ///< 尚未完成当前任务的工作线程数
+  std::atomic<bool> stopping{false}; ///< 析构时通知工作线程退出
+  const std::function<void(size_t)> *current_task = nullptr; ///< 当前任务
+  size_t spin_count; ///< 挂起前的自旋次数
+
+  /**
+   * @brief 工作线程主循环
+   *
+   * @param tid 参与者编号(1..size()-1)
+   */
+  void worker_loop(size_t tid);
+
+public:
+  /**
+   * @brief 创建线程池
+   *
+   * @param num_threads 参与者总数(包括调用线程), 至少为1
+   * @param spins 挂起前的自旋次数
+   */
+  explicit ThreadPool(size_t num_threads, size_t spins = 4096);
+
+  /**
+   * @brief 通知并等待所有工作线程退出
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief 获取参与者总数
+   *
+   * @return size_t 后台线程数加上调用线程
+   */
+  size_t size() const { return workers.size() + 1; }
+
+  /**
+   * @brief 在所有参与者上执行任务并等待完成
+   *
+   * task(tid)在每个参与者上各执行一次, tid取值0..size()-1,
+   * 其中0号由调用线程执行
+   *
+   * @param task 任务函数
+   */
+  void run(const std::function<void(size_t)> &task);
+};
+
+/**
+ * @brief 测量fork/join派发延迟
+ *
+ * 反复派发空任务并取平均值: pool为nullptr时每轮创建并join
+ * num_threads个std::thread(与原有实现一致), 否则使用线程池派发
+ *
+ * @param num_threads 线程数
+ * @param pool 线程池, nullptr表示每次创建线程
+ * @param rounds 测量轮数
+ * @return double 平均每次派发的延迟, 单位为微秒
+ */
+double measure_dispatch_latency(size_t num_threads,
+                                ThreadPool *pool,
+                                size_t rounds);
+
+#endif // THREADPOOL_H
@@ -58,37 +58,36 @@ if exist "Makefile.win" (
 )
 echo.
 
-rem 运行测试
+rem 运行测试, JSON结果写入results目录
+if not exist results mkdir results
 echo === 性能测试套件 ===
 echo.
 
 echo 1. 快速测试 (512x512)
-%PROGRAM% -s 512 -i 3
+%PROGRAM% -s 512 -i 3 --output results\quick_512.json
 echo.
 
 echo 2. 标准测试 (1024x1024)
-%PROGRAM% -s 1024 -i 3
+%PROGRAM% -s 1024 -i 3 --output results\standard_1024.json
 echo.
 
 echo 3. 扩展性测试
 echo 单线程:
-%PROGRAM% -s 1024 -t 1 -i 2
+%PROGRAM% -s 1024 -t 1 -i 2 --output results\scaling_1t.json
 echo 多线程:
-%PROGRAM% -s 1024 -i 2
+%PROGRAM% -s 1024 -i 2 --output results\scaling_all.json
 echo.
 
 if "%1"=="full" (
     echo 4. 大矩阵测试 (2048x2048)
-    %PROGRAM% -s 2048 -i 1
+    %PROGRAM% -s 2048 -i 1 --output results\large_2048.json
     echo.
 
-    echo 5. 块大小优化测试
-    for %%s in (32 64 128 256) do (
-        echo 块大小 %%s:
-        %PROGRAM% -s 1024 -b %%s -i 1
-    )
+    echo 5. 自动调优 (内核/块大小/线程数)
+    %PROGRAM% -s 1024 --autotune -i 1 --output results\autotune_1024.json
     echo.
 )
 
+echo JSON结果已保存到: results
 echo 测试完成！
 pause
@@ -92,37 +92,52 @@ print_system_info() {
   echo ""
 }
 
+# 运行单个测试, 控制台输出文本, 同时把JSON结果写入$RESULT_DIR/<名称>.json
+run_case() {
+  local name="$1"
+  shift
+  $PROGRAM "$@" --format json --output "$RESULT_DIR/$name.json"
+}
+
 # 运行性能测试
 run_benchmarks() {
+  RESULT_DIR="results/$(date +%Y%m%d-%H%M%S)"
+  mkdir -p "$RESULT_DIR"
+
   echo -e "${YELLOW}=== 性能测试套件 ===${NC}"
 
   echo -e "${BLUE}1. 快速测试 (512x512)${NC}"
-  $PROGRAM -s 512 -i 3
+  run_case quick_512 -s 512 -i 3
   echo ""
 
   echo -e "${BLUE}2. 标准测试 (1024x1024)${NC}"
-  $PROGRAM -s 1024 -i 3
+  run_case standard_1024 -s 1024 -i 3
   echo ""
 
   echo -e "${BLUE}3. 扩展性测试${NC}"
   echo "单线程:"
-  $PROGRAM -s 1024 -t 1 -i 2
+  run_case scaling_1t -s 1024 -t 1 -i 2
   echo "多线程:"
-  $PROGRAM -s 1024 -i 2
+  run_case scaling_all -s 1024 -i 2
   echo ""
 
   if [ "$1" == "full" ]; then
     echo -e "${BLUE}4. 大矩阵测试 (2048x2048)${NC}"
-    $PROGRAM -s 2048 -i 1
+    run_case large_2048 -s 2048 -i 1
     echo ""
 
-    echo -e "${BLUE}5. 块大小优化测试${NC}"
-    for block_size in 32 64 128 256; do
-      echo "块大小 $block_size:"
-      $PROGRAM -s 1024 -b $block_size -i 1
-    done
+    echo -e "${BLUE}5. 自动调优 (内核/块大小/线程数)${NC}"
+    run_case autotune_1024 -s 1024 --autotune -i 1
+    echo ""
+
+    echo -e "${BLUE}6. 矩形形状 (瘦高/矮宽/长K)${NC}"
+    run_case tall_skinny -d f32 -k packed --shape 65536x256x256 -i 2
+    run_case short_wide -d f32 -k packed --shape 256x65536x256 -i 2
+    run_case long_inner -d f32 -k packed --shape 256x256x65536 -i 2
     echo ""
   fi
+
+  echo -e "${GREEN}JSON结果已保存到: $RESULT_DIR${NC}"
 }
 
 # 主函数
@@ -7,7 +7,6 @@
 import datetime
 import json
 import platform
-import re
 import subprocess
 import sys
 
@@ -34,9 +33,9 @@ def get_system_info():
 
 
 def run_benchmark(program_path, args):
-  """运行基准测试并解析输出"""
+  """运行基准测试并解析 --format json 输出"""
   try:
-    cmd = [program_path] + args
+    cmd = [program_path] + args + ['--format', 'json']
     result = subprocess.run(cmd, capture_output=True, text=True, timeout=300)
 
     if result.returncode != 0:
@@ -45,42 +44,37 @@ def run_benchmark(program_path, args):
     return parse_output(result.stdout), None
   except subprocess.TimeoutExpired:
     return None, "程序执行超时"
+  except json.JSONDecodeError as e:
+    return None, f"无法解析程序输出: {str(e)}"
   except Exception as e:
     return None, f"执行错误: {str(e)}"
 
 
 def parse_output(output):
-  """解析程序输出"""
-  data = {}
-
-  # 提取关键信息
-  patterns = {
-      'matrix_size': r'矩阵大小: (\d+)x(\d+)',
-      'block_size': r'块大小: (\d+)',
-      'thread_count': r'线程数: (\d+)',
-      'iterations': r'迭代次数: (\d+)',
-      'memory_usage': r'内存使用量约: ([\d.]+) MB',
-      'single_thread_time': r'单线程平均时间: ([\d.]+) 秒',
-      'multi_thread_time': r'多线程平均时间: ([\d.]+) 秒',
-      'speedup': r'加速比: ([\d.]+)x',
-      'efficiency': r'效率: ([\d.]+)%',
-      'single_gflops': r'单线程性能: ([\d.]+) GFLOPS',
-      'multi_gflops': r'多线程性能: ([\d.]+) GFLOPS'
+  """解析程序的 JSON 结果, 提取报告使用的指标
+
+  字段名由程序的 JSON 格式固定, 不依赖控制台文本的措辞。
+  原始结果保存在 report 中, 包含每次迭代的时间。
+  """
+  report = json.loads(output)
+  config = report['config']
+  run = report['runs'][0]
+  return {
+      'matrix_size': config['matrix_size'],
+      'block_size': config['block_size'],
+      'thread_count': config['num_threads'],
+      'iterations': config['iterations'],
+      'memory_usage': round(config['memory_mb'], 2),
+      'single_thread_time': run['single_avg_seconds'],
+      'multi_thread_time': run['multi_avg_seconds'],
+      'speedup': round(run['speedup'], 4),
+      'efficiency': round(run['efficiency'] * 100, 2),
+      'single_gflops': round(run['single_throughput'], 4),
+      'multi_gflops': round(run['multi_throughput'], 4),
+      'unit': run['throughput_unit'],
+      'report': report
   }
 
-  for key, pattern in patterns.items():
-    match = re.search(pattern, output)
-    if match:
-      if key == 'matrix_size':
-        data[key] = int(match.group(1))
-      elif key in ['block_size', 'thread_count', 'iterations']:
-        data[key] = int(match.group(1))
-      else:
-        data[key] = float(match.group(1))
-
-  data['raw_output'] = output
-  return data
-
 
 def generate_html_report(results, output_file):
   """生成 HTML 报告"""
@@ -137,7 +131,14 @@ def generate_html_report(results, output_file):
 </html>
 """
 
-  system_info = results['system_info']
+  system_info = dict(results['system_info'])
+  # 优先使用程序检测到的 CPU 型号和核心数
+  for result in results['benchmarks']:
+    if 'data' in result:
+      system = result['data']['report']['system']
+      system_info['processor'] = system['cpu_model']
+      system_info['cpu_count'] = system['cpu_cores']
+      break
   test_results_html = ""
   summary_rows = ""
 
@@ -160,8 +161,8 @@ def generate_html_report(results, output_file):
             <div class="metric">迭代次数: {data.get('iterations', 'N/A')}</div>
             <div class="metric">内存使用: {data.get('memory_usage', 'N/A')} MB</div>
             <br>
-            <div class="metric performance">单线程: {data.get('single_gflops', 'N/A')} GFLOPS</div>
-            <div class="metric performance">多线程: {data.get('multi_gflops', 'N/A')} GFLOPS</div>
+            <div class="metric performance">单线程: {data.get('single_gflops', 'N/A')} {data.get('unit', 'GFLOPS')}</div>
+            <div class="metric performance">多线程: {data.get('multi_gflops', 'N/A')} {data.get('unit', 'GFLOPS')}</div>
             <div class="metric">加速比: {data.get('speedup', 'N/A')}x</div>
             <div class="metric">效率: {data.get('efficiency', 'N/A')}%</div>
         </div>
@@ -306,9 +307,19 @@ def main():
 
   print(f"生成报告: {output_file}")
   generate_html_report(results, output_file)
+  json_file = output_file.rsplit('.', 1)[0] + '.json'
+  with open(json_file, 'w', encoding='utf-8') as f:
+    json.dump([
+        result['data']['report']
+        for result in results['benchmarks']
+        if 'data' in result
+    ],
+              f,
+              ensure_ascii=False,
+              indent=2)
+  print(f"原始结果: {json_file}")
   print("报告生成完成！")
 
 
 if __name__ == '__main__':
   main()
-  main()
@@ -0,0 +1,127 @@
+/**
+ * @file test_thread_grid.cpp
+ * @brief choose_thread_grid()的回归测试
+ *
+ * 检查线程网格的基本约束, 并要求M x N网格足以分给所有线程的问题
+ * (包括所有方阵)不拆分K。通过`make test-grid`编译运行, 失败时返回1
+ */
+#include "../MatrixMul.h"
+
+/// 失败的检查数
+static int failures = 0;
+
+/**
+ * @brief 输出一个不满足预期的网格
+ *
+ * @param what 不满足的条件
+ * @param m 结果矩阵行数
+ * @param n 结果矩阵列数
+ * @param k 公共维度
+ * @param threads 线程数
+ * @param grid 选出的网格
+ */
+static void fail(const char *what,
+                 size_t m,
+                 size_t n,
+                 size_t k,
+                 size_t threads,
+                 const ThreadGrid &grid)
+{
+  cout << "失败: " << what << ": " << m << "x" << n << "x" << k
+       << " t=" << threads << " -> " << grid.row_parts << "x"
+       << grid.col_parts << "x" << grid.k_parts << endl;
+  failures++;
+}
+
+/**
+ * @brief 检查网格覆盖全部线程、各段大小与段数一致且没有空的K段
+ *
+ * @return ThreadGrid 选出的网格
+ */
+static ThreadGrid check_grid(size_t m,
+                             size_t n,
+                             size_t k,
+                             size_t threads,
+                             size_t element_size)
+{
+  const ThreadGrid grid = choose_thread_grid(m, n, k, threads, element_size);
+  if (grid.row_parts * grid.col_parts * grid.k_parts != threads)
+  {
+    fail("网格大小不等于线程数", m, n, k, threads, grid);
+  }
+  if (grid.rows_per_part * grid.row_parts < m
+      || grid.cols_per_part * grid.col_parts < n
+      || grid.depth_per_part * grid.k_parts < k)
+  {
+    fail("各段没有覆盖整个问题", m, n, k, threads, grid);
+  }
+  if (grid.k_parts > 1 && (grid.k_parts - 1) * grid.depth_per_part >= k)
+  {
+    fail("最后一个K段为空", m, n, k, threads, grid);
+  }
+  return grid;
+}
+
+/**
+ * @brief 检查网格与预期的分解相同
+ */
+static void expect_grid(size_t m,
+                        size_t n,
+                        size_t k,
+                        size_t threads,
+                        size_t row_parts,
+                        size_t col_parts,
+                        size_t k_parts)
+{
+  const ThreadGrid grid = check_grid(m, n, k, threads, sizeof(int));
+  if (grid.row_parts != row_parts || grid.col_parts != col_parts
+      || grid.k_parts != k_parts)
+  {
+    fail("网格与预期不同", m, n, k, threads, grid);
+  }
+}
+
+int main()
+{
+  // 方阵的M x N网格总能分给所有线程, 不应拆分K
+  const size_t sizes[] = {64, 256, 512, 999, 1000, 1024, 2048, 4096, 8192};
+  for (size_t size : sizes)
+  {
+    for (size_t threads = 1; threads <= 64; threads++)
+    {
+      for (size_t element_size : {sizeof(float), sizeof(double)})
+      {
+        const ThreadGrid grid =
+            check_grid(size, size, size, threads, element_size);
+        if (grid.k_parts != 1)
+        {
+          fail("方阵选择了split-K", size, size, size, threads, grid);
+        }
+      }
+    }
+  }
+
+  // M或N很小时沿另一维划分, 两者都太小时才拆分K
+  expect_grid(1024, 1024, 1024, 8, 4, 2, 1);
+  expect_grid(65536, 256, 256, 8, 8, 1, 1);
+  expect_grid(256, 65536, 256, 8, 1, 8, 1);
+  expect_grid(256, 256, 65536, 8, 4, 2, 1);
+  expect_grid(1, 1, 65536, 8, 1, 1, 8);
+  expect_grid(1, 1, 65536, 3, 1, 1, 3);
+
+  // 40列int32按4段切分时列段向上取整为16列, 只有3段非空;
+  // 2x2网格的乘加次数相同且没有空闲线程
+  expect_grid(2, 40, 256, 4, 2, 2, 1);
+
+  check_grid(1, 16, 4225, 66, sizeof(int));
+  check_grid(1, 1, 4225, 66, sizeof(int));
+  check_grid(3, 5, 8191, 66, sizeof(int));
+
+  if (failures != 0)
+  {
+    cout << failures << " 项检查失败" << endl;
+    return 1;
+  }
+  cout << "线程网格测试通过" << endl;
+  return 0;
+}